@@ -1,14 +1,18 @@
-/*#include <SFML/Graphics.hpp>
+#include <SFML/Graphics.hpp>
 
 #include <rbf/SDRNetwork.h>
 
 #include <time.h>
+#include <assert.h>
 #include <iostream>
 #include <random>
 #include <array>
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include <dirent.h>
 
@@ -22,6 +26,207 @@ struct Label {
 	{}
 };
 
+sf::Image toImage(const std::vector<float> &values, int width, int height) {
+	sf::Image image;
+
+	image.create(width, height);
+
+	for (int x = 0; x < width; x++)
+	for (int y = 0; y < height; y++) {
+		sf::Color color = sf::Color::White;
+
+		color.r = color.b = color.g = values[x + y * width] * 255.0f;
+
+		image.setPixel(x, y, color);
+	}
+
+	return image;
+}
+
+// Decodes an image and fits it (centered, aspect kept) into a width x height greyscale input on a white background.
+// Sampling is bilinear like a smoothed sprite, but done on the CPU so that it can run on any thread
+bool loadInput(const std::string &fileName, int width, int height, std::vector<float> &input) {
+	sf::Image source;
+
+	if (!source.loadFromFile(fileName))
+		return false;
+
+	const float byteInv = 1.0f / 255.0f;
+
+	int sourceWidth = source.getSize().x;
+	int sourceHeight = source.getSize().y;
+
+	const sf::Uint8* pPixels = source.getPixelsPtr();
+
+	float scale = std::min(static_cast<float>(width) / sourceWidth, static_cast<float>(height) / sourceHeight);
+	float scaleInv = 1.0f / scale;
+
+	float offsetX = width * 0.5f - sourceWidth * scale * 0.5f;
+	float offsetY = height * 0.5f - sourceHeight * scale * 0.5f;
+
+	input.resize(width * height);
+
+	for (int y = 0; y < height; y++)
+	for (int x = 0; x < width; x++) {
+		float u = (x + 0.5f - offsetX) * scaleInv;
+		float v = (y + 0.5f - offsetY) * scaleInv;
+
+		if (u < 0.0f || u >= sourceWidth || v < 0.0f || v >= sourceHeight) {
+			input[x + y * width] = 1.0f;
+
+			continue;
+		}
+
+		float su = std::min(static_cast<float>(sourceWidth - 1), std::max(0.0f, u - 0.5f));
+		float sv = std::min(static_cast<float>(sourceHeight - 1), std::max(0.0f, v - 0.5f));
+
+		int x0 = static_cast<int>(su);
+		int y0 = static_cast<int>(sv);
+		int x1 = std::min(sourceWidth - 1, x0 + 1);
+		int y1 = std::min(sourceHeight - 1, y0 + 1);
+
+		float fx = su - x0;
+		float fy = sv - y0;
+
+		float color[4];
+
+		for (int c = 0; c < 4; c++) {
+			float top = pPixels[(x0 + y0 * sourceWidth) * 4 + c] * (1.0f - fx) + pPixels[(x1 + y0 * sourceWidth) * 4 + c] * fx;
+			float bottom = pPixels[(x0 + y1 * sourceWidth) * 4 + c] * (1.0f - fx) + pPixels[(x1 + y1 * sourceWidth) * 4 + c] * fx;
+
+			color[c] = (top * (1.0f - fy) + bottom * fy) * byteInv;
+		}
+
+		float greyscale = color[0] * 0.299f + color[1] * 0.587f + color[2] * 0.114f;
+
+		// Blend onto the white background
+		input[x + y * width] = greyscale * color[3] + (1.0f - color[3]);
+	}
+
+	return true;
+}
+
+// Decodes a fixed list of images on background threads, handing them out in list order.
+// At most capacity images are decoded ahead of the consumer
+class ImagePrefetcher {
+public:
+	struct Item {
+		std::string _fileName;
+		int _label;
+		int _member;
+	};
+
+private:
+	struct Slot {
+		std::vector<float> _input;
+		bool _loaded;
+		bool _ready;
+
+		Slot()
+			: _loaded(false), _ready(false)
+		{}
+	};
+
+	std::vector<Item> _items;
+
+	int _width, _height;
+
+	std::vector<Slot> _slots;
+
+	// Next item to decode, next item to hand out
+	int _next;
+	int _consumed;
+
+	bool _stop;
+
+	std::mutex _mutex;
+	std::condition_variable _claimable;
+	std::condition_variable _ready;
+
+	std::vector<std::thread> _workers;
+
+	void work() {
+		for (;;) {
+			int index;
+
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+
+				_claimable.wait(lock, [this] { return _stop || _next >= _items.size() || _next < _consumed + static_cast<int>(_slots.size()); });
+
+				if (_stop || _next >= _items.size())
+					return;
+
+				index = _next++;
+			}
+
+			std::vector<float> input;
+
+			bool loaded = loadInput(_items[index]._fileName, _width, _height, input);
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+
+				Slot &slot = _slots[index % _slots.size()];
+
+				slot._input.swap(input);
+				slot._loaded = loaded;
+				slot._ready = true;
+			}
+
+			_ready.notify_all();
+		}
+	}
+
+public:
+	ImagePrefetcher(const std::vector<Item> &items, int width, int height, int capacity, int numThreads)
+		: _items(items), _width(width), _height(height), _slots(std::max(1, capacity)), _next(0), _consumed(0), _stop(false)
+	{
+		for (int t = 0; t < std::max(1, numThreads); t++)
+			_workers.push_back(std::thread(&ImagePrefetcher::work, this));
+	}
+
+	~ImagePrefetcher() {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+
+			_stop = true;
+		}
+
+		_claimable.notify_all();
+
+		for (int t = 0; t < _workers.size(); t++)
+			_workers[t].join();
+	}
+
+	// Blocks until the next item is decoded, returns false if it could not be loaded
+	bool pop(std::vector<float> &input, Item &item) {
+		bool loaded;
+
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+
+			assert(_consumed < _items.size());
+
+			Slot &slot = _slots[_consumed % _slots.size()];
+
+			_ready.wait(lock, [&slot] { return slot._ready; });
+
+			input.swap(slot._input);
+			loaded = slot._loaded;
+			item = _items[_consumed];
+
+			slot._ready = false;
+
+			_consumed++;
+		}
+
+		_claimable.notify_all();
+
+		return loaded;
+	}
+};
+
 int main() {
 	std::vector<Label> labels;
 
@@ -94,173 +299,110 @@ int main() {
 
 	sdrnet.createRandom(inputWidth, inputHeight, layerDescs, labels.size(), -0.01f, 0.01f, 0.0f, 0.05f, -0.01f, 0.01f, generator);
 
-	sf::RenderTexture resizeTexture;
-	resizeTexture.create(inputWidth, inputHeight);
-
-	sf::RectangleShape clearRect;
-	clearRect.setSize(sf::Vector2f(inputWidth, inputHeight));
-
-	clearRect.setFillColor(sf::Color::White);
+	// Threads decoding images, the training loop keeps the main thread
+	const int numThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	const int numDecodeThreads = std::max(1, numThreads - 1);
+	const int prefetchCapacity = 64;
 
 	std::uniform_int_distribution<int> distImage(0, totalImages - 1);
 
-	const float byteInv = 1.0f / 255.0f;
+	// Draws the training images of a phase up front, so they can be decoded ahead of training
+	auto drawItems = [&](int numItems) {
+		std::vector<ImagePrefetcher::Item> items(numItems);
 
-	int unsupervisedIterations = 1500;
-	int supervisedIterations = 1000;
-
-	for (int i = 0; i < unsupervisedIterations; i++) {
-		resizeTexture.draw(clearRect);
-
-		int index = distImage(generator);
+		for (int i = 0; i < numItems; i++) {
+			int index = distImage(generator);
 
-		int li = 0;
-		int mi = 0;
-		int c = 0;
+			int li = 0;
+			int mi = 0;
+			int c = 0;
 
-		for (int l = 0; l < labels.size(); l++) {
-			int pc = c;
-			c += labels[l]._members.size();
+			for (int l = 0; l < labels.size(); l++) {
+				int pc = c;
+				c += labels[l]._members.size();
 
-			if (c > index) {
-				li = l;
-				mi = index - pc;
-				break;
+				if (c > index) {
+					li = l;
+					mi = index - pc;
+					break;
+				}
 			}
-		}
 
-		sf::Texture source;
-		if (!source.loadFromFile("Resources/train/" + labels[li]._name + "/" + labels[li]._members[mi])) {
-			std::cerr << "Could not load \"" << ("Resources/train/" + labels[li]._name + "/" + labels[li]._members[mi]) << "\"!" << std::endl;
-
-			continue;
+			items[i]._fileName = "Resources/train/" + labels[li]._name + "/" + labels[li]._members[mi];
+			items[i]._label = li;
+			items[i]._member = mi;
 		}
 
-		source.setSmooth(true);
-
-		sf::Sprite sprite;
-		sprite.setTexture(source);
-
-		sprite.setOrigin(source.getSize().x * 0.5f, source.getSize().y * 0.5f);
-
-		sprite.setPosition(inputWidth / 2.0f, inputHeight / 2.0f);
+		return items;
+	};
 
-		float scale = std::min(static_cast<float>(inputWidth) / source.getSize().x, static_cast<float>(inputHeight) / source.getSize().y);
+	int unsupervisedIterations = 1500;
+	int supervisedIterations = 1000;
 
-		sprite.setScale(scale, scale);
+	std::vector<float> input;
+	std::vector<float> output;
 
-		resizeTexture.draw(sprite);
+	{
+		ImagePrefetcher prefetcher(drawItems(unsupervisedIterations), inputWidth, inputHeight, prefetchCapacity, numDecodeThreads);
 
-		resizeTexture.display();
+		for (int i = 0; i < unsupervisedIterations; i++) {
+			ImagePrefetcher::Item item;
 
-		sf::Image resizedImage = resizeTexture.getTexture().copyToImage();
+			if (!prefetcher.pop(input, item)) {
+				std::cerr << "Could not load \"" << item._fileName << "\"!" << std::endl;
 
-		std::vector<float> input(resizedImage.getSize().x * resizedImage.getSize().y);
+				continue;
+			}
 
-		for (int x = 0; x < inputWidth; x++)
-		for (int y = 0; y < inputHeight; y++) {
-			sf::Color color = resizedImage.getPixel(x, y);
+			sdrnet.getOutput(input, output, generator);
 
-			float greyscale = color.r * byteInv * 0.299f + color.g * byteInv * 0.587f + color.b * byteInv * 0.114f;
+			sdrnet.updateUnsupervised(input, 0.001f, 0.01f, 0.005f);
 
-			input[x + y * inputWidth] = greyscale;
+			if (i % 25 == 0)
+				std::cout << i / static_cast<float>(unsupervisedIterations) * 100.0f << "%" << std::endl;
 		}
-
-		std::vector<float> output;
-
-		sdrnet.getOutput(input, output, generator);
-
-		sdrnet.updateUnsupervised(input, 0.001f, 0.01f, 0.005f);
-
-		if (i % 25 == 0)
-			std::cout << i / static_cast<float>(unsupervisedIterations) * 100.0f << "%" << std::endl;
 	}
 
-	sf::Image rfImage;
-
-	sdrnet.getReceptiveFields(0, rfImage);
+	std::vector<float> rfs;
+	int rfsWidth, rfsHeight;
 
-	rfImage.saveToFile("rfsnet.png");
+	sdrnet.getReceptiveFields(0, rfs, rfsWidth, rfsHeight);
 
-	for (int i = 0; i < supervisedIterations; i++) {
-		resizeTexture.draw(clearRect);
+	toImage(rfs, rfsWidth, rfsHeight).saveToFile("rfsnet.png");
 
-		int index = distImage(generator);
+	{
+		ImagePrefetcher prefetcher(drawItems(supervisedIterations), inputWidth, inputHeight, prefetchCapacity, numDecodeThreads);
 
-		int li = 0;
-		int mi = 0;
-		int c = 0;
+		for (int i = 0; i < supervisedIterations; i++) {
+			ImagePrefetcher::Item item;
 
-		for (int l = 0; l < labels.size(); l++) {
-			int pc = c;
-			c += labels[l]._members.size();
+			if (!prefetcher.pop(input, item)) {
+				std::cerr << "Could not load \"" << item._fileName << "\"!" << std::endl;
 
-			if (c > index) {
-				li = l;
-				mi = index - pc;
-				break;
+				continue;
 			}
-		}
-
-		sf::Texture source;
-		if (!source.loadFromFile("Resources/train/" + labels[li]._name + "/" + labels[li]._members[mi])) {
-			std::cerr << "Could not load \"" << ("Resources/train/" + labels[li]._name + "/" + labels[li]._members[mi]) << "\"!" << std::endl;
-
-			continue;
-		}
 
-		source.setSmooth(true);
-
-		sf::Sprite sprite;
-		sprite.setTexture(source);
-
-		sprite.setOrigin(source.getSize().x * 0.5f, source.getSize().y * 0.5f);
-
-		sprite.setPosition(inputWidth / 2.0f, inputHeight / 2.0f);
-
-		float scale = std::min(static_cast<float>(inputWidth) / source.getSize().x, static_cast<float>(inputHeight) / source.getSize().y);
-
-		sprite.setScale(scale, scale);
-
-		resizeTexture.draw(sprite);
-
-		resizeTexture.display();
-
-		sf::Image resizedImage = resizeTexture.getTexture().copyToImage();
-
-		std::vector<float> input(resizedImage.getSize().x * resizedImage.getSize().y);
+			sdrnet.getOutput(input, output, generator);
 
-		for (int x = 0; x < inputWidth; x++)
-		for (int y = 0; y < inputHeight; y++) {
-			sf::Color color = resizedImage.getPixel(x, y);
+			int givenLabel = 0;
 
-			float greyscale = color.r * byteInv * 0.299f + color.g * byteInv * 0.587f + color.b * byteInv * 0.114f;
+			for (int l = 1; l < output.size(); l++)	 {
+				if (output[l] > output[givenLabel])
+					givenLabel = l;
+			}
 
-			input[x + y * inputWidth] = greyscale;
-		}
+			std::vector<float> target(output.size(), 0.0f);
 
-		std::vector<float> output;
+			target[item._label] = 1.0f;
 
-		sdrnet.getOutput(input, output, generator);
+			if (item._label == givenLabel)
+				std::cout << "g";
 
-		int givenLabel = 0;
+			sdrnet.updateSupervised(input, output, target, 0.005f, 0.001f, 0.3f);
 
-		for (int l = 1; l < output.size(); l++)	 {
-			if (output[l] > output[givenLabel])
-				givenLabel = l;
+			if (i % 25 == 0)
+				std::cout << i / static_cast<float>(supervisedIterations) * 100.0f << "%" << std::endl;
 		}
-
-		std::vector<float> target(output.size(), 0.0f);
-
-		target[li] = 1.0f;
-
-		if (li == givenLabel)
-			std::cout << "g";
-
-		sdrnet.updateSupervised(input, output, target, 0.005f, 0.001f, 0.3f);
-
-		if (i % 25 == 0)
-			std::cout << i / static_cast<float>(supervisedIterations) * 100.0f << "%" << std::endl;
 	}
 
 	std::ofstream toFile("result.csv");
@@ -280,68 +422,68 @@ int main() {
 
 	dirent *testEnt;
 
+	std::vector<std::string> testNames;
+
 	if ((testDir = opendir("Resources/test/test")) != nullptr) {
 		readdir(testDir);
 		readdir(testDir);
 
-		while ((testEnt = readdir(testDir)) != nullptr) {
-			std::string fullName = "Resources/test/test/" + std::string(testEnt->d_name);
-
-			sf::Texture source;
-			if (!source.loadFromFile(fullName)) {
-				std::cerr << "Could not load \"" << fullName << "\"!" << std::endl;
+		while ((testEnt = readdir(testDir)) != nullptr)
+			testNames.push_back(testEnt->d_name);
 
-				continue;
-			}
-
-			std::cout << "Eval: " << std::string(testEnt->d_name) << std::endl;
-
-			toFile << std::string(testEnt->d_name) + ",";
+		closedir(testDir);
+	}
 
-			source.setSmooth(true);
+	// Inference only, so every thread decodes and evaluates its share of the test set with its own copy of the network
+	std::vector<std::vector<float>> testOutputs(testNames.size());
+	std::vector<char> testLoaded(testNames.size(), 0);
 
-			sf::Sprite sprite;
-			sprite.setTexture(source);
+	std::vector<std::thread> testWorkers;
 
-			sprite.setOrigin(source.getSize().x * 0.5f, source.getSize().y * 0.5f);
+	std::vector<unsigned long> testSeeds(numThreads);
 
-			sprite.setPosition(inputWidth / 2.0f, inputHeight / 2.0f);
+	for (int t = 0; t < numThreads; t++)
+		testSeeds[t] = generator();
 
-			float scale = std::min(static_cast<float>(inputWidth) / source.getSize().x, static_cast<float>(inputHeight) / source.getSize().y);
+	for (int t = 0; t < numThreads; t++)
+		testWorkers.push_back(std::thread([&, t] {
+			sdr::SDRNetwork workerNet = sdrnet;
 
-			sprite.setScale(scale, scale);
+			std::mt19937 workerGenerator(testSeeds[t]);
 
-			resizeTexture.draw(sprite);
+			std::vector<float> workerInput;
 
-			resizeTexture.display();
+			for (int i = t; i < testNames.size(); i += numThreads) {
+				if (!loadInput("Resources/test/test/" + testNames[i], inputWidth, inputHeight, workerInput))
+					continue;
 
-			sf::Image resizedImage = resizeTexture.getTexture().copyToImage();
+				workerNet.getOutput(workerInput, testOutputs[i], workerGenerator);
 
-			std::vector<float> input(resizedImage.getSize().x * resizedImage.getSize().y);
+				testLoaded[i] = 1;
+			}
+		}));
 
-			for (int x = 0; x < inputWidth; x++)
-			for (int y = 0; y < inputHeight; y++) {
-				sf::Color color = resizedImage.getPixel(x, y);
+	for (int t = 0; t < numThreads; t++)
+		testWorkers[t].join();
 
-				float greyscale = color.r * byteInv * 0.299f + color.g * byteInv * 0.587f + color.b * byteInv * 0.114f;
+	for (int i = 0; i < testNames.size(); i++) {
+		if (!testLoaded[i]) {
+			std::cerr << "Could not load \"" << "Resources/test/test/" + testNames[i] << "\"!" << std::endl;
 
-				input[x + y * inputWidth] = greyscale;
-			}
+			continue;
+		}
 
-			std::vector<float> output;
+		std::cout << "Eval: " << testNames[i] << std::endl;
 
-			sdrnet.getOutput(input, output, generator);
+		toFile << testNames[i] + ",";
 
-			for (int i = 0; i < output.size(); i++)
-			if (i == output.size() - 1)
-				toFile << output[i];
-			else
-				toFile << output[i] << ",";
+		for (int j = 0; j < testOutputs[i].size(); j++)
+		if (j == testOutputs[i].size() - 1)
+			toFile << testOutputs[i][j];
+		else
+			toFile << testOutputs[i][j] << ",";
 
-			toFile << std::endl;
-		}
-
-		closedir(testDir);
+		toFile << std::endl;
 	}
 
 	toFile.close();
@@ -399,8 +541,6 @@ int main() {
 			quit = true;
 
 		if (first || (!testKeyPressedLastFrame && sf::Keyboard::isKeyPressed(sf::Keyboard::T))) {
-			resizeTexture.draw(clearRect);
-
 			int index = distImage(generator);
 
 			int li = 0;
@@ -418,46 +558,13 @@ int main() {
 				}
 			}
 
-			sf::Texture source;
-			if (!source.loadFromFile("Resources/train/" + labels[li]._name + "/" + labels[li]._members[mi])) {
+			if (!loadInput("Resources/train/" + labels[li]._name + "/" + labels[li]._members[mi], inputWidth, inputHeight, input)) {
 				std::cerr << "Could not load \"" << ("Resources/train/" + labels[li]._name + "/" + labels[li]._members[mi]) << "\"!" << std::endl;
 
 				continue;
 			}
 
-			source.setSmooth(true);
-
-			sf::Sprite sprite;
-			sprite.setTexture(source);
-
-			sprite.setOrigin(source.getSize().x * 0.5f, source.getSize().y * 0.5f);
-
-			sprite.setPosition(inputWidth / 2.0f, inputHeight / 2.0f);
-
-			float scale = std::min(static_cast<float>(inputWidth) / source.getSize().x, static_cast<float>(inputHeight) / source.getSize().y);
-
-			sprite.setScale(scale, scale);
-
-			resizeTexture.draw(sprite);
-
-			resizeTexture.display();
-
-			sf::Image resizedImage = resizeTexture.getTexture().copyToImage();
-
-			currentImage = resizedImage;
-
-			std::vector<float> input(resizedImage.getSize().x * resizedImage.getSize().y);
-
-			for (int x = 0; x < inputWidth; x++)
-			for (int y = 0; y < inputHeight; y++) {
-				sf::Color color = resizedImage.getPixel(x, y);
-
-				float greyscale = color.r * byteInv * 0.299f + color.g * byteInv * 0.587f + color.b * byteInv * 0.114f;
-
-				input[x + y * inputWidth] = greyscale;
-			}
-
-			std::vector<float> output;
+			currentImage = toImage(input, inputWidth, inputHeight);
 
 			sdrnet.getOutput(input, output, generator);
 
@@ -480,7 +587,14 @@ int main() {
 			currentMi = mi;
 			currentGiven = givenLabel;
 
-			sdrnet.getImages(rbfImages);
+			std::vector<std::vector<float>> layerImages;
+
+			sdrnet.getImages(layerImages);
+
+			rbfImages.resize(layerImages.size());
+
+			for (int l = 0; l < layerImages.size(); l++)
+				rbfImages[l] = toImage(layerImages[l], sdrnet.getLayerDesc(l)._width, sdrnet.getLayerDesc(l)._height);
 		}
 
 		first = false;
@@ -553,4 +667,4 @@ int main() {
 
 		dt = clock.getElapsedTime().asSeconds();
 	} while (!quit);
-}*/
\ No newline at end of file
+}
\ No newline at end of file
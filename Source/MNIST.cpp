@@ -0,0 +1,237 @@
+/*
+AI Lib
+Copyright (C) 4014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <rbf/SDRNetwork.h>
+
+#include <time.h>
+#include <assert.h>
+#include <iostream>
+#include <random>
+#include <fstream>
+#include <string>
+
+struct Image {
+	std::vector<unsigned char> _image;
+};
+
+int reverseInt(int i) {
+	unsigned char c1, c2, c3, c4;
+
+	c1 = i & 255;
+	c2 = (i >> 8) & 255;
+	c3 = (i >> 16) & 255;
+	c4 = (i >> 24) & 255;
+
+	return ((int)c1 << 24) + ((int)c2 << 16) + ((int)c3 << 8) + c4;
+}
+
+void getMNISTImages(std::vector<Image> &images, const std::string &filename, int numUse) {
+	std::ifstream file(filename, std::ios::binary);
+
+	if (file.is_open()) {
+		int magicNumber = 0;
+		int nImages = 0;
+		int nRows = 0;
+		int nCols = 0;
+
+		file.read((char*)&magicNumber, sizeof(int));
+		magicNumber = reverseInt(magicNumber);
+		file.read((char*)&nImages, sizeof(int));
+		nImages = reverseInt(nImages);
+		file.read((char*)&nRows, sizeof(int));
+		nRows = reverseInt(nRows);
+		file.read((char*)&nCols, sizeof(int));
+		nCols = reverseInt(nCols);
+
+		assert(numUse <= nImages);
+
+		images.resize(numUse);
+
+		for (int i = 0; i < numUse; i++) {
+			assert(file.good());
+
+			images[i]._image.resize(nRows * nCols);
+
+			file.read((char*)&(images[i]._image[0]), sizeof(unsigned char) * images[i]._image.size());
+		}
+	}
+
+	file.close();
+}
+
+void getMNISTLabels(std::vector<unsigned char> &labels, const std::string &filename, int numUse) {
+	std::ifstream file(filename, std::ios::binary);
+
+	if (file.is_open()) {
+		int magicNumber = 0;
+		int nLabels = 0;
+		int nRows = 0;
+		int nCols = 0;
+
+		file.read((char*)&magicNumber, sizeof(magicNumber));
+		magicNumber = reverseInt(magicNumber);
+		file.read((char*)&nLabels, sizeof(nLabels));
+		nLabels = reverseInt(nLabels);
+
+		assert(numUse <= nLabels);
+
+		labels.resize(numUse);
+
+		for (int i = 0; i < numUse; i++) {
+			unsigned char temp = 0;
+			file.read((char*)&temp, sizeof(unsigned char));
+
+			labels[i] = temp;
+		}
+	}
+
+	file.close();
+}
+
+int main() {
+	std::vector<Image> trainingImages;
+	std::vector<unsigned char> trainingLabels;
+
+	getMNISTImages(trainingImages, "MNIST/train-images.idx3-ubyte", 60000);
+	getMNISTLabels(trainingLabels, "MNIST/train-labels.idx1-ubyte", 60000);
+
+	std::vector<Image> testImages;
+	std::vector<unsigned char> testLabels;
+
+	getMNISTImages(testImages, "MNIST/t10k-images.idx3-ubyte", 10000);
+	getMNISTLabels(testLabels, "MNIST/t10k-labels.idx1-ubyte", 10000);
+
+	// Get list of odd and even examples
+	std::vector<int> oddIndices;
+	std::vector<int> evenIndices;
+
+	for (int i = 0; i < trainingLabels.size(); i++) {
+		if (trainingLabels[i] % 2 == 0)
+			evenIndices.push_back(i);
+		else
+			oddIndices.push_back(i);
+	}
+
+	sdr::SDRNetwork sdrnet;
+
+	std::mt19937 generator(time(nullptr));
+
+	std::vector<sdr::SDRNetwork::LayerDesc> layerDescs(3);
+
+	layerDescs[0]._width = 56;
+	layerDescs[0]._height = 56;
+	layerDescs[0]._receptiveRadius = 4;
+	layerDescs[0]._inhibitionRadius = 3;
+
+	layerDescs[1]._width = 40;
+	layerDescs[1]._height = 40;
+	layerDescs[1]._receptiveRadius = 4;
+	layerDescs[1]._inhibitionRadius = 3;
+
+	layerDescs[2]._width = 24;
+	layerDescs[2]._height = 24;
+	layerDescs[2]._receptiveRadius = 4;
+	layerDescs[2]._inhibitionRadius = 3;
+
+	sdrnet.createRandom(28, 28, layerDescs, 10, -0.01f, 0.01f, 0.0f, 0.05f, -0.01f, 0.01f, generator);
+
+	std::vector<float> inputf(28 * 28);
+	std::vector<float> outputf(10);
+
+	std::uniform_int_distribution<int> selectionDist(0, trainingImages.size() - 1);
+	std::uniform_int_distribution<int> selectionDistEven(0, evenIndices.size() - 1);
+	std::uniform_int_distribution<int> selectionDistOdd(0, oddIndices.size() - 1);
+
+	int totalIterUnsupervised = 1000;
+	int totalIterSupervised = 1000;
+
+	for (int i = 0; i < totalIterUnsupervised; i++) {
+		int trainIndex = selectionDist(generator);
+
+		for (int j = 0; j < trainingImages[trainIndex]._image.size(); j++)
+			inputf[j] = trainingImages[trainIndex]._image[j] / 255.0f;
+
+		sdrnet.getOutput(inputf, outputf, generator);
+
+		sdrnet.updateUnsupervised(inputf, 0.001f, 0.01f, 0.005f);
+
+		if (i % 100 == 0)
+			std::cout << "Iter Unsupervised: " << i << " / " << totalIterUnsupervised << std::endl;
+	}
+
+	for (int i = 0; i < totalIterSupervised; i++) {
+		int trainIndex = selectionDist(generator);
+
+		for (int j = 0; j < trainingImages[trainIndex]._image.size(); j++)
+			inputf[j] = trainingImages[trainIndex]._image[j] / 255.0f;
+
+		sdrnet.getOutput(inputf, outputf, generator);
+
+		std::vector<float> target(10, 0.0f);
+
+		target[trainingLabels[trainIndex]] = 1.0f;
+
+		sdrnet.updateSupervised(inputf, outputf, target, 0.005f, 0.001f, 0.3f);
+
+		if (i % 100 == 0)
+			std::cout << "Supervised Iter: " << i << " / " << totalIterSupervised << std::endl;
+	}
+
+	int wrongs = 0;
+	int oddWrongs = 0;
+	int totalOdds = 0;
+
+	std::uniform_int_distribution<int> testDist(0, testImages.size() - 1);
+
+	int totalIterTest = 500;
+
+	for (int i = 0; i < totalIterTest; i++) {
+		int trainIndex = i;
+
+		for (int j = 0; j < testImages[trainIndex]._image.size(); j++)
+			inputf[j] = testImages[trainIndex]._image[j] / 255.0f;
+
+		sdrnet.getOutput(inputf, outputf, generator);
+
+		int maxIndex = 0;
+
+		for (int j = 0; j < outputf.size(); j++)
+		if (outputf[j] > outputf[maxIndex])
+			maxIndex = j;
+
+		if (maxIndex != testLabels[trainIndex])
+			wrongs++;
+
+		if (testLabels[trainIndex] % 2 == 1) {
+			totalOdds++;
+
+			if (maxIndex != testLabels[trainIndex])
+				oddWrongs++;
+		}
+
+		std::cout << "Result: " << maxIndex << " Actual: " << static_cast<int>(testLabels[trainIndex]) << std::endl;
+	}
+
+	std::cout << "Total Error: " << (static_cast<float>(wrongs) / static_cast<float>(totalIterTest)) * 100.0f << std::endl;
+	std::cout << "Odd Error: " << (static_cast<float>(oddWrongs) / static_cast<float>(totalOdds)) * 100.0f << std::endl;
+
+	return 0;
+}
@@ -233,9 +233,11 @@ misrepresented as being the original software.
 
 	window.setVerticalSyncEnabled(true);
 
-	hn::SampleField sampleField;
+	hn::SampleField<> sampleField;
 	sampleField.create(2, 3);
-	sampleField._kernel = std::bind(hn::kernelSquaredExponential, std::placeholders::_1, std::placeholders::_2, 128.0f);
+	sampleField._kernel = hn::KernelSquaredExponential(128.0f);
+
+	std::vector<hn::SampleField<>::Neighbour> neighbours;
 
 	std::mt19937 generator(time(nullptr));
 
@@ -243,7 +245,7 @@ misrepresented as being the original software.
 
 	// Add some samples
 	for (size_t i = 0; i < 100; i++) {
-		hn::SampleField::Sample s;
+		hn::SampleField<>::Sample s;
 
 		s._x.resize(2);
 		s._x[0] = dist01(generator);
@@ -266,7 +268,8 @@ misrepresented as being the original software.
 		sx[0] = static_cast<float>(x) / static_cast<float>(image.getSize().x);
 		sx[1] = static_cast<float>(y) / static_cast<float>(image.getSize().y);
 
-		std::vector<float> sy = sampleField.getYAtX(sx);
+		std::vector<float> sy(3);
+		sampleField.getYAtX(sx.data(), sy.data(), neighbours);
 
 		sf::Color c;
 
@@ -775,6 +778,55 @@ float evaluateXOR(ctrnn::CTRNN &net, std::mt19937 &generator) {
 	return totalReward;
 }
 
+// Same as evaluateAND/OR/XOR for a whole population at once, adds rewardScale times the total reward to fitnesses
+void evaluateLogicGateBatch(ctrnn::CTRNNPopulation &population, const float (&outputs)[4], float rewardScale, std::vector<std::mt19937> &generators, std::vector<float> &fitnesses) {
+	float inputs[4][2] {
+		{ -1.0f, -1.0f },
+		{ -1.0f, 1.0f },
+		{ 1.0f, -1.0f },
+		{ 1.0f, 1.0f }
+	};
+
+	size_t populationSize = population.getPopulationSize();
+
+	std::vector<float> reward(populationSize, 0.0f);
+	std::vector<float> prevReward(populationSize, 0.0f);
+	std::vector<float> newReward(populationSize);
+	std::vector<float> stepReward(populationSize);
+
+	for (size_t m = 0; m < populationSize; m++)
+		stepReward[m] = (reward[m] - prevReward[m]) * 0.1f;
+
+	for (size_t i = 0; i < 100; i++) {
+		std::fill(newReward.begin(), newReward.end(), 1.0f);
+
+		for (size_t j = 0; j < 4; j++) {
+			population.setInput(0, inputs[j][0]);
+			population.setInput(1, inputs[j][1]);
+			population.setInput(2, inputs[j][0]);
+			population.setInput(3, inputs[j][1]);
+
+			for (size_t m = 0; m < populationSize; m++)
+				population.setInput(m, 4, stepReward[m]);
+
+			for (size_t s = 0; s < 18; s++)
+				population.step(1.0f, stepReward, 0.1f, generators);
+
+			for (size_t m = 0; m < populationSize; m++)
+				newReward[m] -= std::pow(std::abs(outputs[j] - population.getOutput(m, 0)), 1.0f) * 0.25f;
+		}
+
+		for (size_t m = 0; m < populationSize; m++) {
+			prevReward[m] = reward[m];
+			reward[m] = newReward[m];
+
+			stepReward[m] = (reward[m] - prevReward[m]) * 0.1f;
+
+			fitnesses[m] += reward[m] * rewardScale;
+		}
+	}
+}
+
 /*int main() {
 	std::mt19937 generator(time(nullptr));
 
@@ -782,20 +834,29 @@ float evaluateXOR(ctrnn::CTRNN &net, std::mt19937 &generator) {
 
 	ga.create(40, 5, 1, 14, -0.5f, 0.5f, 1.01f, 2.0f, 0.05f, 1.0f, generator);
 
+	ga.setNumThreads(8);
+
 	for (size_t g = 0; g < 550; g++) {
 		float maxFitness = -99999.0f;
 
-		for (size_t i = 0; i < ga.getPopulationSize(); i++) {
-			//ctrnn::CTRNN memberPoleBalancing = ga.getPopulationMember(i);
-			ctrnn::CTRNN memberAND = ga.getPopulationMember(i);
-			ctrnn::CTRNN memberOR = ga.getPopulationMember(i);
-			ctrnn::CTRNN memberXOR = ga.getPopulationMember(i);
+		ga.evaluateBatch([](ctrnn::CTRNNPopulation &population, std::vector<std::mt19937> &generators, std::vector<float> &fitnesses) {
+			const float outputsAND[4] { 0.0f, 0.0f, 0.0f, 1.0f };
+			const float outputsOR[4] { 0.0f, 1.0f, 1.0f, 1.0f };
+			const float outputsXOR[4] { 0.0f, 1.0f, 1.0f, 0.0f };
 
-			ga.setFitness(i, evaluateAND(memberAND, generator) + evaluateOR(memberOR, generator) + evaluateXOR(memberXOR, generator));
+			ctrnn::CTRNNPopulation populationAND = population;
+			ctrnn::CTRNNPopulation populationOR = population;
 
-			if (ga.getFitness(i) > maxFitness)
-				maxFitness = ga.getFitness(i);
-		}
+			std::fill(fitnesses.begin(), fitnesses.end(), 0.0f);
+
+			evaluateLogicGateBatch(populationAND, outputsAND, 0.1f, generators, fitnesses);
+			evaluateLogicGateBatch(populationOR, outputsOR, 0.5f, generators, fitnesses);
+			evaluateLogicGateBatch(population, outputsXOR, 0.5f, generators, fitnesses);
+		}, generator);
+
+		for (size_t i = 0; i < ga.getPopulationSize(); i++)
+		if (ga.getFitness(i) > maxFitness)
+			maxFitness = ga.getFitness(i);
 
 		ga.generation(0.3f, 0.05f, 0.2f, 0.3f, 0.05f, 0.2f, 0.3f, 0.05f, 0.2f, 3.0f, 4, generator);
 
@@ -3460,338 +3521,6 @@ int main() {
 	return 0;
 }*/
 
-/*int main() {
-	std::mt19937 generator(time(nullptr));
-
-	float reward = 0.0f;
-	float prevReward = 0.0f;
-
-	float initReward = 0.0f;
-
-	float totalReward = 0.0f;
-
-	sf::RenderWindow window;
-
-	window.create(sf::VideoMode(1600, 600), "Pole Balancing");
-
-	window.setVerticalSyncEnabled(true);
-
-	//window.setFramerateLimit(60);
-
-	// -------------------------- Load Resources --------------------------
-
-	sf::Texture backgroundTexture;
-	sf::Texture cartTexture;
-	sf::Texture poleTexture;
-
-	backgroundTexture.loadFromFile("Resources/background.png");
-	cartTexture.loadFromFile("Resources/cart.png");
-	poleTexture.loadFromFile("Resources/pole.png");
-
-	sf::Texture inputCartTexture;
-	sf::Texture inputPoleTexture;
-
-	inputCartTexture.loadFromFile("Resources/inputCart.png");
-	inputPoleTexture.loadFromFile("Resources/inputPole.png");
-
-	// --------------------------------------------------------------------
-
-	sf::Sprite backgroundSprite;
-	sf::Sprite cartSprite;
-	sf::Sprite poleSprite;
-
-	backgroundSprite.setTexture(backgroundTexture);
-	cartSprite.setTexture(cartTexture);
-	poleSprite.setTexture(poleTexture);
-
-	backgroundSprite.setPosition(sf::Vector2f(0.0f, 0.0f));
-
-	cartSprite.setOrigin(sf::Vector2f(static_cast<float>(cartSprite.getTexture()->getSize().x) * 0.5f, static_cast<float>(cartSprite.getTexture()->getSize().y)));
-	poleSprite.setOrigin(sf::Vector2f(static_cast<float>(poleSprite.getTexture()->getSize().x) * 0.5f, static_cast<float>(poleSprite.getTexture()->getSize().y)));
-
-	sf::Sprite inputCartSprite;
-	sf::Sprite inputPoleSprite;
-
-	inputCartSprite.setTexture(inputCartTexture);
-	inputPoleSprite.setTexture(inputPoleTexture);
-
-	inputCartSprite.setOrigin(sf::Vector2f(static_cast<float>(inputCartSprite.getTexture()->getSize().x) * 0.5f, static_cast<float>(inputCartSprite.getTexture()->getSize().y)));
-	inputPoleSprite.setOrigin(sf::Vector2f(static_cast<float>(inputPoleSprite.getTexture()->getSize().x) * 0.5f, static_cast<float>(inputPoleSprite.getTexture()->getSize().y)));
-
-
-	// ----------------------------- Physics ------------------------------
-
-	float pixelsPerMeter = 128.0f;
-	float inputPixelsPerMeter = 8.0f;
-	float poleLength = 1.0f;
-	float g = -2.8f;
-	float massMass = 40.0f;
-	float cartMass = 2.0f;
-	sf::Vector2f massPos(0.0f, poleLength);
-	sf::Vector2f massVel(0.0f, 0.0f);
-	float poleAngle = static_cast<float>(PI)* 0.0f;
-	float poleAngleVel = 0.0f;
-	float poleAngleAccel = 0.0f;
-	float cartX = 0.0f;
-	float cartVelX = 0.0f;
-	float cartAccelX = 0.0f;
-	float poleRotationalFriction = 0.008f;
-	float cartMoveRadius = 1.8f;
-	float cartFriction = 0.02f;
-	float maxSpeed = 3.0f;
-
-	// ---------------------------- Game Loop -----------------------------
-
-	bool quit = false;
-
-	sf::Clock clock;
-
-	float dt = 0.017f;
-
-	float fitness = 0.0f;
-	float prevFitness = 0.0f;
-
-	float lowPassFitness = 0.0f;
-
-	bool reverseDirection = false;
-
-	bool trainMode = true;
-
-	bool tDownLastFrame = false;
-
-	std::uniform_real_distribution<float> dist01(0.0f, 1.0f);
-
-	sf::Font font;
-
-	font.loadFromFile("Resources/pixelated.ttf");
-
-	sf::RenderTexture inputRT;
-
-	inputRT.create(64, 32);
-
-	sf::RenderTexture rt;
-
-	rt.create(800, 600);
-
-	float avgReward = 0.0f;
-	float avgRewardDecay = 0.003f;
-
-	float totalTime = 0.0f;
-
-	float plotUpdateTimer = 0.0f;
-
-	deep::RSARL agent;
-
-	agent.createRandom(4, 1, 64, 5.01f / 64.0f, -0.1f, 0.1f, 0.1f, generator);
-
-	std::vector<float> prevInput(6, 0.0f);
-
-	do {
-		clock.restart();
-
-		// ----------------------------- Input -----------------------------
-
-		sf::Event windowEvent;
-
-		while (window.pollEvent(windowEvent))
-		{
-			switch (windowEvent.type)
-			{
-			case sf::Event::Closed:
-				quit = true;
-				break;
-			}
-		}
-
-		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Escape))
-			quit = true;
-
-		// Update fitness
-		if (poleAngle < static_cast<float>(PI))
-			fitness = -(static_cast<float>(PI)* 0.5f - poleAngle);
-		else
-			fitness = -(static_cast<float>(PI)* 0.5f - (static_cast<float>(PI)* 2.0f - poleAngle));
-
-		fitness += static_cast<float>(PI)* 0.5f;
-
-		//fitness = fitness - std::abs(poleAngleVel * 1.0f);
-
-		//fitness = -std::abs(cartX);
-
-		if (sf::Keyboard::isKeyPressed(sf::Keyboard::A))
-			fitness = -cartX;
-		else if (sf::Keyboard::isKeyPressed(sf::Keyboard::D))
-			fitness = cartX;
-
-		// ------------------------------ AI -------------------------------
-
-		float dFitness = fitness - prevFitness;
-
-		//reward = dFitness * 5.0f;
-
-		reward = fitness * 0.5f;
-
-		if (totalTime == 0.0f)
-			avgReward = reward;
-		else
-			avgReward = (1.0f - avgRewardDecay) * avgReward + avgRewardDecay * reward;
-
-		sf::Image img = inputRT.getTexture().copyToImage();
-
-		agent.setInput(0, cartX * 0.25f);
-		agent.setInput(1, cartVelX * 0.1f);
-		agent.setInput(2, std::fmod(poleAngle + static_cast<float>(PI), 2.0f * static_cast<float>(PI)) * 0.1f);
-		agent.setInput(3, poleAngleVel * 0.1f);
-
-		agent.step(reward, 10, 20, 0.0f, 0.01f, 0.005f, 0.0f, 0.3f, 0.01f, 0.5f, 1.0f, 1.0f, 1.0f, 0.1f, 0.7f, 0.992f, 0.1f, generator);
-
-		float dir = agent.getOutput(0);
-
-		float agentForce = 4000.0f * dir;
-
-		prevFitness = fitness;
-
-		// ---------------------------- Physics ----------------------------
-
-		float pendulumCartAccelX = cartAccelX;
-
-		if (cartX < -cartMoveRadius)
-			pendulumCartAccelX = 0.0f;
-		else if (cartX > cartMoveRadius)
-			pendulumCartAccelX = 0.0f;
-
-		poleAngleAccel = pendulumCartAccelX * std::cos(poleAngle) + g * std::sin(poleAngle);
-		poleAngleVel += -poleRotationalFriction * poleAngleVel + poleAngleAccel * dt;
-		poleAngle += poleAngleVel * dt;
-
-		massPos = sf::Vector2f(cartX + std::cos(poleAngle + static_cast<float>(PI)* 0.5f) * poleLength, std::sin(poleAngle + static_cast<float>(PI)* 0.5f) * poleLength);
-
-		float force = 0.0f;
-
-		if (std::abs(cartVelX) < maxSpeed) {
-			force = std::max(-4000.0f, std::min(4000.0f, agentForce));
-
-			if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left))
-				force = -4000.0f;
-
-			if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
-				force = 4000.0f;
-		}
-
-		if (cartX < -cartMoveRadius) {
-			cartX = -cartMoveRadius;
-
-			cartAccelX = -cartVelX / dt;
-			cartVelX = -0.5f * cartVelX;
-		}
-		else if (cartX > cartMoveRadius) {
-			cartX = cartMoveRadius;
-
-			cartAccelX = -cartVelX / dt;
-			cartVelX = -0.5f * cartVelX;
-		}
-
-		cartAccelX = 0.25f * (force + massMass * poleLength * poleAngleAccel * std::cos(poleAngle) - massMass * poleLength * poleAngleVel * poleAngleVel * std::sin(poleAngle)) / (massMass + cartMass);
-		cartVelX += -cartFriction * cartVelX + cartAccelX * dt;
-		cartX += cartVelX * dt;
-
-		poleAngle = std::fmod(poleAngle, (2.0f * static_cast<float>(PI)));
-
-		if (poleAngle < 0.0f)
-			poleAngle += static_cast<float>(PI)* 2.0f;
-
-		if (sf::Keyboard::isKeyPressed(sf::Keyboard::T)) {
-			if (!tDownLastFrame) {
-				trainMode = !trainMode;
-			}
-
-			tDownLastFrame = true;
-		}
-		else
-			tDownLastFrame = false;
-
-		// ---------------------------- Rendering ----------------------------
-
-		// Render to input buffer
-		inputRT.clear();
-
-		inputCartSprite.setPosition(sf::Vector2f(inputRT.getSize().x * 0.5f + inputPixelsPerMeter * cartX, inputRT.getSize().y * 0.5f + 4.0f));
-
-		inputRT.draw(inputCartSprite);
-
-		inputPoleSprite.setPosition(inputCartSprite.getPosition() + sf::Vector2f(0.0f, -4.0f));
-		inputPoleSprite.setRotation(poleAngle * 180.0f / static_cast<float>(PI)+180.0f);
-
-		inputRT.draw(inputPoleSprite);
-
-		inputRT.display();
-
-		window.clear();
-
-		window.draw(backgroundSprite);
-
-		cartSprite.setPosition(sf::Vector2f(800.0f * 0.5f + pixelsPerMeter * cartX, 600.0f * 0.5f + 3.0f));
-
-		window.draw(cartSprite);
-
-		poleSprite.setPosition(cartSprite.getPosition() + sf::Vector2f(0.0f, -45.0f));
-		poleSprite.setRotation(poleAngle * 180.0f / static_cast<float>(PI)+180.0f);
-
-		window.draw(poleSprite);
-
-		// Draw hidden states
-		sf::Vector2f hiddenCenter(1200.0f, 300.0f);
-
-		float sScalar = 1.5f;
-
-		int rowSize = 8;
-
-		int rCount = 0;
-		int row = -4;
-
-		while (rCount < agent.getRSA().getNumHiddenNodes()) {
-			for (int i = 0; i < rowSize; i++) {
-				sf::CircleShape circle;
-
-				circle.setPosition(hiddenCenter + sf::Vector2f((i - rowSize / 2) * 18.0f * sScalar, row * 18.0f * sScalar));
-
-				circle.setRadius(8.0f * sScalar);
-
-				circle.setFillColor(sf::Color::White);
-
-				circle.setOrigin(8.0f * sScalar, 8.0f * sScalar);
-
-				window.draw(circle);
-
-				circle.setRadius(7.0f * sScalar);
-
-				circle.setOrigin(7.0f * sScalar, 7.0f * sScalar);
-
-				int s = (agent.getRSA().getHiddenNodeState(rCount)) * 255;
-
-				circle.setFillColor(sf::Color(s, s, s, 255));
-
-				window.draw(circle);
-
-				rCount++;
-			}
-
-			row++;
-		}
-
-		// -------------------------------------------------------------------
-
-		window.display();
-
-		//dt = clock.getElapsedTime().asSeconds();
-
-		totalTime += dt;
-		plotUpdateTimer += dt;
-	} while (!quit);
-
-	return 0;
-}*/
-
 	/*deep::FERL ferl;
 
 	ferl.createRandom(2, 2, 12, 0.1f, generator);
@@ -3933,227 +3662,6 @@ int main() {
 	std::cout << successes << " " << failures << std::endl;
 }*/
 
-/*struct Image {
-	std::vector<unsigned char> _image;
-};
-
-int reverseInt(int i) {
-	unsigned char c1, c2, c3, c4;
-
-	c1 = i & 255;
-	c2 = (i >> 8) & 255;
-	c3 = (i >> 16) & 255;
-	c4 = (i >> 24) & 255;
-
-	return ((int)c1 << 24) + ((int)c2 << 16) + ((int)c3 << 8) + c4;
-}
-
-void getMNISTImages(std::vector<Image> &images, const std::string &filename, int numUse) {
-	std::ifstream file(filename, std::ios::binary);
-
-	if (file.is_open()) {
-		int magicNumber = 0;
-		int nImages = 0;
-		int nRows = 0;
-		int nCols = 0;
-
-		file.read((char*)&magicNumber, sizeof(int));
-		magicNumber = reverseInt(magicNumber);
-		file.read((char*)&nImages, sizeof(int));
-		nImages = reverseInt(nImages);
-		file.read((char*)&nRows, sizeof(int));
-		nRows = reverseInt(nRows);
-		file.read((char*)&nCols, sizeof(int));
-		nCols = reverseInt(nCols);
-
-		assert(numUse <= nImages);
-
-		images.resize(numUse);
-
-		for (int i = 0; i < numUse; i++) {
-			assert(file.good());
-
-			images[i]._image.resize(nRows * nCols);
-
-			file.read((char*)&(images[i]._image[0]), sizeof(unsigned char) * images[i]._image.size());
-		}
-	}
-
-	file.close();
-}
-
-void getMNISTLabels(std::vector<unsigned char> &labels, const std::string &filename, int numUse) {
-	std::ifstream file(filename, std::ios::binary);
-
-	if (file.is_open()) {
-		int magicNumber = 0;
-		int nLabels = 0;
-		int nRows = 0;
-		int nCols = 0;
-
-		file.read((char*)&magicNumber, sizeof(magicNumber));
-		magicNumber = reverseInt(magicNumber);
-		file.read((char*)&nLabels, sizeof(nLabels));
-		nLabels = reverseInt(nLabels);
-
-		assert(numUse <= nLabels);
-
-		labels.resize(numUse);
-
-		for (int i = 0; i < numUse; i++) {
-			unsigned char temp = 0;
-			file.read((char*)&temp, sizeof(unsigned char));
-
-			labels[i] = temp;
-		}
-	}
-
-	file.close();
-}
-
-int main() {
-	std::vector<Image> trainingImages;
-	std::vector<unsigned char> trainingLabels;
-
-	getMNISTImages(trainingImages, "MNIST/train-images.idx3-ubyte", 60000);
-	getMNISTLabels(trainingLabels, "MNIST/train-labels.idx1-ubyte", 60000);
-
-	std::vector<Image> testImages;
-	std::vector<unsigned char> testLabels;
-
-	getMNISTImages(testImages, "MNIST/t10k-images.idx3-ubyte", 10000);
-	getMNISTLabels(testLabels, "MNIST/t10k-labels.idx1-ubyte", 10000);
-
-	// Get list of odd and even examples
-	std::vector<int> oddIndices;
-	std::vector<int> evenIndices;
-
-	for (int i = 0; i < trainingLabels.size(); i++) {
-		if (trainingLabels[i] % 2 == 0)
-			evenIndices.push_back(i);
-		else
-			oddIndices.push_back(i);
-	}
-
-	rbf::SDRRBFNetwork sdrrbfnet;
-
-	std::mt19937 generator(time(nullptr));
-
-	std::vector<rbf::SDRRBFNetwork::LayerDesc> layerDescs(3);
-
-	layerDescs[0]._rbfWidth = 56;
-	layerDescs[0]._rbfHeight = 56;
-	layerDescs[0]._receptiveRadius = 4;
-	layerDescs[0]._inhibitionRadius = 3;
-	layerDescs[0]._localActivity = 4.0f;
-	layerDescs[0]._outputIntensity = 0.05f;
-	layerDescs[0]._outputMultiplier = 0.0f;
-
-	layerDescs[1]._rbfWidth = 40;
-	layerDescs[1]._rbfHeight = 40;
-	layerDescs[1]._receptiveRadius = 4;
-	layerDescs[1]._inhibitionRadius = 3;
-	layerDescs[1]._localActivity = 4.0f;
-	layerDescs[1]._outputIntensity = 0.05f;
-	layerDescs[1]._outputMultiplier = 0.5f;
-
-	layerDescs[2]._rbfWidth = 24;
-	layerDescs[2]._rbfHeight = 24;
-	layerDescs[2]._receptiveRadius = 4;
-	layerDescs[2]._inhibitionRadius = 3;
-	layerDescs[2]._localActivity = 4.0f;
-	layerDescs[2]._outputIntensity = 0.05f;
-	layerDescs[2]._outputMultiplier = 0.5f;
-
-	sdrrbfnet.createRandom(28, 28, layerDescs, 10, 0.05f, 0.95f, 0.1f, 0.3f, -0.5f, 0.5f, generator);
-
-	std::vector<float> inputf(28 * 28);
-	std::vector<float> outputf(10);
-
-	std::uniform_int_distribution<int> selectionDist(0, trainingImages.size() - 1);
-	std::uniform_int_distribution<int> selectionDistEven(0, evenIndices.size() - 1);
-	std::uniform_int_distribution<int> selectionDistOdd(0, oddIndices.size() - 1);
-
-	int totalIterUnsupervised = 1000;
-	int totalIterSupervised = 1000;
-
-	for (int i = 0; i < totalIterUnsupervised; i++) {
-		int trainIndex = selectionDist(generator);
-
-		for (int j = 0; j < trainingImages[trainIndex]._image.size(); j++)
-			inputf[j] = trainingImages[trainIndex]._image[j] / 255.0f;
-
-		sdrrbfnet.getOutput(inputf, outputf, 1.0f, 0.01f, 0.0f, 0.0f, 0.001f, 0.5f, generator);
-
-		std::vector<float> target(10, 0.0f);
-
-		target[trainingLabels[trainIndex]] = 1.0f;
-
-		sdrrbfnet.updateUnsupervised(inputf, 0.05f, 0.9f, 0.2f, 1.0f, 0.0001f, 0.01f);
-
-		if (i % 100 == 0)
-			std::cout << "Iter Unsupervised: " << i << " / " << totalIterUnsupervised << std::endl;
-	}
-
-	for (int i = 0; i < totalIterSupervised; i++) {
-		int trainIndex = selectionDist(generator);
-
-		for (int j = 0; j < trainingImages[trainIndex]._image.size(); j++)
-			inputf[j] = trainingImages[trainIndex]._image[j] / 255.0f;
-
-		sdrrbfnet.getOutput(inputf, outputf, 1.0f, 0.01f, 0.0f, 0.0f, 0.001f, 0.5f, generator);
-
-		std::vector<float> target(10, 0.0f);
-
-		target[trainingLabels[trainIndex]] = 1.0f;
-
-		sdrrbfnet.updateSupervised(inputf, outputf, target, 0.05f, 0.1f, 0.1f, 1.0f, 0.0001f, 0.01f);
-
-		if (i % 100 == 0)
-			std::cout << "Supervised Iter: " << i << " / " << totalIterSupervised << std::endl;
-	}
-
-	int wrongs = 0;
-	int oddWrongs = 0;
-	int totalOdds = 0;
-
-	std::uniform_int_distribution<int> testDist(0, testImages.size() - 1);
-
-	int totalIterTest = 500;
-
-	for (int i = 0; i < totalIterTest; i++) {
-		int trainIndex = i;
-
-		for (int j = 0; j < testImages[trainIndex]._image.size(); j++)
-			inputf[j] = testImages[trainIndex]._image[j] / 255.0f;
-
-		sdrrbfnet.getOutput(inputf, outputf, 1.0f, 0.01f, 0.0f, 0.0f, 0.001f, 0.01f, generator);
-
-		int maxIndex = 0;
-
-		for (int j = 0; j < outputf.size(); j++)
-		if (outputf[j] > outputf[maxIndex])
-			maxIndex = j;
-
-		if (maxIndex != testLabels[trainIndex])
-			wrongs++;
-
-		if (testLabels[trainIndex] % 2 == 1) {
-			totalOdds++;
-
-			if (maxIndex != testLabels[trainIndex])
-				oddWrongs++;
-		}
-
-		std::cout << "Result: " << maxIndex << " Actual: " << static_cast<int>(testLabels[trainIndex]) << std::endl;
-	}
-
-	std::cout << "Total Error: " << (static_cast<float>(wrongs) / static_cast<float>(totalIterTest)) * 100.0f << std::endl;
-	std::cout << "Odd Error: " << (static_cast<float>(oddWrongs) / static_cast<float>(totalOdds)) * 100.0f << std::endl;
-
-	return 0;
-}*/
-
 /*struct Sample {
 	float Dens_Lab;
 	float FREQ;
@@ -1,4 +1,4 @@
-/*#include <deep/FERL.h>
+#include <deep/FERL.h>
 
 #include <lstm/LSTMActorCritic.h>
 #include <htmrl/HTMRL.h>
@@ -15,7 +15,7 @@
 const int mazeWidth = 32;
 const int mazeHeight = 32;
 const int mazeSize = mazeWidth * mazeHeight;
-const float mazeSpan = std::sqrtf(mazeWidth * mazeWidth + mazeHeight * mazeHeight);
+const float mazeSpan = std::sqrt(mazeWidth * mazeWidth + mazeHeight * mazeHeight);
 
 int maze[mazeSize] = {
 	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
@@ -74,7 +74,7 @@ void observation(int botX, int botY, int endX, int endY, std::vector<float> &obs
 
 	// Normalize
 	if (obs[6] != 0.0f || obs[7] != 0.0f) {
-		float deltaDist = std::sqrtf(obs[6] * obs[6] + obs[7] * obs[7]);
+		float deltaDist = std::sqrt(obs[6] * obs[6] + obs[7] * obs[7]);
 		obs[6] /= deltaDist;
 		obs[7] /= deltaDist;
 	}
@@ -398,4 +398,4 @@ int main() {
 	} while (!quit);
 
 	return 0;
-}*/
\ No newline at end of file
+}
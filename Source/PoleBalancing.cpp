@@ -0,0 +1,363 @@
+/*
+AI Lib
+Copyright (C) 4014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <SFML/Window.hpp>
+#include <SFML/Graphics.hpp>
+
+#include <Consts.h>
+
+#include <deep/RSARL.h>
+
+#include <time.h>
+#include <iostream>
+#include <random>
+
+int main() {
+	std::mt19937 generator(time(nullptr));
+
+	float reward = 0.0f;
+	float prevReward = 0.0f;
+
+	float initReward = 0.0f;
+
+	float totalReward = 0.0f;
+
+	sf::RenderWindow window;
+
+	window.create(sf::VideoMode(1600, 600), "Pole Balancing");
+
+	window.setVerticalSyncEnabled(true);
+
+	//window.setFramerateLimit(60);
+
+	// -------------------------- Load Resources --------------------------
+
+	sf::Texture backgroundTexture;
+	sf::Texture cartTexture;
+	sf::Texture poleTexture;
+
+	backgroundTexture.loadFromFile("Resources/background.png");
+	cartTexture.loadFromFile("Resources/cart.png");
+	poleTexture.loadFromFile("Resources/pole.png");
+
+	sf::Texture inputCartTexture;
+	sf::Texture inputPoleTexture;
+
+	inputCartTexture.loadFromFile("Resources/inputCart.png");
+	inputPoleTexture.loadFromFile("Resources/inputPole.png");
+
+	// --------------------------------------------------------------------
+
+	sf::Sprite backgroundSprite;
+	sf::Sprite cartSprite;
+	sf::Sprite poleSprite;
+
+	backgroundSprite.setTexture(backgroundTexture);
+	cartSprite.setTexture(cartTexture);
+	poleSprite.setTexture(poleTexture);
+
+	backgroundSprite.setPosition(sf::Vector2f(0.0f, 0.0f));
+
+	cartSprite.setOrigin(sf::Vector2f(static_cast<float>(cartSprite.getTexture()->getSize().x) * 0.5f, static_cast<float>(cartSprite.getTexture()->getSize().y)));
+	poleSprite.setOrigin(sf::Vector2f(static_cast<float>(poleSprite.getTexture()->getSize().x) * 0.5f, static_cast<float>(poleSprite.getTexture()->getSize().y)));
+
+	sf::Sprite inputCartSprite;
+	sf::Sprite inputPoleSprite;
+
+	inputCartSprite.setTexture(inputCartTexture);
+	inputPoleSprite.setTexture(inputPoleTexture);
+
+	inputCartSprite.setOrigin(sf::Vector2f(static_cast<float>(inputCartSprite.getTexture()->getSize().x) * 0.5f, static_cast<float>(inputCartSprite.getTexture()->getSize().y)));
+	inputPoleSprite.setOrigin(sf::Vector2f(static_cast<float>(inputPoleSprite.getTexture()->getSize().x) * 0.5f, static_cast<float>(inputPoleSprite.getTexture()->getSize().y)));
+
+
+	// ----------------------------- Physics ------------------------------
+
+	float pixelsPerMeter = 128.0f;
+	float inputPixelsPerMeter = 8.0f;
+	float poleLength = 1.0f;
+	float g = -2.8f;
+	float massMass = 40.0f;
+	float cartMass = 2.0f;
+	sf::Vector2f massPos(0.0f, poleLength);
+	sf::Vector2f massVel(0.0f, 0.0f);
+	float poleAngle = static_cast<float>(PI)* 0.0f;
+	float poleAngleVel = 0.0f;
+	float poleAngleAccel = 0.0f;
+	float cartX = 0.0f;
+	float cartVelX = 0.0f;
+	float cartAccelX = 0.0f;
+	float poleRotationalFriction = 0.008f;
+	float cartMoveRadius = 1.8f;
+	float cartFriction = 0.02f;
+	float maxSpeed = 3.0f;
+
+	// ---------------------------- Game Loop -----------------------------
+
+	bool quit = false;
+
+	sf::Clock clock;
+
+	float dt = 0.017f;
+
+	float fitness = 0.0f;
+	float prevFitness = 0.0f;
+
+	float lowPassFitness = 0.0f;
+
+	bool reverseDirection = false;
+
+	bool trainMode = true;
+
+	bool tDownLastFrame = false;
+
+	std::uniform_real_distribution<float> dist01(0.0f, 1.0f);
+
+	sf::Font font;
+
+	font.loadFromFile("Resources/pixelated.ttf");
+
+	sf::RenderTexture inputRT;
+
+	inputRT.create(64, 32);
+
+	sf::RenderTexture rt;
+
+	rt.create(800, 600);
+
+	float avgReward = 0.0f;
+	float avgRewardDecay = 0.003f;
+
+	float totalTime = 0.0f;
+
+	float plotUpdateTimer = 0.0f;
+
+	deep::RSARL agent;
+
+	agent.createRandom(4, 1, 64, 5.01f / 64.0f, -0.1f, 0.1f, 0.1f, generator);
+
+	std::vector<float> prevInput(6, 0.0f);
+
+	do {
+		clock.restart();
+
+		// ----------------------------- Input -----------------------------
+
+		sf::Event windowEvent;
+
+		while (window.pollEvent(windowEvent))
+		{
+			switch (windowEvent.type)
+			{
+			case sf::Event::Closed:
+				quit = true;
+				break;
+			}
+		}
+
+		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Escape))
+			quit = true;
+
+		// Update fitness
+		if (poleAngle < static_cast<float>(PI))
+			fitness = -(static_cast<float>(PI)* 0.5f - poleAngle);
+		else
+			fitness = -(static_cast<float>(PI)* 0.5f - (static_cast<float>(PI)* 2.0f - poleAngle));
+
+		fitness += static_cast<float>(PI)* 0.5f;
+
+		//fitness = fitness - std::abs(poleAngleVel * 1.0f);
+
+		//fitness = -std::abs(cartX);
+
+		if (sf::Keyboard::isKeyPressed(sf::Keyboard::A))
+			fitness = -cartX;
+		else if (sf::Keyboard::isKeyPressed(sf::Keyboard::D))
+			fitness = cartX;
+
+		// ------------------------------ AI -------------------------------
+
+		float dFitness = fitness - prevFitness;
+
+		//reward = dFitness * 5.0f;
+
+		reward = fitness * 0.5f;
+
+		if (totalTime == 0.0f)
+			avgReward = reward;
+		else
+			avgReward = (1.0f - avgRewardDecay) * avgReward + avgRewardDecay * reward;
+
+		sf::Image img = inputRT.getTexture().copyToImage();
+
+		agent.setInput(0, cartX * 0.25f);
+		agent.setInput(1, cartVelX * 0.1f);
+		agent.setInput(2, std::fmod(poleAngle + static_cast<float>(PI), 2.0f * static_cast<float>(PI)) * 0.1f);
+		agent.setInput(3, poleAngleVel * 0.1f);
+
+		agent.step(reward, 10, 20, 0.0f, 0.01f, 0.005f, 0.0f, 0.3f, 0.01f, 0.5f, 1.0f, 1.0f, 1.0f, 0.1f, 0.7f, 0.992f, 0.1f, generator);
+
+		float dir = agent.getOutput(0);
+
+		float agentForce = 4000.0f * dir;
+
+		prevFitness = fitness;
+
+		// ---------------------------- Physics ----------------------------
+
+		float pendulumCartAccelX = cartAccelX;
+
+		if (cartX < -cartMoveRadius)
+			pendulumCartAccelX = 0.0f;
+		else if (cartX > cartMoveRadius)
+			pendulumCartAccelX = 0.0f;
+
+		poleAngleAccel = pendulumCartAccelX * std::cos(poleAngle) + g * std::sin(poleAngle);
+		poleAngleVel += -poleRotationalFriction * poleAngleVel + poleAngleAccel * dt;
+		poleAngle += poleAngleVel * dt;
+
+		massPos = sf::Vector2f(cartX + std::cos(poleAngle + static_cast<float>(PI)* 0.5f) * poleLength, std::sin(poleAngle + static_cast<float>(PI)* 0.5f) * poleLength);
+
+		float force = 0.0f;
+
+		if (std::abs(cartVelX) < maxSpeed) {
+			force = std::max(-4000.0f, std::min(4000.0f, agentForce));
+
+			if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left))
+				force = -4000.0f;
+
+			if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right))
+				force = 4000.0f;
+		}
+
+		if (cartX < -cartMoveRadius) {
+			cartX = -cartMoveRadius;
+
+			cartAccelX = -cartVelX / dt;
+			cartVelX = -0.5f * cartVelX;
+		}
+		else if (cartX > cartMoveRadius) {
+			cartX = cartMoveRadius;
+
+			cartAccelX = -cartVelX / dt;
+			cartVelX = -0.5f * cartVelX;
+		}
+
+		cartAccelX = 0.25f * (force + massMass * poleLength * poleAngleAccel * std::cos(poleAngle) - massMass * poleLength * poleAngleVel * poleAngleVel * std::sin(poleAngle)) / (massMass + cartMass);
+		cartVelX += -cartFriction * cartVelX + cartAccelX * dt;
+		cartX += cartVelX * dt;
+
+		poleAngle = std::fmod(poleAngle, (2.0f * static_cast<float>(PI)));
+
+		if (poleAngle < 0.0f)
+			poleAngle += static_cast<float>(PI)* 2.0f;
+
+		if (sf::Keyboard::isKeyPressed(sf::Keyboard::T)) {
+			if (!tDownLastFrame) {
+				trainMode = !trainMode;
+			}
+
+			tDownLastFrame = true;
+		}
+		else
+			tDownLastFrame = false;
+
+		// ---------------------------- Rendering ----------------------------
+
+		// Render to input buffer
+		inputRT.clear();
+
+		inputCartSprite.setPosition(sf::Vector2f(inputRT.getSize().x * 0.5f + inputPixelsPerMeter * cartX, inputRT.getSize().y * 0.5f + 4.0f));
+
+		inputRT.draw(inputCartSprite);
+
+		inputPoleSprite.setPosition(inputCartSprite.getPosition() + sf::Vector2f(0.0f, -4.0f));
+		inputPoleSprite.setRotation(poleAngle * 180.0f / static_cast<float>(PI)+180.0f);
+
+		inputRT.draw(inputPoleSprite);
+
+		inputRT.display();
+
+		window.clear();
+
+		window.draw(backgroundSprite);
+
+		cartSprite.setPosition(sf::Vector2f(800.0f * 0.5f + pixelsPerMeter * cartX, 600.0f * 0.5f + 3.0f));
+
+		window.draw(cartSprite);
+
+		poleSprite.setPosition(cartSprite.getPosition() + sf::Vector2f(0.0f, -45.0f));
+		poleSprite.setRotation(poleAngle * 180.0f / static_cast<float>(PI)+180.0f);
+
+		window.draw(poleSprite);
+
+		// Draw hidden states
+		sf::Vector2f hiddenCenter(1200.0f, 300.0f);
+
+		float sScalar = 1.5f;
+
+		int rowSize = 8;
+
+		int rCount = 0;
+		int row = -4;
+
+		while (rCount < agent.getRSA().getNumHiddenNodes()) {
+			for (int i = 0; i < rowSize; i++) {
+				sf::CircleShape circle;
+
+				circle.setPosition(hiddenCenter + sf::Vector2f((i - rowSize / 2) * 18.0f * sScalar, row * 18.0f * sScalar));
+
+				circle.setRadius(8.0f * sScalar);
+
+				circle.setFillColor(sf::Color::White);
+
+				circle.setOrigin(8.0f * sScalar, 8.0f * sScalar);
+
+				window.draw(circle);
+
+				circle.setRadius(7.0f * sScalar);
+
+				circle.setOrigin(7.0f * sScalar, 7.0f * sScalar);
+
+				int s = (agent.getRSA().getHiddenNodeState(rCount)) * 255;
+
+				circle.setFillColor(sf::Color(s, s, s, 255));
+
+				window.draw(circle);
+
+				rCount++;
+			}
+
+			row++;
+		}
+
+		// -------------------------------------------------------------------
+
+		window.display();
+
+		//dt = clock.getElapsedTime().asSeconds();
+
+		totalTime += dt;
+		plotUpdateTimer += dt;
+	} while (!quit);
+
+	return 0;
+}
@@ -122,7 +122,8 @@ void CTRNN::step(float dt, float reward, float traceDecay, std::mt19937 &generat
 		for (size_t j = 0; j < _nodes.size(); j++) {
 			Weight &w = getWeight(i, j);
 
-			w._weight += reward * w._trace;
+			if (reward != 0.0f)
+				w._weight += reward * w._trace;
 
 			sum += w._weight * _nodes[j]._prevOutput;
 		}
@@ -130,7 +131,8 @@ void CTRNN::step(float dt, float reward, float traceDecay, std::mt19937 &generat
 		for (size_t j = 0; j < _inputs.size(); j++) {
 			Weight &w = getWeight(i, j + _numNodesHiddenOutput);
 
-			w._weight += reward * w._trace;
+			if (reward != 0.0f)
+				w._weight += reward * w._trace;
 
 			sum += w._weight * _inputs[j];
 		}
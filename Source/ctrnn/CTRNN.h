@@ -38,6 +38,8 @@ namespace ctrnn {
 			return _weightMatrix[j + i * _numNodesTotal];
 		}
 
+		friend class CTRNNPopulation;
+
 	public:
 		void createRandom(size_t numInputs, size_t numOutputs, size_t numHidden, float minWeight, float maxWeight, float minTau, float maxTau, float minNoiseStdDev, float maxNoiseStdDev, std::mt19937 &generator);
 		void createFromParents(const CTRNN &parent1, const CTRNN &parent2, float averageWeightsChance, float averageTausChance, float averageNoiseStdDevChance, std::mt19937 &generator);
@@ -54,6 +56,7 @@ namespace ctrnn {
 
 		void clear();
 
+		// Weight updates are skipped when reward is 0
 		void step(float dt, float reward, float traceDecay, std::mt19937 &generator);
 	};
 }
\ No newline at end of file
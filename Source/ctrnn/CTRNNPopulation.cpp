@@ -0,0 +1,228 @@
+#include "CTRNNPopulation.h"
+
+#include <assert.h>
+
+using namespace ctrnn;
+
+CTRNNPopulation::CTRNNPopulation()
+: _populationSize(0), _numInputs(0), _numOutputs(0), _numHidden(0), _numNodesTotal(0), _numNodesHiddenOutput(0)
+{}
+
+void CTRNNPopulation::create(const std::vector<CTRNN> &members) {
+	assert(!members.empty());
+
+	const CTRNN &first = members.front();
+
+	_populationSize = members.size();
+	_numInputs = first._inputs.size();
+	_numOutputs = first._numOutputs;
+	_numHidden = first._numHidden;
+	_numNodesTotal = first._numNodesTotal;
+	_numNodesHiddenOutput = first._numNodesHiddenOutput;
+
+	size_t numWeights = _numNodesTotal * _numNodesHiddenOutput;
+
+	_weights.resize(numWeights * _populationSize);
+	_traces.resize(numWeights * _populationSize);
+
+	_biases.resize(_numNodesHiddenOutput * _populationSize);
+	_states.resize(_numNodesHiddenOutput * _populationSize);
+	_tauInvs.resize(_numNodesHiddenOutput * _populationSize);
+	_noiseStdDevs.resize(_numNodesHiddenOutput * _populationSize);
+	_prevOutputs.resize(_numNodesHiddenOutput * _populationSize);
+	_outputs.resize(_numNodesHiddenOutput * _populationSize);
+
+	_inputs.resize(_numInputs * _populationSize);
+
+	_sums.resize(_populationSize);
+
+	// Box-Muller produces samples in pairs
+	_noise.resize(((_numNodesHiddenOutput + 1) / 2) * 2 * _populationSize);
+
+	for (size_t m = 0; m < _populationSize; m++) {
+		const CTRNN &member = members[m];
+
+		assert(member._inputs.size() == _numInputs && member._numOutputs == _numOutputs && member._numHidden == _numHidden);
+
+		for (size_t w = 0; w < numWeights; w++) {
+			_weights[w * _populationSize + m] = member._weightMatrix[w]._weight;
+			_traces[w * _populationSize + m] = member._weightMatrix[w]._trace;
+		}
+
+		for (size_t i = 0; i < _numNodesHiddenOutput; i++) {
+			const CTRNN::Node &node = member._nodes[i];
+
+			_biases[i * _populationSize + m] = node._bias;
+			_states[i * _populationSize + m] = node._state;
+			_tauInvs[i * _populationSize + m] = node._tauInv;
+			_noiseStdDevs[i * _populationSize + m] = node._noiseStdDev;
+			_prevOutputs[i * _populationSize + m] = node._prevOutput;
+			_outputs[i * _populationSize + m] = node._output;
+		}
+
+		for (size_t j = 0; j < _numInputs; j++)
+			_inputs[j * _populationSize + m] = member._inputs[j];
+	}
+}
+
+void CTRNNPopulation::getMember(size_t member, CTRNN &network) const {
+	network._numOutputs = _numOutputs;
+	network._numHidden = _numHidden;
+	network._numNodesTotal = _numNodesTotal;
+	network._numNodesHiddenOutput = _numNodesHiddenOutput;
+
+	network._weightMatrix.resize(_numNodesTotal * _numNodesHiddenOutput);
+	network._nodes.resize(_numNodesHiddenOutput);
+	network._inputs.resize(_numInputs);
+
+	for (size_t w = 0; w < network._weightMatrix.size(); w++) {
+		network._weightMatrix[w]._weight = _weights[w * _populationSize + member];
+		network._weightMatrix[w]._trace = _traces[w * _populationSize + member];
+	}
+
+	for (size_t i = 0; i < _numNodesHiddenOutput; i++) {
+		CTRNN::Node &node = network._nodes[i];
+
+		node._bias = _biases[i * _populationSize + member];
+		node._state = _states[i * _populationSize + member];
+		node._tauInv = _tauInvs[i * _populationSize + member];
+		node._noiseStdDev = _noiseStdDevs[i * _populationSize + member];
+		node._prevOutput = _prevOutputs[i * _populationSize + member];
+		node._output = _outputs[i * _populationSize + member];
+	}
+
+	for (size_t j = 0; j < _numInputs; j++)
+		network._inputs[j] = _inputs[j * _populationSize + member];
+}
+
+void CTRNNPopulation::clear() {
+	std::fill(_states.begin(), _states.end(), 0.0f);
+	std::fill(_prevOutputs.begin(), _prevOutputs.end(), 0.0f);
+	std::fill(_outputs.begin(), _outputs.end(), 0.0f);
+	std::fill(_traces.begin(), _traces.end(), 0.0f);
+}
+
+void CTRNNPopulation::generateNoise(std::vector<std::mt19937> &generators) {
+	const float pi2 = 6.283185307f;
+
+	size_t numPairs = _noise.size() / (2 * _populationSize);
+
+	float* radii = _noise.data();
+	float* angles = _noise.data() + numPairs * _populationSize;
+
+	std::uniform_real_distribution<float> uniformDist(0.0f, 1.0f);
+
+	// The random streams are serial per member, so draw all uniforms first
+	for (size_t m = 0; m < _populationSize; m++) {
+		std::mt19937 &generator = generators[m];
+
+		for (size_t p = 0; p < numPairs; p++) {
+			radii[p * _populationSize + m] = uniformDist(generator);
+			angles[p * _populationSize + m] = uniformDist(generator);
+		}
+	}
+
+	// Transform in place, first half becomes the cosine samples, second half the sine samples
+	size_t numUniforms = numPairs * _populationSize;
+
+	for (size_t k = 0; k < numUniforms; k++) {
+		float radius = std::sqrt(-2.0f * std::log(1.0f - radii[k]));
+		float angle = pi2 * angles[k];
+
+		radii[k] = radius * std::cos(angle);
+		angles[k] = radius * std::sin(angle);
+	}
+}
+
+void CTRNNPopulation::step(float dt, const std::vector<float> &rewards, float traceDecay, std::vector<std::mt19937> &generators) {
+	assert(rewards.size() == _populationSize && generators.size() == _populationSize);
+
+	generateNoise(generators);
+
+	// Plasticity
+	bool rewarded = false;
+
+	for (size_t m = 0; m < _populationSize; m++)
+		if (rewards[m] != 0.0f) {
+			rewarded = true;
+
+			break;
+		}
+
+	if (rewarded) {
+		const float* pRewards = rewards.data();
+
+		for (size_t w = 0; w < _weights.size(); w += _populationSize) {
+			float* pWeights = &_weights[w];
+			const float* pTraces = &_traces[w];
+
+			for (size_t m = 0; m < _populationSize; m++)
+				pWeights[m] += pRewards[m] * pTraces[m];
+		}
+	}
+
+	// Activation
+	float* pSums = _sums.data();
+
+	for (size_t i = 0; i < _numNodesHiddenOutput; i++) {
+		size_t node = i * _populationSize;
+
+		const float* pNoise = &_noise[node];
+		const float* pNoiseStdDevs = &_noiseStdDevs[node];
+
+		for (size_t m = 0; m < _populationSize; m++)
+			pSums[m] = pNoise[m] * pNoiseStdDevs[m];
+
+		for (size_t j = 0; j < _numNodesHiddenOutput; j++) {
+			const float* pWeights = &_weights[weightIndex(i, j, 0)];
+			const float* pPrevOutputs = &_prevOutputs[j * _populationSize];
+
+			for (size_t m = 0; m < _populationSize; m++)
+				pSums[m] += pWeights[m] * pPrevOutputs[m];
+		}
+
+		for (size_t j = 0; j < _numInputs; j++) {
+			const float* pWeights = &_weights[weightIndex(i, j + _numNodesHiddenOutput, 0)];
+			const float* pInputs = &_inputs[j * _populationSize];
+
+			for (size_t m = 0; m < _populationSize; m++)
+				pSums[m] += pWeights[m] * pInputs[m];
+		}
+
+		float* pStates = &_states[node];
+		float* pOutputs = &_outputs[node];
+		const float* pTauInvs = &_tauInvs[node];
+		const float* pBiases = &_biases[node];
+
+		for (size_t m = 0; m < _populationSize; m++) {
+			pStates[m] += dt * pTauInvs[m] * (-pStates[m] + pSums[m]);
+			pOutputs[m] = 1.0f / (1.0f + std::exp(-(pStates[m] + pBiases[m])));
+		}
+	}
+
+	std::copy(_outputs.begin(), _outputs.end(), _prevOutputs.begin());
+
+	// Hebbian
+	for (size_t i = 0; i < _numNodesHiddenOutput; i++) {
+		const float* pOutputsI = &_outputs[i * _populationSize];
+
+		for (size_t j = 0; j < _numNodesHiddenOutput; j++) {
+			const float* pWeights = &_weights[weightIndex(i, j, 0)];
+			float* pTraces = &_traces[weightIndex(i, j, 0)];
+			const float* pOutputsJ = &_outputs[j * _populationSize];
+
+			for (size_t m = 0; m < _populationSize; m++)
+				pTraces[m] += -traceDecay * pTraces[m] + pWeights[m] * pOutputsJ[m] * (-1.0f + pOutputsI[m]) + (1.0f - pWeights[m]) * pOutputsJ[m] * pOutputsI[m];
+		}
+
+		// Input columns use the node outputs, as in CTRNN::step
+		for (size_t j = 0; j < _numInputs; j++) {
+			const float* pWeights = &_weights[weightIndex(i, j + _numNodesHiddenOutput, 0)];
+			float* pTraces = &_traces[weightIndex(i, j + _numNodesHiddenOutput, 0)];
+			const float* pOutputsJ = &_outputs[j * _populationSize];
+
+			for (size_t m = 0; m < _populationSize; m++)
+				pTraces[m] += -traceDecay * pTraces[m] + pWeights[m] * pOutputsJ[m] * (-1.0f + pOutputsI[m]) + (1.0f - pWeights[m]) * pOutputsJ[m] * pOutputsI[m];
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CTRNN.h"
+
+#include <algorithm>
+
+namespace ctrnn {
+	// Steps a whole population of CTRNNs with the same topology together. Parameters and states are stored with the member
+	// index innermost ([node][member], [node][column][member]), so every inner loop runs over contiguous members
+	class CTRNNPopulation {
+	private:
+		std::vector<float> _weights;
+		std::vector<float> _traces;
+
+		std::vector<float> _biases;
+		std::vector<float> _states;
+		std::vector<float> _tauInvs;
+		std::vector<float> _noiseStdDevs;
+		std::vector<float> _prevOutputs;
+		std::vector<float> _outputs;
+
+		std::vector<float> _inputs;
+
+		// Scratch
+		std::vector<float> _sums;
+		std::vector<float> _noise;
+
+		size_t _populationSize;
+		size_t _numInputs, _numOutputs, _numHidden;
+		size_t _numNodesTotal, _numNodesHiddenOutput;
+
+		size_t weightIndex(size_t i, size_t j, size_t member) const {
+			return (j + i * _numNodesTotal) * _populationSize + member;
+		}
+
+		// Fills _noise with unit Gaussian samples, two per pair of uniforms (Box-Muller)
+		void generateNoise(std::vector<std::mt19937> &generators);
+
+	public:
+		CTRNNPopulation();
+
+		// All members must have the same numbers of inputs, outputs and hidden nodes
+		void create(const std::vector<CTRNN> &members);
+
+		// Copies weights, traces and node states of a member back into network
+		void getMember(size_t member, CTRNN &network) const;
+
+		void setInput(size_t member, size_t index, float value) {
+			_inputs[index * _populationSize + member] = value;
+		}
+
+		// Sets an input for all members
+		void setInput(size_t index, float value) {
+			std::fill(_inputs.begin() + index * _populationSize, _inputs.begin() + (index + 1) * _populationSize, value);
+		}
+
+		float getOutput(size_t member, size_t index) const {
+			return _outputs[(_numHidden + index) * _populationSize + member];
+		}
+
+		void clear();
+
+		// Same as CTRNN::step for every member. rewards and generators hold one entry per member, generators[i] drives the
+		// noise of member i. Weight updates are skipped when all rewards are 0
+		void step(float dt, const std::vector<float> &rewards, float traceDecay, std::vector<std::mt19937> &generators);
+
+		size_t getPopulationSize() const {
+			return _populationSize;
+		}
+
+		size_t getNumInputs() const {
+			return _numInputs;
+		}
+
+		size_t getNumOutputs() const {
+			return _numOutputs;
+		}
+	};
+}
\ No newline at end of file
@@ -6,6 +6,7 @@
 using namespace ctrnn;
 
 GeneticAlgorithm::GeneticAlgorithm()
+: _numThreads(1), _generation(0)
 {}
 
 void GeneticAlgorithm::create(size_t populationSize,
@@ -51,6 +52,39 @@ size_t GeneticAlgorithm::rouletteWheel(float totalFitness, std::mt19937 &generat
 	return 0;
 }
 
+void GeneticAlgorithm::evaluate(const std::function<float(CTRNN &member, std::mt19937 &generator)> &fitnessFunc, std::mt19937 &generator) {
+	unsigned long seed = generator();
+
+	int populationSize = _population.size();
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(_numThreads)
+	for (int i = 0; i < populationSize; i++) {
+		std::seed_seq memberSeed { seed, static_cast<unsigned long>(_generation), static_cast<unsigned long>(i) };
+
+		std::mt19937 memberGenerator(memberSeed);
+
+		CTRNN member = _population[i];
+
+		_fitnesses[i] = fitnessFunc(member, memberGenerator);
+	}
+}
+
+void GeneticAlgorithm::evaluateBatch(const std::function<void(CTRNNPopulation &population, std::vector<std::mt19937> &generators, std::vector<float> &fitnesses)> &fitnessFunc, std::mt19937 &generator) {
+	unsigned long seed = generator();
+
+	_batch.create(_population);
+
+	_batchGenerators.resize(_population.size());
+
+	for (size_t i = 0; i < _batchGenerators.size(); i++) {
+		std::seed_seq memberSeed { seed, static_cast<unsigned long>(_generation), static_cast<unsigned long>(i) };
+
+		_batchGenerators[i].seed(memberSeed);
+	}
+
+	fitnessFunc(_batch, _batchGenerators, _fitnesses);
+}
+
 void GeneticAlgorithm::generation(float weightPerturbationChance, float maxWeightPerturbation, float averageWeightsChance,
 	float tauPerturbationChance, float maxTauPerturbation, float averageTausChance,
 	float noiseStdDevPerturbationChance, float maxNoiseStdDevPerturbation, float averageNoiseStdDevChance,
@@ -95,4 +129,6 @@ void GeneticAlgorithm::generation(float weightPerturbationChance, float maxWeigh
 
 	// Set new population as current population
 	_population = newPopulation;
+
+	_generation++;
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 
-#include "CTRNN.h"
+#include "CTRNNPopulation.h"
+
+#include <functional>
+#include <algorithm>
 
 namespace ctrnn {
 	class GeneticAlgorithm {
@@ -8,6 +11,13 @@ namespace ctrnn {
 		std::vector<CTRNN> _population;
 		std::vector<float> _fitnesses;
 
+		CTRNNPopulation _batch;
+		std::vector<std::mt19937> _batchGenerators;
+
+		int _numThreads;
+
+		size_t _generation;
+
 		// Rescale to all positive fitnesses and greedify
 		void rescaleFitnesses(float greedExponent);
 
@@ -21,6 +31,15 @@ namespace ctrnn {
 			float minWeight, float maxWeight, float minTau, float maxTau, float minNoise, float maxNoise,
 			std::mt19937 &generator);
 
+		// Evaluates every member on a copy and sets the fitnesses. Members are evaluated by _numThreads threads (OpenMP),
+		// each with its own random stream seeded from (one draw of generator, generation, member), so fitnesses do not
+		// depend on the number of threads. fitnessFunc is called concurrently
+		void evaluate(const std::function<float(CTRNN &member, std::mt19937 &generator)> &fitnessFunc, std::mt19937 &generator);
+
+		// Evaluates the whole generation packed into one CTRNNPopulation. fitnessFunc gets one random stream per member,
+		// seeded as in evaluate, and must write every member's fitness
+		void evaluateBatch(const std::function<void(CTRNNPopulation &population, std::vector<std::mt19937> &generators, std::vector<float> &fitnesses)> &fitnessFunc, std::mt19937 &generator);
+
 		// Creates a new generation based on set fitnesses
 		void generation(float weightPerturbationChance, float maxWeightPerturbation, float averageWeightsChance,
 			float tauPerturbationChance, float maxTauPerturbation, float averageTausChance,
@@ -43,5 +62,17 @@ namespace ctrnn {
 		const CTRNN &getPopulationMember(size_t i) const {
 			return _population[i];
 		}
+
+		void setNumThreads(int numThreads) {
+			_numThreads = std::max(1, numThreads);
+		}
+
+		int getNumThreads() const {
+			return _numThreads;
+		}
+
+		size_t getGeneration() const {
+			return _generation;
+		}
 	};
 }
\ No newline at end of file
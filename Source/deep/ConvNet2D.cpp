@@ -25,8 +25,8 @@ misrepresented as being the original software.
 
 using namespace deep;
 
-void ConvNet2D::createRandom(int inputMapWidth, int inputMapHeight, int inputNumMaps, const std::vector<LayerPairDesc> &layerDescs, float minWeight, float maxWeight, std::mt19937 &generator) {
-	std::uniform_real_distribution<float> distWeight(minWeight, maxWeight);
+void ConvNet2D::create(int inputMapWidth, int inputMapHeight, int inputNumMaps, const std::vector<LayerPairDesc> &layerDescs) {
+	_layerDescs = layerDescs;
 
 	_convolutionLayers.resize(layerDescs.size());
 	_downsamplingLayers.resize(layerDescs.size());
@@ -43,64 +43,11 @@ void ConvNet2D::createRandom(int inputMapWidth, int inputMapHeight, int inputNum
 		_inputLayer._maps[m]._outputs.assign(inputMapSize, 0.0f);
 	}
 
-	// First convolution layer
-	{
-		int l = 0;
-
-		_convolutionLayers[l]._filterSizeWidth = layerDescs[l]._filterSizeWidth;
-		_convolutionLayers[l]._filterSizeHeight = layerDescs[l]._filterSizeHeight;
-
-		_convolutionLayers[l]._strideWidth = layerDescs[l]._strideWidth;
-		_convolutionLayers[l]._strideHeight = layerDescs[l]._strideHeight;
-
-		int numConnectionsPerNode = _convolutionLayers[l]._filterSizeWidth * _convolutionLayers[l]._filterSizeHeight * _inputLayer._maps.size();
-
-		_convolutionLayers[l]._mapWidth = (_inputLayer._mapWidth - _convolutionLayers[l]._filterSizeWidth + 1) / (_convolutionLayers[l]._strideWidth);
-		_convolutionLayers[l]._mapHeight = (_inputLayer._mapHeight - _convolutionLayers[l]._filterSizeHeight + 1) / (_convolutionLayers[l]._strideHeight);
-
-		_convolutionLayers[l]._maps.resize(layerDescs[l]._numFeatureMaps);
-
-		int numNodesPerMap = _convolutionLayers[l]._mapWidth * _convolutionLayers[l]._mapHeight;
-
-		for (int m = 0; m < _convolutionLayers[l]._maps.size(); m++) {
-			_convolutionLayers[l]._maps[m]._outputs.clear();
-			_convolutionLayers[l]._maps[m]._outputs.assign(numNodesPerMap, 0.0f);
-
-			Node &node = _convolutionLayers[l]._maps[m]._node;
-
-			node._bias._weight = distWeight(generator);
-
-			node._connections.resize(numConnectionsPerNode);
-
-			for (int c = 0; c < numConnectionsPerNode; c++)
-				node._connections[c]._weight = distWeight(generator);
-		}
-	}
-
-	// First downsampling layer
-	{
-		int l = 0;
-
-		_downsamplingLayers[l]._downsampleWidth = layerDescs[l]._downsampleWidth;
-		_downsamplingLayers[l]._downsampleHeight = layerDescs[l]._downsampleHeight;
-
-		_downsamplingLayers[l]._mapWidth = static_cast<int>(static_cast<float>(_convolutionLayers[l]._mapWidth) / _downsamplingLayers[l]._downsampleWidth);
-		_downsamplingLayers[l]._mapHeight = static_cast<int>(static_cast<float>(_convolutionLayers[l]._mapHeight) / _downsamplingLayers[l]._downsampleHeight);
-
-		int numNodesPerMap = _downsamplingLayers[l]._mapWidth * _downsamplingLayers[l]._mapHeight;
-
-		_downsamplingLayers[l]._maps.resize(_convolutionLayers[l]._maps.size());
-
-		for (int m = 0; m < _downsamplingLayers[l]._maps.size(); m++) {
-			_downsamplingLayers[l]._maps[m]._outputs.clear();
-			_downsamplingLayers[l]._maps[m]._outputs.assign(numNodesPerMap, 0.0f);
-		}
-	}
-
-	// All other layers
-	for (int l = 1; l < layerDescs.size(); l++) {
-		int prevLayerIndex = l - 1;
+	int prevMapWidth = _inputLayer._mapWidth;
+	int prevMapHeight = _inputLayer._mapHeight;
+	int prevNumMaps = _inputLayer._maps.size();
 
+	for (int l = 0; l < layerDescs.size(); l++) {
 		// ------------------------------ Convolutional Layer ------------------------------
 
 		{
@@ -110,10 +57,10 @@ void ConvNet2D::createRandom(int inputMapWidth, int inputMapHeight, int inputNum
 			_convolutionLayers[l]._strideWidth = layerDescs[l]._strideWidth;
 			_convolutionLayers[l]._strideHeight = layerDescs[l]._strideHeight;
 
-			int numConnectionsPerNode = _convolutionLayers[l]._filterSizeWidth * _convolutionLayers[l]._filterSizeHeight * _downsamplingLayers[prevLayerIndex]._maps.size();
+			int numConnectionsPerNode = _convolutionLayers[l]._filterSizeWidth * _convolutionLayers[l]._filterSizeHeight * prevNumMaps;
 
-			_convolutionLayers[l]._mapWidth = (_downsamplingLayers[prevLayerIndex]._mapWidth - _convolutionLayers[l]._filterSizeWidth + 1) / (_convolutionLayers[l]._strideWidth);
-			_convolutionLayers[l]._mapHeight = (_downsamplingLayers[prevLayerIndex]._mapHeight - _convolutionLayers[l]._filterSizeHeight + 1) / (_convolutionLayers[l]._strideHeight);
+			_convolutionLayers[l]._mapWidth = (prevMapWidth - _convolutionLayers[l]._filterSizeWidth + 1) / (_convolutionLayers[l]._strideWidth);
+			_convolutionLayers[l]._mapHeight = (prevMapHeight - _convolutionLayers[l]._filterSizeHeight + 1) / (_convolutionLayers[l]._strideHeight);
 
 			_convolutionLayers[l]._maps.resize(layerDescs[l]._numFeatureMaps);
 
@@ -123,14 +70,7 @@ void ConvNet2D::createRandom(int inputMapWidth, int inputMapHeight, int inputNum
 				_convolutionLayers[l]._maps[m]._outputs.clear();
 				_convolutionLayers[l]._maps[m]._outputs.assign(numNodesPerMap, 0.0f);
 
-				Node &node = _convolutionLayers[l]._maps[m]._node;
-
-				node._bias._weight = distWeight(generator);
-
-				node._connections.resize(numConnectionsPerNode);
-
-				for (int c = 0; c < numConnectionsPerNode; c++)
-					node._connections[c]._weight = distWeight(generator);
+				_convolutionLayers[l]._maps[m]._node._connections.resize(numConnectionsPerNode);
 			}
 		}
 
@@ -152,131 +92,230 @@ void ConvNet2D::createRandom(int inputMapWidth, int inputMapHeight, int inputNum
 				_downsamplingLayers[l]._maps[m]._outputs.assign(numNodesPerMap, 0.0f);
 			}
 		}
+
+		prevMapWidth = _downsamplingLayers[l]._mapWidth;
+		prevMapHeight = _downsamplingLayers[l]._mapHeight;
+		prevNumMaps = _downsamplingLayers[l]._maps.size();
 	}
 }
 
-void ConvNet2D::activate() {
-	// First convolution layer
-	{
-		int l = 0;
+void ConvNet2D::createRandom(int inputMapWidth, int inputMapHeight, int inputNumMaps, const std::vector<LayerPairDesc> &layerDescs, float minWeight, float maxWeight, std::mt19937 &generator) {
+	std::uniform_real_distribution<float> distWeight(minWeight, maxWeight);
 
-		int filterSize = _convolutionLayers[l]._filterSizeWidth * _convolutionLayers[l]._filterSizeHeight;
+	create(inputMapWidth, inputMapHeight, inputNumMaps, layerDescs);
 
-		// Convolve
-		for (int m = 0; m < _convolutionLayers[l]._maps.size(); m++)
-		for (int nx = 0; nx < _convolutionLayers[l]._mapWidth; nx++)
-		for (int ny = 0; ny < _convolutionLayers[l]._mapHeight; ny++) {
-			Node &node = _convolutionLayers[l]._maps[m]._node;
+	for (int l = 0; l < _convolutionLayers.size(); l++)
+	for (int m = 0; m < _convolutionLayers[l]._maps.size(); m++) {
+		Node &node = _convolutionLayers[l]._maps[m]._node;
 
-			int ix = nx * _convolutionLayers[l]._strideWidth;
-			int iy = ny * _convolutionLayers[l]._strideHeight;
+		node._bias._weight = distWeight(generator);
 
-			// Go through filter
-			float sum = node._bias._weight;
+		for (int c = 0; c < node._connections.size(); c++)
+			node._connections[c]._weight = distWeight(generator);
+	}
+}
 
-			for (int fm = 0; fm < _inputLayer._maps.size(); fm++)
-			for (int fx = 0; fx < _convolutionLayers[l]._filterSizeWidth; fx++)
-			for (int fy = 0; fy < _convolutionLayers[l]._filterSizeHeight; fy++) {
-				int tx = ix + fx;
-				int ty = iy + fy;
+void ConvNet2D::writeToCheckpoint(io::CheckpointWriter &writer, const std::string &prefix) const {
+	int dims[3] = { _inputLayer._mapWidth, _inputLayer._mapHeight, static_cast<int>(_inputLayer._maps.size()) };
 
-				if (tx < _inputLayer._mapWidth && ty < _inputLayer._mapHeight)
-					sum += node._connections[fx + fy * _convolutionLayers[l]._filterSizeWidth + fm * filterSize]._weight * _inputLayer._maps[fm]._outputs[tx + ty * _inputLayer._mapWidth];
-			}
+	writer.addInts(prefix + "dims", dims, 3);
+
+	std::vector<int> layerDescs;
+
+	for (int l = 0; l < _layerDescs.size(); l++) {
+		int desc[7] = { _layerDescs[l]._filterSizeWidth, _layerDescs[l]._filterSizeHeight, _layerDescs[l]._numFeatureMaps,
+			_layerDescs[l]._strideWidth, _layerDescs[l]._strideHeight, _layerDescs[l]._downsampleWidth, _layerDescs[l]._downsampleHeight };
+
+		layerDescs.insert(layerDescs.end(), desc, desc + 7);
+	}
+
+	writer.addInts(prefix + "layerDescs", layerDescs);
+
+	// Per layer, one row of filter weights per feature map in connection order, and a bias per feature map
+	for (int l = 0; l < _convolutionLayers.size(); l++) {
+		std::vector<float> weights;
+		std::vector<float> biases;
 
-			_convolutionLayers[l]._maps[m]._outputs[nx + ny * _convolutionLayers[l]._mapWidth] = sigmoid(sum);
+		for (int m = 0; m < _convolutionLayers[l]._maps.size(); m++) {
+			const Node &node = _convolutionLayers[l]._maps[m]._node;
+
+			for (int c = 0; c < node._connections.size(); c++)
+				weights.push_back(node._connections[c]._weight);
+
+			biases.push_back(node._bias._weight);
 		}
+
+		writer.addFloats(prefix + "conv" + std::to_string(l) + "/weights", weights);
+		writer.addFloats(prefix + "conv" + std::to_string(l) + "/biases", biases);
 	}
+}
 
-	// First downsampling layer
-	{
-		int l = 0;
+bool ConvNet2D::readFromCheckpoint(const io::CheckpointReader &reader, const std::string &prefix) {
+	int dims[3];
 
-		for (int m = 0; m < _downsamplingLayers[l]._maps.size(); m++)
-		for (int nx = 0; nx < _downsamplingLayers[l]._mapWidth; nx++)
-		for (int ny = 0; ny < _downsamplingLayers[l]._mapHeight; ny++) {
-			int ix = nx * _downsamplingLayers[l]._downsampleWidth;
-			int iy = ny * _downsamplingLayers[l]._downsampleHeight;
+	if (!reader.readInts(prefix + "dims", dims, 3))
+		return false;
 
-			// Go through filter
-			float maximum = -999999.0f;
+	std::vector<int> descs;
 
-			for (int fx = 0; fx < _downsamplingLayers[l]._downsampleWidth; fx++)
-			for (int fy = 0; fy < _downsamplingLayers[l]._downsampleHeight; fy++) {
-				int tx = ix + fx;
-				int ty = iy + fy;
+	if (!reader.readInts(prefix + "layerDescs", descs) || descs.empty() || descs.size() % 7 != 0)
+		return false;
 
-				// Make sure it is in bounds
-				if (tx < _convolutionLayers[l]._mapWidth && ty < _convolutionLayers[l]._mapHeight)
-					maximum = std::max(maximum, _convolutionLayers[l]._maps[m]._outputs[tx + ty * _convolutionLayers[l]._mapWidth]);
-			}
+	std::vector<LayerPairDesc> layerDescs(descs.size() / 7);
+
+	for (int l = 0; l < layerDescs.size(); l++) {
+		layerDescs[l]._filterSizeWidth = descs[l * 7 + 0];
+		layerDescs[l]._filterSizeHeight = descs[l * 7 + 1];
+		layerDescs[l]._numFeatureMaps = descs[l * 7 + 2];
+		layerDescs[l]._strideWidth = descs[l * 7 + 3];
+		layerDescs[l]._strideHeight = descs[l * 7 + 4];
+		layerDescs[l]._downsampleWidth = descs[l * 7 + 5];
+		layerDescs[l]._downsampleHeight = descs[l * 7 + 6];
+	}
+
+	create(dims[0], dims[1], dims[2], layerDescs);
+
+	for (int l = 0; l < _convolutionLayers.size(); l++) {
+		size_t numWeights, numBiases;
+
+		const float* pWeights = reader.getFloats(prefix + "conv" + std::to_string(l) + "/weights", numWeights);
+		const float* pBiases = reader.getFloats(prefix + "conv" + std::to_string(l) + "/biases", numBiases);
+
+		int numMaps = _convolutionLayers[l]._maps.size();
+		int numConnections = numMaps > 0 ? _convolutionLayers[l]._maps[0]._node._connections.size() : 0;
+
+		if (pWeights == nullptr || pBiases == nullptr || numWeights != numMaps * numConnections || numBiases != numMaps)
+			return false;
+
+		for (int m = 0; m < numMaps; m++) {
+			Node &node = _convolutionLayers[l]._maps[m]._node;
+
+			for (int c = 0; c < numConnections; c++)
+				node._connections[c]._weight = pWeights[m * numConnections + c];
 
-			_downsamplingLayers[l]._maps[m]._outputs[nx + ny * _downsamplingLayers[l]._mapWidth] = maximum;
+			node._bias._weight = pBiases[m];
 		}
 	}
 
-	for (int l = 1; l < _convolutionLayers.size(); l++) {
-		int prevLayerIndex = l - 1;
+	return true;
+}
 
-		// ------------------------------ Convolutional Layer ------------------------------
+void ConvNet2D::convolve(ConvolutionLayer &layer, const std::vector<const float*> &inputMaps, int inputWidth, int inputHeight) {
+	int filterSize = layer._filterSizeWidth * layer._filterSizeHeight;
+	int numRows = filterSize * inputMaps.size();
+	int numNodesPerMap = layer._mapWidth * layer._mapHeight;
 
-		{
-			int filterSize = _convolutionLayers[l]._filterSizeWidth * _convolutionLayers[l]._filterSizeHeight;
+	// Unroll the receptive fields, row (fm * filterSizeWidth + fx) * filterSizeHeight + fy holds that filter tap for every node.
+	// This row order is the order in which the taps were always summed, so every sum is accumulated in the same order as a direct convolution
+	_columns.resize(numRows * numNodesPerMap);
 
-			// Convolve
-			for (int m = 0; m < _convolutionLayers[l]._maps.size(); m++)
-			for (int nx = 0; nx < _convolutionLayers[l]._mapWidth; nx++)
-			for (int ny = 0; ny < _convolutionLayers[l]._mapHeight; ny++) {
-				Node &node = _convolutionLayers[l]._maps[m]._node;
+	for (int fm = 0; fm < inputMaps.size(); fm++)
+	for (int fx = 0; fx < layer._filterSizeWidth; fx++)
+	for (int fy = 0; fy < layer._filterSizeHeight; fy++) {
+		float* pRow = &_columns[((fm * layer._filterSizeWidth + fx) * layer._filterSizeHeight + fy) * numNodesPerMap];
 
-				int ix = nx * _convolutionLayers[l]._strideWidth;
-				int iy = ny * _convolutionLayers[l]._strideHeight;
+		for (int ny = 0; ny < layer._mapHeight; ny++) {
+			int ty = ny * layer._strideHeight + fy;
 
-				// Go through filter
-				float sum = node._bias._weight;
+			for (int nx = 0; nx < layer._mapWidth; nx++) {
+				int tx = nx * layer._strideWidth + fx;
 
-				for (int fm = 0; fm < _downsamplingLayers[prevLayerIndex]._maps.size(); fm++)
-				for (int fx = 0; fx < _convolutionLayers[l]._filterSizeWidth; fx++)
-				for (int fy = 0; fy < _convolutionLayers[l]._filterSizeHeight; fy++) {
-					int tx = ix + fx;
-					int ty = iy + fy;
+				pRow[nx + ny * layer._mapWidth] = tx < inputWidth && ty < inputHeight ? inputMaps[fm][tx + ty * inputWidth] : 0.0f;
+			}
+		}
+	}
 
-					if (tx < _downsamplingLayers[prevLayerIndex]._mapWidth && ty < _downsamplingLayers[prevLayerIndex]._mapHeight)
-						sum += node._connections[fx + fy * _convolutionLayers[l]._filterSizeWidth + fm * filterSize]._weight * _downsamplingLayers[prevLayerIndex]._maps[fm]._outputs[tx + ty * _downsamplingLayers[prevLayerIndex]._mapWidth];
-				}
+	// Filters in the same row order
+	_filters.resize(layer._maps.size() * numRows);
+
+	for (int m = 0; m < layer._maps.size(); m++)
+	for (int fm = 0; fm < inputMaps.size(); fm++)
+	for (int fx = 0; fx < layer._filterSizeWidth; fx++)
+	for (int fy = 0; fy < layer._filterSizeHeight; fy++)
+		_filters[m * numRows + (fm * layer._filterSizeWidth + fx) * layer._filterSizeHeight + fy] = layer._maps[m]._node._connections[fx + fy * layer._filterSizeWidth + fm * filterSize]._weight;
+
+	// Filters x columns, in blocks of nodes so that a block of columns stays in cache for all maps
+	const int nodeBlockSize = 256;
+
+	for (int start = 0; start < numNodesPerMap; start += nodeBlockSize) {
+		int blockSize = std::min(nodeBlockSize, numNodesPerMap - start);
+
+		for (int m = 0; m < layer._maps.size(); m++) {
+			float* pOutputs = &layer._maps[m]._outputs[start];
+			const float* pFilter = &_filters[m * numRows];
+
+			std::fill(pOutputs, pOutputs + blockSize, layer._maps[m]._node._bias._weight);
 
-				_convolutionLayers[l]._maps[m]._outputs[nx + ny * _convolutionLayers[l]._mapWidth] = sigmoid(sum);
+			for (int r = 0; r < numRows; r++) {
+				float weight = pFilter[r];
+				const float* pRow = &_columns[r * numNodesPerMap + start];
+
+				for (int n = 0; n < blockSize; n++)
+					pOutputs[n] += weight * pRow[n];
 			}
 		}
+	}
 
-		// ------------------------------ Downsampling Layer ------------------------------
+	for (int m = 0; m < layer._maps.size(); m++)
+	for (int n = 0; n < numNodesPerMap; n++)
+		layer._maps[m]._outputs[n] = sigmoid(layer._maps[m]._outputs[n]);
+}
 
-		{
-			for (int m = 0; m < _downsamplingLayers[l]._maps.size(); m++)
-			for (int nx = 0; nx < _downsamplingLayers[l]._mapWidth; nx++)
-			for (int ny = 0; ny < _downsamplingLayers[l]._mapHeight; ny++) {
-				int ix = nx * _downsamplingLayers[l]._downsampleWidth;
-				int iy = ny * _downsamplingLayers[l]._downsampleHeight;
+void ConvNet2D::maxPool(const ConvolutionLayer &convolutionLayer, DownsamplingLayer &downsamplingLayer) {
+	for (int m = 0; m < downsamplingLayer._maps.size(); m++) {
+		const std::vector<float> &inputs = convolutionLayer._maps[m]._outputs;
+		std::vector<float> &outputs = downsamplingLayer._maps[m]._outputs;
 
-				// Go through filter
-				float maximum = -999999.0f;
+		// A row of outputs at a time, taps in the same order as before so ties between -0 and 0 resolve the same way
+		for (int ny = 0; ny < downsamplingLayer._mapHeight; ny++) {
+			float* pOutputs = &outputs[ny * downsamplingLayer._mapWidth];
 
-				for (int fx = 0; fx < _downsamplingLayers[l]._downsampleWidth; fx++)
-				for (int fy = 0; fy < _downsamplingLayers[l]._downsampleHeight; fy++) {
-					int tx = ix + fx;
-					int ty = iy + fy;
+			std::fill(pOutputs, pOutputs + downsamplingLayer._mapWidth, -999999.0f);
 
-					// Make sure it is in bounds
-					if (tx < _convolutionLayers[l]._mapWidth && ty < _convolutionLayers[l]._mapHeight)
-						maximum = std::max(maximum, _convolutionLayers[l]._maps[m]._outputs[tx + ty * _convolutionLayers[l]._mapWidth]);
-				}
+			for (int fx = 0; fx < downsamplingLayer._downsampleWidth; fx++)
+			for (int fy = 0; fy < downsamplingLayer._downsampleHeight; fy++) {
+				int ty = ny * downsamplingLayer._downsampleHeight + fy;
+
+				// Make sure it is in bounds
+				if (ty >= convolutionLayer._mapHeight)
+					continue;
+
+				const float* pInputs = &inputs[fx + ty * convolutionLayer._mapWidth];
+
+				int width = std::min(downsamplingLayer._mapWidth, (convolutionLayer._mapWidth - fx + downsamplingLayer._downsampleWidth - 1) / downsamplingLayer._downsampleWidth);
 
-				_downsamplingLayers[l]._maps[m]._outputs[nx + ny * _downsamplingLayers[l]._mapWidth] = maximum;
+				for (int nx = 0; nx < width; nx++)
+					pOutputs[nx] = std::max(pOutputs[nx], pInputs[nx * downsamplingLayer._downsampleWidth]);
 			}
 		}
 	}
 }
 
+void ConvNet2D::activate() {
+	std::vector<const float*> inputMaps;
+
+	for (int l = 0; l < _convolutionLayers.size(); l++) {
+		inputMaps.clear();
+
+		if (l == 0) {
+			for (int m = 0; m < _inputLayer._maps.size(); m++)
+				inputMaps.push_back(_inputLayer._maps[m]._outputs.data());
+
+			convolve(_convolutionLayers[l], inputMaps, _inputLayer._mapWidth, _inputLayer._mapHeight);
+		}
+		else {
+			int prevLayerIndex = l - 1;
+
+			for (int m = 0; m < _downsamplingLayers[prevLayerIndex]._maps.size(); m++)
+				inputMaps.push_back(_downsamplingLayers[prevLayerIndex]._maps[m]._outputs.data());
+
+			convolve(_convolutionLayers[l], inputMaps, _downsamplingLayers[prevLayerIndex]._mapWidth, _downsamplingLayers[prevLayerIndex]._mapHeight);
+		}
+
+		maxPool(_convolutionLayers[l], _downsamplingLayers[l]);
+	}
+}
+
 void ConvNet2D::activateAndLearn(float alpha, std::mt19937 &generator) {
 	std::uniform_real_distribution<float> dist01(0.0f, 1.0f);
 
@@ -391,31 +430,7 @@ void ConvNet2D::activateAndLearn(float alpha, std::mt19937 &generator) {
 	}
 
 	// First downsampling layer
-	{
-		int l = 0;
-
-		for (int m = 0; m < _downsamplingLayers[l]._maps.size(); m++)
-		for (int nx = 0; nx < _downsamplingLayers[l]._mapWidth; nx++)
-		for (int ny = 0; ny < _downsamplingLayers[l]._mapHeight; ny++) {
-			int ix = nx * _downsamplingLayers[l]._downsampleWidth;
-			int iy = ny * _downsamplingLayers[l]._downsampleHeight;
-
-			// Go through filter
-			float maximum = -999999.0f;
-
-			for (int fx = 0; fx < _downsamplingLayers[l]._downsampleWidth; fx++)
-			for (int fy = 0; fy < _downsamplingLayers[l]._downsampleHeight; fy++) {
-				int tx = ix + fx;
-				int ty = iy + fy;
-
-				// Make sure it is in bounds
-				if (tx < _convolutionLayers[l]._mapWidth && ty < _convolutionLayers[l]._mapHeight)
-					maximum = std::max(maximum, _convolutionLayers[l]._maps[m]._outputs[tx + ty * _convolutionLayers[l]._mapWidth]);
-			}
-
-			_downsamplingLayers[l]._maps[m]._outputs[nx + ny * _downsamplingLayers[l]._mapWidth] = maximum;
-		}
-	}
+	maxPool(_convolutionLayers[0], _downsamplingLayers[0]);
 
 	for (int l = 1; l < _convolutionLayers.size(); l++) {
 		int prevLayerIndex = l - 1;
@@ -527,28 +542,6 @@ void ConvNet2D::activateAndLearn(float alpha, std::mt19937 &generator) {
 
 		// ------------------------------ Downsampling Layer ------------------------------
 
-		{
-			for (int m = 0; m < _downsamplingLayers[l]._maps.size(); m++)
-			for (int nx = 0; nx < _downsamplingLayers[l]._mapWidth; nx++)
-			for (int ny = 0; ny < _downsamplingLayers[l]._mapHeight; ny++) {
-				int ix = nx * _downsamplingLayers[l]._downsampleWidth;
-				int iy = ny * _downsamplingLayers[l]._downsampleHeight;
-
-				// Go through filter
-				float maximum = -999999.0f;
-
-				for (int fx = 0; fx < _downsamplingLayers[l]._downsampleWidth; fx++)
-				for (int fy = 0; fy < _downsamplingLayers[l]._downsampleHeight; fy++) {
-					int tx = ix + fx;
-					int ty = iy + fy;
-
-					// Make sure it is in bounds
-					if (tx < _convolutionLayers[l]._mapWidth && ty < _convolutionLayers[l]._mapHeight)
-						maximum = std::max(maximum, _convolutionLayers[l]._maps[m]._outputs[tx + ty * _convolutionLayers[l]._mapWidth]);
-				}
-
-				_downsamplingLayers[l]._maps[m]._outputs[nx + ny * _downsamplingLayers[l]._mapWidth] = maximum;
-			}
-		}
+		maxPool(_convolutionLayers[l], _downsamplingLayers[l]);
 	}
 }
\ No newline at end of file
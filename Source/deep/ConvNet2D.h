@@ -22,6 +22,8 @@ misrepresented as being the original software.
 #pragma once
 
 #include <deep/RBM.h>
+#include <io/CheckpointWriter.h>
+#include <io/CheckpointReader.h>
 #include <vector>
 #include <random>
 
@@ -100,17 +102,31 @@ namespace deep {
 
 		std::vector<float> _input;
 
+		std::vector<LayerPairDesc> _layerDescs;
+
 		InputLayer _inputLayer;
 
 		std::vector<ConvolutionLayer> _convolutionLayers;
 		std::vector<DownsamplingLayer> _downsamplingLayers;
 
+		// Scratch for convolve, unrolled receptive fields (im2col) and the matching filter matrix
+		std::vector<float> _columns;
+		std::vector<float> _filters;
+
+		void convolve(ConvolutionLayer &layer, const std::vector<const float*> &inputMaps, int inputWidth, int inputHeight);
+		static void maxPool(const ConvolutionLayer &convolutionLayer, DownsamplingLayer &downsamplingLayer);
+
 	public:
+		void create(int inputMapWidth, int inputMapHeight, int inputNumMaps, const std::vector<LayerPairDesc> &layerDescs);
 		void createRandom(int inputMapWidth, int inputMapHeight, int inputNumMaps, const std::vector<LayerPairDesc> &layerDescs, float minWeight, float maxWeight, std::mt19937 &generator);
 
 		void activate();
 		void activateAndLearn(float alpha, std::mt19937 &generator);
 
+		// Binary checkpoint, tensor names start with prefix
+		void writeToCheckpoint(io::CheckpointWriter &writer, const std::string &prefix) const;
+		bool readFromCheckpoint(const io::CheckpointReader &reader, const std::string &prefix);
+
 		int getInputWidth() const {
 			return _inputLayer._mapWidth;
 		}
@@ -1,9 +1,22 @@
 #include <deep/DBN.h>
 
+#include <algorithm>
 #include <assert.h>
 
 using namespace deep;
 
+void DBN::createOutputNodes(int numOutputs, int numInputs) {
+	_outputNodes.resize(numOutputs);
+
+	for (int i = 0; i < _outputNodes.size(); i++) {
+		_outputNodes[i]._weights.resize(numInputs);
+		_outputNodes[i]._prevDWeights.clear();
+		_outputNodes[i]._prevDWeights.assign(numInputs, 0.0f);
+		_outputNodes[i]._accumulatedDWeight.clear();
+		_outputNodes[i]._accumulatedDWeight.assign(numInputs, 0.0f);
+	}
+}
+
 void DBN::createRandom(int numInputs, int numOutputs, const std::vector<int> &rbmNumHiddens, float minWeight, float maxWeight, std::mt19937 &generator) {
 	_rbmLayers.resize(rbmNumHiddens.size());
 	_rbmErrors.resize(rbmNumHiddens.size());
@@ -18,17 +31,11 @@ void DBN::createRandom(int numInputs, int numOutputs, const std::vector<int> &rb
 		prevNumOutputs = rbmNumHiddens[i];
 	}
 
-	_outputNodes.resize(numOutputs);
+	createOutputNodes(numOutputs, prevNumOutputs);
 
 	std::uniform_real_distribution<float> weightDist(minWeight, maxWeight);
 
 	for (int i = 0; i < _outputNodes.size(); i++) {
-		_outputNodes[i]._weights.resize(prevNumOutputs);
-		_outputNodes[i]._prevDWeights.clear();
-		_outputNodes[i]._prevDWeights.assign(prevNumOutputs, 0.0f);
-		_outputNodes[i]._accumulatedDWeight.clear();
-		_outputNodes[i]._accumulatedDWeight.assign(prevNumOutputs, 0.0f);
-
 		_outputNodes[i]._bias = weightDist(generator);
 
 		for (int j = 0; j < _outputNodes[i]._weights.size(); j++)
@@ -75,12 +82,37 @@ void DBN::getOutputMeanThroughLayers(int numLayers, const std::vector<float> &in
 	}
 }
 
-void DBN::prepareForGradientDescent() {
+void DBN::trainLayerUnsupervisedBatch(int layerIndex, const std::vector<float> &inputs, int batchSize, int k, float alpha, std::mt19937 &generator) {
+	assert(inputs.size() == batchSize * _rbmLayers[layerIndex].getNumVisible());
+
+	_rbmLayers[layerIndex].learnBatch(inputs.data(), batchSize, k, alpha, generator);
+}
+
+void DBN::getOutputMeanThroughLayersBatch(int numLayers, const std::vector<float> &inputs, int batchSize, std::vector<float> &means) {
+	means = inputs;
+
+	std::vector<float> layerInputs;
+
+	for (int l = 0; l < numLayers; l++) {
+		layerInputs.swap(means);
+
+		means.resize(batchSize * _rbmLayers[l].getNumHidden());
+
+		_rbmLayers[l].activateLightBatch(layerInputs.data(), batchSize, means.data());
+	}
+}
+
+void DBN::setNumThreads(int numThreads) {
 	for (int l = 0; l < _rbmLayers.size(); l++)
-	for (int i = 0; i < _rbmLayers[l].getNumHidden(); i++)
-	for (int j = 0; j < _rbmLayers[l]._hidden[i]._connections.size(); j++) {
-		_rbmLayers[l]._hidden[i]._connections[j]._positive = 0.0f;
-		_rbmLayers[l]._hidden[i]._connections[j]._negative = 0.0f;
+		_rbmLayers[l].setNumThreads(numThreads);
+}
+
+void DBN::prepareForGradientDescent() {
+	for (int l = 0; l < _rbmLayers.size(); l++) {
+		int size = _rbmLayers[l].getNumHidden() * _rbmLayers[l]._visibleProbabilities.size();
+
+		std::fill(_rbmLayers[l]._positives.begin(), _rbmLayers[l]._positives.begin() + size, 0.0f);
+		std::fill(_rbmLayers[l]._negatives.begin(), _rbmLayers[l]._negatives.begin() + size, 0.0f);
 	}
 }
 
@@ -142,7 +174,7 @@ void DBN::getError(const std::vector<float> &target) {
 			float sum = 0.0f;
 
 			for (int j = 0; j < _rbmErrors[upperLayerIndex].size(); j++)
-				sum += _rbmErrors[upperLayerIndex][j] * _rbmLayers[upperLayerIndex]._hidden[j]._connections[i]._weight;
+				sum += _rbmErrors[upperLayerIndex][j] * _rbmLayers[upperLayerIndex].getWeight(j, i);
 
 			_rbmErrors[l][i] = sum * _rbmLayers[l].getHidden(i) * (1.0f - _rbmLayers[l].getHidden(i));
 		}
@@ -169,15 +201,20 @@ void DBN::moveAlongGradient(float alpha, float momentum, float alphaLayerMulipli
 	for (int l = static_cast<int>(_rbmLayers.size()) - 1; l >= 1; l--) {
 		int lowerLayerIndex = l - 1;
 
+		int numVisible = _rbmLayers[l].getNumVisible();
+
 		for (int i = 0; i < _rbmLayers[l].getNumHidden(); i++) {
-			float dBias = alpha * _rbmErrors[l][i] + _rbmLayers[l]._hidden[i]._connections.back()._positive * momentum;
-			_rbmLayers[l]._hidden[i]._connections.back()._weight += dBias;
-			_rbmLayers[l]._hidden[i]._connections.back()._positive = dBias;
-
-			for (int j = 0; j < _rbmLayers[l]._hidden[i]._connections.size() - 1; j++) {
-				float dWeight = alpha * _rbmErrors[l][i] * _rbmLayers[lowerLayerIndex].getHidden(j) + _rbmLayers[l]._hidden[i]._connections[j]._positive * momentum;
-				_rbmLayers[l]._hidden[i]._connections[j]._weight += dWeight;
-				_rbmLayers[l]._hidden[i]._connections[j]._positive = dWeight;
+			float* pWeights = &_rbmLayers[l]._weights[i * (numVisible + 1)];
+			float* pPrevDWeights = &_rbmLayers[l]._positives[i * (numVisible + 1)];
+
+			float dBias = alpha * _rbmErrors[l][i] + pPrevDWeights[numVisible] * momentum;
+			pWeights[numVisible] += dBias;
+			pPrevDWeights[numVisible] = dBias;
+
+			for (int j = 0; j < numVisible; j++) {
+				float dWeight = alpha * _rbmErrors[l][i] * _rbmLayers[lowerLayerIndex].getHidden(j) + pPrevDWeights[j] * momentum;
+				pWeights[j] += dWeight;
+				pPrevDWeights[j] = dWeight;
 			}
 		}
 
@@ -185,15 +222,20 @@ void DBN::moveAlongGradient(float alpha, float momentum, float alphaLayerMulipli
 	}
 
 	// First RBM
+	int numVisible = _rbmLayers[0].getNumVisible();
+
 	for (int i = 0; i < _rbmLayers[0].getNumHidden(); i++) {
-		float dBias = alpha * _rbmErrors[0][i] + _rbmLayers[0]._hidden[i]._connections.back()._positive * momentum;
-		_rbmLayers[0]._hidden[i]._connections.back()._weight += dBias;
-		_rbmLayers[0]._hidden[i]._connections.back()._positive = dBias;
-
-		for (int j = 0; j < _rbmLayers[0]._hidden[i]._connections.size() - 1; j++) {
-			float dWeight = alpha * _rbmErrors[0][i] * _input[j] + _rbmLayers[0]._hidden[i]._connections[j]._positive * momentum;
-			_rbmLayers[0]._hidden[i]._connections[j]._weight += dWeight;
-			_rbmLayers[0]._hidden[i]._connections[j]._positive = dWeight;
+		float* pWeights = &_rbmLayers[0]._weights[i * (numVisible + 1)];
+		float* pPrevDWeights = &_rbmLayers[0]._positives[i * (numVisible + 1)];
+
+		float dBias = alpha * _rbmErrors[0][i] + pPrevDWeights[numVisible] * momentum;
+		pWeights[numVisible] += dBias;
+		pPrevDWeights[numVisible] = dBias;
+
+		for (int j = 0; j < numVisible; j++) {
+			float dWeight = alpha * _rbmErrors[0][i] * _input[j] + pPrevDWeights[j] * momentum;
+			pWeights[j] += dWeight;
+			pPrevDWeights[j] = dWeight;
 		}
 	}
 }
@@ -220,20 +262,28 @@ void DBN::accumulateGradient() {
 	for (int l = static_cast<int>(_rbmLayers.size()) - 1; l >= 1; l--) {
 		int lowerLayerIndex = l - 1;
 
+		int numVisible = _rbmLayers[l].getNumVisible();
+
 		for (int i = 0; i < _rbmLayers[l].getNumHidden(); i++) {
-			_rbmLayers[l]._hidden[i]._connections.back()._negative += _rbmErrors[l][i];
+			float* pAccumulatedDWeights = &_rbmLayers[l]._negatives[i * (numVisible + 1)];
+
+			pAccumulatedDWeights[numVisible] += _rbmErrors[l][i];
 
-			for (int j = 0; j < _rbmLayers[l]._hidden[i]._connections.size() - 1; j++)
-				_rbmLayers[l]._hidden[i]._connections[j]._negative += _rbmErrors[l][i] * _rbmLayers[lowerLayerIndex].getHidden(j);
+			for (int j = 0; j < numVisible; j++)
+				pAccumulatedDWeights[j] += _rbmErrors[l][i] * _rbmLayers[lowerLayerIndex].getHidden(j);
 		}
 	}
 
 	// First RBM
+	int numVisible = _rbmLayers[0].getNumVisible();
+
 	for (int i = 0; i < _rbmLayers[0].getNumHidden(); i++) {
-		_rbmLayers[0]._hidden[i]._connections.back()._negative += _rbmErrors[0][i];
+		float* pAccumulatedDWeights = &_rbmLayers[0]._negatives[i * (numVisible + 1)];
+
+		pAccumulatedDWeights[numVisible] += _rbmErrors[0][i];
 	
-		for (int j = 0; j < _rbmLayers[0]._hidden[i]._connections.size() - 1; j++)
-			_rbmLayers[0]._hidden[i]._connections[j]._negative += _rbmErrors[0][i] * _input[j];
+		for (int j = 0; j < numVisible; j++)
+			pAccumulatedDWeights[j] += _rbmErrors[0][i] * _input[j];
 	}
 }
 
@@ -250,25 +300,22 @@ void DBN::moveAlongAccumulatedGradient(float alpha) {
 	}
 
 	// All RBMs
-	for (int l = static_cast<int>(_rbmLayers.size()) - 1; l >= 0; l--)
-	for (int i = 0; i < _rbmLayers[l].getNumHidden(); i++) {
-		_rbmLayers[l]._hidden[i]._connections.back()._weight += alpha * _rbmLayers[l]._hidden[i]._connections.back()._negative;
-		_rbmLayers[l]._hidden[i]._connections.back()._negative = 0.0f;
-
-		for (int j = 0; j < _rbmLayers[l]._hidden[i]._connections.size() - 1; j++) {
-			_rbmLayers[l]._hidden[i]._connections[j]._weight += alpha * _rbmLayers[l]._hidden[i]._connections[j]._negative;
-			_rbmLayers[l]._hidden[i]._connections[j]._negative = 0.0f;
+	for (int l = static_cast<int>(_rbmLayers.size()) - 1; l >= 0; l--) {
+		int size = _rbmLayers[l].getNumHidden() * _rbmLayers[l]._visibleProbabilities.size();
+
+		for (int i = 0; i < size; i++) {
+			_rbmLayers[l]._weights[i] += alpha * _rbmLayers[l]._negatives[i];
+			_rbmLayers[l]._negatives[i] = 0.0f;
 		}
 	}
 }
 
 void DBN::decayWeights(float decayMultiplier) {
-	for (int l = 0; l < _rbmLayers.size(); l++)
-	for (int i = 0; i < _rbmLayers[l].getNumHidden(); i++) {
-		_rbmLayers[l]._hidden[i]._connections.back()._weight *= decayMultiplier;
+	for (int l = 0; l < _rbmLayers.size(); l++) {
+		int size = _rbmLayers[l].getNumHidden() * _rbmLayers[l]._visibleProbabilities.size();
 
-		for (int j = 0; j < _rbmLayers[l]._hidden[i]._connections.size() - 1; j++)
-			_rbmLayers[l]._hidden[i]._connections[j]._weight *= decayMultiplier;
+		for (int i = 0; i < size; i++)
+			_rbmLayers[l]._weights[i] *= decayMultiplier;
 	}
 
 	for (int i = 0; i < _outputNodes.size(); i++) {
@@ -286,4 +333,67 @@ void DBN::decayWeightsLastLayerOnly(float decayMultiplier) {
 		for (int j = 0; j < _outputNodes[i]._weights.size(); j++)
 			_outputNodes[i]._weights[j] *= decayMultiplier;
 	}
+}
+
+void DBN::writeToCheckpoint(io::CheckpointWriter &writer, const std::string &prefix) const {
+	int dims[2] = { static_cast<int>(_rbmLayers.size()), static_cast<int>(_outputNodes.size()) };
+
+	writer.addInts(prefix + "dims", dims, 2);
+
+	for (int l = 0; l < _rbmLayers.size(); l++)
+		_rbmLayers[l].writeToCheckpoint(writer, prefix + "rbm" + std::to_string(l) + "/");
+
+	// Output layer as a row-major matrix and a bias vector
+	std::vector<float> outputWeights;
+	std::vector<float> outputBiases(_outputNodes.size());
+
+	for (int i = 0; i < _outputNodes.size(); i++) {
+		outputWeights.insert(outputWeights.end(), _outputNodes[i]._weights.begin(), _outputNodes[i]._weights.end());
+		outputBiases[i] = _outputNodes[i]._bias;
+	}
+
+	writer.addFloats(prefix + "outputWeights", outputWeights);
+	writer.addFloats(prefix + "outputBiases", outputBiases);
+}
+
+bool DBN::readFromCheckpoint(const io::CheckpointReader &reader, const std::string &prefix) {
+	int dims[2];
+
+	if (!reader.readInts(prefix + "dims", dims, 2) || dims[0] < 1)
+		return false;
+
+	_rbmLayers.resize(dims[0]);
+	_rbmErrors.resize(dims[0]);
+
+	for (int l = 0; l < _rbmLayers.size(); l++) {
+		if (!_rbmLayers[l].readFromCheckpoint(reader, prefix + "rbm" + std::to_string(l) + "/"))
+			return false;
+
+		_rbmErrors[l].clear();
+		_rbmErrors[l].assign(_rbmLayers[l].getNumHidden(), 0.0f);
+	}
+
+	int numInputs = _rbmLayers.back().getNumHidden();
+
+	createOutputNodes(dims[1], numInputs);
+
+	size_t count;
+
+	const float* pOutputWeights = reader.getFloats(prefix + "outputWeights", count);
+
+	if (pOutputWeights == nullptr || count != _outputNodes.size() * numInputs)
+		return false;
+
+	const float* pOutputBiases = reader.getFloats(prefix + "outputBiases", count);
+
+	if (pOutputBiases == nullptr || count != _outputNodes.size())
+		return false;
+
+	for (int i = 0; i < _outputNodes.size(); i++) {
+		_outputNodes[i]._weights.assign(pOutputWeights + i * numInputs, pOutputWeights + (i + 1) * numInputs);
+		_outputNodes[i]._bias = pOutputBiases[i];
+		_outputNodes[i]._prevDBias = _outputNodes[i]._accumulatedDBias = 0.0f;
+	}
+
+	return true;
 }
\ No newline at end of file
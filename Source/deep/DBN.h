@@ -52,6 +52,8 @@ namespace deep {
 
 		std::vector<float> _input;
 
+		void createOutputNodes(int numOutputs, int numInputs);
+
 	public:
 		void createRandom(int numInputs, int numOutputs, const std::vector<int> &rbmNumHiddens, float minWeight, float maxWeight, std::mt19937 &generator);
 	
@@ -60,6 +62,17 @@ namespace deep {
 		void getLayerOutputMean(int layerIndex, const std::vector<float> &input, std::vector<float> &mean);
 		void getOutputMeanThroughLayers(int numLayers, const std::vector<float> &input, std::vector<float> &mean);
 
+		// Minibatch versions, inputs hold batchSize rows. Pretraining a layer uses CD-k, see RBM::learnBatch
+		void trainLayerUnsupervisedBatch(int layerIndex, const std::vector<float> &inputs, int batchSize, int k, float alpha, std::mt19937 &generator);
+		void getOutputMeanThroughLayersBatch(int numLayers, const std::vector<float> &inputs, int batchSize, std::vector<float> &means);
+
+		// Binary checkpoint, tensor names start with prefix
+		void writeToCheckpoint(io::CheckpointWriter &writer, const std::string &prefix) const;
+		bool readFromCheckpoint(const io::CheckpointReader &reader, const std::string &prefix);
+
+		// Threads used by the minibatch functions of all layers
+		void setNumThreads(int numThreads);
+
 		void prepareForGradientDescent();
 
 		void execute(const std::vector<float> &input, std::vector<float> &output);
@@ -22,6 +22,7 @@ misrepresented as being the original software.
 #include <deep/FA.h>
 
 #include <list>
+#include <iostream>
 
 using namespace deep;
 
@@ -230,7 +231,7 @@ int FA::createFromWeightsVector(int numInputs, int numOutputs, int numHiddenLaye
 	return weightIndex;
 }
 
-void FA::getWeightsVector(std::vector<float> &weights) {
+void FA::getWeightsVector(std::vector<float> &weights) const {
 	for (int l = 0; l < _hiddenLayers.size(); l++)
 	for (int n = 0; n < _hiddenLayers[l].size(); n++) {
 		for (int w = 0; w < _hiddenLayers[l][n]._connections.size(); w++)
@@ -744,4 +745,49 @@ void FA::readFromStream(std::istream &is) {
 			is >> _outputLayer[n]._bias._weight;
 		}
 	}
+}
+
+void FA::writeToCheckpoint(io::CheckpointWriter &writer, const std::string &prefix) const {
+	int dims[4] = { getNumInputs(), getNumOutputs(), getNumHiddenLayers(), getNumNeuronsPerHiddenLayer() };
+
+	std::vector<float> weights;
+
+	getWeightsVector(weights);
+
+	writer.addInts(prefix + "dims", dims, 4);
+	writer.addFloats(prefix + "weights", weights);
+}
+
+bool FA::readFromCheckpoint(const io::CheckpointReader &reader, const std::string &prefix) {
+	int dims[4];
+
+	std::vector<float> weights;
+
+	if (!reader.readInts(prefix + "dims", dims, 4) || !reader.readFloats(prefix + "weights", weights))
+		return false;
+
+	int numInputs = dims[0];
+	int numOutputs = dims[1];
+	int numHiddenLayers = dims[2];
+	int numNeuronsPerHiddenLayer = dims[3];
+
+	if (numInputs < 1 || numOutputs < 1 || numHiddenLayers < 0 || (numHiddenLayers > 0 && numNeuronsPerHiddenLayer < 1))
+		return false;
+
+	size_t numWeights;
+
+	if (numHiddenLayers > 0)
+		numWeights = (numInputs + 1) * numNeuronsPerHiddenLayer + (numHiddenLayers - 1) * (numNeuronsPerHiddenLayer + 1) * numNeuronsPerHiddenLayer + (numNeuronsPerHiddenLayer + 1) * numOutputs;
+	else
+		numWeights = (numInputs + 1) * numOutputs;
+
+	if (weights.size() != numWeights)
+		return false;
+
+	_hiddenLayers.clear();
+	_outputLayer.clear();
+
+	createFromWeightsVector(numInputs, numOutputs, numHiddenLayers, numNeuronsPerHiddenLayer, weights);
+
+	return true;
 }
\ No newline at end of file
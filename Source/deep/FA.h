@@ -21,6 +21,9 @@ misrepresented as being the original software.
 
 #pragma once
 
+#include <io/CheckpointWriter.h>
+#include <io/CheckpointReader.h>
+
 #include <vector>
 #include <random>
 
@@ -64,7 +67,7 @@ namespace deep {
 
 		// Returns last index of weight vector
 		int createFromWeightsVector(int numInputs, int numOutputs, int numHiddenLayers, int numNeuronsPerHiddenLayer, const std::vector<float> &weights, int startIndex = 0);
-		void getWeightsVector(std::vector<float> &weights);
+		void getWeightsVector(std::vector<float> &weights) const;
 
 		void process(const std::vector<float> &inputs, std::vector<float> &outputs);
 
@@ -82,6 +85,10 @@ namespace deep {
 		void writeToStream(std::ostream &os) const;
 		void readFromStream(std::istream &is);
 
+		// Binary checkpoint of the structure and weights, tensor names start with prefix
+		void writeToCheckpoint(io::CheckpointWriter &writer, const std::string &prefix) const;
+		bool readFromCheckpoint(const io::CheckpointReader &reader, const std::string &prefix);
+
 		static float sigmoid(float x) {
 			return 1.0f / (1.0f + std::exp(-x));
 		}
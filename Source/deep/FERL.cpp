@@ -28,7 +28,7 @@ misrepresented as being the original software.
 using namespace deep;
 
 FERL::FERL()
-: _zInv(1.0f), _prevMax(0.0f), _prevValue(0.0f)
+: _zInv(1.0f), _prevMax(0.0f), _prevValue(0.0f), _numThreads(1)
 {}
 
 void FERL::createRandom(int numState, int numAction, int numHidden, float weightStdDev, std::mt19937 &generator) {
@@ -142,38 +142,55 @@ void FERL::step(const std::vector<float> &state, std::vector<float> &action,
 
 	std::uniform_real_distribution<float> uniformDist(0.0f, 1.0f);
 
-	for (int s = 0; s < actionSearchSamples; s++) {
-		// Start with random inputs
-		for (int j = 0; j < _numAction; j++)
-			_visible[j + _numState]._state = uniformDist(generator) * 2.0f - 1.0f;
+	// Fold the fixed (state and previous hidden) columns into a base activation per hidden unit
+	const int numHidden = _hidden.size();
+	const int hiddenStart = _numState + _numAction;
 
-		activate();
+	_searchBase.resize(numHidden);
+	_searchActionWeights.resize(numHidden * _numAction);
 
-		// Find best action and associated Q value
-		for (int p = 0; p < actionSearchIterations; p++) {
-			for (int j = 0; j < _numAction; j++) {
-				int index = j + _numState;
+	for (int k = 0; k < numHidden; k++) {
+		float sum = _hidden[k]._bias._weight;
 
-				float sum = _visible[index]._bias._weight;
+		for (int i = 0; i < _numState; i++)
+			sum += _hidden[k]._connections[i]._weight * _visible[i]._state;
 
-				for (int k = 0; k < _hidden.size(); k++)
-					sum += _hidden[k]._connections[index]._weight * _hidden[k]._state;
+		for (int i = 0; i < numHidden; i++)
+			sum += _hidden[k]._connections[hiddenStart + i]._weight * prevHidden[i];
 
-				_visible[index]._state = std::min(1.0f, std::max(-1.0f, _visible[index]._state + actionSearchAlpha * sum));
-			}
+		_searchBase[k] = sum;
 
-			// Q value of best action
-			activate();
-		}
+		for (int j = 0; j < _numAction; j++)
+			_searchActionWeights[k * _numAction + j] = _hidden[k]._connections[_numState + j]._weight;
+	}
 
-		float q = value();
+	float fixedVisibleEnergy = 0.0f;
 
-		if (q > nextQ) {
-			nextQ = q;
+	for (int i = 0; i < _numState; i++)
+		fixedVisibleEnergy -= _visible[i]._bias._weight * _visible[i]._state;
 
-			for (int j = 0; j < _numAction; j++)
-				maxAction[j] = _visible[j + _numState]._state;
-		}
+	for (int i = 0; i < numHidden; i++)
+		fixedVisibleEnergy -= _visible[hiddenStart + i]._bias._weight * prevHidden[i];
+
+	// Start with random inputs, drawn up front so the restarts can run in any order
+	_searchActions.resize(actionSearchSamples * _numAction);
+	_searchHidden.resize(actionSearchSamples * numHidden);
+	_searchQ.resize(actionSearchSamples);
+
+	for (int i = 0; i < _searchActions.size(); i++)
+		_searchActions[i] = uniformDist(generator) * 2.0f - 1.0f;
+
+#pragma omp parallel for schedule(static) num_threads(_numThreads)
+	for (int s = 0; s < actionSearchSamples; s++)
+		_searchQ[s] = searchAction(s, actionSearchIterations, actionSearchAlpha, fixedVisibleEnergy);
+
+	// Best action and associated Q value, first restart wins ties
+	for (int s = 0; s < actionSearchSamples; s++)
+	if (_searchQ[s] > nextQ) {
+		nextQ = _searchQ[s];
+
+		for (int j = 0; j < _numAction; j++)
+			maxAction[j] = _searchActions[s * _numAction + j];
 	}
 
 	// Actual action (perturbed from maximum)
@@ -201,52 +218,40 @@ void FERL::step(const std::vector<float> &state, std::vector<float> &action,
 
 	float error = newAdv - _prevValue;
 
-	ReplaySample sample;
+	const int numVisible = _visible.size();
 
-	sample._visible = _prevVisible;
-	sample._q = _prevValue + qAlpha * error;
+	if (_replaySamples.getRowSize() != numVisible + 1)
+		_replaySamples.create(numVisible + 1, maxNumReplaySamples);
+	else
+		_replaySamples.setCapacity(maxNumReplaySamples);
 
 	// Update previous samples
 	float g = gamma;
 
-	for (std::list<ReplaySample>::iterator it = _replaySamples.begin(); it != _replaySamples.end(); it++) {
-		it->_q += qAlpha * g * error;
+	for (int a = 0; a < _replaySamples.size(); a++) {
+		_replaySamples.getRow(a)[numVisible] += qAlpha * g * error;
 
 		g *= gamma;
 	}
 
-	_replaySamples.push_front(sample);
-
-	while (_replaySamples.size() > maxNumReplaySamples)
-		_replaySamples.pop_back();
-
-	// Create buffer for random sample access
-	std::vector<ReplaySample*> pReplaySamples(_replaySamples.size());
+	float* pNewSample = _replaySamples.push();
 
-	int replayIndex = 0;
+	std::copy(_prevVisible.begin(), _prevVisible.end(), pNewSample);
 
-	for (std::list<ReplaySample>::iterator it = _replaySamples.begin(); it != _replaySamples.end(); it++) {
-		pReplaySamples[replayIndex] = &(*it);
-
-		replayIndex++;
-	}
+	pNewSample[numVisible] = _prevValue + qAlpha * error;
 
 	// Update on the chain
-	std::uniform_int_distribution<int> replayDist(0, pReplaySamples.size() - 1);
-
 	for (int r = 0; r < replayIterations; r++) {
-		replayIndex = replayDist(generator);
+		const float* pSample = _replaySamples.getRow(_replaySamples.sampleAgeUniform(generator));
 
-		ReplaySample* pSample = pReplaySamples[replayIndex];
-
-		for (int i = 0; i < _visible.size(); i++)
-			_visible[i]._state = pSample->_visible[i];
+		for (int i = 0; i < numVisible; i++)
+			_visible[i]._state = pSample[i];
 
 		activate();
 
 		float currentQ = value();
 
-		updateOnError(gradientAlpha * (pSample->_q - currentQ), gradientMomentum);
+		updateOnError(gradientAlpha * (pSample[numVisible] - currentQ), gradientMomentum);
 	}
 
 	_prevMax = nextQ;
@@ -269,6 +274,55 @@ void FERL::step(const std::vector<float> &state, std::vector<float> &action,
 	//std::cout << value() << " " << newAdv << " " << action[0] << std::endl;
 }
 
+float FERL::activateSearch(int s) {
+	const float* pAction = &_searchActions[s * _numAction];
+	float* pHidden = &_searchHidden[s * _hidden.size()];
+
+	float energy = 0.0f;
+
+	for (int k = 0; k < _hidden.size(); k++) {
+		const float* pWeights = &_searchActionWeights[k * _numAction];
+
+		float sum = _searchBase[k];
+
+		for (int j = 0; j < _numAction; j++)
+			sum += pWeights[j] * pAction[j];
+
+		pHidden[k] = sigmoid(sum);
+
+		energy -= sum * pHidden[k];
+	}
+
+	return energy;
+}
+
+float FERL::searchAction(int s, int actionSearchIterations, float actionSearchAlpha, float fixedVisibleEnergy) {
+	float* pAction = &_searchActions[s * _numAction];
+	const float* pHidden = &_searchHidden[s * _hidden.size()];
+
+	float hiddenEnergy = activateSearch(s);
+
+	for (int p = 0; p < actionSearchIterations; p++) {
+		for (int j = 0; j < _numAction; j++) {
+			float sum = _visible[_numState + j]._bias._weight;
+
+			for (int k = 0; k < _hidden.size(); k++)
+				sum += _searchActionWeights[k * _numAction + j] * pHidden[k];
+
+			pAction[j] = std::min(1.0f, std::max(-1.0f, pAction[j] + actionSearchAlpha * sum));
+		}
+
+		hiddenEnergy = activateSearch(s);
+	}
+
+	float energy = hiddenEnergy + fixedVisibleEnergy;
+
+	for (int j = 0; j < _numAction; j++)
+		energy -= _visible[_numState + j]._bias._weight * pAction[j];
+
+	return -energy * _zInv;
+}
+
 void FERL::activate() {
 	for (int k = 0; k < _hidden.size(); k++) {
 		float sum = _hidden[k]._bias._weight;
@@ -321,11 +375,13 @@ void FERL::saveToFile(std::ostream &os, bool saveReplayInformation) {
 	if (saveReplayInformation) {
 		os << "t" << _replaySamples.size() << std::endl;
 
-		for (std::list<ReplaySample>::iterator it = _replaySamples.begin(); it != _replaySamples.end(); it++) {
-			for (int i = 0; i < it->_visible.size(); i++)
-				os << it->_visible[i] << " ";
+		for (int a = 0; a < _replaySamples.size(); a++) {
+			const float* pSample = _replaySamples.getRow(a);
+
+			for (int i = 0; i < _visible.size(); i++)
+				os << pSample[i] << " ";
 
-			os << it->_q << std::endl;
+			os << pSample[_visible.size()] << std::endl;
 		}
 	}
 	else
@@ -363,18 +419,16 @@ void FERL::loadFromFile(std::istream &is, bool loadReplayInformation) {
 
 			is >> numSamples;
 
-			for (int i = 0; i < numSamples; i++) {
-				ReplaySample rs;
+			// Samples are stored newest first
+			std::vector<float> samples(numSamples * (numVisible + 1));
 
-				rs._visible.resize(numVisible);
+			for (int i = 0; i < samples.size(); i++)
+				is >> samples[i];
 
-				for (int j = 0; j < numVisible; j++)
-					is >> rs._visible[j];
-				
-				is >> rs._q;
+			_replaySamples.create(numVisible + 1, std::max(numSamples, _replaySamples.getCapacity()));
 
-				_replaySamples.push_back(rs);
-			}
+			for (int i = numSamples - 1; i >= 0; i--)
+				_replaySamples.push(&samples[i * (numVisible + 1)]);
 		}
 		else
 			std::cerr << "Stream does not contain replay information, but the application tried to load it!" << std::endl;
@@ -21,9 +21,11 @@ misrepresented as being the original software.
 
 #pragma once
 
+#include <deep/ReplayMemory.h>
+
 #include <vector>
-#include <list>
 #include <random>
+#include <algorithm>
 #include <string>
 
 namespace deep {
@@ -33,12 +35,6 @@ namespace deep {
 			return 1.0f / (1.0f + std::exp(-x));
 		}
 
-		struct ReplaySample {
-			std::vector<float> _visible;
-
-			float _q;
-		};
-
 	private:
 		struct Connection {
 			float _weight;
@@ -81,7 +77,22 @@ namespace deep {
 
 		std::vector<float> _prevVisible;
 
-		std::list<ReplaySample> _replaySamples;
+		// Replay rows are the visible states followed by the Q target, newest first
+		ReplayMemory _replaySamples;
+
+		int _numThreads;
+
+		// Action search scratch. The state and previous hidden columns are the same for every restart,
+		// so their contribution is folded into _searchBase once per step and a restart only touches the action columns
+		std::vector<float> _searchBase;
+		std::vector<float> _searchActionWeights; // [hidden x action]
+		std::vector<float> _searchActions; // [samples x action]
+		std::vector<float> _searchHidden; // [samples x hidden]
+		std::vector<float> _searchQ;
+
+		// Returns the hidden part of the free energy of restart s
+		float activateSearch(int s);
+		float searchAction(int s, int actionSearchIterations, float actionSearchAlpha, float fixedVisibleEnergy);
 
 	public:
 		FERL();
@@ -132,7 +143,16 @@ namespace deep {
 			return _zInv;
 		}
 
-		const std::list<ReplaySample> &getSamples() const {
+		// Threads used by the action search (OpenMP)
+		void setNumThreads(int numThreads) {
+			_numThreads = std::max(1, numThreads);
+		}
+
+		int getNumThreads() const {
+			return _numThreads;
+		}
+
+		const ReplayMemory &getSamples() const {
 			return _replaySamples;
 		}
 	};
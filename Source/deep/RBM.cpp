@@ -22,84 +22,270 @@ misrepresented as being the original software.
 #include <deep/RBM.h>
 
 #include <iostream>
+#include <algorithm>
+#include <assert.h>
 
 using namespace deep;
 
-void RBM::createRandom(int numVisible, int numHidden, float minWeight, float maxWeight, std::mt19937 &generator) {
-	std::uniform_real_distribution<float> weightDist(minWeight, maxWeight);
+void RBM::create(int numVisible, int numHidden) {
+	_visibleProbabilities.assign(numVisible + 1, 0.0f); // + 1 for bias
 
-	_visible.resize(numVisible + 1); // + 1 for bias
+	_hiddenProbabilities.assign(numHidden + 1, 0.0f); // + 1 for bias
+	_hiddenOutputs.assign(numHidden + 1, 0.0f);
 
-	_hidden.resize(numHidden + 1); // + 1 for bias
+	_weights.assign(_hiddenProbabilities.size() * _visibleProbabilities.size(), 0.0f);
+	_positives.assign(_weights.size(), 0.0f);
+	_negatives.assign(_weights.size(), 0.0f);
 
-	for (int i = 0; i < _hidden.size(); i++) {
-		_hidden[i]._connections.resize(_visible.size());
+	// Bias always outputs 1
+	_visibleProbabilities.back() = 1.0f;
+	_hiddenProbabilities.back() = 1.0f;
+	_hiddenOutputs.back() = 1.0f;
+}
 
-		for (int j = 0; j < _hidden[i]._connections.size(); j++)
-			_hidden[i]._connections[j]._weight = weightDist(generator);
-	}
+void RBM::createRandom(int numVisible, int numHidden, float minWeight, float maxWeight, std::mt19937 &generator) {
+	std::uniform_real_distribution<float> weightDist(minWeight, maxWeight);
 
-	// Bias always outputs 1
-	_visible.back()._probability = 1.0f;
-	_hidden.back()._probability = 1.0f;
-	_hidden.back()._output = 1.0f;
+	create(numVisible, numHidden);
+
+	for (int i = 0; i < _weights.size(); i++)
+		_weights[i] = weightDist(generator);
 }
 
 void RBM::activate(std::mt19937 &generator) {
 	std::uniform_real_distribution<float> dist01(0.0f, 1.0f);
 
-	for (int i = 0; i < _hidden.size(); i++) {
+	int numVisible = _visibleProbabilities.size();
+
+	for (int i = 0; i < _hiddenProbabilities.size(); i++) {
+		const float* pWeights = &_weights[i * numVisible];
+		float* pPositives = &_positives[i * numVisible];
+
 		float sum = 0.0f;
 
-		for (int j = 0; j < _hidden[i]._connections.size(); j++)
-			sum += _hidden[i]._connections[j]._weight * _visible[j]._probability;
+		for (int j = 0; j < numVisible; j++)
+			sum += pWeights[j] * _visibleProbabilities[j];
 
-		_hidden[i]._probability = sigmoid(sum);
-		_hidden[i]._output = dist01(generator) < _hidden[i]._probability ? 1.0f : 0.0f;
+		_hiddenProbabilities[i] = sigmoid(sum);
+		_hiddenOutputs[i] = dist01(generator) < _hiddenProbabilities[i] ? 1.0f : 0.0f;
 
-		for (int j = 0; j < _hidden[i]._connections.size(); j++)
-			_hidden[i]._connections[j]._positive = _hidden[i]._probability * _visible[j]._probability;
+		for (int j = 0; j < numVisible; j++)
+			pPositives[j] = _hiddenProbabilities[i] * _visibleProbabilities[j];
 	}
 }
 
 void RBM::activateLight() {
-	for (int i = 0; i < _hidden.size(); i++) {
+	int numVisible = _visibleProbabilities.size();
+
+	for (int i = 0; i < _hiddenProbabilities.size(); i++) {
+		const float* pWeights = &_weights[i * numVisible];
+
 		float sum = 0.0f;
 
-		for (int j = 0; j < _hidden[i]._connections.size(); j++)
-			sum += _hidden[i]._connections[j]._weight * _visible[j]._probability;
+		for (int j = 0; j < numVisible; j++)
+			sum += pWeights[j] * _visibleProbabilities[j];
 
-		_hidden[i]._probability = sigmoid(sum);
+		_hiddenProbabilities[i] = sigmoid(sum);
 	}
 }
 
 void RBM::learn(float alpha, std::mt19937 &generator) {
-	std::uniform_real_distribution<float> dist01(0.0f, 1.0f);
+	int numVisible = _visibleProbabilities.size();
 
-	for (int i = 0; i < _visible.size(); i++) {
+	for (int i = 0; i < numVisible; i++) {
 		float sum = 0.0f;
 
-		for (int j = 0; j < _hidden.size(); j++)
-			sum += _hidden[j]._connections[i]._weight * _hidden[j]._output;
+		for (int j = 0; j < _hiddenOutputs.size(); j++)
+			sum += _weights[j * numVisible + i] * _hiddenOutputs[j];
 
-		_visible[i]._probability = sigmoid(sum);
+		_visibleProbabilities[i] = sigmoid(sum);
 	}
 
-	_visible.back()._probability = 1.0f;
+	_visibleProbabilities.back() = 1.0f;
+
+	for (int i = 0; i < _hiddenProbabilities.size(); i++) {
+		const float* pWeights = &_weights[i * numVisible];
+		float* pNegatives = &_negatives[i * numVisible];
 
-	for (int i = 0; i < _hidden.size(); i++) {
 		float sum = 0.0f;
 
-		for (int j = 0; j < _hidden[i]._connections.size(); j++)
-			sum += _hidden[i]._connections[j]._weight * _visible[j]._probability;
+		for (int j = 0; j < numVisible; j++)
+			sum += pWeights[j] * _visibleProbabilities[j];
+
+		_hiddenProbabilities[i] = sigmoid(sum);
+
+		for (int j = 0; j < numVisible; j++)
+			pNegatives[j] = _hiddenProbabilities[i] * _visibleProbabilities[j];
+	}
+
+	for (int i = 0; i < _weights.size(); i++)
+		_weights[i] += alpha * (_positives[i] - _negatives[i]);
+}
+
+void RBM::transposeWeights(const std::vector<float> &weights, int numVisible, int numHidden, std::vector<float> &weightsTransposed) {
+	weightsTransposed.resize(weights.size());
+
+	for (int i = 0; i < numHidden; i++)
+	for (int j = 0; j < numVisible; j++)
+		weightsTransposed[j * numHidden + i] = weights[i * numVisible + j];
+}
+
+void RBM::activateHiddenBatch(const std::vector<float> &weightsTransposed, const float* visible, int batchSize, int numVisible, int numHidden, float* hidden, int hiddenStride, int numThreads) {
+	// Visible rows and weightsTransposed include the bias units, only the first numHidden - 1 hidden units are written.
+	// Sums run over the visible units in order like activateLight, one row of weights at a time so zero inputs can be skipped
+#pragma omp parallel for schedule(static) num_threads(numThreads)
+	for (int s = 0; s < batchSize; s++) {
+		const float* pVisible = visible + s * numVisible;
+		float* pHidden = hidden + s * hiddenStride;
+
+		std::fill(pHidden, pHidden + numHidden - 1, 0.0f);
+
+		for (int j = 0; j < numVisible; j++)
+		if (pVisible[j] != 0.0f) {
+			const float* pWeights = &weightsTransposed[j * numHidden];
+
+			for (int i = 0; i < numHidden - 1; i++)
+				pHidden[i] += pWeights[i] * pVisible[j];
+		}
+
+		for (int i = 0; i < numHidden - 1; i++)
+			pHidden[i] = sigmoid(pHidden[i]);
+	}
+}
+
+void RBM::activateLightBatch(const float* visible, int batchSize, float* hidden) const {
+	int numVisible = _visibleProbabilities.size();
+
+	// Append the bias to every row
+	std::vector<float> batchVisible(batchSize * numVisible);
+
+	for (int s = 0; s < batchSize; s++) {
+		std::copy(visible + s * (numVisible - 1), visible + (s + 1) * (numVisible - 1), &batchVisible[s * numVisible]);
+
+		batchVisible[(s + 1) * numVisible - 1] = 1.0f;
+	}
+
+	std::vector<float> weightsTransposed;
+
+	transposeWeights(_weights, numVisible, _hiddenProbabilities.size(), weightsTransposed);
 
-		_hidden[i]._probability = sigmoid(sum);
+	activateHiddenBatch(weightsTransposed, batchVisible.data(), batchSize, numVisible, _hiddenProbabilities.size(), hidden, getNumHidden(), _numThreads);
+}
+
+void RBM::learnBatch(const float* visible, int batchSize, int k, float alpha, std::mt19937 &generator) {
+	assert(k >= 1);
+
+	int numVisible = _visibleProbabilities.size();
+	int numHidden = _hiddenProbabilities.size();
+
+	// All rows include the bias units
+	_batchVisible.resize(batchSize * numVisible);
+	_batchHidden.resize(batchSize * numHidden);
+	_batchHiddenStates.resize(batchSize * numHidden);
+	_batchReconstruction.resize(batchSize * numVisible);
+	_batchReconstructionHidden.resize(batchSize * numHidden);
+
+	_batchGenerators.resize(batchSize);
 
-		for (int j = 0; j < _hidden[i]._connections.size(); j++)
-			_hidden[i]._connections[j]._negative = _hidden[i]._probability * _visible[j]._probability;
+	for (int s = 0; s < batchSize; s++) {
+		std::copy(visible + s * (numVisible - 1), visible + (s + 1) * (numVisible - 1), &_batchVisible[s * numVisible]);
+
+		_batchVisible[(s + 1) * numVisible - 1] = 1.0f;
+		_batchHidden[(s + 1) * numHidden - 1] = 1.0f;
+		_batchReconstructionHidden[(s + 1) * numHidden - 1] = 1.0f;
+
+		_batchGenerators[s].seed(generator());
 	}
 
-	for (int i = 0; i < _hidden.size(); i++)
-	for (int j = 0; j < _hidden[i]._connections.size(); j++)
-		_hidden[i]._connections[j]._weight += alpha * (_hidden[i]._connections[j]._positive - _hidden[i]._connections[j]._negative);
+	// Positive phase
+	transposeWeights(_weights, numVisible, numHidden, _weightsTransposed);
+
+	activateHiddenBatch(_weightsTransposed, _batchVisible.data(), batchSize, numVisible, numHidden, _batchHidden.data(), numHidden, _numThreads);
+
+	const float* pHidden = _batchHidden.data();
+
+	for (int step = 0; step < k; step++) {
+		// Sample hidden states, each sample from its own stream
+#pragma omp parallel for schedule(static) num_threads(_numThreads)
+		for (int s = 0; s < batchSize; s++) {
+			std::uniform_real_distribution<float> dist01(0.0f, 1.0f);
+
+			for (int i = 0; i < numHidden - 1; i++)
+				_batchHiddenStates[s * numHidden + i] = dist01(_batchGenerators[s]) < pHidden[s * numHidden + i] ? 1.0f : 0.0f;
+
+			_batchHiddenStates[(s + 1) * numHidden - 1] = 1.0f;
+		}
+
+		// Reconstruct visible probabilities from the binary hidden states, only active units contribute
+#pragma omp parallel for schedule(static) num_threads(_numThreads)
+		for (int s = 0; s < batchSize; s++) {
+			float* pReconstruction = &_batchReconstruction[s * numVisible];
+
+			std::fill(pReconstruction, pReconstruction + numVisible, 0.0f);
+
+			for (int i = 0; i < numHidden; i++)
+			if (_batchHiddenStates[s * numHidden + i] != 0.0f) {
+				const float* pWeights = &_weights[i * numVisible];
+
+				for (int j = 0; j < numVisible; j++)
+					pReconstruction[j] += pWeights[j];
+			}
+
+			for (int j = 0; j < numVisible - 1; j++)
+				pReconstruction[j] = sigmoid(pReconstruction[j]);
+
+			pReconstruction[numVisible - 1] = 1.0f;
+		}
+
+		activateHiddenBatch(_weightsTransposed, _batchReconstruction.data(), batchSize, numVisible, numHidden, _batchReconstructionHidden.data(), numHidden, _numThreads);
+
+		pHidden = _batchReconstructionHidden.data();
+	}
+
+	// Statistics summed over the batch in sample order, each thread owns a range of hidden rows
+	float batchAlpha = alpha / batchSize;
+
+#pragma omp parallel for schedule(static) num_threads(_numThreads)
+	for (int i = 0; i < numHidden; i++) {
+		float* pWeights = &_weights[i * numVisible];
+		float* pPositives = &_positives[i * numVisible];
+		float* pNegatives = &_negatives[i * numVisible];
+
+		std::fill(pPositives, pPositives + numVisible, 0.0f);
+		std::fill(pNegatives, pNegatives + numVisible, 0.0f);
+
+		for (int s = 0; s < batchSize; s++) {
+			float positive = _batchHidden[s * numHidden + i];
+			float negative = _batchReconstructionHidden[s * numHidden + i];
+
+			const float* pVisible = &_batchVisible[s * numVisible];
+			const float* pReconstruction = &_batchReconstruction[s * numVisible];
+
+			for (int j = 0; j < numVisible; j++) {
+				pPositives[j] += positive * pVisible[j];
+				pNegatives[j] += negative * pReconstruction[j];
+			}
+		}
+
+		for (int j = 0; j < numVisible; j++)
+			pWeights[j] += batchAlpha * (pPositives[j] - pNegatives[j]);
+	}
+}
+
+void RBM::writeToCheckpoint(io::CheckpointWriter &writer, const std::string &prefix) const {
+	int dims[2] = { getNumVisible(), getNumHidden() };
+
+	writer.addInts(prefix + "dims", dims, 2);
+	writer.addFloats(prefix + "weights", _weights);
+}
+
+bool RBM::readFromCheckpoint(const io::CheckpointReader &reader, const std::string &prefix) {
+	int dims[2];
+
+	if (!reader.readInts(prefix + "dims", dims, 2))
+		return false;
+
+	create(dims[0], dims[1]);
+
+	return reader.readFloats(prefix + "weights", _weights.data(), _weights.size());
 }
\ No newline at end of file
@@ -21,6 +21,9 @@ misrepresented as being the original software.
 
 #pragma once
 
+#include <io/CheckpointWriter.h>
+#include <io/CheckpointReader.h>
+
 #include <vector>
 #include <random>
 
@@ -32,61 +35,82 @@ namespace deep {
 		}
 
 	private:
-		struct Connection {
-			float _weight;
-			float _positive;
-			float _negative;
-
-			Connection()
-				: _positive(0.0f),
-				_negative(0.0f)
-			{}
-		};
+		// Row-major (hidden x visible) matrices, both including a bias unit as the last entry.
+		// _positives and _negatives hold the contrastive divergence statistics (DBN reuses them for momentum and gradient accumulation)
+		std::vector<float> _weights;
+		std::vector<float> _positives;
+		std::vector<float> _negatives;
+
+		std::vector<float> _visibleProbabilities;
+		std::vector<float> _hiddenProbabilities;
+		std::vector<float> _hiddenOutputs;
+
+		// Minibatch scratch, one row per sample
+		std::vector<float> _weightsTransposed;
+		std::vector<float> _batchVisible;
+		std::vector<float> _batchHidden;
+		std::vector<float> _batchHiddenStates;
+		std::vector<float> _batchReconstruction;
+		std::vector<float> _batchReconstructionHidden;
+		std::vector<std::mt19937> _batchGenerators;
+
+		int _numThreads;
+
+		static void transposeWeights(const std::vector<float> &weights, int numVisible, int numHidden, std::vector<float> &weightsTransposed);
+		static void activateHiddenBatch(const std::vector<float> &weightsTransposed, const float* visible, int batchSize, int numVisible, int numHidden, float* hidden, int hiddenStride, int numThreads);
 
-		struct HiddenNode {
-			std::vector<Connection> _connections;
+	public:
+		RBM()
+			: _numThreads(1)
+		{}
 
-			float _output;
-			float _probability;
+		void create(int numVisible, int numHidden);
+		void createRandom(int numVisible, int numHidden, float minWeight, float maxWeight, std::mt19937 &generator);
 
-			HiddenNode()
-				: _output(0.0f), _probability(0.0f)
-			{}
-		};
+		void activate(std::mt19937 &generator);
+		void activateLight();
 
-		struct VisibleNode {
-			float _probability;
+		void learn(float alpha, std::mt19937 &generator);
 
-			VisibleNode()
-				: _probability(0.0f)
-			{}
-		};
+		// Hidden probabilities for batchSize visible vectors. Visible is batchSize rows of getNumVisible() values,
+		// hidden receives batchSize rows of getNumHidden() values. Same results as setVisible + activateLight per sample
+		void activateLightBatch(const float* visible, int batchSize, float* hidden) const;
 
-		std::vector<VisibleNode> _visible;
-		std::vector<HiddenNode> _hidden;
+		// Minibatch CD-k, the weight change is averaged over the batch. Bias units are fixed at 1.
+		// Every sample gets its own random stream seeded from generator, so results do not depend on the number of threads
+		void learnBatch(const float* visible, int batchSize, int k, float alpha, std::mt19937 &generator);
 
-	public:
-		void createRandom(int numVisible, int numHidden, float minWeight, float maxWeight, std::mt19937 &generator);
+		// Binary checkpoint, tensor names start with prefix. Only the weights are stored
+		void writeToCheckpoint(io::CheckpointWriter &writer, const std::string &prefix) const;
+		bool readFromCheckpoint(const io::CheckpointReader &reader, const std::string &prefix);
 
-		void activate(std::mt19937 &generator);
-		void activateLight();
+		// Threads used by the batch functions (OpenMP)
+		void setNumThreads(int numThreads) {
+			_numThreads = numThreads < 1 ? 1 : numThreads;
+		}
 
-		void learn(float alpha, std::mt19937 &generator);
+		int getNumThreads() const {
+			return _numThreads;
+		}
 
 		void setVisible(int index, float value) {
-			_visible[index]._probability = value;
+			_visibleProbabilities[index] = value;
 		}
 
 		float getHidden(int index) const {
-			return _hidden[index]._probability;
+			return _hiddenProbabilities[index];
+		}
+
+		float getWeight(int hiddenIndex, int visibleIndex) const {
+			return _weights[hiddenIndex * _visibleProbabilities.size() + visibleIndex];
 		}
 
 		int getNumVisible() const {
-			return _visible.size() - 1; // -1 to account for bias
+			return _visibleProbabilities.size() - 1; // -1 to account for bias
 		}
 
 		int getNumHidden() const {
-			return _hidden.size() - 1; // -1 to account for bias
+			return _hiddenProbabilities.size() - 1; // -1 to account for bias
 		}
 
 		friend class DBN;
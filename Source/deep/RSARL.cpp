@@ -121,77 +121,68 @@ void RSARL::step(float reward, int actionSamples, int experienceSamples, float r
 	input[_numInputs + _outputs.size()] = newQ;
 	maxInput[_numInputs + _outputs.size()] = _prevValue;
 
+	const int numHidden = _rsa.getNumHiddenNodes();
+	const int numVisible = _rsa.getNumVisibleNodes();
+	const int qIndex = _numInputs + _outputs.size();
+
+	if (_experiences.getRowSize() != numHidden + numVisible * 2)
+		_experiences.create(numHidden + numVisible * 2, _experienceBufferLength);
+	else
+		_experiences.setCapacity(_experienceBufferLength);
+
 	// Propagate Q down chain
 	float g = qGamma;
 
-	for (std::list<Experience>::iterator it = _experiences.begin(); it != _experiences.end(); it++) {
-		it->_visibleStates[_numInputs + _outputs.size()] += qAlpha * tdError * g;
+	for (int a = 0; a < _experiences.size(); a++) {
+		_experiences.getRow(a)[numHidden + numVisible + qIndex] += qAlpha * tdError * g;
 
 		g *= qGamma;
 	}
 
 	// Push new experience
-	Experience experience;
-	experience._hiddenStates.resize(_rsa.getNumHiddenNodes());
-
-	for (int h = 0; h < _rsa.getNumHiddenNodes(); h++)
-		experience._hiddenStates[h] = _rsa.getHiddenNodeState(h);
-
-	experience._maxVisibleStates = maxInput;
-	experience._visibleStates = input;
+	float* pExperience = _experiences.push();
 
-	_experiences.push_front(experience);
+	for (int h = 0; h < numHidden; h++)
+		pExperience[h] = _rsa.getHiddenNodeState(h);
 
-	while (_experiences.size() > _experienceBufferLength)
-		_experiences.pop_back();
+	std::copy(maxInput.begin(), maxInput.end(), pExperience + numHidden);
+	std::copy(input.begin(), input.end(), pExperience + numHidden + numVisible);
 
 	_prevValue = nextQ;
 
-	// Transform chain to get random access
-	std::vector<std::list<Experience>::iterator> expIters(_experiences.size());
-
-	int index = 0;
+	if (_experiences.size() > 2) {
+		std::uniform_int_distribution<int> sampleDist(0, std::max(0, _experiences.size() - 3));
 
-	for (std::list<Experience>::iterator it = _experiences.begin(); it != _experiences.end(); it++)
-		expIters[index++] = it;
+		RecurrentSparseAutoencoder::Experience &rsaExp = _rsaExperience;
 
-	if (expIters.size() > 2) {
-		std::uniform_int_distribution<int> sampleDist(0, std::max(0, static_cast<int>(expIters.size()) - 3));
+		rsaExp._hiddenStatesPrevPrev.resize(numHidden);
+		rsaExp._visibleStatesPrev.resize(numVisible);
+		rsaExp._hiddenStatesPrev.resize(numHidden);
+		rsaExp._visibleStates.resize(numVisible);
 
 		for (int i = 0; i < experienceSamples; i++) {
 			int j = sampleDist(generator);
 
-			RecurrentSparseAutoencoder::Experience rsaExp;
-
-			if (j >= static_cast<int>(expIters.size()) - 3)
-				rsaExp._hiddenStatesPrevPrev.assign(_rsa.getNumHiddenNodes(), 0.0f);
+			if (j >= _experiences.size() - 3)
+				std::fill(rsaExp._hiddenStatesPrevPrev.begin(), rsaExp._hiddenStatesPrevPrev.end(), 0.0f);
 			else {
-				rsaExp._hiddenStatesPrevPrev.resize(_rsa.getNumHiddenNodes());
+				const float* pPrevPrev = _experiences.getRow(j + 3);
 
-				for (int k = 0; k < _rsa.getNumHiddenNodes(); k++)
-					rsaExp._hiddenStatesPrevPrev[k] = expIters[j + 3]->_hiddenStates[k];
+				std::copy(pPrevPrev, pPrevPrev + numHidden, rsaExp._hiddenStatesPrevPrev.begin());
 			}
 
-			rsaExp._visibleStatesPrev.resize(_rsa.getNumVisibleNodes());
-
-			for (int k = 0; k < _rsa.getNumVisibleNodes(); k++)
-				rsaExp._visibleStatesPrev[k] = expIters[j + 2]->_maxVisibleStates[k];
-
-			rsaExp._hiddenStatesPrev.resize(_rsa.getNumHiddenNodes());
+			const float* pPrev = _experiences.getRow(j + 2);
 
-			for (int k = 0; k < _rsa.getNumHiddenNodes(); k++)
-				rsaExp._hiddenStatesPrev[k] = expIters[j + 2]->_hiddenStates[k];
+			std::copy(pPrev + numHidden, pPrev + numHidden + numVisible, rsaExp._visibleStatesPrev.begin());
+			std::copy(pPrev, pPrev + numHidden, rsaExp._hiddenStatesPrev.begin());
 
-			rsaExp._visibleStates.resize(_rsa.getNumVisibleNodes());
+			const float* pNext = _experiences.getRow(j + 1);
+			const float* pCurrent = _experiences.getRow(j);
 
-			if (expIters[j + 1]->_visibleStates[_numInputs + _outputs.size()] > expIters[j + 1]->_maxVisibleStates[_numInputs + _outputs.size()]) {
-				for (int k = 0; k < _rsa.getNumVisibleNodes(); k++)
-					rsaExp._visibleStates[k] = expIters[j]->_visibleStates[k];
-			}
-			else {	
-				for (int k = 0; k < _rsa.getNumVisibleNodes(); k++)
-					rsaExp._visibleStates[k] = expIters[j]->_maxVisibleStates[k];
-			}
+			if (pNext[numHidden + numVisible + qIndex] > pNext[numHidden + qIndex])
+				std::copy(pCurrent + numHidden + numVisible, pCurrent + numHidden + numVisible * 2, rsaExp._visibleStates.begin());
+			else
+				std::copy(pCurrent + numHidden, pCurrent + numHidden + numVisible, rsaExp._visibleStates.begin());
 
 			_rsa.learnExperience(rsaExp, _sparsity, rsaStateLeak, rsaAlpha, rsaBeta, rsaGamma, rsaEpsilon, rsaMomentum, 1.0f, 1.0f);
 		}
@@ -1,6 +1,5 @@
 #include <deep/RecurrentSparseAutoencoder.h>
-
-#include <list>
+#include <deep/ReplayMemory.h>
 
 namespace deep {
 	class RSARL {
@@ -14,15 +13,6 @@ namespace deep {
 			{}
 		};*/
 
-		struct Experience {
-			std::vector<float> _hiddenStates;
-			std::vector<float> _maxVisibleStates;
-			std::vector<float> _visibleStates;
-			
-			//float _originalQ;
-			//float _q;
-		};
-
 		deep::RecurrentSparseAutoencoder _rsa;
 
 		float _prevValue;
@@ -34,7 +24,11 @@ namespace deep {
 		std::vector<float> _outputs;
 		std::vector<float> _maxOutputs;
 
-		std::list<Experience> _experiences;
+		// Experience rows are the hidden states, the maximum visible states and the visible states, newest first
+		ReplayMemory _experiences;
+
+		// Reused for learning from experiences
+		RecurrentSparseAutoencoder::Experience _rsaExperience;
 
 		void dqOverDo(std::vector<float> &deltaO);
 
@@ -0,0 +1,156 @@
+/*
+AI Lib
+Copyright (C) 2014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#include <deep/ReplayMemory.h>
+
+#include <algorithm>
+
+#include <assert.h>
+
+using namespace deep;
+
+void ReplayMemory::create(int rowSize, int capacity) {
+	_rowSize = rowSize;
+	_capacity = std::max(1, capacity);
+
+	_rows.assign(_capacity * _rowSize, 0.0f);
+
+	_numLeaves = 1;
+
+	while (_numLeaves < _capacity)
+		_numLeaves *= 2;
+
+	_priorities.assign(_numLeaves * 2, 0.0f);
+
+	_size = 0;
+	_head = -1;
+}
+
+void ReplayMemory::setCapacity(int capacity) {
+	capacity = std::max(1, capacity);
+
+	if (capacity == _capacity)
+		return;
+
+	// Rebuild with the newest rows, oldest first so that they keep their age order
+	int numKept = std::min(_size, capacity);
+
+	std::vector<float> rows(numKept * _rowSize);
+	std::vector<float> priorities(numKept);
+
+	for (int a = 0; a < numKept; a++) {
+		std::copy(getRow(a), getRow(a) + _rowSize, rows.begin() + a * _rowSize);
+
+		priorities[a] = getPriority(getSlot(a));
+	}
+
+	create(_rowSize, capacity);
+
+	for (int a = numKept - 1; a >= 0; a--)
+		push(&rows[a * _rowSize], priorities[a]);
+}
+
+void ReplayMemory::clear() {
+	std::fill(_priorities.begin(), _priorities.end(), 0.0f);
+
+	_size = 0;
+	_head = -1;
+}
+
+float* ReplayMemory::push(float priority) {
+	assert(_capacity > 0);
+
+	// When full, the slot after the newest one holds the oldest row
+	_head = (_head + 1) % _capacity;
+
+	if (_size < _capacity)
+		_size++;
+
+	setPriority(_head, priority);
+
+	return &_rows[_head * _rowSize];
+}
+
+void ReplayMemory::push(const float* row, float priority) {
+	float* pRow = push(priority);
+
+	std::copy(row, row + _rowSize, pRow);
+}
+
+void ReplayMemory::setPriority(int slot, float priority) {
+	int node = _numLeaves + slot;
+
+	_priorities[node] = priority;
+
+	// Parents are recomputed from their children instead of adding differences, so rounding errors do not build up
+	for (node /= 2; node >= 1; node /= 2)
+		_priorities[node] = _priorities[node * 2] + _priorities[node * 2 + 1];
+}
+
+int ReplayMemory::sampleAgeUniform(std::mt19937 &generator) const {
+	assert(_size > 0);
+
+	std::uniform_int_distribution<int> ageDist(0, _size - 1);
+
+	return ageDist(generator);
+}
+
+int ReplayMemory::sampleSlotPrioritized(std::mt19937 &generator) const {
+	assert(_size > 0 && getTotalPriority() > 0.0f);
+
+	std::uniform_real_distribution<float> priorityDist(0.0f, getTotalPriority());
+
+	float value = priorityDist(generator);
+
+	int node = 1;
+
+	while (node < _numLeaves) {
+		int left = node * 2;
+
+		// Rounding can leave value slightly above the total, never descend into an empty subtree
+		if (value < _priorities[left] || _priorities[left + 1] <= 0.0f)
+			node = left;
+		else {
+			value -= _priorities[left];
+
+			node = left + 1;
+		}
+	}
+
+	return node - _numLeaves;
+}
+
+void ReplayMemory::sampleBatch(int batchSize, bool prioritized, std::mt19937 &generator, std::vector<int> &slots, std::vector<float> &batch) const {
+	slots.resize(batchSize);
+
+	for (int i = 0; i < batchSize; i++)
+		slots[i] = prioritized ? sampleSlotPrioritized(generator) : getSlot(sampleAgeUniform(generator));
+
+	gather(slots, batch);
+}
+
+void ReplayMemory::gather(const std::vector<int> &slots, std::vector<float> &batch) const {
+	batch.resize(slots.size() * _rowSize);
+
+	for (int i = 0; i < slots.size(); i++)
+		std::copy(getSlotRow(slots[i]), getSlotRow(slots[i]) + _rowSize, batch.begin() + i * _rowSize);
+}
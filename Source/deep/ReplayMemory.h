@@ -0,0 +1,122 @@
+/*
+AI Lib
+Copyright (C) 2014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+
+#pragma once
+
+#include <vector>
+#include <random>
+
+namespace deep {
+	// Replay memory of fixed width float rows in a preallocated ring buffer.
+	// Rows are addressed by slot (position in the buffer) or by age (0 is the most recently pushed row).
+	// Every slot has a priority kept in a sum tree, so prioritized sampling is O(log capacity). Empty slots have priority 0
+	class ReplayMemory {
+	private:
+		int _rowSize;
+		int _capacity;
+		int _size;
+
+		// Slot of the newest row
+		int _head;
+
+		std::vector<float> _rows;
+
+		// Sum tree over the slot priorities, node 1 is the root and the leaves start at _numLeaves
+		int _numLeaves;
+		std::vector<float> _priorities;
+
+	public:
+		ReplayMemory()
+			: _rowSize(0), _capacity(0), _size(0), _head(-1), _numLeaves(0)
+		{}
+
+		void create(int rowSize, int capacity);
+
+		// Keeps the newest rows that fit
+		void setCapacity(int capacity);
+
+		void clear();
+
+		// Makes room for a new newest row (dropping the oldest one when full) and returns it for filling
+		float* push(float priority = 1.0f);
+		void push(const float* row, float priority = 1.0f);
+
+		void setPriority(int slot, float priority);
+
+		float getPriority(int slot) const {
+			return _priorities[_numLeaves + slot];
+		}
+
+		float getTotalPriority() const {
+			return _priorities.empty() ? 0.0f : _priorities[1];
+		}
+
+		int sampleAgeUniform(std::mt19937 &generator) const;
+
+		// Returns a slot with probability proportional to its priority
+		int sampleSlotPrioritized(std::mt19937 &generator) const;
+
+		// Draws batchSize slots and copies their rows into batch, one row after the other
+		void sampleBatch(int batchSize, bool prioritized, std::mt19937 &generator, std::vector<int> &slots, std::vector<float> &batch) const;
+		void gather(const std::vector<int> &slots, std::vector<float> &batch) const;
+
+		int getSlot(int age) const {
+			return (_head - age + _capacity) % _capacity;
+		}
+
+		int getAge(int slot) const {
+			return (_head - slot + _capacity) % _capacity;
+		}
+
+		float* getRow(int age) {
+			return &_rows[getSlot(age) * _rowSize];
+		}
+
+		const float* getRow(int age) const {
+			return &_rows[getSlot(age) * _rowSize];
+		}
+
+		float* getSlotRow(int slot) {
+			return &_rows[slot * _rowSize];
+		}
+
+		const float* getSlotRow(int slot) const {
+			return &_rows[slot * _rowSize];
+		}
+
+		int getRowSize() const {
+			return _rowSize;
+		}
+
+		int getCapacity() const {
+			return _capacity;
+		}
+
+		int size() const {
+			return _size;
+		}
+
+		bool empty() const {
+			return _size == 0;
+		}
+	};
+}
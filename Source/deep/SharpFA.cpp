@@ -22,6 +22,7 @@ misrepresented as being the original software.
 #include <deep/SharpFA.h>
 
 #include <list>
+#include <iostream>
 
 using namespace deep;
 
@@ -24,6 +24,10 @@
  *
  * $Id: dirent.h,v 1.20 2014/03/19 17:52:23 tronkko Exp $
  */
+#if !defined(_MSC_VER)
+/* Other platforms provide a native dirent.h */
+#   include_next <dirent.h>
+#else
 #ifndef DIRENT_H
 #define DIRENT_H
 
@@ -835,4 +839,5 @@ dirent_set_errno(
 }
 #endif
 #endif /*DIRENT_H*/
+#endif /*_MSC_VER*/
 
@@ -5,8 +5,20 @@
 
 using namespace dnf;
 
+void Field::NodeStates::resize(int numNodes) {
+	_activationE.resize(numNodes);
+	_outputE.resize(numNodes);
+	_averageRateE.resize(numNodes);
+	_bdnfE.resize(numNodes);
+
+	_activationI.resize(numNodes);
+	_outputI.resize(numNodes);
+
+	_hE.resize(numNodes);
+}
+
 Field::Field()
-: _hI(0.0f)
+: _current(0), _numThreads(1), _hI(0.0f)
 {}
 
 void Field::createRandom(int numInputs, int size, int weightRadius, float weightDeviation, float minWeight, float maxWeight, std::mt19937 &generator) {
@@ -22,47 +34,50 @@ void Field::createRandom(int numInputs, int size, int weightRadius, float weight
 		_inputData[i]._bdnf = 1.0f;
 	}
 
-	_nodes.resize(_size * _size);
+	int numNodes = _size * _size;
+
+	_current = 0;
+
+	_states[0].resize(numNodes);
+	_states[1].resize(numNodes);
 
 	int weightDimSize = _weightRadius * 2 + 1;
 	int numWeights = weightDimSize * weightDimSize;
 
-	std::uniform_real_distribution<float> distWeight(minWeight, maxWeight);
+	_weeWeights.resize(numNodes * numWeights);
+	_weiWeights.resize(numNodes * numWeights);
+	_wieWeights.resize(numNodes * numWeights);
 
-	for (size_t n = 0; n < _nodes.size(); n++) {
-		_nodes[n]._activationE = 0.0f;
-		_nodes[n]._outputE = 0.5f;
-		_nodes[n]._averageRateE = 0.5f;
-		_nodes[n]._bdnfE = 1.0f;
+	_weeTraces.assign(numNodes * numWeights, 0.0f);
+	_weiTraces.assign(numNodes * numWeights, 0.0f);
+	_wieTraces.assign(numNodes * numWeights, 0.0f);
 
-		_nodes[n]._activationI = 0.0f;
-		_nodes[n]._outputI = 0.5f;
-		//_nodes[n]._averageRateI = 0.5f;
-		//_nodes[n]._bdnfI = 1.0f;
+	_wextWeights.resize(numNodes * _numInputs);
+	_wextTraces.assign(numNodes * _numInputs, 0.0f);
 
-		_nodes[n]._hE = distWeight(generator);
-
-		_nodes[n]._wee.resize(numWeights);
-		_nodes[n]._wei.resize(numWeights);
-		_nodes[n]._wie.resize(numWeights);
+	std::uniform_real_distribution<float> distWeight(minWeight, maxWeight);
 
-		_nodes[n]._wext.resize(_numInputs);
+	NodeStates &states = _states[_current];
 
-		for (int w = 0; w < numWeights; w++) {
-			_nodes[n]._wee[w]._weight = distWeight(generator);
-			_nodes[n]._wei[w]._weight = distWeight(generator);
-			_nodes[n]._wie[w]._weight = distWeight(generator);
+	for (int n = 0; n < numNodes; n++) {
+		states._activationE[n] = 0.0f;
+		states._outputE[n] = 0.5f;
+		states._averageRateE[n] = 0.5f;
+		states._bdnfE[n] = 1.0f;
 
-			_nodes[n]._wee[w]._eligibilityTrace = 0.0f;
-			_nodes[n]._wei[w]._eligibilityTrace = 0.0f;
-			_nodes[n]._wie[w]._eligibilityTrace = 0.0f;
-		}
+		states._activationI[n] = 0.0f;
+		states._outputI[n] = 0.5f;
 
-		for (int w = 0; w < _numInputs; w++) {
-			_nodes[n]._wext[w]._weight = distWeight(generator);
+		states._hE[n] = distWeight(generator);
 
-			_nodes[n]._wext[w]._eligibilityTrace = 0.0f;
+		for (int w = 0; w < numWeights; w++) {
+			_weeWeights[n * numWeights + w] = distWeight(generator);
+			_weiWeights[n * numWeights + w] = distWeight(generator);
+			_wieWeights[n * numWeights + w] = distWeight(generator);
 		}
+
+		for (int w = 0; w < _numInputs; w++)
+			_wextWeights[n * _numInputs + w] = distWeight(generator);
 	}
 
 	// Precompute g
@@ -79,100 +94,177 @@ void Field::createRandom(int numInputs, int size, int weightRadius, float weight
 
 		_gLookup[i] = gCoeff * std::exp(dCoeff * distSquared);
 	}
+
+	// Halo layout
+	_haloWidth = _size + _weightRadius * 2;
+
+	_haloSources.resize(_haloWidth * _haloWidth);
+
+	for (int hx = 0; hx < _haloWidth; hx++)
+	for (int hy = 0; hy < _haloWidth; hy++) {
+		int nx = ((hx - _weightRadius) % _size + _size) % _size;
+		int ny = ((hy - _weightRadius) % _size + _size) % _size;
+
+		_haloSources[hx + hy * _haloWidth] = nx + ny * _size;
+	}
+
+	_haloOutputE.resize(_haloSources.size());
+	_haloOutputI.resize(_haloSources.size());
+	_haloBdnfE.resize(_haloSources.size());
+	_haloNewOutputE.resize(_haloSources.size());
+	_haloNewOutputI.resize(_haloSources.size());
+
+	_inputBdnfs.resize(numNodes * _numInputs);
+}
+
+void Field::fillHalo(const std::vector<float> &values, std::vector<float> &halo) const {
+	for (int i = 0; i < _haloSources.size(); i++)
+		halo[i] = values[_haloSources[i]];
 }
 
 void Field::step(const std::vector<float> &input, float dt, float threshold, float gain, float reward, float eligibilityDecay,
 	float averageDecay, float homeoAlphaH, float homeoAlphaT, float targetActivation)
 {
-	std::vector<Node> newNodes = _nodes;
+	const NodeStates &states = _states[_current];
+	NodeStates &newStates = _states[1 - _current];
+
+	int numNodes = _size * _size;
 
 	int weightDimSize = _weightRadius * 2 + 1;
+	int numWeights = weightDimSize * weightDimSize;
+
+	fillHalo(states._outputE, _haloOutputE);
+	fillHalo(states._outputI, _haloOutputI);
+	fillHalo(states._bdnfE, _haloBdnfE);
+
+	// Input rates advance once per node, so node n sees them after n updates
+	for (int n = 0; n < numNodes; n++)
+	for (int i = 0; i < _numInputs; i++) {
+		_inputBdnfs[n * _numInputs + i] = _inputData[i]._bdnf;
+
+		_inputData[i]._averageRate = (1.0f - averageDecay) * _inputData[i]._averageRate + averageDecay * input[i];
+		_inputData[i]._bdnf = bdnf(_inputData[i]._averageRate, targetActivation, homeoAlphaH);
+	}
 
-	for (int n = 0; n < newNodes.size(); n++) {
+	// Weights and activations, reading the current states only
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(static) num_threads(_numThreads)
+#endif
+	for (int n = 0; n < numNodes; n++) {
 		int x = n % _size;
 		int y = n / _size;
 
+		float* pWee = &_weeWeights[n * numWeights];
+		float* pWei = &_weiWeights[n * numWeights];
+		float* pWie = &_wieWeights[n * numWeights];
+
+		const float* pWeeTraces = &_weeTraces[n * numWeights];
+		const float* pWeiTraces = &_weiTraces[n * numWeights];
+		const float* pWieTraces = &_wieTraces[n * numWeights];
+
+		// Neighbourhood corner in the halo planes
+		int haloStart = x + y * _haloWidth;
+
+		float bdnfE = states._bdnfE[n];
+
 		float eeSum = 0.0f;
 		float eiSum = 0.0f;
 		float ieSum = 0.0f;
 		float extSum = 0.0f;
 
-		for (int dx = -_weightRadius; dx <= _weightRadius; dx++)
-		for (int dy = -_weightRadius; dy <= _weightRadius; dy++) {
-			int nx = (x + dx) % _size;
-			int ny = (y + dy) % _size;
+		for (int wx = 0; wx < weightDimSize; wx++)
+		for (int wy = 0; wy < weightDimSize; wy++) {
+			int hCoord = haloStart + wx + wy * _haloWidth;
+			int wCoord = wx + wy * weightDimSize;
 
-			if (nx < 0)
-				nx += _size;
-			if (ny < 0)
-				ny += _size;
-
-			int nCoord = nx + ny * _size;
-			int wCoord = dx + _weightRadius + (dy + _weightRadius) * weightDimSize;
-
-			float ou = _nodes[nCoord]._outputE;
-			float ov = _nodes[nCoord]._outputI;
+			float ou = _haloOutputE[hCoord];
+			float ov = _haloOutputI[hCoord];
 
 			float g = _gLookup[wCoord];
 
-			newNodes[n]._wee[wCoord]._weight = std::min(1.0f, std::max(0.0f, _nodes[n]._wee[wCoord]._weight + _nodes[n]._wee[wCoord]._eligibilityTrace * reward) / (_nodes[n]._bdnfE * _nodes[nCoord]._bdnfE));
-			newNodes[n]._wei[wCoord]._weight = std::min(1.0f, std::max(0.0f, (_nodes[n]._wei[wCoord]._weight + _nodes[n]._wei[wCoord]._eligibilityTrace * reward) * _nodes[n]._bdnfE));
-			newNodes[n]._wie[wCoord]._weight = std::min(1.0f, std::max(0.0f, (_nodes[n]._wie[wCoord]._weight + _nodes[n]._wie[wCoord]._eligibilityTrace * reward) * _nodes[nCoord]._bdnfE));
+			pWee[wCoord] = std::min(1.0f, std::max(0.0f, pWee[wCoord] + pWeeTraces[wCoord] * reward) / (bdnfE * _haloBdnfE[hCoord]));
+			pWei[wCoord] = std::min(1.0f, std::max(0.0f, (pWei[wCoord] + pWeiTraces[wCoord] * reward) * bdnfE));
+			pWie[wCoord] = std::min(1.0f, std::max(0.0f, (pWie[wCoord] + pWieTraces[wCoord] * reward) * _haloBdnfE[hCoord]));
+
+			eeSum += g * pWee[wCoord] * ou;
+			eiSum += pWei[wCoord] * ov;
 
-			eeSum += g * newNodes[n]._wee[wCoord]._weight * ou;
-			eiSum += newNodes[n]._wei[wCoord]._weight * ov;
-			
-			ieSum += g * newNodes[n]._wie[wCoord]._weight * ou;
+			ieSum += g * pWie[wCoord] * ou;
 		}
 
 		for (int i = 0; i < _numInputs; i++) {
-			newNodes[n]._wext[i]._weight = std::min(1.0f, std::max(0.0f, (_nodes[n]._wext[i]._weight + _nodes[n]._wext[i]._eligibilityTrace * reward) / (newNodes[n]._bdnfE * _inputData[i]._bdnf)));
+			int eCoord = n * _numInputs + i;
 
-			extSum += newNodes[n]._wext[i]._weight * input[i];
+			_wextWeights[eCoord] = std::min(1.0f, std::max(0.0f, (_wextWeights[eCoord] + _wextTraces[eCoord] * reward) / (bdnfE * _inputBdnfs[eCoord])));
+
+			extSum += _wextWeights[eCoord] * input[i];
 		}
 
 		// Modify resting potential
-		newNodes[n]._hE = _nodes[n]._hE + homeoAlphaT * (targetActivation - _nodes[n]._averageRateE) / targetActivation;
+		newStates._hE[n] = states._hE[n] + homeoAlphaT * (targetActivation - states._averageRateE[n]) / targetActivation;
 
 		// Calculate excitatory activation
-		newNodes[n]._activationE += dt * (-_nodes[n]._activationE + eeSum - eiSum + extSum + newNodes[n]._hE);
-		newNodes[n]._outputE = sigmoid((_nodes[n]._activationE - threshold) * gain);
-		newNodes[n]._averageRateE = (1.0f - averageDecay) * _nodes[n]._averageRateE + averageDecay * newNodes[n]._outputE;
-		newNodes[n]._bdnfE = bdnf(newNodes[n]._averageRateE, targetActivation, homeoAlphaH);
+		newStates._activationE[n] = states._activationE[n] + dt * (-states._activationE[n] + eeSum - eiSum + extSum + newStates._hE[n]);
+		newStates._outputE[n] = sigmoid((states._activationE[n] - threshold) * gain);
+		newStates._averageRateE[n] = (1.0f - averageDecay) * states._averageRateE[n] + averageDecay * newStates._outputE[n];
+		newStates._bdnfE[n] = bdnf(newStates._averageRateE[n], targetActivation, homeoAlphaH);
 
 		// Calculate inhibitory activation
-		newNodes[n]._activationI += dt * (-_nodes[n]._activationI + ieSum + _hI);
-		newNodes[n]._outputI = sigmoid((_nodes[n]._activationI - threshold) * gain);
-		//newNodes[n]._averageRateI = (1.0f - averageDecay) * _nodes[n]._averageRateI + averageDecay * newNodes[n]._outputI;
-		//newNodes[n]._bdnfI = bdnf(newNodes[n]._averageRateI, targetActivation, homeoAlpha);
+		newStates._activationI[n] = states._activationI[n] + dt * (-states._activationI[n] + ieSum + _hI);
+		newStates._outputI[n] = sigmoid((states._activationI[n] - threshold) * gain);
+	}
 
-		for (int i = 0; i < _numInputs; i++) {
-			_inputData[i]._averageRate = (1.0f - averageDecay) * _inputData[i]._averageRate + averageDecay * input[i];
-			_inputData[i]._bdnf = bdnf(_inputData[i]._averageRate, targetActivation, homeoAlphaH);
-		}
+	fillHalo(newStates._outputE, _haloNewOutputE);
+	fillHalo(newStates._outputI, _haloNewOutputI);
+
+	// Update eligibility traces. Neighbours up to this node in node order contribute their new outputs, the others their current ones
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(static) num_threads(_numThreads)
+#endif
+	for (int n = 0; n < numNodes; n++) {
+		int x = n % _size;
+		int y = n / _size;
+
+		const float* pWee = &_weeWeights[n * numWeights];
+		const float* pWei = &_weiWeights[n * numWeights];
+		const float* pWie = &_wieWeights[n * numWeights];
+
+		float* pWeeTraces = &_weeTraces[n * numWeights];
+		float* pWeiTraces = &_weiTraces[n * numWeights];
+		float* pWieTraces = &_wieTraces[n * numWeights];
+
+		float outputE = newStates._outputE[n];
+		float outputI = newStates._outputI[n];
 
-		// Update eligibility traces
-		for (int dx = -_weightRadius; dx <= _weightRadius; dx++)
-		for (int dy = -_weightRadius; dy <= _weightRadius; dy++) {
-			int nx = (x + dx) % _size;
-			int ny = (y + dy) % _size;
+		for (int wy = 0; wy < weightDimSize; wy++) {
+			int ny = ((y + wy - _weightRadius) % _size + _size) % _size;
 
-			if (nx < 0)
-				nx += _size;
-			if (ny < 0)
-				ny += _size;
+			int hRow = x + (y + wy) * _haloWidth;
+			int wRow = wy * weightDimSize;
 
-			int nCoord = nx + ny * _size;
-			int wCoord = dx + _weightRadius + (dy + _weightRadius) * weightDimSize;
+			for (int wx = 0; wx < weightDimSize; wx++) {
+				bool visited = ny < y;
 
-			newNodes[n]._wee[wCoord]._eligibilityTrace = (1.0f - eligibilityDecay) * _nodes[n]._wee[wCoord]._eligibilityTrace + (newNodes[nCoord]._outputE * newNodes[n]._outputE - newNodes[n]._wee[wCoord]._weight * newNodes[nCoord]._outputE * newNodes[nCoord]._outputE);
-			newNodes[n]._wei[wCoord]._eligibilityTrace = (1.0f - eligibilityDecay) * _nodes[n]._wei[wCoord]._eligibilityTrace + (newNodes[nCoord]._outputI * newNodes[n]._outputE - newNodes[n]._wei[wCoord]._weight * newNodes[nCoord]._outputI * newNodes[nCoord]._outputI);
-			newNodes[n]._wie[wCoord]._eligibilityTrace = (1.0f - eligibilityDecay) * _nodes[n]._wie[wCoord]._eligibilityTrace + (newNodes[nCoord]._outputE * newNodes[n]._outputI - newNodes[n]._wie[wCoord]._weight * newNodes[nCoord]._outputE * newNodes[nCoord]._outputE);
+				if (ny == y)
+					visited = ((x + wx - _weightRadius) % _size + _size) % _size <= x;
+
+				float ou = visited ? _haloNewOutputE[hRow + wx] : _haloOutputE[hRow + wx];
+				float ov = visited ? _haloNewOutputI[hRow + wx] : _haloOutputI[hRow + wx];
+
+				int wCoord = wRow + wx;
+
+				pWeeTraces[wCoord] = (1.0f - eligibilityDecay) * pWeeTraces[wCoord] + (ou * outputE - pWee[wCoord] * ou * ou);
+				pWeiTraces[wCoord] = (1.0f - eligibilityDecay) * pWeiTraces[wCoord] + (ov * outputE - pWei[wCoord] * ov * ov);
+				pWieTraces[wCoord] = (1.0f - eligibilityDecay) * pWieTraces[wCoord] + (ou * outputI - pWie[wCoord] * ou * ou);
+			}
 		}
 
-		for (int i = 0; i < _numInputs; i++)
-			newNodes[n]._wext[i]._eligibilityTrace = (1.0f - eligibilityDecay) * _nodes[n]._wext[i]._eligibilityTrace + (input[i] * newNodes[n]._outputE - newNodes[n]._wext[i]._weight * input[i] * input[i]);
+		for (int i = 0; i < _numInputs; i++) {
+			int eCoord = n * _numInputs + i;
+
+			_wextTraces[eCoord] = (1.0f - eligibilityDecay) * _wextTraces[eCoord] + (input[i] * outputE - _wextWeights[eCoord] * input[i] * input[i]);
+		}
 	}
 
-	_nodes = newNodes;
+	_current = 1 - _current;
 }
\ No newline at end of file
@@ -3,37 +3,13 @@
 #include <vector>
 #include <random>
 #include <iostream>
+#include <algorithm>
 
 #include <Consts.h>
 
 namespace dnf {
 	class Field {
 	public:
-		struct Connection {
-			float _weight;
-			float _eligibilityTrace;
-		};
-
-		struct Node {
-			std::vector<Connection> _wee;
-			std::vector<Connection> _wei;
-			std::vector<Connection> _wie;
-
-			std::vector<Connection> _wext;
-
-			float _activationE;
-			float _outputE;
-			float _averageRateE;
-			float _bdnfE;
-
-			float _activationI;
-			float _outputI;
-			//float _averageRateI;
-			//float _bdnfI;
-
-			float _hE;
-		};
-
 		struct InputData {
 			float _averageRate;
 			float _bdnf;
@@ -48,17 +24,62 @@ namespace dnf {
 		}
 
 	private:
+		// Node states, the field keeps the current and the next ones and swaps them every step
+		struct NodeStates {
+			std::vector<float> _activationE;
+			std::vector<float> _outputE;
+			std::vector<float> _averageRateE;
+			std::vector<float> _bdnfE;
+
+			std::vector<float> _activationI;
+			std::vector<float> _outputI;
+
+			std::vector<float> _hE;
+
+			void resize(int numNodes);
+		};
+
 		int _numInputs;
 		int _size;
 		int _weightRadius;
 		float _weightDeviation;
 
-		std::vector<Node> _nodes;
+		NodeStates _states[2];
+		int _current;
+
+		// Node-major weights and eligibility traces, [node * numWeights + (dx + radius) + (dy + radius) * (2 * radius + 1)]
+		std::vector<float> _weeWeights;
+		std::vector<float> _weeTraces;
+		std::vector<float> _weiWeights;
+		std::vector<float> _weiTraces;
+		std::vector<float> _wieWeights;
+		std::vector<float> _wieTraces;
+
+		// [node * numInputs + input]
+		std::vector<float> _wextWeights;
+		std::vector<float> _wextTraces;
 
 		std::vector<float> _gLookup;
 
 		std::vector<InputData> _inputData;
 
+		// Toroidal node values padded by the weight radius on every side, so neighbourhoods need no wrapping.
+		// Halo cell i holds the value of node _haloSources[i]
+		int _haloWidth;
+		std::vector<int> _haloSources;
+		std::vector<float> _haloOutputE;
+		std::vector<float> _haloOutputI;
+		std::vector<float> _haloBdnfE;
+		std::vector<float> _haloNewOutputE;
+		std::vector<float> _haloNewOutputI;
+
+		// Input BDNF seen by every node, [node * numInputs + input]. Input rates advance once per node during a step
+		std::vector<float> _inputBdnfs;
+
+		int _numThreads;
+
+		void fillHalo(const std::vector<float> &values, std::vector<float> &halo) const;
+
 	public:
 		float _hI;
 
@@ -66,9 +87,18 @@ namespace dnf {
 
 		void createRandom(int numInputs, int size, int weightRadius, float weightDeviation, float minWeight, float maxWeight, std::mt19937 &generator);
 
+		// Nodes are updated by _numThreads threads (OpenMP)
 		void step(const std::vector<float> &input, float dt, float threshold, float gain, float reward, float eligibilityDecay,
 			float averageDecay, float homeoAlphaH, float homeoAlphaT, float targetActivation);
 
+		void setNumThreads(int numThreads) {
+			_numThreads = std::max(1, numThreads);
+		}
+
+		int getNumThreads() const {
+			return _numThreads;
+		}
+
 		int getNumInputs() const {
 			return _numInputs;
 		}
@@ -82,7 +112,7 @@ namespace dnf {
 		}
 
 		float getOutputE(int x, int y) const {
-			return _nodes[x + y * _size]._outputE;
+			return _states[_current]._outputE[x + y * _size];
 		}
 	};
 }
\ No newline at end of file
@@ -27,4 +27,8 @@ class ExperimentAND : public hn::Experiment {
 public:
 	// Inherited from Experiment
 	float evaluate(hn::HyperNet &hypernet, const hn::Config &config, std::mt19937 &generator);
+
+	std::shared_ptr<hn::Experiment> clone() const {
+		return std::make_shared<ExperimentAND>(*this);
+	}
 };
\ No newline at end of file
@@ -21,8 +21,6 @@ misrepresented as being the original software.
 
 #include <experiments/ExperimentOR.h>
 
-#include <SFML/System.hpp>
-
 #include <iostream>
 
 float ExperimentOR::evaluate(hn::HyperNet &hypernet, const hn::Config &config, std::mt19937 &generator) {
@@ -21,8 +21,6 @@ misrepresented as being the original software.
 
 #include <experiments/ExperimentPoleBalancing.h>
 
-#include <SFML/System.hpp>
-
 #include <iostream>
 
 float ExperimentPoleBalancing::evaluate(hn::HyperNet &hypernet, const hn::Config &config, std::mt19937 &generator) {
@@ -45,8 +43,6 @@ float ExperimentPoleBalancing::evaluate(hn::HyperNet &hypernet, const hn::Config
 	float g = -2.8f;
 	float massMass = 20.0f;
 	float cartMass = 2.0f;
-	sf::Vector2f massPos(0.0f, poleLength);
-	sf::Vector2f massVel(0.0f, 0.0f);
 	float poleAngle = static_cast<float>(PI) * 0.0f;
 	float poleAngleVel = 0.0f;
 	float poleAngleAccel = 0.0f;
@@ -115,8 +111,6 @@ float ExperimentPoleBalancing::evaluate(hn::HyperNet &hypernet, const hn::Config
 		poleAngleVel += -poleRotationalFriction * poleAngleVel + poleAngleAccel * dt;
 		poleAngle += poleAngleVel * dt;
 
-		massPos = sf::Vector2f(cartX + std::cos(poleAngle + static_cast<float>(PI) * 0.5f) * poleLength, std::sin(poleAngle + static_cast<float>(PI) * 0.5f) * poleLength);
-
 		float force = 0.0f;
 
 		if (std::abs(cartVelX) < maxSpeed)
@@ -57,55 +57,60 @@ void AudioFeatureMFCC::dft(const std::vector<short> &samples, int start, int len
 		result.resize(length);
 
 	const float sizeInv = 1.0f / 64.0f;
-	
+
 	float lengthInv = 1.0f / length;
 
-	// Sweep "length" number of frequencies
-	for (int k = 0; k < length; k++) {
-		float realSum = 0.0f;
-		float imaginarySum = 0.0f;
+	std::vector<float> frame(length);
 
-		for (int n = 0; n < length; n++) {
-			float sample = samples[start + n] * sizeInv;
+	for (int n = 0; n < length; n++)
+		frame[n] = samples[start + n] * sizeInv * hamming(n * lengthInv);
 
-			float h = hamming(n * lengthInv);
+	RealFFT fft;
 
-			float rads = 2.0f * _pi * k * n * lengthInv;
-			
-			realSum += sample * h * std::cos(rads);
-			imaginarySum += sample * h * std::sin(rads);
-		}
+	fft.create(length);
 
-		result[k] = std::complex<float>(realSum, imaginarySum);
-	}
+	std::vector<std::complex<float>> bins(fft.getNumBins());
+
+	fft.forward(frame.data(), bins.data());
+
+	// The sweep uses exp(+i), so the result is the conjugate of the forward transform
+	for (int k = 0; k < length; k++)
+		result[k] = k < bins.size() ? std::conj(bins[k]) : bins[length - k];
 }
 
 void AudioFeatureMFCC::dct(const std::vector<float> &data, std::vector<float> &result) {
 	if (result.size() != data.size())
 		result.resize(data.size());
 
-	float lengthInv = 1.0f / data.size();
-
-	// Sweep "length" number of frequencies
-	for (int k = 0; k < data.size(); k++) {
-		float sum = 0.0f;
+	if (data.empty())
+		return;
 
-		for (int n = 0; n < data.size(); n++) {
-			float sample = data[n];
+	DCT transform;
 
-			sum += sample * std::cos(_pi * lengthInv * (n + 0.5f) * k);
-		}
+	transform.create(data.size());
 
-		result[k] = sum;
-	}
+	transform.forward(data.data(), result.data());
 }
 
 void AudioFeatureMFCC::rdft(const std::vector<std::complex<float>> &result, int start, int length, std::vector<short> &samples) {
 	const float size = 64.0f;
-	const float sizeInv = 1.0f / 64.0f;
 
 	float lengthInv = 1.0f / length;
 
+	// sum_k cos(rads) / re[k] + sin(rads) / im[k] is the real part of the forward transform of 1 / re[k] + i / im[k]
+	std::vector<std::complex<float>> inverses(length);
+
+	for (int k = 0; k < length; k++)
+		inverses[k] = std::complex<float>(1.0f / result[k].real(), 1.0f / result[k].imag());
+
+	FFT fft;
+
+	fft.create(length);
+
+	std::vector<std::complex<float>> sums(length);
+
+	fft.forward(inverses.data(), sums.data());
+
 	for (int n = 0; n < length; n++) {
 		int i = start + n;
 
@@ -113,74 +118,132 @@ void AudioFeatureMFCC::rdft(const std::vector<std::complex<float>> &result, int
 
 		float hInv = 1.0f / h;
 
-		float sum = 0.0f;
+		samples[i] = sums[n].real() * hInv * size;
+	}
+}
 
-		// Add frequencies
-		for (int k = 0; k < length; k++) {
-			float rads = 2.0f * _pi * k * n * lengthInv;
+void AudioFeatureMFCC::rdct(const std::vector<float> &result, std::vector<float> &data) {
+	if (data.empty())
+		return;
 
-			sum += (std::cos(rads) / result[k].real() + std::sin(rads) / result[k].imag()) * hInv;
-		}
+	std::vector<float> inverses(data.size());
 
-		samples[i] = sum * size;
-	}
+	for (int k = 0; k < data.size(); k++)
+		inverses[k] = 1.0f / result[k];
+
+	DCT transform;
+
+	transform.create(data.size());
+
+	transform.transpose(inverses.data(), data.data());
 }
 
-void AudioFeatureMFCC::rdct(const std::vector<float> &result, std::vector<float> &data) {
-	float lengthInv = 1.0f / data.size();
+void AudioFeatureMFCC::Transforms::create(const MelFilterBank &filterBank) {
+	int length = filterBank.getFilterSize();
 
-	for (int n = 0; n < data.size(); n++) {
-		float sum = 0.0f;
+	const float sizeInv = 1.0f / 64.0f;
+
+	float lengthInv = 1.0f / length;
 
-		// Add frequencies
-		for (int k = 0; k < data.size(); k++) {
-			float rads = 2.0f * _pi * k * n * lengthInv;
+	_fft.create(length);
+	_dct.create(filterBank.getNumFilters());
 
-			sum += std::cos(_pi * lengthInv * (n + 0.5f) * k) / result[k];
-		}
+	_window.resize(length);
+
+	for (int n = 0; n < length; n++)
+		_window[n] = sizeInv * hamming(n * lengthInv);
+
+	_filterStarts.resize(filterBank.getNumFilters());
+	_filterEnds.resize(filterBank.getNumFilters());
 
-		data[n] = sum;
+	for (int fi = 0; fi < filterBank.getNumFilters(); fi++) {
+		int start = 0;
+
+		while (start < length && filterBank.getValue(fi, start) == 0.0f)
+			start++;
+
+		int end = length;
+
+		while (end > start && filterBank.getValue(fi, end - 1) == 0.0f)
+			end--;
+
+		_filterStarts[fi] = start;
+		_filterEnds[fi] = end;
 	}
+
+	_frame.resize(length);
+	_spectrum.resize(_fft.getNumBins());
+	_periodogram.resize(length);
+	_logEnergies.resize(filterBank.getNumFilters());
 }
 
-void AudioFeatureMFCC::extract(const std::vector<short> &samples, int start, int length, const MelFilterBank &filterBank) {
-	assert(filterBank.getFilterSize() == length);
-	
-	// Perform discrete Fourier transform
-	std::vector<std::complex<float>> dftResult;
+void AudioFeatureMFCC::extractFrame(Transforms &transforms, const std::vector<short> &samples, int start, const MelFilterBank &filterBank, float* coeffs) {
+	int length = filterBank.getFilterSize();
 
-	dft(samples, start, length, dftResult);
+	assert(start + length <= samples.size());
 
-	// Compute periodogram
-	std::vector<float> periodogram(length);
+	// Windowed real FFT
+	for (int n = 0; n < length; n++)
+		transforms._frame[n] = samples[start + n] * transforms._window[n];
 
+	transforms._fft.forward(transforms._frame.data(), transforms._spectrum.data());
+
+	// Compute periodogram, the upper half mirrors the lower one
 	float lengthInv = 1.0f / length;
 
-	for (int n = 0; n < length; n++) {
-		float absVal = std::abs(dftResult[n]);
+	for (int n = 0; n < transforms._spectrum.size(); n++)
+		transforms._periodogram[n] = lengthInv * std::norm(transforms._spectrum[n]);
 
-		periodogram[n] = lengthInv * absVal * absVal;
-	}
+	for (int n = transforms._spectrum.size(); n < length; n++)
+		transforms._periodogram[n] = transforms._periodogram[length - n];
 
 	// Multiply by the filter banks
-	std::vector<float> energies(filterBank.getNumFilters());
-
 	for (int n = 0; n < filterBank.getNumFilters(); n++) {
 		float sum = 0.0f;
 
-		for (int k = 0; k < length; k++)
-			sum += filterBank.getValue(n, k) * periodogram[k];
+		for (int k = transforms._filterStarts[n]; k < transforms._filterEnds[n]; k++)
+			sum += filterBank.getValue(n, k) * transforms._periodogram[k];
 
-		energies[n] = sum;
+		transforms._logEnergies[n] = std::log(sum);
 	}
 
-	std::vector<float> logEnergies(filterBank.getNumFilters());
+	// Perform discrete cosine transform
+	transforms._dct.forward(transforms._logEnergies.data(), coeffs);
+}
 
-	for (int n = 0; n < filterBank.getNumFilters(); n++)
-		logEnergies[n] = std::log(energies[n]);
+void AudioFeatureMFCC::extract(const std::vector<short> &samples, int start, int length, const MelFilterBank &filterBank) {
+	assert(filterBank.getFilterSize() == length);
 
-	// Perform discrete cosine transform
-	dct(logEnergies, _coeffs);
+	Transforms transforms;
+
+	transforms.create(filterBank);
+
+	_coeffs.resize(filterBank.getNumFilters());
+
+	extractFrame(transforms, samples, start, filterBank, _coeffs.data());
+}
+
+int AudioFeatureMFCC::extract(const std::vector<short> &samples, int step, const MelFilterBank &filterBank, std::vector<float> &coeffs) {
+	assert(step > 0);
+
+	int length = filterBank.getFilterSize();
+	int numCoeffs = filterBank.getNumFilters();
+
+	int numFrames = samples.size() < length ? 0 : (static_cast<int>(samples.size()) - length) / step + 1;
+
+	coeffs.resize(numFrames * numCoeffs);
+
+	if (numFrames == 0)
+		return 0;
+
+	Transforms transforms;
+
+	transforms.create(filterBank);
+
+	for (int f = 0; f < numFrames; f++)
+		extractFrame(transforms, samples, f * step, filterBank, &coeffs[f * numCoeffs]);
+
+	return numFrames;
 }
 
 void AudioFeatureMFCC::reverse(std::vector<short> &samples, int start, int length, const MelFilterBank &filterBank) {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <featureExtraction/FFT.h>
+
 #include <vector>
 #include <random>
 #include <array>
@@ -57,11 +59,37 @@ namespace mfcc {
 		static void rdct(const std::vector<float> &result, std::vector<float> &data);
 
 	private:
+		// Tables and buffers for one frame length and filter bank, shared by all frames of an extraction
+		struct Transforms {
+			RealFFT _fft;
+			DCT _dct;
+
+			// Hamming window with the sample scale folded in
+			std::vector<float> _window;
+
+			// Range of nonzero values of every filter, [start, end)
+			std::vector<int> _filterStarts;
+			std::vector<int> _filterEnds;
+
+			std::vector<float> _frame;
+			std::vector<std::complex<float>> _spectrum;
+			std::vector<float> _periodogram;
+			std::vector<float> _logEnergies;
+
+			void create(const MelFilterBank &filterBank);
+		};
+
+		static void extractFrame(Transforms &transforms, const std::vector<short> &samples, int start, const MelFilterBank &filterBank, float* coeffs);
+
 		std::vector<float> _coeffs;
 
 	public:
 		void extract(const std::vector<short> &samples, int start, int length, const MelFilterBank &filterBank);
 
+		// Extracts every frame of filterBank.getFilterSize() samples that starts at a multiple of step and fits in samples.
+		// coeffs is [frames x filterBank.getNumFilters()], returns the number of frames
+		static int extract(const std::vector<short> &samples, int step, const MelFilterBank &filterBank, std::vector<float> &coeffs);
+
 		void reverse(std::vector<short> &samples, int start, int length, const MelFilterBank &filterBank);
 
 		float getCoeff(int i) const {
@@ -0,0 +1,263 @@
+#include <featureExtraction/FFT.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <assert.h>
+
+using namespace mfcc;
+
+namespace {
+	// Tables are computed in double precision
+	const double pi = 3.14159265358979323846;
+
+	// Plain complex product, std::complex multiplication checks for infinities and NaNs
+	inline std::complex<float> multiply(const std::complex<float> &a, const std::complex<float> &b) {
+		return std::complex<float>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+	}
+}
+
+void FFT::create(int length) {
+	assert(length > 0);
+
+	_length = length;
+
+	_twiddles.resize(_length);
+
+	for (int k = 0; k < _length; k++) {
+		double rads = -2.0 * pi * k / _length;
+
+		_twiddles[k] = std::complex<float>(std::cos(rads), std::sin(rads));
+	}
+
+	// Factor into radices, 4 first, then 2, then odd numbers
+	_factors.clear();
+
+	int n = _length;
+	int p = 4;
+
+	int floorSqrt = std::floor(std::sqrt(static_cast<double>(n)));
+
+	int maxRadix = 1;
+
+	do {
+		while (n % p != 0) {
+			switch (p) {
+			case 4:
+				p = 2;
+				break;
+			case 2:
+				p = 3;
+				break;
+			default:
+				p += 2;
+				break;
+			}
+
+			if (p > floorSqrt)
+				p = n;
+		}
+
+		n /= p;
+
+		_factors.push_back(p);
+		_factors.push_back(n);
+
+		maxRadix = std::max(maxRadix, p);
+	} while (n > 1);
+
+	_scratch.resize(maxRadix);
+}
+
+void FFT::forward(const std::complex<float>* data, std::complex<float>* result) {
+	assert(data != result);
+
+	work(result, data, 1, 0);
+}
+
+void FFT::work(std::complex<float>* result, const std::complex<float>* data, int stride, int factorIndex) {
+	int p = _factors[factorIndex];
+	int m = _factors[factorIndex + 1];
+
+	// Transform the p decimated sub-sequences into consecutive blocks of m
+	if (m == 1) {
+		for (int q = 0; q < p; q++)
+			result[q] = data[q * stride];
+	}
+	else {
+		for (int q = 0; q < p; q++)
+			work(result + q * m, data + q * stride, stride * p, factorIndex + 2);
+	}
+
+	switch (p) {
+	case 2:
+		butterfly2(result, stride, m);
+		break;
+	case 4:
+		butterfly4(result, stride, m);
+		break;
+	default:
+		butterflyGeneric(result, stride, m, p);
+		break;
+	}
+}
+
+void FFT::butterfly2(std::complex<float>* result, int stride, int m) const {
+	for (int k = 0; k < m; k++) {
+		std::complex<float> t = multiply(result[k + m], _twiddles[k * stride]);
+
+		result[k + m] = result[k] - t;
+		result[k] += t;
+	}
+}
+
+void FFT::butterfly4(std::complex<float>* result, int stride, int m) const {
+	for (int k = 0; k < m; k++) {
+		std::complex<float> s0 = multiply(result[k + m], _twiddles[k * stride]);
+		std::complex<float> s1 = multiply(result[k + 2 * m], _twiddles[2 * k * stride]);
+		std::complex<float> s2 = multiply(result[k + 3 * m], _twiddles[3 * k * stride]);
+
+		std::complex<float> s5 = result[k] - s1;
+
+		result[k] += s1;
+
+		std::complex<float> s3 = s0 + s2;
+		std::complex<float> s4 = s0 - s2;
+
+		result[k + 2 * m] = result[k] - s3;
+		result[k] += s3;
+
+		result[k + m] = std::complex<float>(s5.real() + s4.imag(), s5.imag() - s4.real());
+		result[k + 3 * m] = std::complex<float>(s5.real() - s4.imag(), s5.imag() + s4.real());
+	}
+}
+
+void FFT::butterflyGeneric(std::complex<float>* result, int stride, int m, int p) {
+	for (int u = 0; u < m; u++) {
+		for (int q = 0; q < p; q++)
+			_scratch[q] = result[u + q * m];
+
+		for (int q1 = 0; q1 < p; q1++) {
+			int k = u + q1 * m;
+
+			int twiddleIndex = 0;
+
+			std::complex<float> sum = _scratch[0];
+
+			for (int q = 1; q < p; q++) {
+				twiddleIndex += stride * k;
+
+				if (twiddleIndex >= _length)
+					twiddleIndex -= _length;
+
+				sum += multiply(_scratch[q], _twiddles[twiddleIndex]);
+			}
+
+			result[k] = sum;
+		}
+	}
+}
+
+void RealFFT::create(int length) {
+	_length = length;
+
+	if (_length % 2 == 0) {
+		_fft.create(_length / 2);
+
+		_splitTwiddles.resize(_length / 2 + 1);
+
+		for (int k = 0; k <= _length / 2; k++) {
+			double rads = -2.0 * pi * k / _length;
+
+			_splitTwiddles[k] = std::complex<float>(std::cos(rads), std::sin(rads));
+		}
+
+		_packed.resize(_length / 2);
+		_packedResult.resize(_length / 2);
+	}
+	else {
+		_fft.create(_length);
+
+		_packed.resize(_length);
+		_packedResult.resize(_length);
+	}
+}
+
+void RealFFT::forward(const float* data, std::complex<float>* result) {
+	if (_length % 2 != 0) {
+		for (int n = 0; n < _length; n++)
+			_packed[n] = std::complex<float>(data[n], 0.0f);
+
+		_fft.forward(_packed.data(), _packedResult.data());
+
+		for (int k = 0; k <= _length / 2; k++)
+			result[k] = _packedResult[k];
+
+		return;
+	}
+
+	int halfLength = _length / 2;
+
+	for (int n = 0; n < halfLength; n++)
+		_packed[n] = std::complex<float>(data[2 * n], data[2 * n + 1]);
+
+	_fft.forward(_packed.data(), _packedResult.data());
+
+	// Separate the transforms of the even and odd samples, then combine them
+	for (int k = 0; k <= halfLength; k++) {
+		std::complex<float> z = _packedResult[k % halfLength];
+		std::complex<float> zMirror = std::conj(_packedResult[(halfLength - k) % halfLength]);
+
+		std::complex<float> even = (z + zMirror) * 0.5f;
+		std::complex<float> difference = z - zMirror;
+		std::complex<float> odd(difference.imag() * 0.5f, -difference.real() * 0.5f);
+
+		result[k] = even + multiply(_splitTwiddles[k], odd);
+	}
+}
+
+void DCT::create(int length) {
+	_length = length;
+
+	_fft.create(_length);
+	_transposeFFT.create(_length * 2);
+
+	_twiddles.resize(_length);
+
+	for (int k = 0; k < _length; k++) {
+		double rads = -pi * k / (2.0 * _length);
+
+		_twiddles[k] = std::complex<float>(std::cos(rads), std::sin(rads));
+	}
+
+	_buffer.resize(_length * 2);
+	_bufferResult.resize(_length * 2);
+}
+
+void DCT::forward(const float* data, float* result) {
+	// Even samples in order followed by the odd samples reversed (Makhoul)
+	for (int n = 0; 2 * n < _length; n++)
+		_buffer[n] = std::complex<float>(data[2 * n], 0.0f);
+
+	for (int n = 0; 2 * n + 1 < _length; n++)
+		_buffer[_length - 1 - n] = std::complex<float>(data[2 * n + 1], 0.0f);
+
+	_fft.forward(_buffer.data(), _bufferResult.data());
+
+	for (int k = 0; k < _length; k++)
+		result[k] = multiply(_bufferResult[k], _twiddles[k]).real();
+}
+
+void DCT::transpose(const float* result, float* data) {
+	// data[n] = Re(sum_k result[k] * exp(i pi k / (2 length)) * exp(2 pi i k n / (2 length))), a zero padded inverse DFT.
+	// Conjugating the input turns it into a forward transform with the same real part
+	for (int k = 0; k < _length; k++) {
+		_buffer[k] = _twiddles[k] * result[k];
+		_buffer[k + _length] = std::complex<float>(0.0f, 0.0f);
+	}
+
+	_transposeFFT.forward(_buffer.data(), _bufferResult.data());
+
+	for (int n = 0; n < _length; n++)
+		data[n] = _bufferResult[n].real();
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+
+namespace mfcc {
+	// Mixed-radix (4, 2, then odd factors) decimation in time FFT of one length. Twiddles are computed once by create
+	class FFT {
+	private:
+		int _length;
+
+		// Pairs of (radix, remaining length) for every stage
+		std::vector<int> _factors;
+
+		// exp(-2 pi i k / length)
+		std::vector<std::complex<float>> _twiddles;
+
+		// Inputs of a generic butterfly, as long as the largest radix
+		std::vector<std::complex<float>> _scratch;
+
+		void work(std::complex<float>* result, const std::complex<float>* data, int stride, int factorIndex);
+
+		void butterfly2(std::complex<float>* result, int stride, int m) const;
+		void butterfly4(std::complex<float>* result, int stride, int m) const;
+		void butterflyGeneric(std::complex<float>* result, int stride, int m, int p);
+
+	public:
+		FFT()
+			: _length(0)
+		{}
+
+		void create(int length);
+
+		// result[k] = sum_n data[n] * exp(-2 pi i k n / length), data and result must not overlap
+		void forward(const std::complex<float>* data, std::complex<float>* result);
+
+		int getLength() const {
+			return _length;
+		}
+	};
+
+	// FFT of real data. Even lengths run a complex FFT of half the length on the packed even and odd samples
+	class RealFFT {
+	private:
+		int _length;
+
+		FFT _fft;
+
+		// exp(-2 pi i k / length) for k <= length / 2
+		std::vector<std::complex<float>> _splitTwiddles;
+
+		std::vector<std::complex<float>> _packed;
+		std::vector<std::complex<float>> _packedResult;
+
+	public:
+		RealFFT()
+			: _length(0)
+		{}
+
+		void create(int length);
+
+		// Writes bins 0 to length / 2, the remaining bins are the conjugates of these (bin k = conj(bin length - k))
+		void forward(const float* data, std::complex<float>* result);
+
+		int getLength() const {
+			return _length;
+		}
+
+		int getNumBins() const {
+			return _length / 2 + 1;
+		}
+	};
+
+	// Unnormalized DCT-II and its transpose (DCT-III), computed with FFTs
+	class DCT {
+	private:
+		int _length;
+
+		// Length for the DCT-II (reordered input), twice the length for the DCT-III
+		FFT _fft;
+		FFT _transposeFFT;
+
+		// exp(-i pi k / (2 length))
+		std::vector<std::complex<float>> _twiddles;
+
+		std::vector<std::complex<float>> _buffer;
+		std::vector<std::complex<float>> _bufferResult;
+
+	public:
+		DCT()
+			: _length(0)
+		{}
+
+		void create(int length);
+
+		// result[k] = sum_n data[n] * cos(pi / length * (n + 0.5) * k)
+		void forward(const float* data, float* result);
+
+		// data[n] = sum_k result[k] * cos(pi / length * (n + 0.5) * k)
+		void transpose(const float* result, float* data);
+
+		int getLength() const {
+			return _length;
+		}
+	};
+}
\ No newline at end of file
@@ -21,6 +21,8 @@ misrepresented as being the original software.
 
 #pragma once
 
+#include <cstddef>
+
 namespace htm {
 	struct ColumnAndCellIndices {
 		int _columnIndex;
@@ -34,7 +36,7 @@ namespace htm {
 		{}
 
 		size_t operator()(const ColumnAndCellIndices &value) const {
-			return static_cast<size_t>(_columnIndex ^ _cellIndex);
+			return static_cast<size_t>(value._columnIndex) * 31 + static_cast<size_t>(value._cellIndex);
 		}
 
 		bool operator==(const ColumnAndCellIndices &other) const {
@@ -0,0 +1,1182 @@
+/*
+AI Lib
+Copyright (C) 2014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <htm/FlatRegion.h>
+
+#include <algorithm>
+#include <cmath>
+#include <assert.h>
+
+using namespace htm;
+
+void FlatRegion::createRandom(int inputWidth, int inputHeight, int connectionRadius, float initInhibitionRadius, int initNumSegments,
+	int regionWidth, int regionHeight, int columnSize, float permanenceDistanceBias, float permanenceDistanceFalloff, float permanenceBiasFloor,
+	float connectionPermanenceTarget, float connectionPermanenceStdDev, std::mt19937 &generator)
+{
+	std::normal_distribution<float> permanenceDist(connectionPermanenceTarget, connectionPermanenceStdDev);
+
+	_regionWidth = regionWidth;
+	_regionHeight = regionHeight;
+	_inputWidth = inputWidth;
+	_inputHeight = inputHeight;
+	_connectionRadius = connectionRadius;
+	_columnSize = columnSize;
+
+	int numColumns = _regionWidth * _regionHeight;
+	int numCells = numColumns * _columnSize;
+
+	_boosts.assign(numColumns, 1.0f);
+	_overlaps.assign(numColumns, 0.0f);
+	_activeDutyCycles.assign(numColumns, 0.0f);
+	_overlapDutyCycles.assign(numColumns, 0.0f);
+	_minDutyCycles.assign(numColumns, 0.0f);
+	_inhibitionRadii.assign(numColumns, initInhibitionRadius);
+	_columnActiveStates.assign(numColumns, 0);
+	_newActiveDutyCycles.assign(numColumns, 0.0f);
+
+	_activeColumnIndices.clear();
+
+	_inputConnectionStarts.clear();
+	_inputConnectionInputIndices.clear();
+	_inputConnectionRadii.clear();
+	_inputPermanences.clear();
+
+	float regionWidthInv = 1.0f / _regionWidth;
+	float regionHeightInv = 1.0f / _regionHeight;
+
+	for (int i = 0; i < numColumns; i++) {
+		_inputConnectionStarts.push_back(_inputPermanences.size());
+
+		float columnXf = static_cast<float>(i % _regionWidth) * regionWidthInv;
+		float columnYf = static_cast<float>(i / _regionWidth) * regionHeightInv;
+
+		int inputX = static_cast<int>(columnXf * _inputWidth);
+		int inputY = static_cast<int>(columnYf * _inputHeight);
+
+		for (int dx = -_connectionRadius; dx <= _connectionRadius; dx++)
+		for (int dy = -_connectionRadius; dy <= _connectionRadius; dy++) {
+			int connectionX = inputX + dx;
+			int connectionY = inputY + dy;
+
+			// If exists
+			if (connectionX >= 0 && connectionY >= 0 && connectionX < _inputWidth && connectionY < _inputHeight) {
+				float distSquared = dx * dx + dy * dy;
+
+				_inputConnectionInputIndices.push_back(connectionX + connectionY * _inputWidth);
+				_inputConnectionRadii.push_back(std::max(std::abs(dx), std::abs(dy)));
+				_inputPermanences.push_back(permanenceDist(generator) + permanenceDistanceBias * std::exp(-distSquared * permanenceDistanceFalloff) - permanenceBiasFloor);
+			}
+		}
+	}
+
+	_inputConnectionStarts.push_back(_inputPermanences.size());
+
+	_inputActiveStates.assign(_inputPermanences.size(), 0);
+
+	_current = 0;
+
+	for (int b = 0; b < 2; b++) {
+		_cellActiveStates[b].assign(numCells, false);
+		_cellPredictiveStates[b].assign(numCells, false);
+		_cellLearnStates[b].assign(numCells, false);
+		_cellNumPredictionSteps[b].assign(numCells, 0);
+
+		_segmentActiveActivities[b].clear();
+		_segmentLearnActivities[b].clear();
+
+		_synapseActiveStates[b].clear();
+	}
+
+	_segments.clear();
+	_freeSegments.clear();
+	_synapses.clear();
+	_numUnusedSynapses = 0;
+	_synapseActiveStatesSet = false;
+
+	_cellSegments.assign(numCells, std::vector<int>());
+	_cellOutgoingSynapses.assign(numCells, std::vector<SynapseReference>());
+	_cellSegmentUpdates.assign(numCells, std::vector<SegmentUpdate>());
+
+	for (int c = 0; c < numCells; c++)
+	for (int k = 0; k < initNumSegments; k++)
+		_cellSegments[c].push_back(allocateSegment());
+}
+
+int FlatRegion::allocateSegment() {
+	int segmentId;
+
+	if (_freeSegments.empty()) {
+		segmentId = _segments.size();
+
+		_segments.push_back(Segment());
+
+		for (int b = 0; b < 2; b++) {
+			_segmentActiveActivities[b].push_back(0);
+			_segmentLearnActivities[b].push_back(0);
+		}
+	}
+	else {
+		segmentId = _freeSegments.back();
+
+		_freeSegments.pop_back();
+
+		_segments[segmentId] = Segment();
+
+		for (int b = 0; b < 2; b++) {
+			_segmentActiveActivities[b][segmentId] = 0;
+			_segmentLearnActivities[b][segmentId] = 0;
+		}
+	}
+
+	return segmentId;
+}
+
+void FlatRegion::freeSegment(int segmentId) {
+	_numUnusedSynapses += _segments[segmentId]._synapseCapacity;
+
+	_segments[segmentId] = Segment();
+
+	_freeSegments.push_back(segmentId);
+}
+
+void FlatRegion::reserveSynapses(int segmentId, int numSynapses) {
+	Segment &segment = _segments[segmentId];
+
+	if (numSynapses <= segment._synapseCapacity)
+		return;
+
+	// Move the segment's synapses to the end of the pool with room to grow
+	int newCapacity = std::max(numSynapses, std::max(4, segment._synapseCapacity * 2));
+	int newStart = _synapses.size();
+
+	_synapses.resize(newStart + newCapacity);
+
+	for (int b = 0; b < 2; b++)
+		_synapseActiveStates[b].resize(newStart + newCapacity, false);
+
+	for (int s = 0; s < segment._numSynapses; s++) {
+		_synapses[newStart + s] = _synapses[segment._synapseStart + s];
+
+		for (int b = 0; b < 2; b++)
+			_synapseActiveStates[b][newStart + s] = _synapseActiveStates[b][segment._synapseStart + s];
+	}
+
+	_numUnusedSynapses += segment._synapseCapacity;
+
+	segment._synapseStart = newStart;
+	segment._synapseCapacity = newCapacity;
+}
+
+void FlatRegion::addSynapse(int segmentId, int cell, float permanence) {
+	reserveSynapses(segmentId, _segments[segmentId]._numSynapses + 1);
+
+	Segment &segment = _segments[segmentId];
+
+	int index = segment._synapseStart + segment._numSynapses;
+
+	_synapses[index]._cell = cell;
+	_synapses[index]._permanence = permanence;
+
+	for (int b = 0; b < 2; b++)
+		_synapseActiveStates[b][index] = false;
+
+	SynapseReference reference;
+	reference._segment = segmentId;
+	reference._offset = segment._numSynapses;
+
+	_cellOutgoingSynapses[cell].push_back(reference);
+
+	segment._numSynapses++;
+}
+
+void FlatRegion::removeOutgoingSynapse(int cell, int segmentId, int offset) {
+	std::vector<SynapseReference> &references = _cellOutgoingSynapses[cell];
+
+	for (int r = 0; r < references.size(); r++)
+	if (references[r]._segment == segmentId && references[r]._offset == offset) {
+		references[r] = references.back();
+		references.pop_back();
+
+		return;
+	}
+
+	assert(false);
+}
+
+void FlatRegion::moveOutgoingSynapse(int cell, int segmentId, int offset, int newOffset) {
+	std::vector<SynapseReference> &references = _cellOutgoingSynapses[cell];
+
+	for (int r = 0; r < references.size(); r++)
+	if (references[r]._segment == segmentId && references[r]._offset == offset) {
+		references[r]._offset = newOffset;
+
+		return;
+	}
+
+	assert(false);
+}
+
+int FlatRegion::findSynapse(int segmentId, int cell) const {
+	const Segment &segment = _segments[segmentId];
+
+	for (int s = segment._synapseStart; s < segment._synapseStart + segment._numSynapses; s++)
+	if (_synapses[s]._cell == cell)
+		return s;
+
+	return -1;
+}
+
+void FlatRegion::removeZeroPermanenceSynapses(int segmentId) {
+	Segment &segment = _segments[segmentId];
+
+	int end = segment._synapseStart + segment._numSynapses;
+	int kept = segment._synapseStart;
+
+	for (int s = segment._synapseStart; s < end; s++)
+	if (_synapses[s]._permanence != 0.0f) {
+		if (kept != s) {
+			moveOutgoingSynapse(_synapses[s]._cell, segmentId, s - segment._synapseStart, kept - segment._synapseStart);
+
+			_synapses[kept] = _synapses[s];
+
+			for (int b = 0; b < 2; b++)
+				_synapseActiveStates[b][kept] = _synapseActiveStates[b][s];
+		}
+
+		kept++;
+	}
+	else
+		removeOutgoingSynapse(_synapses[s]._cell, segmentId, s - segment._synapseStart);
+
+	segment._numSynapses = kept - segment._synapseStart;
+}
+
+void FlatRegion::compactSynapses() {
+	std::vector<Synapse> synapses;
+	std::vector<bool> synapseActiveStates[2];
+
+	synapses.reserve(_synapses.size() - _numUnusedSynapses);
+
+	for (int b = 0; b < 2; b++)
+		synapseActiveStates[b].reserve(_synapses.size() - _numUnusedSynapses);
+
+	// Keep segments of the same cell next to each other
+	for (int c = 0; c < _cellSegments.size(); c++)
+	for (int k = 0; k < _cellSegments[c].size(); k++) {
+		Segment &segment = _segments[_cellSegments[c][k]];
+
+		int newStart = synapses.size();
+
+		for (int s = 0; s < segment._synapseCapacity; s++) {
+			synapses.push_back(_synapses[segment._synapseStart + s]);
+
+			for (int b = 0; b < 2; b++)
+				synapseActiveStates[b].push_back(_synapseActiveStates[b][segment._synapseStart + s]);
+		}
+
+		segment._synapseStart = newStart;
+	}
+
+	_synapses.swap(synapses);
+
+	for (int b = 0; b < 2; b++)
+		_synapseActiveStates[b].swap(synapseActiveStates[b]);
+
+	_numUnusedSynapses = 0;
+}
+
+bool FlatRegion::getOutput(int i) const {
+	for (int c = i * _columnSize; c < (i + 1) * _columnSize; c++)
+	if (_cellActiveStates[_current][c] || _cellPredictiveStates[_current][c])
+		return true;
+
+	return false;
+}
+
+bool FlatRegion::getOutput(int x, int y) const {
+	return getOutput(x + y * _regionWidth);
+}
+
+bool FlatRegion::getPrediction(int i, int t) const {
+	for (int c = i * _columnSize; c < (i + 1) * _columnSize; c++)
+	if (_cellNumPredictionSteps[_current][c] == t)
+		return true;
+
+	return false;
+}
+
+bool FlatRegion::getPrediction(int x, int y, int t) const {
+	return getPrediction(x + y * _regionWidth, t);
+}
+
+void FlatRegion::setColumnsToOutput() {
+	_activeColumnIndices.clear();
+
+	for (int i = 0; i < _columnActiveStates.size(); i++) {
+		_columnActiveStates[i] = getOutput(i);
+
+		if (_columnActiveStates[i])
+			_activeColumnIndices.push_back(i);
+	}
+}
+
+bool FlatRegion::hasLearningCell(int x, int y) const {
+	int i = x + y * _regionWidth;
+
+	for (int c = i * _columnSize; c < (i + 1) * _columnSize; c++)
+	if (_cellLearnStates[1 - _current][c])
+		return true;
+
+	return false;
+}
+
+bool FlatRegion::hasSegments(int x, int y) const {
+	int i = x + y * _regionWidth;
+
+	for (int c = i * _columnSize; c < (i + 1) * _columnSize; c++)
+	if (!_cellSegments[c].empty())
+		return true;
+
+	return false;
+}
+
+bool FlatRegion::hasConnections(int x, int y) const {
+	int i = x + y * _regionWidth;
+
+	for (int c = i * _columnSize; c < (i + 1) * _columnSize; c++)
+	for (int k = 0; k < _cellSegments[c].size(); k++)
+	if (_segments[_cellSegments[c][k]]._numSynapses != 0)
+		return true;
+
+	return false;
+}
+
+void FlatRegion::getReconstructionFromColumns(std::vector<bool> &output, const std::vector<char> &columnOutputs, float minOverlap, float minPermanence) const {
+	if (output.size() != _inputWidth * _inputHeight)
+		output.resize(_inputWidth * _inputHeight);
+
+	std::vector<float> accum;
+	accum.assign(output.size(), 0.0f);
+
+	for (int i = 0; i < columnOutputs.size(); i++)
+	if (columnOutputs[i]) {
+		for (int ci = _inputConnectionStarts[i]; ci < _inputConnectionStarts[i + 1]; ci++)
+		if (_inputPermanences[ci] > minPermanence)
+			accum[_inputConnectionInputIndices[ci]]++;
+	}
+
+	float maximumAccum = 0.0f;
+
+	for (int i = 0; i < accum.size(); i++)
+		maximumAccum = std::max(maximumAccum, accum[i]);
+
+	if (maximumAccum == 0.0f)
+		return;
+
+	float maximumAccumInv = 1.0f / maximumAccum;
+	float minOverlapInv = 1.0f / minOverlap;
+
+	for (int i = 0; i < accum.size(); i++)
+		output[i] = accum[i] * maximumAccumInv > minOverlapInv;
+}
+
+void FlatRegion::getReconstruction(std::vector<bool> &output, float minOverlap, float minPermanence, bool fromPrediction) const {
+	if (!fromPrediction) {
+		getReconstructionFromColumns(output, _columnActiveStates, minOverlap, minPermanence);
+
+		return;
+	}
+
+	std::vector<char> columnOutputs(_columnActiveStates.size());
+
+	for (int i = 0; i < columnOutputs.size(); i++)
+		columnOutputs[i] = getOutput(i);
+
+	getReconstructionFromColumns(output, columnOutputs, minOverlap, minPermanence);
+}
+
+void FlatRegion::getReconstructionAtTime(std::vector<bool> &output, float minOverlap, float minPermanence, int t) const {
+	std::vector<char> columnOutputs(_columnActiveStates.size());
+
+	for (int i = 0; i < columnOutputs.size(); i++)
+		columnOutputs[i] = getPrediction(i, t);
+
+	getReconstructionFromColumns(output, columnOutputs, minOverlap, minPermanence);
+}
+
+int FlatRegion::getNumTiles() const {
+	return ((_regionWidth + _tileSize - 1) / _tileSize) * ((_regionHeight + _tileSize - 1) / _tileSize);
+}
+
+void FlatRegion::getTileBounds(int tile, int &startX, int &startY, int &endX, int &endY) const {
+	int numTilesX = (_regionWidth + _tileSize - 1) / _tileSize;
+
+	startX = (tile % numTilesX) * _tileSize;
+	startY = (tile / numTilesX) * _tileSize;
+	endX = std::min(startX + _tileSize, _regionWidth);
+	endY = std::min(startY + _tileSize, _regionHeight);
+}
+
+int FlatRegion::calculateOverlap(int i, const std::vector<bool> &inputs, float minPermanence, float minOverlap, float overlapDutyCycleDecay) {
+	int receptiveFieldSize = 0;
+
+	// Calculate overlap
+	float overlap = 0.0f;
+
+	for (int ci = _inputConnectionStarts[i]; ci < _inputConnectionStarts[i + 1]; ci++) {
+		_inputActiveStates[ci] = false;
+
+		if (_inputPermanences[ci] > minPermanence) {
+			if (inputs[_inputConnectionInputIndices[ci]]) {
+				_inputActiveStates[ci] = true;
+				overlap++;
+			}
+
+			receptiveFieldSize = std::max(receptiveFieldSize, _inputConnectionRadii[ci]);
+		}
+	}
+
+	if (overlap < minOverlap) {
+		overlap = 0.0f;
+		_overlapDutyCycles[i] = (1.0f - overlapDutyCycleDecay) * _overlapDutyCycles[i];
+	}
+	else {
+		overlap *= _boosts[i];
+
+		_overlapDutyCycles[i] = (1.0f - overlapDutyCycleDecay) * _overlapDutyCycles[i] + overlapDutyCycleDecay;
+	}
+
+	_overlaps[i] = overlap;
+
+	return receptiveFieldSize;
+}
+
+void FlatRegion::inhibit(int i, int desiredLocalActivity, float permanenceIncrease, float permanenceDecrease) {
+	_columnActiveStates[i] = false;
+
+	if (_overlaps[i] > 0.0f) {
+		int columnX = i % _regionWidth;
+		int columnY = i / _regionWidth;
+
+		int numHigherThanThis = 0;
+
+		int inhibitionRadius = std::ceil(_inhibitionRadii[i]);
+
+		// Count columns in inhibition radius with higher overlap
+		for (int dy = -inhibitionRadius; dy <= inhibitionRadius; dy++) {
+			int inhibitionY = columnY + dy;
+
+			if (inhibitionY < 0 || inhibitionY >= _regionHeight)
+				continue;
+
+			for (int dx = -inhibitionRadius; dx <= inhibitionRadius; dx++) {
+				int inhibitionX = columnX + dx;
+
+				if (inhibitionX >= 0 && inhibitionX < _regionWidth && _overlaps[inhibitionX + inhibitionY * _regionWidth] > _overlaps[i])
+					numHigherThanThis++;
+			}
+		}
+
+		if (numHigherThanThis < desiredLocalActivity) {
+			_columnActiveStates[i] = true;
+
+			// Update synapses
+			for (int ci = _inputConnectionStarts[i]; ci < _inputConnectionStarts[i + 1]; ci++)
+			if (_inputActiveStates[ci])
+				_inputPermanences[ci] = std::min(1.0f, _inputPermanences[ci] + permanenceIncrease);
+			else
+				_inputPermanences[ci] = std::max(0.0f, _inputPermanences[ci] - permanenceDecrease);
+		}
+	}
+}
+
+void FlatRegion::updateDutyCycles(int i, float minPermanence, float minDutyCycleRatio, float subOverlapPermanenceIncrease,
+	std::function<float(float, float)> &boostFunction)
+{
+	int columnX = i % _regionWidth;
+	int columnY = i / _regionWidth;
+
+	float maxNeighborhoodDutyCycle = -999999.0f;
+
+	// Columns in inhibition radius. The serial order updated the columns before this one first, so those use their new duty cycles
+	int inhibitionRadius = std::ceil(_inhibitionRadii[i]);
+
+	for (int dy = -inhibitionRadius; dy <= inhibitionRadius; dy++) {
+		int inhibitionY = columnY + dy;
+
+		if (inhibitionY < 0 || inhibitionY >= _regionHeight)
+			continue;
+
+		for (int dx = -inhibitionRadius; dx <= inhibitionRadius; dx++) {
+			int inhibitionX = columnX + dx;
+
+			if (inhibitionX >= 0 && inhibitionX < _regionWidth) {
+				int inhibitionIndex = inhibitionX + inhibitionY * _regionWidth;
+
+				maxNeighborhoodDutyCycle = std::max(maxNeighborhoodDutyCycle, inhibitionIndex < i ? _newActiveDutyCycles[inhibitionIndex] : _activeDutyCycles[inhibitionIndex]);
+			}
+		}
+	}
+
+	_minDutyCycles[i] = minDutyCycleRatio * maxNeighborhoodDutyCycle;
+
+	_boosts[i] = boostFunction(_newActiveDutyCycles[i], _minDutyCycles[i]);
+
+	if (_overlapDutyCycles[i] < _minDutyCycles[i]) {
+		// Increase all permanences
+		for (int ci = _inputConnectionStarts[i]; ci < _inputConnectionStarts[i + 1]; ci++)
+			_inputPermanences[ci] += subOverlapPermanenceIncrease * minPermanence;
+	}
+}
+
+void FlatRegion::spatialPooling(const std::vector<bool> &inputs, float minPermanence, float minOverlap, int desiredLocalActivity,
+	float permanenceIncrease, float permanenceDecrease, float minDutyCycleRatio, float activeDutyCycleDecay,
+	float overlapDutyCycleDecay, float subOverlapPermanenceIncrease,
+	std::function<float(float, float)> &boostFunction)
+{
+	int numColumns = _overlaps.size();
+	int numTiles = getNumTiles();
+
+	int totalReceptiveFieldSize = 0;
+
+#pragma omp parallel for schedule(static) num_threads(_numThreads) reduction(+:totalReceptiveFieldSize)
+	for (int t = 0; t < numTiles; t++) {
+		int startX, startY, endX, endY;
+
+		getTileBounds(t, startX, startY, endX, endY);
+
+		for (int y = startY; y < endY; y++)
+		for (int x = startX; x < endX; x++)
+			totalReceptiveFieldSize += calculateOverlap(x + y * _regionWidth, inputs, minPermanence, minOverlap, overlapDutyCycleDecay);
+	}
+
+	float averageReceptiveFieldSize = static_cast<float>(totalReceptiveFieldSize) / numColumns;
+
+#pragma omp parallel for schedule(static) num_threads(_numThreads)
+	for (int t = 0; t < numTiles; t++) {
+		int startX, startY, endX, endY;
+
+		getTileBounds(t, startX, startY, endX, endY);
+
+		for (int y = startY; y < endY; y++)
+		for (int x = startX; x < endX; x++)
+			inhibit(x + y * _regionWidth, desiredLocalActivity, permanenceIncrease, permanenceDecrease);
+	}
+
+	_activeColumnIndices.clear();
+
+	for (int i = 0; i < numColumns; i++) {
+		if (_columnActiveStates[i])
+			_activeColumnIndices.push_back(i);
+
+		_newActiveDutyCycles[i] = (1.0f - activeDutyCycleDecay) * _activeDutyCycles[i] + activeDutyCycleDecay * (_columnActiveStates[i] ? 1.0f : 0.0f);
+	}
+
+#pragma omp parallel for schedule(static) num_threads(_numThreads)
+	for (int t = 0; t < numTiles; t++) {
+		int startX, startY, endX, endY;
+
+		getTileBounds(t, startX, startY, endX, endY);
+
+		for (int y = startY; y < endY; y++)
+		for (int x = startX; x < endX; x++)
+			updateDutyCycles(x + y * _regionWidth, minPermanence, minDutyCycleRatio, subOverlapPermanenceIncrease, boostFunction);
+	}
+
+	_activeDutyCycles.swap(_newActiveDutyCycles);
+
+	std::fill(_inhibitionRadii.begin(), _inhibitionRadii.end(), averageReceptiveFieldSize);
+}
+
+void FlatRegion::stepBegin() {
+	// Current states become the previous ones
+	_current = 1 - _current;
+
+	std::fill(_cellActiveStates[_current].begin(), _cellActiveStates[_current].end(), false);
+	std::fill(_cellPredictiveStates[_current].begin(), _cellPredictiveStates[_current].end(), false);
+	std::fill(_cellLearnStates[_current].begin(), _cellLearnStates[_current].end(), false);
+	std::fill(_cellNumPredictionSteps[_current].begin(), _cellNumPredictionSteps[_current].end(), 0);
+
+	std::fill(_segmentActiveActivities[_current].begin(), _segmentActiveActivities[_current].end(), 0);
+	std::fill(_segmentLearnActivities[_current].begin(), _segmentLearnActivities[_current].end(), 0);
+
+	std::fill(_synapseActiveStates[_current].begin(), _synapseActiveStates[_current].end(), false);
+
+	_synapseActiveStatesSet = false;
+}
+
+void FlatRegion::updateSegmentActivities(float minPermanence) {
+	std::vector<int> &segmentActiveActivities = _segmentActiveActivities[_current];
+	std::vector<int> &segmentLearnActivities = _segmentLearnActivities[_current];
+	std::vector<bool> &synapseActiveStates = _synapseActiveStates[_current];
+
+	std::fill(segmentActiveActivities.begin(), segmentActiveActivities.end(), 0);
+	std::fill(segmentLearnActivities.begin(), segmentLearnActivities.end(), 0);
+
+	// Cells only become active in active columns, visit their outgoing synapses
+	for (int a = 0; a < _activeColumnIndices.size(); a++) {
+		int i = _activeColumnIndices[a];
+
+		for (int c = i * _columnSize; c < (i + 1) * _columnSize; c++) {
+			if (!_cellActiveStates[_current][c])
+				continue;
+
+			bool learnState = _cellLearnStates[_current][c];
+
+			const std::vector<SynapseReference> &references = _cellOutgoingSynapses[c];
+
+			for (int r = 0; r < references.size(); r++) {
+				int segmentId = references[r]._segment;
+				int s = _segments[segmentId]._synapseStart + references[r]._offset;
+
+				if (_synapses[s]._permanence > minPermanence) {
+					synapseActiveStates[s] = true;
+
+					segmentActiveActivities[segmentId]++;
+				}
+
+				if (learnState)
+					segmentLearnActivities[segmentId]++;
+			}
+		}
+	}
+
+	_synapseActiveStatesSet = true;
+}
+
+void FlatRegion::temporalPoolingNoLearn(float minPermanence, int activationThreshold) {
+	int prev = 1 - _current;
+
+	for (int a = 0; a < _activeColumnIndices.size(); a++) {
+		int i = _activeColumnIndices[a];
+
+		bool bottomUpPredicted = false;
+
+		for (int c = i * _columnSize; c < (i + 1) * _columnSize; c++) {
+			if (_cellPredictiveStates[prev][c]) {
+				int activeSegmentId = -1;
+
+				// Find active segment (this is an OR operation, so can stop as soon as find one, except when it is not a sequence segment)
+				for (int k = 0; k < _cellSegments[c].size(); k++) {
+					int segmentId = _cellSegments[c][k];
+					const Segment &segment = _segments[segmentId];
+
+					if (segment._numPredictionSteps != 1)
+						continue;
+
+					int activity = _segmentActiveActivities[prev][segmentId];
+
+					if (activity > activationThreshold) {
+						if (activeSegmentId == -1)
+							activeSegmentId = segmentId;
+						else if (_segments[activeSegmentId]._sequenceSegment) {
+							if (segment._sequenceSegment && _segmentActiveActivities[prev][activeSegmentId] < activity)
+								activeSegmentId = segmentId;
+						}
+						else {
+							if (_segmentActiveActivities[prev][activeSegmentId] < activity)
+								activeSegmentId = segmentId;
+						}
+					}
+				}
+
+				if (activeSegmentId != -1 && _segments[activeSegmentId]._sequenceSegment) {
+					bottomUpPredicted = true;
+
+					_cellActiveStates[_current][c] = true;
+				}
+			}
+		}
+
+		if (!bottomUpPredicted) {
+			for (int c = i * _columnSize; c < (i + 1) * _columnSize; c++)
+				_cellActiveStates[_current][c] = true;
+		}
+	}
+
+	if (_synapseActiveStatesSet)
+		std::fill(_synapseActiveStates[_current].begin(), _synapseActiveStates[_current].end(), false);
+
+	updateSegmentActivities(minPermanence);
+
+	for (int c = 0; c < _cellSegments.size(); c++)
+	for (int k = 0; k < _cellSegments[c].size(); k++) {
+		int segmentId = _cellSegments[c][k];
+
+		if (_segmentActiveActivities[_current][segmentId] > activationThreshold) {
+			if (!_cellPredictiveStates[_current][c])
+				_cellNumPredictionSteps[_current][c] = _segments[segmentId]._numPredictionSteps;
+			else
+				_cellNumPredictionSteps[_current][c] = std::min(_cellNumPredictionSteps[_current][c], _segments[segmentId]._numPredictionSteps);
+
+			_cellPredictiveStates[_current][c] = true;
+		}
+	}
+}
+
+void FlatRegion::getBestMatchingCell(int columnIndex, int &cellIndex, int &segmentIndex, int predictionSteps, bool usePrevious, std::mt19937 &generator) {
+	const std::vector<int> &segmentActiveActivities = _segmentActiveActivities[usePrevious ? 1 - _current : _current];
+
+	int firstCell = columnIndex * _columnSize;
+
+	// Go through cells and see which one has the best matching segment
+	int maxActiveConnections = 0;
+	cellIndex = -1;
+	segmentIndex = -1;
+
+	for (int j = 0; j < _columnSize; j++) {
+		int maxSegmentIndex;
+
+		getBestMatchingSegment(columnIndex, j, maxSegmentIndex, predictionSteps, usePrevious);
+
+		if (maxSegmentIndex != -1) {
+			int activeCount = segmentActiveActivities[_cellSegments[firstCell + j][maxSegmentIndex]];
+
+			if (activeCount > maxActiveConnections) {
+				cellIndex = j;
+				segmentIndex = maxSegmentIndex;
+				maxActiveConnections = activeCount;
+			}
+		}
+	}
+
+	if (cellIndex == -1) {
+		int minSegmentsCellIndex = 0;
+
+		int numSame = 0;
+
+		for (int j = 1; j < _columnSize; j++) {
+			if (_cellSegments[firstCell + j].size() < _cellSegments[firstCell + minSegmentsCellIndex].size()) {
+				numSame = 1;
+				minSegmentsCellIndex = j;
+			}
+			else if (_cellSegments[firstCell + j].size() == _cellSegments[firstCell + minSegmentsCellIndex].size()) {
+				numSame++;
+
+				std::uniform_int_distribution<int> sameDist(0, numSame - 1);
+
+				if (sameDist(generator) == 0)
+					minSegmentsCellIndex = j;
+			}
+		}
+
+		cellIndex = minSegmentsCellIndex;
+
+		segmentIndex = -1;
+	}
+}
+
+void FlatRegion::getBestMatchingSegment(int columnIndex, int cellIndex, int &segmentIndex, int predictionSteps, bool usePrevious) {
+	const std::vector<int> &cellSegments = _cellSegments[columnIndex * _columnSize + cellIndex];
+
+	segmentIndex = -1;
+
+	int maxActivity = 0;
+
+	for (int k = 0; k < cellSegments.size(); k++) {
+		int segmentId = cellSegments[k];
+
+		if (_segments[segmentId]._numPredictionSteps != predictionSteps)
+			continue;
+
+		// Like Region, the comparison uses the requested buffer but the maximum is always taken from the previous one
+		int activity = _segmentActiveActivities[usePrevious ? 1 - _current : _current][segmentId];
+
+		if (activity >= maxActivity) {
+			segmentIndex = k;
+
+			maxActivity = _segmentActiveActivities[1 - _current][segmentId];
+		}
+	}
+}
+
+void FlatRegion::updateSegmentActiveSynapses(int columnIndex, int cellIndex, int segmentIndex, bool usePrevious, int numConnections, int learningRadius, SegmentUpdateType updateType, SegmentUpdate &segmentUpdate, std::mt19937 &generator) {
+	int columnX = columnIndex % _regionWidth;
+	int columnY = columnIndex / _regionWidth;
+
+	int cell = columnIndex * _columnSize + cellIndex;
+
+	segmentUpdate._cellIndex = cellIndex;
+	segmentUpdate._segmentIndex = segmentIndex;
+	segmentUpdate._updateType = updateType;
+	segmentUpdate._numPredictionSteps = 1; // Means is sequence segment
+
+	int segmentId = -1;
+	int numConnectionsAdd = numConnections;
+
+	if (segmentIndex != -1) {
+		segmentId = _cellSegments[cell][segmentIndex];
+
+		const Segment &segment = _segments[segmentId];
+		const std::vector<bool> &synapseActiveStates = _synapseActiveStates[usePrevious ? 1 - _current : _current];
+
+		for (int s = segment._synapseStart; s < segment._synapseStart + segment._numSynapses; s++)
+		if (synapseActiveStates[s])
+			segmentUpdate._activeSynapseCells.push_back(_synapses[s]._cell);
+		else
+			segmentUpdate._inactiveSynapseCells.push_back(_synapses[s]._cell);
+
+		numConnectionsAdd = numConnections - segment._numSynapses;
+	}
+
+	if (numConnectionsAdd > 0) {
+		const std::vector<bool> &prevLearnStates = _cellLearnStates[1 - _current];
+
+		std::vector<int> availableCells;
+
+		for (int dx = -learningRadius; dx <= learningRadius; dx++)
+		for (int dy = -learningRadius; dy <= learningRadius; dy++) {
+			int learningX = columnX + dx;
+			int learningY = columnY + dy;
+
+			// If exists
+			if (learningX >= 0 && learningY >= 0 && learningX < _regionWidth && learningY < _regionHeight) {
+				int firstNeighborCell = (learningX + learningY * _regionWidth) * _columnSize;
+
+				for (int neighborCell = firstNeighborCell; neighborCell < firstNeighborCell + _columnSize; neighborCell++) {
+					if (neighborCell == cell || !prevLearnStates[neighborCell])
+						continue;
+
+					if (segmentId != -1 && findSynapse(segmentId, neighborCell) != -1)
+						continue;
+
+					availableCells.push_back(neighborCell);
+				}
+			}
+		}
+
+		std::shuffle(availableCells.begin(), availableCells.end(), generator);
+
+		int selectIndex = 0;
+
+		while (numConnectionsAdd > 0 && selectIndex < availableCells.size()) {
+			// Select random cell to connect to from available list
+			segmentUpdate._activeSynapseCells.push_back(availableCells[selectIndex]);
+
+			numConnectionsAdd--;
+			selectIndex++;
+		}
+	}
+}
+
+void FlatRegion::temporalPoolingLearn(float minPermanence, int learningRadius, int minLearningThreshold, int activationThreshold, int newNumConnections, float permanenceIncrease, float permanenceDecrease, float newConnectionPermanence, int maxSteps, std::mt19937 &generator) {
+	int prev = 1 - _current;
+
+	// Phase 1
+	for (int a = 0; a < _activeColumnIndices.size(); a++) {
+		int i = _activeColumnIndices[a];
+
+		bool bottomUpPredicted = false;
+		bool learningCellChosen = false;
+
+		for (int c = i * _columnSize; c < (i + 1) * _columnSize; c++) {
+			if (_cellPredictiveStates[prev][c]) {
+				int activeSegmentId = -1;
+
+				// Find active segment (this is an OR operation, so can stop as soon as find one, except when it is not a sequence segment)
+				for (int k = 0; k < _cellSegments[c].size(); k++) {
+					int segmentId = _cellSegments[c][k];
+					const Segment &segment = _segments[segmentId];
+
+					int activity = _segmentActiveActivities[prev][segmentId];
+
+					if (activity > activationThreshold) {
+						if (activeSegmentId == -1)
+							activeSegmentId = segmentId;
+						else if (_segments[activeSegmentId]._sequenceSegment) {
+							if (segment._sequenceSegment && _segmentActiveActivities[prev][activeSegmentId] < activity)
+								activeSegmentId = segmentId;
+						}
+						else {
+							if (_segmentActiveActivities[prev][activeSegmentId] < activity)
+								activeSegmentId = segmentId;
+						}
+					}
+				}
+
+				if (activeSegmentId != -1 && _segments[activeSegmentId]._sequenceSegment) {
+					bottomUpPredicted = true;
+
+					_cellActiveStates[_current][c] = true;
+
+					if (_segmentLearnActivities[prev][activeSegmentId] > activationThreshold) {
+						learningCellChosen = true;
+
+						_cellLearnStates[_current][c] = true;
+					}
+				}
+			}
+		}
+
+		if (!bottomUpPredicted) {
+			for (int c = i * _columnSize; c < (i + 1) * _columnSize; c++)
+				_cellActiveStates[_current][c] = true;
+		}
+
+		if (!learningCellChosen) {
+			int cellIndex;
+			int segmentIndex;
+
+			getBestMatchingCell(i, cellIndex, segmentIndex, 1, true, generator);
+
+			_cellLearnStates[_current][i * _columnSize + cellIndex] = true;
+
+			SegmentUpdate segmentUpdate;
+
+			updateSegmentActiveSynapses(i, cellIndex, segmentIndex, true, newNumConnections, learningRadius, _dueToActive, segmentUpdate, generator);
+
+			segmentUpdate._numPredictionSteps = 1;
+
+			_cellSegmentUpdates[i * _columnSize + segmentUpdate._cellIndex].push_back(segmentUpdate);
+		}
+	}
+
+	// Phase 2, active states of synapses are not cleared (same as Region)
+	updateSegmentActivities(minPermanence);
+
+	for (int c = 0; c < _cellSegments.size(); c++) {
+		int i = c / _columnSize;
+		int j = c % _columnSize;
+
+		for (int k = 0; k < _cellSegments[c].size(); k++) {
+			int segmentId = _cellSegments[c][k];
+
+			if (_segmentActiveActivities[_current][segmentId] > activationThreshold) {
+				if (!_cellPredictiveStates[_current][c])
+					_cellNumPredictionSteps[_current][c] = _segments[segmentId]._numPredictionSteps;
+				else
+					_cellNumPredictionSteps[_current][c] = std::min(_cellNumPredictionSteps[_current][c], _segments[segmentId]._numPredictionSteps);
+
+				_cellPredictiveStates[_current][c] = true;
+
+				SegmentUpdate segmentUpdate;
+
+				updateSegmentActiveSynapses(i, j, k, false, newNumConnections, learningRadius, _dueToPredictive, segmentUpdate, generator);
+
+				_cellSegmentUpdates[c].push_back(segmentUpdate);
+			}
+		}
+
+		if (_cellPredictiveStates[_current][c] && _cellNumPredictionSteps[_current][c] != maxSteps) {
+			int segmentIndex;
+
+			getBestMatchingSegment(i, j, segmentIndex, _cellNumPredictionSteps[_current][c] + 1, true);
+
+			SegmentUpdate segmentUpdate;
+
+			updateSegmentActiveSynapses(i, j, segmentIndex, true, newNumConnections, learningRadius, _dueToPredictive, segmentUpdate, generator);
+
+			if (segmentIndex == -1)
+				segmentUpdate._numPredictionSteps = _cellNumPredictionSteps[_current][c] + 1;
+
+			_cellSegmentUpdates[c].push_back(segmentUpdate);
+		}
+	}
+
+	// Phase 3
+	std::vector<int> modifiedSegmentIndices;
+	std::vector<SegmentUpdate> keepUpdates;
+
+	for (int c = 0; c < _cellSegments.size(); c++) {
+		std::vector<int> &cellSegments = _cellSegments[c];
+		std::vector<SegmentUpdate> &segmentUpdates = _cellSegmentUpdates[c];
+
+		bool learnState = _cellLearnStates[_current][c];
+		bool predictiveState = _cellPredictiveStates[_current][c];
+		bool prevPredictiveState = _cellPredictiveStates[prev][c];
+
+		modifiedSegmentIndices.clear();
+		keepUpdates.clear();
+
+		if (learnState) {
+			for (int s = 0; s < segmentUpdates.size(); s++) {
+				SegmentUpdate &segmentUpdate = segmentUpdates[s];
+
+				if (segmentUpdate._isNew && segmentUpdate._updateType == _dueToPredictive) {
+					segmentUpdate._isNew = false;
+					keepUpdates.push_back(segmentUpdate);
+					continue;
+				}
+
+				segmentUpdate._isNew = false;
+
+				if (segmentUpdate._segmentIndex == -1) {
+					if (segmentUpdate._activeSynapseCells.size() > activationThreshold) {
+						int segmentId = allocateSegment();
+
+						cellSegments.push_back(segmentId);
+
+						reserveSynapses(segmentId, segmentUpdate._activeSynapseCells.size());
+
+						for (int a = 0; a < segmentUpdate._activeSynapseCells.size(); a++) {
+							int synapse = findSynapse(segmentId, segmentUpdate._activeSynapseCells[a]);
+
+							// Create new connection
+							if (synapse == -1)
+								addSynapse(segmentId, segmentUpdate._activeSynapseCells[a], newConnectionPermanence);
+							else
+								_synapses[synapse]._permanence = newConnectionPermanence;
+						}
+
+						_segments[segmentId]._numPredictionSteps = std::max(1, segmentUpdate._numPredictionSteps);
+
+						if (_segments[segmentId]._numPredictionSteps == 1)
+							_segments[segmentId]._sequenceSegment = true;
+
+						int modIndex = cellSegments.size() - 1;
+
+						if (std::find(modifiedSegmentIndices.begin(), modifiedSegmentIndices.end(), modIndex) == modifiedSegmentIndices.end())
+							modifiedSegmentIndices.push_back(modIndex);
+					}
+					else
+						keepUpdates.push_back(segmentUpdate);
+				}
+				else {
+					int segmentId = cellSegments[segmentUpdate._segmentIndex];
+
+					for (int a = 0; a < segmentUpdate._activeSynapseCells.size(); a++) {
+						int synapse = findSynapse(segmentId, segmentUpdate._activeSynapseCells[a]);
+
+						// Create new connection
+						if (synapse == -1)
+							addSynapse(segmentId, segmentUpdate._activeSynapseCells[a], newConnectionPermanence);
+						else
+							_synapses[synapse]._permanence = std::min(1.0f, _synapses[synapse]._permanence + permanenceIncrease);
+					}
+
+					for (int a = 0; a < segmentUpdate._inactiveSynapseCells.size(); a++) {
+						int synapse = findSynapse(segmentId, segmentUpdate._inactiveSynapseCells[a]);
+
+						if (synapse != -1)
+							_synapses[synapse]._permanence = std::max(0.0f, _synapses[synapse]._permanence - permanenceDecrease);
+					}
+
+					int modIndex = segmentUpdate._segmentIndex;
+
+					if (std::find(modifiedSegmentIndices.begin(), modifiedSegmentIndices.end(), modIndex) == modifiedSegmentIndices.end())
+						modifiedSegmentIndices.push_back(modIndex);
+				}
+			}
+		}
+		else if (!predictiveState && prevPredictiveState) {
+			for (int s = 0; s < segmentUpdates.size(); s++) {
+				SegmentUpdate &segmentUpdate = segmentUpdates[s];
+
+				if (segmentUpdate._isNew && segmentUpdate._updateType == _dueToPredictive) {
+					segmentUpdate._isNew = false;
+					keepUpdates.push_back(segmentUpdate);
+					continue;
+				}
+
+				segmentUpdate._isNew = false;
+
+				if (segmentUpdate._segmentIndex != -1) {
+					int segmentId = cellSegments[segmentUpdate._segmentIndex];
+
+					for (int a = 0; a < segmentUpdate._activeSynapseCells.size(); a++) {
+						int synapse = findSynapse(segmentId, segmentUpdate._activeSynapseCells[a]);
+
+						// Create new connection
+						if (synapse == -1)
+							addSynapse(segmentId, segmentUpdate._activeSynapseCells[a], minPermanence);
+						else
+							_synapses[synapse]._permanence = std::max(0.0f, _synapses[synapse]._permanence - permanenceDecrease);
+					}
+
+					int modIndex = segmentUpdate._segmentIndex;
+
+					if (std::find(modifiedSegmentIndices.begin(), modifiedSegmentIndices.end(), modIndex) == modifiedSegmentIndices.end())
+						modifiedSegmentIndices.push_back(modIndex);
+				}
+				else
+					keepUpdates.push_back(segmentUpdate);
+			}
+		}
+		else if (predictiveState && prevPredictiveState && _cellNumPredictionSteps[_current][c] > 1 && _cellNumPredictionSteps[prev][c] == 1) {
+			for (int s = 0; s < segmentUpdates.size(); s++) {
+				SegmentUpdate &segmentUpdate = segmentUpdates[s];
+
+				if (segmentUpdate._isNew && segmentUpdate._updateType == _dueToPredictive) {
+					segmentUpdate._isNew = false;
+					keepUpdates.push_back(segmentUpdate);
+					continue;
+				}
+
+				segmentUpdate._isNew = false;
+
+				if (segmentUpdate._numPredictionSteps <= 1 && segmentUpdate._segmentIndex != -1) {
+					int segmentId = cellSegments[segmentUpdate._segmentIndex];
+
+					for (int a = 0; a < segmentUpdate._activeSynapseCells.size(); a++) {
+						int synapse = findSynapse(segmentId, segmentUpdate._activeSynapseCells[a]);
+
+						// Create new connection
+						if (synapse == -1)
+							addSynapse(segmentId, segmentUpdate._activeSynapseCells[a], newConnectionPermanence);
+						else
+							_synapses[synapse]._permanence = std::max(0.0f, _synapses[synapse]._permanence - permanenceDecrease);
+					}
+
+					int modIndex = segmentUpdate._segmentIndex;
+
+					if (std::find(modifiedSegmentIndices.begin(), modifiedSegmentIndices.end(), modIndex) == modifiedSegmentIndices.end())
+						modifiedSegmentIndices.push_back(modIndex);
+				}
+				else
+					keepUpdates.push_back(segmentUpdate);
+			}
+		}
+		else {
+			for (int s = 0; s < segmentUpdates.size(); s++) {
+				SegmentUpdate &segmentUpdate = segmentUpdates[s];
+
+				segmentUpdate._isNew = false;
+
+				keepUpdates.push_back(segmentUpdate);
+			}
+		}
+
+		segmentUpdates.swap(keepUpdates);
+
+		if (segmentUpdates.empty())
+		for (int m = 0; m < modifiedSegmentIndices.size(); m++) {
+			int s = modifiedSegmentIndices[m];
+			int segmentId = cellSegments[s];
+
+			removeZeroPermanenceSynapses(segmentId);
+
+			if (_segments[segmentId]._numSynapses == 0) {
+				freeSegment(segmentId);
+
+				cellSegments.erase(cellSegments.begin() + s);
+
+				// Shift indices
+				for (int n = m; n < modifiedSegmentIndices.size(); n++)
+				if (modifiedSegmentIndices[n] > s)
+					modifiedSegmentIndices[n]--;
+			}
+		}
+	}
+
+	// Reclaim space of relocated and freed segments once it dominates the pool
+	if (_numUnusedSynapses > 1024 && _numUnusedSynapses * 2 > _synapses.size())
+		compactSynapses();
+}
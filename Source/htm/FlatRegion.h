@@ -0,0 +1,251 @@
+/*
+AI Lib
+Copyright (C) 2014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <htm/Segment.h>
+
+#include <random>
+#include <functional>
+#include <algorithm>
+
+namespace htm {
+	// Same algorithm and outputs as Region, with flat storage instead of Column -> Cell -> Segment objects.
+	// Cells are identified by columnIndex * columnSize + cellIndex. Cell, segment and synapse states are double-buffered,
+	// so stepBegin only flips the buffer index and clears the new current buffer.
+	// Segments come from a pool, their synapses are contiguous (presynaptic cell, permanence) pairs in one shared array.
+	// Every cell also indexes the synapses it projects to, so segment activities are accumulated from the active cells only
+	class FlatRegion {
+	public:
+		struct Synapse {
+			int _cell;
+			float _permanence;
+		};
+
+	private:
+		struct Segment {
+			int _synapseStart;
+			int _numSynapses;
+			int _synapseCapacity;
+
+			int _numPredictionSteps;
+
+			bool _sequenceSegment;
+
+			Segment()
+				: _synapseStart(0), _numSynapses(0), _synapseCapacity(0),
+				_numPredictionSteps(-1), _sequenceSegment(false)
+			{}
+		};
+
+		// Synapse _offset within the segment, stays valid when the segment is moved in the pool
+		struct SynapseReference {
+			int _segment;
+			int _offset;
+		};
+
+		struct SegmentUpdate {
+			int _cellIndex;
+			int _segmentIndex; // Index into the cell's segment list, -1 for a new segment
+			std::vector<int> _activeSynapseCells;
+			std::vector<int> _inactiveSynapseCells;
+
+			bool _isNew;
+			SegmentUpdateType _updateType;
+			int _numPredictionSteps;
+
+			SegmentUpdate()
+				: _cellIndex(-1), _segmentIndex(-1),
+				_isNew(true), _updateType(_dueToActive), _numPredictionSteps(1)
+			{}
+		};
+
+		int _regionWidth;
+		int _regionHeight;
+		int _inputWidth;
+		int _inputHeight;
+		int _connectionRadius;
+		int _columnSize;
+
+		// Columns
+		std::vector<float> _boosts;
+		std::vector<float> _overlaps;
+		std::vector<float> _activeDutyCycles;
+		std::vector<float> _overlapDutyCycles;
+		std::vector<float> _minDutyCycles;
+		std::vector<float> _inhibitionRadii;
+		std::vector<char> _columnActiveStates;
+
+		std::vector<int> _activeColumnIndices;
+
+		// Spatial pooling tiles and threads, see Region. Column states are chars so that threads can write neighbouring columns
+		int _numThreads;
+		int _tileSize;
+
+		std::vector<float> _newActiveDutyCycles;
+
+		// Proximal connections of column i are [_inputConnectionStarts[i], _inputConnectionStarts[i + 1])
+		std::vector<int> _inputConnectionStarts;
+		std::vector<int> _inputConnectionInputIndices;
+		std::vector<int> _inputConnectionRadii;
+		std::vector<float> _inputPermanences;
+		std::vector<char> _inputActiveStates;
+
+		// Cells, [_current] is this step, [1 - _current] the previous one
+		int _current;
+
+		std::vector<bool> _cellActiveStates[2];
+		std::vector<bool> _cellPredictiveStates[2];
+		std::vector<bool> _cellLearnStates[2];
+		std::vector<int> _cellNumPredictionSteps[2];
+
+		std::vector<std::vector<int>> _cellSegments;
+		std::vector<std::vector<SynapseReference>> _cellOutgoingSynapses;
+		std::vector<std::vector<SegmentUpdate>> _cellSegmentUpdates;
+
+		// Segment pool
+		std::vector<Segment> _segments;
+		std::vector<int> _freeSegments;
+		std::vector<int> _segmentActiveActivities[2];
+		std::vector<int> _segmentLearnActivities[2];
+
+		// Synapse pool
+		std::vector<Synapse> _synapses;
+		std::vector<bool> _synapseActiveStates[2];
+		int _numUnusedSynapses;
+
+		// Whether synapse active states were set since stepBegin
+		bool _synapseActiveStatesSet;
+
+		int allocateSegment();
+		void freeSegment(int segmentId);
+		void reserveSynapses(int segmentId, int numSynapses);
+		void addSynapse(int segmentId, int cell, float permanence);
+		int findSynapse(int segmentId, int cell) const;
+		void removeZeroPermanenceSynapses(int segmentId);
+		void compactSynapses();
+
+		void removeOutgoingSynapse(int cell, int segmentId, int offset);
+		void moveOutgoingSynapse(int cell, int segmentId, int offset, int newOffset);
+
+		void updateSegmentActivities(float minPermanence);
+
+		void getBestMatchingCell(int columnIndex, int &cellIndex, int &segmentIndex, int predictionSteps, bool usePrevious, std::mt19937 &generator);
+		void getBestMatchingSegment(int columnIndex, int cellIndex, int &segmentIndex, int predictionSteps, bool usePrevious);
+		void updateSegmentActiveSynapses(int columnIndex, int cellIndex, int segmentIndex, bool usePrevious, int numConnections, int learningRadius, SegmentUpdateType updateType, SegmentUpdate &segmentUpdate, std::mt19937 &generator);
+
+		int getNumTiles() const;
+		void getTileBounds(int tile, int &startX, int &startY, int &endX, int &endY) const;
+
+		int calculateOverlap(int i, const std::vector<bool> &inputs, float minPermanence, float minOverlap, float overlapDutyCycleDecay);
+		void inhibit(int i, int desiredLocalActivity, float permanenceIncrease, float permanenceDecrease);
+		void updateDutyCycles(int i, float minPermanence, float minDutyCycleRatio, float subOverlapPermanenceIncrease,
+			std::function<float(float, float)> &boostFunction);
+
+		void getReconstructionFromColumns(std::vector<bool> &output, const std::vector<char> &columnOutputs, float minOverlap, float minPermanence) const;
+
+	public:
+		FlatRegion()
+			: _regionWidth(0), _regionHeight(0), _inputWidth(0), _inputHeight(0),
+			_connectionRadius(0), _columnSize(0), _numThreads(1), _tileSize(16), _current(0), _numUnusedSynapses(0), _synapseActiveStatesSet(false)
+		{}
+
+		void createRandom(int inputWidth, int inputHeight, int connectionRadius, float initInhibitionRadius, int initNumSegments,
+			int regionWidth, int regionHeight, int columnSize, float permanenceDistanceBias, float permanenceDistanceFalloff, float permanenceBiasFloor,
+			float connectionPermanenceTarget, float connectionPermanenceStdDev, std::mt19937 &generator);
+
+		void spatialPooling(const std::vector<bool> &inputs, float minPermanence, float minOverlap, int desiredLocalActivity,
+			float permanenceIncrease, float permanenceDecrease, float minDutyCycleRatio, float activeDutyCycleDecay,
+			float overlapDutyCycleDecay, float subOverlapPermanenceIncrease,
+			std::function<float(float, float)> &boostFunction);
+
+		void setNumThreads(int numThreads) {
+			_numThreads = std::max(1, numThreads);
+		}
+
+		void setTileSize(int tileSize) {
+			_tileSize = std::max(1, tileSize);
+		}
+
+		int getNumThreads() const {
+			return _numThreads;
+		}
+
+		int getTileSize() const {
+			return _tileSize;
+		}
+
+		void stepBegin();
+		void temporalPoolingNoLearn(float minPermanence, int activationThreshold);
+		void temporalPoolingLearn(float minPermanence, int learningRadius, int minLearningThreshold, int activationThreshold, int newNumConnections, float permanenceIncrease, float permanenceDecrease, float newConnectionPermanence, int maxSteps, std::mt19937 &generator);
+
+		bool getOutput(int i) const;
+		bool getOutput(int x, int y) const;
+		bool getPrediction(int i, int t) const;
+		bool getPrediction(int x, int y, int t) const;
+		void setColumnsToOutput();
+		bool hasLearningCell(int x, int y) const;
+		bool hasSegments(int x, int y) const;
+		bool hasConnections(int x, int y) const;
+		void getReconstruction(std::vector<bool> &output, float minOverlap, float minPermanence, bool fromPrediction) const;
+		void getReconstructionAtTime(std::vector<bool> &output, float minOverlap, float minPermanence, int t) const;
+
+		bool isColumnActive(int i) const {
+			return _columnActiveStates[i];
+		}
+
+		bool isCellActive(int i, int j) const {
+			return _cellActiveStates[_current][i * _columnSize + j];
+		}
+
+		bool isCellPredictive(int i, int j) const {
+			return _cellPredictiveStates[_current][i * _columnSize + j];
+		}
+
+		int getNumSegments(int i, int j) const {
+			return _cellSegments[i * _columnSize + j].size();
+		}
+
+		int getColumnSize() const {
+			return _columnSize;
+		}
+
+		int getRegionWidth() const {
+			return _regionWidth;
+		}
+
+		int getRegionHeight() const {
+			return _regionHeight;
+		}
+
+		int getInputWidth() const {
+			return _inputWidth;
+		}
+
+		int getInputHeight() const {
+			return _inputHeight;
+		}
+
+		int getConnectionRadius() const {
+			return _connectionRadius;
+		}
+	};
+}
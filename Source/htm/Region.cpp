@@ -291,129 +291,92 @@ void Region::getReconstructionAtTime(std::vector<bool> &output, float minOverlap
 	}
 }
 
-void Region::spatialPooling(const std::vector<bool> &inputs, float minPermanence, float minOverlap, int desiredLocalActivity,
-	float permanenceIncrease, float permanenceDecrease, float minDutyCycleRatio, float activeDutyCycleDecay,
-	float overlapDutyCycleDecay, float subOverlapPermanenceIncrease,
-	std::function<float(float, float)> &boostFunction)
-{
-	_activeColumnIndices.clear();
+void Region::getTileBounds(int tile, int &startX, int &startY, int &endX, int &endY) const {
+	int numTilesX = (_regionWidth + _tileSize - 1) / _tileSize;
 
-	size_t connectionSize = 4 * _connectionRadius * _connectionRadius;
+	startX = (tile % numTilesX) * _tileSize;
+	startY = (tile / numTilesX) * _tileSize;
+	endX = std::min(startX + _tileSize, _regionWidth);
+	endY = std::min(startY + _tileSize, _regionHeight);
+}
 
-	float regionWidthInv = 1.0f / _regionWidth;
-	float regionHeightInv = 1.0f / _regionHeight;
+int Region::getNumTiles() const {
+	return ((_regionWidth + _tileSize - 1) / _tileSize) * ((_regionHeight + _tileSize - 1) / _tileSize);
+}
 
-	int totalReceptiveFieldSize = 0;
+int Region::calculateOverlap(int i, const std::vector<bool> &inputs, float minPermanence, float minOverlap, float overlapDutyCycleDecay) {
+	Column &column = _columns[i];
 
-	for (int i = 0; i < _columns.size(); i++) {
-		Column &column = _columns[i];
+	int columnX = i % _regionWidth;
+	int columnY = i / _regionWidth;
 
-		int columnX = i % _regionWidth;
-		int columnY = i / _regionWidth;
+	float regionWidthInv = 1.0f / _regionWidth;
+	float regionHeightInv = 1.0f / _regionHeight;
 
-		float columnXf = static_cast<float>(columnX) * regionWidthInv;
-		float columnYf = static_cast<float>(columnY) * regionHeightInv;
+	float columnXf = static_cast<float>(columnX) * regionWidthInv;
+	float columnYf = static_cast<float>(columnY) * regionHeightInv;
 
-		int inputX = static_cast<int>(columnXf * _inputWidth);
-		int inputY = static_cast<int>(columnYf * _inputHeight);
+	int inputX = static_cast<int>(columnXf * _inputWidth);
+	int inputY = static_cast<int>(columnYf * _inputHeight);
 
-		int connectionIndex = 0;
+	int connectionIndex = 0;
 
-		int receptiveFieldSize = 0;
-		
-		// Calculate overlap
-		float overlap = 0.0f;
+	int receptiveFieldSize = 0;
 
-		for (int dx = -_connectionRadius; dx <= _connectionRadius; dx++)
-		for (int dy = -_connectionRadius; dy <= _connectionRadius; dy++) {
-			int connectionX = inputX + dx;
-			int connectionY = inputY + dy;
+	// Calculate overlap
+	float overlap = 0.0f;
 
-			// If exists
-			if (connectionX >= 0 && connectionY >= 0 && connectionX < _inputWidth && connectionY < _inputHeight) {
-				column._inputConnections[connectionIndex]._active = false;
+	for (int dx = -_connectionRadius; dx <= _connectionRadius; dx++)
+	for (int dy = -_connectionRadius; dy <= _connectionRadius; dy++) {
+		int connectionX = inputX + dx;
+		int connectionY = inputY + dy;
 
-				if (column._inputConnections[connectionIndex]._permanence > minPermanence) {
-					if (inputs[connectionX + connectionY * _inputWidth]) {
-						column._inputConnections[connectionIndex]._active = true;
-						overlap++;
-					}
+		// If exists
+		if (connectionX >= 0 && connectionY >= 0 && connectionX < _inputWidth && connectionY < _inputHeight) {
+			column._inputConnections[connectionIndex]._active = false;
 
-					receptiveFieldSize = std::max(receptiveFieldSize, std::max(std::abs(dx), std::abs(dy)));
+			if (column._inputConnections[connectionIndex]._permanence > minPermanence) {
+				if (inputs[connectionX + connectionY * _inputWidth]) {
+					column._inputConnections[connectionIndex]._active = true;
+					overlap++;
 				}
 
-				connectionIndex++;
+				receptiveFieldSize = std::max(receptiveFieldSize, std::max(std::abs(dx), std::abs(dy)));
 			}
-		}
-
-		totalReceptiveFieldSize += receptiveFieldSize;
 
-		if (overlap < minOverlap) {
-			overlap = 0.0f;
-			column._overlapDutyCycle = (1.0f - overlapDutyCycleDecay) * column._overlapDutyCycle;
+			connectionIndex++;
 		}
-		else {
-			overlap *= column._boost;
-
-			column._overlapDutyCycle = (1.0f - overlapDutyCycleDecay) * column._overlapDutyCycle + overlapDutyCycleDecay;
-		}
-
-		column._overlap = overlap;
 	}
 
-	float averageReceptiveFieldSize = static_cast<float>(totalReceptiveFieldSize) / _columns.size();
-
-	for (int i = 0; i < _columns.size(); i++) {
-		Column &column = _columns[i];
-
-		column._active = false;
-
-		if (column._overlap > 0.0f) {
-			int columnX = i % _regionWidth;
-			int columnY = i / _regionWidth;
-
-			int numHigherThanThis = 0;
+	if (overlap < minOverlap) {
+		overlap = 0.0f;
+		column._overlapDutyCycle = (1.0f - overlapDutyCycleDecay) * column._overlapDutyCycle;
+	}
+	else {
+		overlap *= column._boost;
 
-			int inhibitionRadius = std::ceil(column._inhibitionRadius);
+		column._overlapDutyCycle = (1.0f - overlapDutyCycleDecay) * column._overlapDutyCycle + overlapDutyCycleDecay;
+	}
 
-			// Gather columns in inhibition radius
-			for (int dx = -inhibitionRadius; dx <= inhibitionRadius; dx++)
-			for (int dy = -inhibitionRadius; dy <= inhibitionRadius; dy++) {
-				int inhibitionX = columnX + dx;
-				int inhibitionY = columnY + dy;
+	column._overlap = overlap;
 
-				// If exists
-				if (inhibitionX >= 0 && inhibitionY >= 0 && inhibitionX < _regionWidth && inhibitionY < _regionHeight)
-				if (_columns[inhibitionX + inhibitionY * _regionWidth]._overlap > column._overlap)
-					numHigherThanThis++;
-			}
+	return receptiveFieldSize;
+}
 
-			if (numHigherThanThis < desiredLocalActivity) {
-				column._active = true;
-
-				_activeColumnIndices.push_back(i);
-				
-				// Update synapses
-				for (int j = 0; j < column._inputConnections.size(); j++)
-				if (column._inputConnections[j]._active)
-					column._inputConnections[j]._permanence = std::min(1.0f, column._inputConnections[j]._permanence + permanenceIncrease);
-				else
-					column._inputConnections[j]._permanence = std::max(0.0f, column._inputConnections[j]._permanence - permanenceDecrease);
-			}
-		}
-	}
+void Region::inhibit(int i, int desiredLocalActivity, float permanenceIncrease, float permanenceDecrease) {
+	Column &column = _columns[i];
 
-	for (int i = 0; i < _columns.size(); i++) {
-		Column &column = _columns[i];
+	column._active = false;
 
+	if (column._overlap > 0.0f) {
 		int columnX = i % _regionWidth;
 		int columnY = i / _regionWidth;
 
-		float maxNeighborhoodDutyCycle = -999999.0f;
+		int numHigherThanThis = 0;
 
-		// Columns in inhibition radius
 		int inhibitionRadius = std::ceil(column._inhibitionRadius);
 
+		// Gather columns in inhibition radius
 		for (int dx = -inhibitionRadius; dx <= inhibitionRadius; dx++)
 		for (int dy = -inhibitionRadius; dy <= inhibitionRadius; dy++) {
 			int inhibitionX = columnX + dx;
@@ -421,22 +384,119 @@ void Region::spatialPooling(const std::vector<bool> &inputs, float minPermanence
 
 			// If exists
 			if (inhibitionX >= 0 && inhibitionY >= 0 && inhibitionX < _regionWidth && inhibitionY < _regionHeight)
-				maxNeighborhoodDutyCycle = std::max(maxNeighborhoodDutyCycle, _columns[inhibitionX + inhibitionY * _regionWidth]._activeDutyCycle);
+			if (_columns[inhibitionX + inhibitionY * _regionWidth]._overlap > column._overlap)
+				numHigherThanThis++;
+		}
+
+		if (numHigherThanThis < desiredLocalActivity) {
+			column._active = true;
+
+			// Update synapses
+			for (int j = 0; j < column._inputConnections.size(); j++)
+			if (column._inputConnections[j]._active)
+				column._inputConnections[j]._permanence = std::min(1.0f, column._inputConnections[j]._permanence + permanenceIncrease);
+			else
+				column._inputConnections[j]._permanence = std::max(0.0f, column._inputConnections[j]._permanence - permanenceDecrease);
 		}
+	}
+}
+
+void Region::updateDutyCycles(int i, float minPermanence, float minDutyCycleRatio, float subOverlapPermanenceIncrease,
+	std::function<float(float, float)> &boostFunction)
+{
+	Column &column = _columns[i];
 
-		column._minDutyCycle = minDutyCycleRatio * maxNeighborhoodDutyCycle;
+	int columnX = i % _regionWidth;
+	int columnY = i / _regionWidth;
 
-		column._activeDutyCycle = (1.0f - activeDutyCycleDecay) * column._activeDutyCycle + activeDutyCycleDecay * (column._active ? 1.0f : 0.0f);
+	float maxNeighborhoodDutyCycle = -999999.0f;
 
-		column._boost = boostFunction(column._activeDutyCycle, column._minDutyCycle);
+	// Columns in inhibition radius. The serial order updated the columns before this one first, so those use their new duty cycles
+	int inhibitionRadius = std::ceil(column._inhibitionRadius);
 
-		if (column._overlapDutyCycle < column._minDutyCycle) {
-			// Increase all permanences
-			for (int j = 0; j < column._inputConnections.size(); j++)
-				column._inputConnections[j]._permanence += subOverlapPermanenceIncrease * minPermanence;
+	for (int dx = -inhibitionRadius; dx <= inhibitionRadius; dx++)
+	for (int dy = -inhibitionRadius; dy <= inhibitionRadius; dy++) {
+		int inhibitionX = columnX + dx;
+		int inhibitionY = columnY + dy;
+
+		// If exists
+		if (inhibitionX >= 0 && inhibitionY >= 0 && inhibitionX < _regionWidth && inhibitionY < _regionHeight) {
+			int inhibitionIndex = inhibitionX + inhibitionY * _regionWidth;
+
+			maxNeighborhoodDutyCycle = std::max(maxNeighborhoodDutyCycle, inhibitionIndex < i ? _newActiveDutyCycles[inhibitionIndex] : _columns[inhibitionIndex]._activeDutyCycle);
 		}
+	}
+
+	column._minDutyCycle = minDutyCycleRatio * maxNeighborhoodDutyCycle;
+
+	column._boost = boostFunction(_newActiveDutyCycles[i], column._minDutyCycle);
 
-		column._inhibitionRadius = averageReceptiveFieldSize;
+	if (column._overlapDutyCycle < column._minDutyCycle) {
+		// Increase all permanences
+		for (int j = 0; j < column._inputConnections.size(); j++)
+			column._inputConnections[j]._permanence += subOverlapPermanenceIncrease * minPermanence;
+	}
+}
+
+void Region::spatialPooling(const std::vector<bool> &inputs, float minPermanence, float minOverlap, int desiredLocalActivity,
+	float permanenceIncrease, float permanenceDecrease, float minDutyCycleRatio, float activeDutyCycleDecay,
+	float overlapDutyCycleDecay, float subOverlapPermanenceIncrease,
+	std::function<float(float, float)> &boostFunction)
+{
+	int numTiles = getNumTiles();
+
+	int totalReceptiveFieldSize = 0;
+
+#pragma omp parallel for schedule(static) num_threads(_numThreads) reduction(+:totalReceptiveFieldSize)
+	for (int t = 0; t < numTiles; t++) {
+		int startX, startY, endX, endY;
+
+		getTileBounds(t, startX, startY, endX, endY);
+
+		for (int y = startY; y < endY; y++)
+		for (int x = startX; x < endX; x++)
+			totalReceptiveFieldSize += calculateOverlap(x + y * _regionWidth, inputs, minPermanence, minOverlap, overlapDutyCycleDecay);
+	}
+
+	float averageReceptiveFieldSize = static_cast<float>(totalReceptiveFieldSize) / _columns.size();
+
+#pragma omp parallel for schedule(static) num_threads(_numThreads)
+	for (int t = 0; t < numTiles; t++) {
+		int startX, startY, endX, endY;
+
+		getTileBounds(t, startX, startY, endX, endY);
+
+		for (int y = startY; y < endY; y++)
+		for (int x = startX; x < endX; x++)
+			inhibit(x + y * _regionWidth, desiredLocalActivity, permanenceIncrease, permanenceDecrease);
+	}
+
+	_activeColumnIndices.clear();
+
+	for (int i = 0; i < _columns.size(); i++)
+	if (_columns[i]._active)
+		_activeColumnIndices.push_back(i);
+
+	// New duty cycles only depend on the column itself
+	_newActiveDutyCycles.resize(_columns.size());
+
+	for (int i = 0; i < _columns.size(); i++)
+		_newActiveDutyCycles[i] = (1.0f - activeDutyCycleDecay) * _columns[i]._activeDutyCycle + activeDutyCycleDecay * (_columns[i]._active ? 1.0f : 0.0f);
+
+#pragma omp parallel for schedule(static) num_threads(_numThreads)
+	for (int t = 0; t < numTiles; t++) {
+		int startX, startY, endX, endY;
+
+		getTileBounds(t, startX, startY, endX, endY);
+
+		for (int y = startY; y < endY; y++)
+		for (int x = startX; x < endX; x++)
+			updateDutyCycles(x + y * _regionWidth, minPermanence, minDutyCycleRatio, subOverlapPermanenceIncrease, boostFunction);
+	}
+
+	for (int i = 0; i < _columns.size(); i++) {
+		_columns[i]._activeDutyCycle = _newActiveDutyCycles[i];
+		_columns[i]._inhibitionRadius = averageReceptiveFieldSize;
 	}
 }
 
@@ -1139,4 +1199,168 @@ void Region::temporalPoolingLearn(float minPermanence, int learningRadius, int m
 			}
 		}
 	}
+}
+
+void Region::writeToCheckpoint(io::CheckpointWriter &writer, const std::string &prefix) const {
+	int columnSize = _columns.empty() ? 0 : _columns[0]._cells.size();
+
+	int dims[6] = { _inputWidth, _inputHeight, _connectionRadius, _regionWidth, _regionHeight, columnSize };
+
+	writer.addInts(prefix + "dims", dims, 6);
+
+	// Column values are stored as 5 floats per column (boost, active duty cycle, overlap duty cycle, min duty cycle, inhibition radius)
+	std::vector<float> columnValues;
+	std::vector<int> inputConnectionCounts;
+	std::vector<float> inputPermanences;
+
+	// Segments are listed cell by cell, 3 ints per segment (prediction steps, sequence segment, number of synapses)
+	std::vector<int> cellNumSegments;
+	std::vector<int> segmentValues;
+	std::vector<int> synapseIndices;
+	std::vector<float> synapsePermanences;
+
+	for (int i = 0; i < _columns.size(); i++) {
+		const Column &column = _columns[i];
+
+		columnValues.push_back(column._boost);
+		columnValues.push_back(column._activeDutyCycle);
+		columnValues.push_back(column._overlapDutyCycle);
+		columnValues.push_back(column._minDutyCycle);
+		columnValues.push_back(column._inhibitionRadius);
+
+		inputConnectionCounts.push_back(column._inputConnections.size());
+
+		for (int ci = 0; ci < column._inputConnections.size(); ci++)
+			inputPermanences.push_back(column._inputConnections[ci]._permanence);
+
+		for (int j = 0; j < column._cells.size(); j++) {
+			const Cell &cell = column._cells[j];
+
+			cellNumSegments.push_back(cell._segments.size());
+
+			for (int k = 0; k < cell._segments.size(); k++) {
+				const Segment &segment = cell._segments[k];
+
+				segmentValues.push_back(segment._numPredictionSteps);
+				segmentValues.push_back(segment._sequenceSegment ? 1 : 0);
+				segmentValues.push_back(segment._connections.size());
+
+				for (std::unordered_map<ColumnAndCellIndices, Connection, ColumnAndCellIndices>::const_iterator it = segment._connections.begin(); it != segment._connections.end(); it++) {
+					synapseIndices.push_back(it->first._columnIndex);
+					synapseIndices.push_back(it->first._cellIndex);
+					synapsePermanences.push_back(it->second._permanence);
+				}
+			}
+		}
+	}
+
+	writer.addFloats(prefix + "columnValues", columnValues);
+	writer.addInts(prefix + "inputConnectionCounts", inputConnectionCounts);
+	writer.addFloats(prefix + "inputPermanences", inputPermanences);
+	writer.addInts(prefix + "cellNumSegments", cellNumSegments);
+	writer.addInts(prefix + "segmentValues", segmentValues);
+	writer.addInts(prefix + "synapseIndices", synapseIndices);
+	writer.addFloats(prefix + "synapsePermanences", synapsePermanences);
+}
+
+bool Region::readFromCheckpoint(const io::CheckpointReader &reader, const std::string &prefix) {
+	int dims[6];
+
+	if (!reader.readInts(prefix + "dims", dims, 6))
+		return false;
+
+	std::vector<float> columnValues;
+	std::vector<int> inputConnectionCounts;
+	std::vector<float> inputPermanences;
+	std::vector<int> cellNumSegments;
+	std::vector<int> segmentValues;
+	std::vector<int> synapseIndices;
+	std::vector<float> synapsePermanences;
+
+	if (!reader.readFloats(prefix + "columnValues", columnValues) ||
+		!reader.readInts(prefix + "inputConnectionCounts", inputConnectionCounts) ||
+		!reader.readFloats(prefix + "inputPermanences", inputPermanences) ||
+		!reader.readInts(prefix + "cellNumSegments", cellNumSegments) ||
+		!reader.readInts(prefix + "segmentValues", segmentValues) ||
+		!reader.readInts(prefix + "synapseIndices", synapseIndices) ||
+		!reader.readFloats(prefix + "synapsePermanences", synapsePermanences))
+		return false;
+
+	int numColumns = dims[3] * dims[4];
+	int columnSize = dims[5];
+
+	if (numColumns < 0 || columnSize < 0 || columnValues.size() != numColumns * 5 || inputConnectionCounts.size() != numColumns ||
+		cellNumSegments.size() != numColumns * columnSize || segmentValues.size() % 3 != 0 || synapseIndices.size() != synapsePermanences.size() * 2)
+		return false;
+
+	_inputWidth = dims[0];
+	_inputHeight = dims[1];
+	_connectionRadius = dims[2];
+	_regionWidth = dims[3];
+	_regionHeight = dims[4];
+
+	_columns.clear();
+	_columns.resize(numColumns);
+
+	_activeColumnIndices.clear();
+
+	size_t inputPermanenceIndex = 0;
+	size_t segmentIndex = 0;
+	size_t synapseIndex = 0;
+
+	for (int i = 0; i < numColumns; i++) {
+		Column &column = _columns[i];
+
+		column._boost = columnValues[i * 5 + 0];
+		column._activeDutyCycle = columnValues[i * 5 + 1];
+		column._overlapDutyCycle = columnValues[i * 5 + 2];
+		column._minDutyCycle = columnValues[i * 5 + 3];
+		column._inhibitionRadius = columnValues[i * 5 + 4];
+
+		if (inputConnectionCounts[i] < 0 || inputPermanenceIndex + inputConnectionCounts[i] > inputPermanences.size())
+			return false;
+
+		column._inputConnections.resize(inputConnectionCounts[i]);
+
+		for (int ci = 0; ci < column._inputConnections.size(); ci++)
+			column._inputConnections[ci]._permanence = inputPermanences[inputPermanenceIndex++];
+
+		column._cells.resize(columnSize);
+
+		for (int j = 0; j < columnSize; j++) {
+			Cell &cell = column._cells[j];
+
+			int numSegments = cellNumSegments[i * columnSize + j];
+
+			if (numSegments < 0 || (segmentIndex + numSegments) * 3 > segmentValues.size())
+				return false;
+
+			cell._segments.resize(numSegments);
+
+			for (int k = 0; k < numSegments; k++) {
+				Segment &segment = cell._segments[k];
+
+				segment._numPredictionSteps = segmentValues[segmentIndex * 3 + 0];
+				segment._sequenceSegment = segmentValues[segmentIndex * 3 + 1] != 0;
+
+				int numSynapses = segmentValues[segmentIndex * 3 + 2];
+
+				segmentIndex++;
+
+				if (numSynapses < 0 || synapseIndex + numSynapses > synapsePermanences.size())
+					return false;
+
+				for (int s = 0; s < numSynapses; s++) {
+					Connection connection;
+					connection._permanence = synapsePermanences[synapseIndex];
+
+					segment._connections[ColumnAndCellIndices(synapseIndices[synapseIndex * 2 + 0], synapseIndices[synapseIndex * 2 + 1])] = connection;
+
+					synapseIndex++;
+				}
+			}
+		}
+	}
+
+	return inputPermanenceIndex == inputPermanences.size() && segmentIndex * 3 == segmentValues.size() && synapseIndex == synapsePermanences.size();
 }
\ No newline at end of file
@@ -22,9 +22,12 @@ misrepresented as being the original software.
 #pragma once
 
 #include <htm/Column.h>
+#include <io/CheckpointWriter.h>
+#include <io/CheckpointReader.h>
 
 #include <random>
 #include <functional>
+#include <algorithm>
 
 namespace htm {
 	class Region {
@@ -39,11 +42,30 @@ namespace htm {
 
 		std::vector<int> _activeColumnIndices;
 
+		// Spatial pooling is split into _tileSize x _tileSize tiles of columns, processed by _numThreads threads (OpenMP)
+		int _numThreads;
+		int _tileSize;
+
+		std::vector<float> _newActiveDutyCycles;
+
+		int getNumTiles() const;
+		void getTileBounds(int tile, int &startX, int &startY, int &endX, int &endY) const;
+
+		int calculateOverlap(int i, const std::vector<bool> &inputs, float minPermanence, float minOverlap, float overlapDutyCycleDecay);
+		void inhibit(int i, int desiredLocalActivity, float permanenceIncrease, float permanenceDecrease);
+		void updateDutyCycles(int i, float minPermanence, float minDutyCycleRatio, float subOverlapPermanenceIncrease,
+			std::function<float(float, float)> &boostFunction);
+
 		void getBestMatchingCell(int columnIndex, int &cellIndex, int &segmentIndex, int predictionSteps, bool usePrevious, std::mt19937 &generator);
 		void getBestMatchingSegment(int columnIndex, int cellIndex, int &segmentIndex, int predictionSteps, bool usePrevious);
 		void updateSegmentActiveSynapses(int columnIndex, int cellIndex, int segmentIndex, bool usePrevious, int numConnections, int learningRadius, SegmentUpdateType updateType, SegmentUpdate &segmentUpdate, std::mt19937 &generator);
 
 	public:
+		Region()
+			: _regionWidth(0), _regionHeight(0), _inputWidth(0), _inputHeight(0), _connectionRadius(0),
+			_numThreads(1), _tileSize(16)
+		{}
+
 		void createRandom(int inputWidth, int inputHeight, int connectionRadius, float initInhibitionRadius, int initNumSegments,
 			int regionWidth, int regionHeight, int columnSize, float permanenceDistanceBias, float permanenceDistanceFalloff, float permanenceBiasFloor,
 			float connectionPermanenceTarget, float connectionPermanenceStdDev, std::mt19937 &generator);
@@ -53,6 +75,24 @@ namespace htm {
 			float overlapDutyCycleDecay, float subOverlapPermanenceIncrease,
 			std::function<float(float, float)> &boostFunction);
 
+		// Results do not depend on the number of threads or the tile size. With more than one thread,
+		// the boost function passed to spatialPooling is called concurrently
+		void setNumThreads(int numThreads) {
+			_numThreads = std::max(1, numThreads);
+		}
+
+		void setTileSize(int tileSize) {
+			_tileSize = std::max(1, tileSize);
+		}
+
+		int getNumThreads() const {
+			return _numThreads;
+		}
+
+		int getTileSize() const {
+			return _tileSize;
+		}
+
 		void stepBegin();
 		void temporalPoolingNoLearn(float minPermanence, int activationThreshold);
 		void temporalPoolingLearn(float minPermanence, int learningRadius, int minLearningThreshold, int activationThreshold, int newNumConnections, float permanenceIncrease, float permanenceDecrease, float newConnectionPermanence, int maxSteps, std::mt19937 &generator);
@@ -76,6 +116,11 @@ namespace htm {
 		void getReconstruction(std::vector<bool> &output, float minOverlap, float minPermanence, bool fromPrediction) const;
 		void getReconstructionAtTime(std::vector<bool> &output, float minOverlap, float minPermanence, int t) const;
 
+		// Binary checkpoint of the learned state (column duty cycles and boosts, proximal and distal permanences).
+		// Cell and segment activity is not stored, a loaded region starts from a cleared state
+		void writeToCheckpoint(io::CheckpointWriter &writer, const std::string &prefix) const;
+		bool readFromCheckpoint(const io::CheckpointReader &reader, const std::string &prefix);
+
 		int getRegionWidth() const {
 			return _regionWidth;
 		}
@@ -30,6 +30,7 @@ misrepresented as being the original software.
 #include <deep/FERL.h>
 
 #include <algorithm>
+#include <list>
 
 #include <assert.h>
 
@@ -28,6 +28,7 @@ misrepresented as being the original software.
 #include <rbf/RBFNetwork.h>
 
 #include <algorithm>
+#include <list>
 
 #include <assert.h>
 
@@ -29,7 +29,8 @@ misrepresented as being the original software.
 using namespace hn;
 
 BayesianOptimizer::BayesianOptimizer()
-: _defaultStdDev(100.0f)
+: _bestFitness(0.0f), _nextCandidateId(0), _defaultStdDev(100.0f), _maxNumSamples(0),
+_numProposals(16), _explorationWeight(1.0f), _penalizationRadius(0.5f)
 {}
 
 void BayesianOptimizer::create(size_t numVariables, const std::vector<float> &minBounds, const std::vector<float> &maxBounds) {
@@ -38,6 +39,9 @@ void BayesianOptimizer::create(size_t numVariables, const std::vector<float> &mi
 	_minBounds = minBounds;
 	_maxBounds = maxBounds;
 
+	_bestVariables.clear();
+	_pendingCandidates.clear();
+
 	assert(numVariables == _minBounds.size() && _minBounds.size() == _maxBounds.size());
 }
 
@@ -53,26 +57,150 @@ void BayesianOptimizer::generateNewVariables(std::mt19937 &generator) {
 		}
 	}
 	else {
-		// Find highest valued data sample
-		SampleField::Sample highest = _sampleField.getSample(0);
-
-		for (size_t s = 1; s < _sampleField.getNumSamples(); s++)
-		if (_sampleField.getSample(s)._y[0] > highest._y[0])
-			highest = _sampleField.getSample(s);
+		_yAtX.resize(_sampleField.getYSize());
 
-		float stdDev = _defaultStdDev / (1.0f + std::sqrt(_sampleField.getVarianceAtX(highest._x)));
+		float stdDev = _defaultStdDev / (1.0f + std::sqrt(_sampleField.getVarianceAtX(_bestVariables.data(), _yAtX.data(), _neighbours)));
 		
 		std::normal_distribution<float> distNormal(0.0f, stdDev);
 
 		for (size_t xi = 0; xi < _currentVariables.size(); xi++)
-			_currentVariables[xi] = std::max(_minBounds[xi], std::min(_maxBounds[xi], highest._x[xi] + distNormal(generator)));
+			_currentVariables[xi] = std::max(_minBounds[xi], std::min(_maxBounds[xi], _bestVariables[xi] + distNormal(generator)));
 	}
 }
 
 void BayesianOptimizer::update(float fitness) {
-	SampleField::Sample s;
-	s._x = _currentVariables;
-	s._y = std::vector<float>(1, fitness);
+	addSample(_currentVariables, fitness);
+}
+
+void BayesianOptimizer::generateCandidates(size_t numCandidates, std::vector<size_t> &ids, std::mt19937 &generator) {
+	size_t numVariables = _sampleField.getXSize();
+
+	// Totally random proposals if below 2 samples
+	bool random = _sampleField.getNumSamples() < 2;
+
+	_yAtX.resize(_sampleField.getYSize());
+
+	float stdDev = _defaultStdDev;
+
+	if (!random)
+		stdDev /= 1.0f + std::sqrt(_sampleField.getVarianceAtX(_bestVariables.data(), _yAtX.data(), _neighbours));
+
+	// Proposals lie about stdDev * sqrt(numVariables) from the best sample
+	float radius = 0.0f;
+
+	if (random) {
+		for (size_t xi = 0; xi < numVariables; xi++)
+			radius += (_maxBounds[xi] - _minBounds[xi]) * (_maxBounds[xi] - _minBounds[xi]);
+
+		radius = std::sqrt(radius);
+	}
+	else
+		radius = stdDev * std::sqrt(static_cast<float>(numVariables));
+
+	float penalizationScale = 1.0f / std::max(0.0001f, 2.0f * (_penalizationRadius * radius) * (_penalizationRadius * radius));
+
+	std::normal_distribution<float> distNormal(0.0f, stdDev);
+
+	_proposals.resize(_numProposals * numVariables);
+	_proposalAcquisitions.resize(_numProposals);
+
+	for (size_t c = 0; c < numCandidates; c++) {
+		for (size_t p = 0; p < _numProposals; p++) {
+			float* pProposal = &_proposals[p * numVariables];
+
+			for (size_t xi = 0; xi < numVariables; xi++) {
+				if (random) {
+					std::uniform_real_distribution<float> distBounds(_minBounds[xi], _maxBounds[xi]);
+
+					pProposal[xi] = distBounds(generator);
+				}
+				else
+					pProposal[xi] = std::max(_minBounds[xi], std::min(_maxBounds[xi], _bestVariables[xi] + distNormal(generator)));
+			}
+
+			if (random)
+				_proposalAcquisitions[p] = 0.0f;
+			else {
+				float variance = _sampleField.getVarianceAtX(pProposal, _yAtX.data(), _neighbours);
+
+				_proposalAcquisitions[p] = _yAtX[0] + _explorationWeight * variance;
+			}
+		}
+
+		// Acquisitions are rescaled to [0, 1] so the penalization can multiply them
+		float minimum = *std::min_element(_proposalAcquisitions.begin(), _proposalAcquisitions.end());
+		float maximum = *std::max_element(_proposalAcquisitions.begin(), _proposalAcquisitions.end());
+		float rangeInv = maximum > minimum ? 1.0f / (maximum - minimum) : 0.0f;
+
+		size_t bestProposal = 0;
+		float bestScore = -1.0f;
+
+		for (size_t p = 0; p < _numProposals; p++) {
+			const float* pProposal = &_proposals[p * numVariables];
+
+			float score = maximum > minimum ? (_proposalAcquisitions[p] - minimum) * rangeInv : 1.0f;
+
+			for (size_t i = 0; i < _pendingCandidates.size(); i++) {
+				const std::vector<float> &pending = _pendingCandidates[i]._variables;
+
+				float distanceSquared = 0.0f;
+
+				for (size_t xi = 0; xi < numVariables; xi++) {
+					float difference = pProposal[xi] - pending[xi];
+					distanceSquared += difference * difference;
+				}
+
+				score *= 1.0f - std::exp(-distanceSquared * penalizationScale);
+			}
+
+			if (score > bestScore) {
+				bestScore = score;
+				bestProposal = p;
+			}
+		}
+
+		Candidate candidate;
+		candidate._id = _nextCandidateId++;
+		candidate._variables.assign(_proposals.begin() + bestProposal * numVariables, _proposals.begin() + (bestProposal + 1) * numVariables);
+
+		_pendingCandidates.push_back(candidate);
+
+		ids.push_back(candidate._id);
+	}
+}
+
+void BayesianOptimizer::updateCandidate(size_t id, float fitness) {
+	for (size_t i = 0; i < _pendingCandidates.size(); i++)
+	if (_pendingCandidates[i]._id == id) {
+		addSample(_pendingCandidates[i]._variables, fitness);
+
+		_pendingCandidates.erase(_pendingCandidates.begin() + i);
+
+		return;
+	}
+
+	assert(false);
+}
+
+const std::vector<float> &BayesianOptimizer::getCandidateVariables(size_t id) const {
+	for (size_t i = 0; i < _pendingCandidates.size(); i++)
+	if (_pendingCandidates[i]._id == id)
+		return _pendingCandidates[i]._variables;
+
+	assert(false);
+
+	return _currentVariables;
+}
+
+void BayesianOptimizer::addSample(const std::vector<float> &variables, float fitness) {
+	_sampleField.addSample(variables.data(), &fitness);
+
+	if (_bestVariables.empty() || fitness > _bestFitness) {
+		_bestVariables = variables;
+		_bestFitness = fitness;
+	}
 
-	_sampleField.addSample(s);
+	// Compress to half the limit so this does not run on every update
+	if (_maxNumSamples != 0 && _sampleField.getNumSamples() > _maxNumSamples)
+		_sampleField.compress(_maxNumSamples / 2);
 }
\ No newline at end of file
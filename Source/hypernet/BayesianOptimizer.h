@@ -27,14 +27,45 @@ misrepresented as being the original software.
 namespace hn {
 	class BayesianOptimizer {
 	private:
+		struct Candidate {
+			size_t _id;
+			std::vector<float> _variables;
+		};
+
 		std::vector<float> _currentVariables;
 
 		std::vector<float> _minBounds, _maxBounds;
 
+		// Highest valued sample so far, tracked on update so compressed fields do not lose it
+		std::vector<float> _bestVariables;
+		float _bestFitness;
+
+		// Query buffers
+		std::vector<SampleField<>::Neighbour> _neighbours;
+		std::vector<float> _yAtX;
+
+		// Proposed candidates whose fitness has not been reported yet
+		std::vector<Candidate> _pendingCandidates;
+		size_t _nextCandidateId;
+
+		std::vector<float> _proposals;
+		std::vector<float> _proposalAcquisitions;
+
+		void addSample(const std::vector<float> &variables, float fitness);
+
 	public:
 		float _defaultStdDev;
 
-		SampleField _sampleField;
+		// Compress the sample field into inducing points once it holds more samples than this, 0 to never compress
+		size_t _maxNumSamples;
+
+		// Batch proposals: random proposals drawn per candidate, weight of the variance in the acquisition,
+		// and radius of the penalization around pending candidates relative to the proposal spread
+		size_t _numProposals;
+		float _explorationWeight;
+		float _penalizationRadius;
+
+		SampleField<> _sampleField;
 
 		BayesianOptimizer();
 
@@ -44,6 +75,19 @@ namespace hn {
 
 		void update(float fitness);
 
+		// Proposes numCandidates diverse candidates and appends their ids. Each is the best of _numProposals random proposals
+		// under the acquisition (predicted fitness plus weighted variance), multiplied by a local penalization around every pending candidate
+		void generateCandidates(size_t numCandidates, std::vector<size_t> &ids, std::mt19937 &generator);
+
+		// Reports the fitness of a pending candidate, candidates can be reported in any order
+		void updateCandidate(size_t id, float fitness);
+
+		const std::vector<float> &getCandidateVariables(size_t id) const;
+
+		size_t getNumPendingCandidates() const {
+			return _pendingCandidates.size();
+		}
+
 		const std::vector<float> &getCurrentVariables() const {
 			return _currentVariables;
 		}
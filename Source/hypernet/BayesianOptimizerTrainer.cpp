@@ -23,10 +23,14 @@ misrepresented as being the original software.
 
 #include <algorithm>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace hn;
 
 BayesianOptimizerTrainer::BayesianOptimizerTrainer()
-: _runsPerExperiment(4), _fitness(0.0f)
+: _numThreads(1), _numBatches(0), _fitness(0.0f), _runsPerExperiment(4)
 {}
 
 void BayesianOptimizerTrainer::create(const Config &config, float minWeight, float maxWeight, std::mt19937 &generator, float activationMultiplier) {
@@ -63,6 +67,70 @@ void BayesianOptimizerTrainer::update(const Config &config, std::mt19937 &genera
 	_hyperNet.createFromWeightsVector(config, _optimizer.getCurrentVariables());
 }
 
+void BayesianOptimizerTrainer::evaluateBatch(const Config &config, size_t numCandidates, std::mt19937 &generator) {
+	_candidateIds.clear();
+
+	_optimizer.generateCandidates(numCandidates, _candidateIds, generator);
+
+	_candidateHyperNets.resize(numCandidates);
+	_candidateFitnesses.resize(numCandidates);
+
+	for (size_t i = 0; i < numCandidates; i++)
+		_candidateHyperNets[i].createFromWeightsVector(config, _optimizer.getCandidateVariables(_candidateIds[i]));
+
+	_workerExperiments.resize(_numThreads);
+
+	for (int w = 0; w < _numThreads; w++) {
+		_workerExperiments[w].resize(_experiments.size());
+
+		for (size_t j = 0; j < _experiments.size(); j++)
+			_workerExperiments[w][j] = _experiments[j]->clone();
+	}
+
+	unsigned long seed = generator();
+
+	int numCandidatesi = numCandidates;
+
+	// Evaluation times differ between candidates, so they are handed out one at a time
+#pragma omp parallel for schedule(dynamic, 1) num_threads(_numThreads)
+	for (int i = 0; i < numCandidatesi; i++) {
+#ifdef _OPENMP
+		int worker = omp_get_thread_num();
+#else
+		int worker = 0;
+#endif
+
+		float fitness = 0.0f;
+
+		for (size_t j = 0; j < _experiments.size(); j++)
+		for (size_t k = 0; k < _runsPerExperiment; k++) {
+			std::seed_seq runSeed { seed, static_cast<unsigned long>(_numBatches), static_cast<unsigned long>(i), static_cast<unsigned long>(j), static_cast<unsigned long>(k) };
+
+			std::mt19937 runGenerator(runSeed);
+
+			fitness += _workerExperiments[worker][j]->getExperimentWeight() * _workerExperiments[worker][j]->evaluate(_candidateHyperNets[i], config, runGenerator);
+		}
+
+		_candidateFitnesses[i] = fitness / (_experiments.size() * _runsPerExperiment);
+	}
+
+	size_t best = 0;
+
+	for (size_t i = 0; i < numCandidates; i++) {
+		_optimizer.updateCandidate(_candidateIds[i], _candidateFitnesses[i]);
+
+		if (_candidateFitnesses[i] > _candidateFitnesses[best])
+			best = i;
+	}
+
+	if (numCandidates > 0) {
+		_hyperNet = _candidateHyperNets[best];
+		_fitness = _candidateFitnesses[best];
+	}
+
+	_numBatches++;
+}
+
 void BayesianOptimizerTrainer::writeBestToStream(std::ostream &os) const {
 	_hyperNet.writeToStream(os);
 }
\ No newline at end of file
@@ -29,6 +29,17 @@ namespace hn {
 	private:
 		std::vector<std::shared_ptr<Experiment>> _experiments;
 
+		// Experiment copies of each worker thread, index [worker][experiment]
+		std::vector<std::vector<std::shared_ptr<Experiment>>> _workerExperiments;
+
+		int _numThreads;
+
+		size_t _numBatches;
+
+		std::vector<size_t> _candidateIds;
+		std::vector<HyperNet> _candidateHyperNets;
+		std::vector<float> _candidateFitnesses;
+
 		HyperNet _hyperNet;
 		float _fitness;
 
@@ -44,6 +55,20 @@ namespace hn {
 		void evaluate(const Config &config, std::mt19937 &generator);
 
 		void update(const Config &config, std::mt19937 &generator);
+
+		// Proposes numCandidates candidates at once and evaluates them with _numThreads threads (OpenMP).
+		// Every run of an experiment gets its own random stream, seeded from (one draw of generator, batch, candidate, experiment, run),
+		// and fitnesses are reported in candidate order, so results do not depend on the number of threads.
+		// The current HyperNet and fitness become those of the best candidate of the batch
+		void evaluateBatch(const Config &config, size_t numCandidates, std::mt19937 &generator);
+
+		void setNumThreads(int numThreads) {
+			_numThreads = std::max(1, numThreads);
+		}
+
+		int getNumThreads() const {
+			return _numThreads;
+		}
 	
 		void writeBestToStream(std::ostream &os) const;
 
@@ -23,8 +23,6 @@ misrepresented as being the original software.
 
 #include <hypernet/HyperNet.h>
 
-#include <assert.h>
-
 using namespace hn;
 
 Boid::Boid(const Config &config, HyperNet &hypernet, std::mt19937 &generator) {
@@ -42,48 +40,33 @@ Boid::Boid(const Config &config, HyperNet &hypernet, std::mt19937 &generator) {
 	}
 }
 
-void Boid::gatherInput(const Config &config, float reward, class HyperNet &hypernet, std::mt19937 &generator, int myInputOffset, float activationMultiplier) {
-	for (std::unordered_map<int, std::shared_ptr<Link>>::iterator it = _links.begin(); it != _links.end(); it++) {
-		assert(it->second->getInputOffset() != myInputOffset);
-
-		it->second->update(config, reward, hypernet, generator, activationMultiplier);
-
-		for (size_t j = 0; j < _inputs.size(); j++)
-			_inputs[j] += it->second->getResponse(j);
-	}
-}
-
-void Boid::update(const Config &config, float reward, class HyperNet &hypernet, std::mt19937 &generator, int myInputOffset, float activationMultiplier) {
-	// Set inputs
+void Boid::gatherFiringInput(float reward, float random, float* processorInputs) {
 	size_t inputIndex = 0;
 
 	for (size_t i = 0; i < _inputs.size(); i++) {
-		hypernet._boidFiringProcessorInputBuffer[inputIndex++] = _inputs[i];
+		processorInputs[inputIndex++] = _inputs[i];
 
 		// Zero input
 		_inputs[i] = 0.0f;
 	}
 
 	for (size_t i = 0; i < _boidMemory.size(); i++)
-		hypernet._boidFiringProcessorInputBuffer[inputIndex++] = _boidMemory[i];
-
-	hypernet._boidFiringProcessorInputBuffer[inputIndex++] = reward;
+		processorInputs[inputIndex++] = _boidMemory[i];
 
-	// Set additional random input
-	std::uniform_real_distribution<float> dist01(0.0f, 1.0f);
+	processorInputs[inputIndex++] = reward;
 
-	hypernet._boidFiringProcessorInputBuffer[inputIndex++] = dist01(generator);
+	// Additional random input
+	processorInputs[inputIndex++] = random;
 
-	hypernet._boidFiringProcessorInputBuffer[inputIndex++] = static_cast<float>(_links.size()) * 0.125f;
-
-	hypernet._boidFiringProcessor.process(hypernet._boidFiringProcessorInputBuffer, hypernet._boidFiringProcessorOutputBuffer, activationMultiplier);
+	processorInputs[inputIndex++] = static_cast<float>(_links.size()) * 0.125f;
+}
 
-	// Gather outputs
+void Boid::setFiringOutput(const Config &config, const float* processorOutputs) {
 	size_t outputIndex = 0;
 
 	for (size_t i = 0; i < _outputs.size(); i++)
-		_outputs[i] = hypernet._boidFiringProcessorOutputBuffer[outputIndex++] * config._boidOutputScalar;
+		_outputs[i] = processorOutputs[outputIndex++] * config._boidOutputScalar;
 
 	for (size_t i = 0; i < _boidMemory.size(); i++)
-		_boidMemory[i] = hypernet._boidFiringProcessorOutputBuffer[outputIndex++];
+		_boidMemory[i] = processorOutputs[outputIndex++];
 }
\ No newline at end of file
@@ -21,7 +21,8 @@ misrepresented as being the original software.
 
 #pragma once
 
-#include <hypernet/Link.h>
+#include <hypernet/Config.h>
+#include <hypernet/FunctionApproximator.h>
 
 #include <unordered_map>
 #include <memory>
@@ -36,12 +37,15 @@ namespace hn {
 	public:
 		std::vector<float> _inputs;
 
-		std::unordered_map<int, std::shared_ptr<Link>> _links;
+		// Input boid index -> link id, link state is stored in HyperNet
+		std::unordered_map<int, int> _links;
 
 		Boid(const Config &config, class HyperNet &hypernet, std::mt19937 &generator);
 
-		void gatherInput(const Config &config, float reward, class HyperNet &hypernet, std::mt19937 &generator, int myInputOffset, float activationMultiplier);
-		void update(const Config &config, float reward, class HyperNet &hypernet, std::mt19937 &generator, int myInputOffset, float activationMultiplier);
+		// Firing processor input and output rows, the processor itself is run for all boids at once by HyperNet::step.
+		// Gathering the input zeroes the accumulated link responses
+		void gatherFiringInput(float reward, float random, float* processorInputs);
+		void setFiringOutput(const Config &config, const float* processorOutputs);
 
 		size_t getNumOutputs() const {
 			return _outputs.size();
@@ -37,24 +37,22 @@ Decoder::Decoder(const Config &config, HyperNet &hypernet, std::mt19937 &generat
 	}
 }
 
-void Decoder::update(const std::vector<float> &boidOutputs, class HyperNet &hypernet, float activationMultiplier) {
-	// Gather inputs
+void Decoder::gatherInput(const std::vector<float> &boidOutputs, float* processorInputs) const {
 	size_t inputIndex = 0;
 
 	for (size_t i = 0; i < boidOutputs.size(); i++)
-		hypernet._decoderInputBuffer[inputIndex++] = boidOutputs[i];
+		processorInputs[inputIndex++] = boidOutputs[i];
 
 	for (size_t i = 0; i < _decoderMemory.size(); i++)
-		hypernet._decoderInputBuffer[inputIndex++] = _decoderMemory[i];
-
-	hypernet._decoder.process(hypernet._decoderInputBuffer, hypernet._decoderOutputBuffer, activationMultiplier);
+		processorInputs[inputIndex++] = _decoderMemory[i];
+}
 
-	// Gather outputs
+void Decoder::setOutput(const float* processorOutputs) {
 	size_t outputIndex = 0;
 
 	for (size_t i = 0; i < _outputs.size(); i++)
-		_outputs[i] = hypernet._decoderOutputBuffer[outputIndex++];
+		_outputs[i] = processorOutputs[outputIndex++];
 
 	for (size_t i = 0; i < _decoderMemory.size(); i++)
-		_decoderMemory[i] = hypernet._decoderOutputBuffer[outputIndex++];
+		_decoderMemory[i] = processorOutputs[outputIndex++];
 }
\ No newline at end of file
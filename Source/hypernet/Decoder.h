@@ -34,7 +34,9 @@ namespace hn {
 	public:
 		Decoder(const Config &config, class HyperNet &hypernet, std::mt19937 &generator);
 
-		void update(const std::vector<float> &boidOutputs, class HyperNet &hypernet, float activationMultiplier);
+		// Decoder processor input and output rows, the processor itself is run for all decoders at once by HyperNet::step
+		void gatherInput(const std::vector<float> &boidOutputs, float* processorInputs) const;
+		void setOutput(const float* processorOutputs);
 
 		size_t getNumOutputs() const {
 			return _outputs.size();
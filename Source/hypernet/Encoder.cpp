@@ -37,24 +37,22 @@ Encoder::Encoder(const Config &config, HyperNet &hypernet, std::mt19937 &generat
 	}
 }
 
-void Encoder::update(const std::vector<float> &input, HyperNet &hypernet, float activationMultiplier) {
-	// Gather inputs
+void Encoder::gatherInput(const float* input, size_t numInputs, float* processorInputs) const {
 	size_t inputIndex = 0;
 
-	for (size_t i = 0; i < input.size(); i++)
-		hypernet._encoderInputBuffer[inputIndex++] = input[i];
+	for (size_t i = 0; i < numInputs; i++)
+		processorInputs[inputIndex++] = input[i];
 
 	for (size_t i = 0; i < _encoderMemory.size(); i++)
-		hypernet._encoderInputBuffer[inputIndex++] = _encoderMemory[i];
-
-	hypernet._encoder.process(hypernet._encoderInputBuffer, hypernet._encoderOutputBuffer, activationMultiplier);
+		processorInputs[inputIndex++] = _encoderMemory[i];
+}
 
-	// Gather outputs
+void Encoder::setOutput(const float* processorOutputs) {
 	size_t outputIndex = 0;
 
 	for (size_t i = 0; i < _outputs.size(); i++)
-		_outputs[i] = hypernet._encoderOutputBuffer[outputIndex++];
+		_outputs[i] = processorOutputs[outputIndex++];
 	
 	for (size_t i = 0; i < _encoderMemory.size(); i++)
-		_encoderMemory[i] = hypernet._encoderOutputBuffer[outputIndex++];
+		_encoderMemory[i] = processorOutputs[outputIndex++];
 }
\ No newline at end of file
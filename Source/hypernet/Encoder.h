@@ -34,7 +34,9 @@ namespace hn {
 	public:
 		Encoder(const Config &config, class HyperNet &hypernet, std::mt19937 &generator);
 
-		void update(const std::vector<float> &input, class HyperNet &hypernet, float activationMultiplier);
+		// Encoder processor input and output rows, the processor itself is run for all encoders at once by HyperNet::step
+		void gatherInput(const float* input, size_t numInputs, float* processorInputs) const;
+		void setOutput(const float* processorOutputs);
 
 		size_t getNumOutputs() const {
 			return _outputs.size();
@@ -23,10 +23,14 @@ misrepresented as being the original software.
 
 #include <algorithm>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace hn;
 
 EvolutionaryTrainer::EvolutionaryTrainer()
-: _runsPerExperiment(2)
+: _numThreads(1), _generation(0), _runsPerExperiment(2)
 {}
 
 void EvolutionaryTrainer::create(const Config &config, size_t populationSize, std::mt19937 &generator, float activationMultiplier) {
@@ -41,16 +45,43 @@ void EvolutionaryTrainer::evaluate(const Config &config, std::mt19937 &generator
 	for (size_t i = 0; i < _experiments.size(); i++)
 		fitnesses[i].resize(_evolutionaryAlgorithm.getPopulationSize());
 
-	for (size_t i = 0; i < _evolutionaryAlgorithm.getPopulationSize(); i++)
-	for (size_t j = 0; j < _experiments.size(); j++) {
-		float experimentFitness = 0.0f;
+	_workerExperiments.resize(_numThreads);
+
+	for (int w = 0; w < _numThreads; w++) {
+		_workerExperiments[w].resize(_experiments.size());
+
+		for (size_t j = 0; j < _experiments.size(); j++)
+			_workerExperiments[w][j] = _experiments[j]->clone();
+	}
+
+	unsigned long seed = generator();
+
+	int populationSize = _evolutionaryAlgorithm.getPopulationSize();
 
-		for (size_t k = 0; k < _runsPerExperiment; k++)
-			experimentFitness += _experiments[j]->evaluate(*_evolutionaryAlgorithm.getHyperNet(i), config, generator);
+	// Evaluation times differ between individuals, so they are handed out one at a time
+#pragma omp parallel for schedule(dynamic, 1) num_threads(_numThreads)
+	for (int i = 0; i < populationSize; i++) {
+#ifdef _OPENMP
+		int worker = omp_get_thread_num();
+#else
+		int worker = 0;
+#endif
 
-		experimentFitness /= _runsPerExperiment;
+		for (size_t j = 0; j < _experiments.size(); j++) {
+			float experimentFitness = 0.0f;
 
-		fitnesses[j][i] = experimentFitness;
+			for (size_t k = 0; k < _runsPerExperiment; k++) {
+				std::seed_seq runSeed { seed, static_cast<unsigned long>(_generation), static_cast<unsigned long>(i), static_cast<unsigned long>(j), static_cast<unsigned long>(k) };
+
+				std::mt19937 runGenerator(runSeed);
+
+				experimentFitness += _workerExperiments[worker][j]->evaluate(*_evolutionaryAlgorithm.getHyperNet(i), config, runGenerator);
+			}
+
+			experimentFitness /= _runsPerExperiment;
+
+			fitnesses[j][i] = experimentFitness;
+		}
 	}
 
 	// Normalize fitness for each experiment
@@ -89,6 +120,8 @@ void EvolutionaryTrainer::evaluate(const Config &config, std::mt19937 &generator
 
 void EvolutionaryTrainer::reproduce(const Config &config, std::mt19937 &generator) {
 	_evolutionaryAlgorithm.generation(config, generator);
+
+	_generation++;
 }
 
 void EvolutionaryTrainer::writeBestToStream(std::ostream &os) const {
@@ -29,6 +29,13 @@ namespace hn {
 	private:
 		std::vector<std::shared_ptr<Experiment>> _experiments;
 
+		// Experiment copies of each worker thread, index [worker][experiment]
+		std::vector<std::vector<std::shared_ptr<Experiment>>> _workerExperiments;
+
+		int _numThreads;
+
+		size_t _generation;
+
 	public:
 		EvolutionaryAlgorithm _evolutionaryAlgorithm;
 
@@ -38,9 +45,23 @@ namespace hn {
 
 		void create(const Config &config, size_t populationSize, std::mt19937 &generator, float activationMultiplier);
 
+		// Individuals are evaluated by _numThreads threads (OpenMP). Every run of an experiment gets its own random stream,
+		// seeded from (one draw of generator, generation, individual, experiment, run), so fitnesses do not depend on the number of threads
 		void evaluate(const Config &config, std::mt19937 &generator);
 		void reproduce(const Config &config, std::mt19937 &generator);
 
+		void setNumThreads(int numThreads) {
+			_numThreads = std::max(1, numThreads);
+		}
+
+		int getNumThreads() const {
+			return _numThreads;
+		}
+
+		size_t getGeneration() const {
+			return _generation;
+		}
+
 		void writeBestToStream(std::ostream &os) const;
 
 		void addExperiment(const std::shared_ptr<Experiment> &experiment) {
@@ -35,6 +35,9 @@ namespace hn {
 
 		virtual float evaluate(HyperNet &hypernet, const Config &config, std::mt19937 &generator) = 0;
 
+		// Copy used by one worker thread of EvolutionaryTrainer::evaluate
+		virtual std::shared_ptr<Experiment> clone() const = 0;
+
 		float getExperimentWeight() const {
 			return _experimentWeight;
 		}
@@ -21,6 +21,8 @@ misrepresented as being the original software.
 
 #include <hypernet/FunctionApproximator.h>
 
+#include <algorithm>
+
 using namespace hn;
 
 void FunctionApproximator::createRandom(size_t numInputs, size_t numOutputs, size_t numHiddenLayers, size_t numNeuronsPerHiddenLayer, float minWeight, float maxWeight, std::mt19937 &generator) {
@@ -361,6 +363,68 @@ void FunctionApproximator::process(const std::vector<float> &inputs, std::vector
 	}
 }
 
+void FunctionApproximator::processLayerBatch(const std::vector<Node> &layer, const float* inputs, size_t blockSize, float* outputs, float activationMultiplier, bool linear) {
+	// Samples are the inner dimension, so the sums of a block are vectorized while each one is still accumulated in weight order
+	for (size_t n = 0; n < layer.size(); n++) {
+		float* pOutputs = outputs + n * blockSize;
+
+		for (size_t s = 0; s < blockSize; s++)
+			pOutputs[s] = layer[n]._bias;
+
+		for (size_t w = 0; w < layer[n]._weights.size(); w++) {
+			const float* pInputs = inputs + w * blockSize;
+
+			float weight = layer[n]._weights[w];
+
+			for (size_t s = 0; s < blockSize; s++)
+				pOutputs[s] += pInputs[s] * weight;
+		}
+
+		if (linear) {
+			for (size_t s = 0; s < blockSize; s++)
+				pOutputs[s] *= activationMultiplier;
+		}
+		else {
+			for (size_t s = 0; s < blockSize; s++)
+				pOutputs[s] = sigmoid(pOutputs[s] * activationMultiplier);
+		}
+	}
+}
+
+void FunctionApproximator::processBatch(const std::vector<float> &inputs, size_t batchSize, std::vector<float> &outputs, float activationMultiplier) {
+	const size_t maxBlockSize = 64;
+
+	size_t numInputs = getNumInputs();
+	size_t numOutputs = getNumOutputs();
+	size_t maxLayerSize = std::max(std::max(numInputs, numOutputs), getNumNeuronsPerHiddenLayer());
+
+	outputs.resize(batchSize * numOutputs);
+
+	_batchLayerInputs.resize(maxLayerSize * maxBlockSize);
+	_batchLayerOutputs.resize(maxLayerSize * maxBlockSize);
+
+	// Blocks of samples are transposed to one row per layer input, then passed through all layers
+	for (size_t blockStart = 0; blockStart < batchSize; blockStart += maxBlockSize) {
+		size_t blockSize = std::min(maxBlockSize, batchSize - blockStart);
+
+		for (size_t s = 0; s < blockSize; s++)
+		for (size_t i = 0; i < numInputs; i++)
+			_batchLayerInputs[i * blockSize + s] = inputs[(blockStart + s) * numInputs + i];
+
+		for (size_t l = 0; l < _hiddenLayers.size(); l++) {
+			processLayerBatch(_hiddenLayers[l], _batchLayerInputs.data(), blockSize, _batchLayerOutputs.data(), activationMultiplier, false);
+
+			std::swap(_batchLayerInputs, _batchLayerOutputs);
+		}
+
+		processLayerBatch(_outputLayer, _batchLayerInputs.data(), blockSize, _batchLayerOutputs.data(), activationMultiplier, true);
+
+		for (size_t s = 0; s < blockSize; s++)
+		for (size_t n = 0; n < numOutputs; n++)
+			outputs[(blockStart + s) * numOutputs + n] = _batchLayerOutputs[n * blockSize + s];
+	}
+}
+
 void FunctionApproximator::backpropagate(const std::vector<float> &inputs, const std::vector<std::vector<float>> &layerOutputs, const std::vector<float> &targetOutputs, float alpha) {
 	// Output layer error
 	std::vector<std::vector<float>> errors = layerOutputs;
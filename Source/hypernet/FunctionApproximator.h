@@ -37,6 +37,12 @@ namespace hn {
 		std::vector<std::vector<Node>> _hiddenLayers;
 		std::vector<Node> _outputLayer;
 
+		// Layer activations of a block of samples in processBatch, one row of the block size per layer input or node
+		std::vector<float> _batchLayerInputs;
+		std::vector<float> _batchLayerOutputs;
+
+		static void processLayerBatch(const std::vector<Node> &layer, const float* inputs, size_t blockSize, float* outputs, float activationMultiplier, bool linear);
+
 		float crossoverChooseWeight(float w1, float w2, float averageChance, std::mt19937 &generator);
 
 	public:
@@ -50,6 +56,9 @@ namespace hn {
 
 		void process(const std::vector<float> &inputs, std::vector<float> &outputs, float activationMultiplier);
 		void process(const std::vector<float> &inputs, std::vector<std::vector<float>> &layerOutputs, float activationMultiplier);
+
+		// Same results as process for every row. Inputs are [batchSize x getNumInputs()], outputs [batchSize x getNumOutputs()], row-major
+		void processBatch(const std::vector<float> &inputs, size_t batchSize, std::vector<float> &outputs, float activationMultiplier);
 		void backpropagate(const std::vector<float> &inputs, const std::vector<std::vector<float>> &layerOutputs, const std::vector<float> &targetOutputs, float alpha);
 		void getInputError(const std::vector<float> &inputs, const std::vector<std::vector<float>> &layerOutputs, const std::vector<float> &targetOutputs, std::vector<float> &inputErrors);
 
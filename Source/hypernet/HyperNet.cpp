@@ -25,10 +25,12 @@ misrepresented as being the original software.
 
 #include <iostream>
 
+#include <assert.h>
+
 using namespace hn;
 
 HyperNet::HyperNet()
-: _connectDisconnectEnabled(false)
+: _neighbourRadius(-1.0f), _connectDisconnectEnabled(false)
 {}
 
 void HyperNet::createRandom(const Config &config, int preTrainIterations, float preTrainAlpha, float preTrainMin, float preTrainMax, std::mt19937 &generator, float activationMultiplier) {
@@ -534,6 +536,11 @@ void HyperNet::generateNetwork(const Config &config, const std::vector<int> &dim
 	_outputs.clear();
 	_boids.clear();
 
+	_linkInputOffsets.clear();
+	_linkMemories.clear();
+	_linkResponses.clear();
+	_freeLinkIds.clear();
+
 	_inputs.assign(config._numInputGroups * config._numInputsPerGroup, 0.0f);
 	_outputs.assign(config._numOutputGroups * config._numOutputsPerGroup, 0.0f);
 
@@ -548,61 +555,15 @@ void HyperNet::generateNetwork(const Config &config, const std::vector<int> &dim
 	for (size_t i = 0; i < _boids.size(); i++)
 		_boids[i].reset(new Boid(config, *this, generator));
 
-	int connectionRadiusi = static_cast<int>(std::ceil(config._boidConnectionRadius));
+	buildNeighbourTable(config._boidConnectionRadius);
 
 	std::uniform_real_distribution<float> dist01(0.0f, 1.0f);
 
 	// Connect neurons to other neurons in a radius
-	for (size_t i = 0; i < _boids.size(); i++) {
-		std::vector<int> multiDimCoordinates;
-
-		getMultiDimCoordinatesFromLinear(i, multiDimCoordinates);
-
-		std::vector<int> min(_dimensions.size());
-		std::vector<int> max(_dimensions.size());
-
-		for (int d = 0; d < _dimensions.size(); d++) {
-			min[d] = std::max<int>(0, multiDimCoordinates[d] - connectionRadiusi);
-			max[d] = std::min<int>(_dimensions[d] - 1, multiDimCoordinates[d] + connectionRadiusi - 1);
-		}
-
-		std::vector<int> parseCoords = min;
-
-		while (parseCoords != max) {
-			int linearCoord = getLinearCoordinate(parseCoords);
-
-			if (linearCoord != i) {
-				// Calculate distance for radial neuron culling
-				float distance = 0.0f;
-
-				for (int d = 0; d < multiDimCoordinates.size(); d++) {
-					float delta = static_cast<float>(multiDimCoordinates[d] - parseCoords[d]);
-					distance += delta * delta;
-				}
-
-				distance = std::sqrt(distance);
-
-				// If the neuron is within range
-				if (distance < config._boidConnectionRadius) {
-					if (dist01(generator) < config._initLinkChance) {
-						std::shared_ptr<Link> link(new Link(config, *this, linearCoord, generator));
-
-						_boids[i]->_links[link->getInputOffset()] = link;
-					}
-				}
-			}
-
-			// Increment coordinates
-			parseCoords[0]++;
-
-			for (int d = 0; d < _dimensions.size() - 1; d++)
-			if (parseCoords[d] > max[d]) {
-				parseCoords[d] = min[d];
-				parseCoords[d + 1]++;
-			}
-			else
-				break;
-		}
+	for (size_t i = 0; i < _boids.size(); i++)
+	for (int k = _neighbourStarts[i]; k < _neighbourStarts[i + 1]; k++) {
+		if (dist01(generator) < config._initLinkChance)
+			_boids[i]->_links[_neighbours[k]] = addLink(config, _neighbours[k], generator);
 	}
 
 	// Place inputs on front end of the chunk
@@ -656,10 +617,18 @@ void HyperNet::generateNetwork(const Config &config, const std::vector<int> &dim
 void HyperNet::generateFeedForward(const Config &config, size_t numHiddenLayers, size_t numBoidsPerHiddenLayer, std::mt19937 &generator) {
 	_dimensions.clear();
 
+	_neighbourStarts.clear();
+	_neighbours.clear();
+
 	_inputs.clear();
 	_outputs.clear();
 	_boids.clear();
 
+	_linkInputOffsets.clear();
+	_linkMemories.clear();
+	_linkResponses.clear();
+	_freeLinkIds.clear();
+
 	_inputs.assign(config._numInputGroups * config._numInputsPerGroup, 0.0f);
 	_outputs.assign(config._numOutputGroups * config._numOutputsPerGroup, 0.0f);
 
@@ -678,9 +647,7 @@ void HyperNet::generateFeedForward(const Config &config, size_t numHiddenLayers,
 			_boids.push_back(boid);
 
 			for (size_t j = 0; j < _inputs.size(); j++) {
-				std::shared_ptr<Link> link(new Link(config, *this, j, generator));
-
-				boid->_links[j] = link;
+				boid->_links[j] = addLink(config, j, generator);
 			}
 		}
 
@@ -694,9 +661,7 @@ void HyperNet::generateFeedForward(const Config &config, size_t numHiddenLayers,
 				_boids.push_back(boid);
 
 				for (size_t j = 0; j < numBoidsPerHiddenLayer; j++) {
-					std::shared_ptr<Link> link(new Link(config, *this, layerStart - numBoidsPerHiddenLayer + j, generator));
-
-					boid->_links[layerStart - numBoidsPerHiddenLayer + j] = link;
+					boid->_links[layerStart - numBoidsPerHiddenLayer + j] = addLink(config, layerStart - numBoidsPerHiddenLayer + j, generator);
 				}
 			}
 		}
@@ -710,9 +675,7 @@ void HyperNet::generateFeedForward(const Config &config, size_t numHiddenLayers,
 			_boids.push_back(boid);
 
 			for (size_t j = 0; j < numBoidsPerHiddenLayer; j++) {
-				std::shared_ptr<Link> link(new Link(config, *this, layerStart - numBoidsPerHiddenLayer + j, generator));
-
-				boid->_links[layerStart - numBoidsPerHiddenLayer + j] = link;
+				boid->_links[layerStart - numBoidsPerHiddenLayer + j] = addLink(config, layerStart - numBoidsPerHiddenLayer + j, generator);
 			}
 		}
 	}
@@ -724,9 +687,7 @@ void HyperNet::generateFeedForward(const Config &config, size_t numHiddenLayers,
 			_boids.push_back(boid);
 
 			for (size_t j = 0; j < _inputs.size(); j++) {
-				std::shared_ptr<Link> link(new Link(config, *this, j, generator));
-
-				boid->_links[j] = link;
+				boid->_links[j] = addLink(config, j, generator);
 			}
 		}
 	}
@@ -759,22 +720,161 @@ void HyperNet::generateFeedForward(const Config &config, size_t numHiddenLayers,
 		_decoders[i].reset(new Decoder(config, *this, generator));
 }
 
-void HyperNet::step(const Config &config, float reward, std::mt19937 &generator, int substeps, float activationMultiplier) {
-	int connectionRadiusi = static_cast<int>(std::ceil(config._boidConnectionRadius));
+int HyperNet::addLink(const Config &config, int inputOffset, std::mt19937 &generator) {
+	int linkId;
+
+	if (_freeLinkIds.empty()) {
+		linkId = _linkInputOffsets.size();
+
+		_linkInputOffsets.push_back(inputOffset);
+		_linkMemories.resize(_linkMemories.size() + config._linkMemorySize);
+		_linkResponses.resize(_linkResponses.size() + config._linkResponseSize);
+	}
+	else {
+		linkId = _freeLinkIds.back();
+
+		_freeLinkIds.pop_back();
+
+		_linkInputOffsets[linkId] = inputOffset;
+	}
+
+	for (int i = 0; i < config._linkResponseSize; i++)
+		_linkResponses[linkId * config._linkResponseSize + i] = 0.0f;
+
+	// Initialize memory
+	for (int i = 0; i < config._linkMemorySize; i++) {
+		std::uniform_real_distribution<float> distMemory(std::get<0>(_linkMemoryInitRange[i]), std::get<1>(_linkMemoryInitRange[i]));
+
+		_linkMemories[linkId * config._linkMemorySize + i] = distMemory(generator);
+	}
+
+	return linkId;
+}
+
+void HyperNet::removeLink(int linkId) {
+	_linkInputOffsets[linkId] = -1;
+
+	_freeLinkIds.push_back(linkId);
+}
+
+void HyperNet::buildNeighbourTable(float connectionRadius) {
+	int connectionRadiusi = static_cast<int>(std::ceil(connectionRadius));
+
+	_neighbourRadius = connectionRadius;
+
+	_neighbourStarts.resize(_boids.size() + 1);
+	_neighbours.clear();
+
+	std::vector<int> multiDimCoordinates;
+	std::vector<int> min(_dimensions.size());
+	std::vector<int> max(_dimensions.size());
+	std::vector<int> parseCoords;
+
+	for (size_t i = 0; i < _boids.size(); i++) {
+		_neighbourStarts[i] = _neighbours.size();
+
+		getMultiDimCoordinatesFromLinear(i, multiDimCoordinates);
+
+		for (int d = 0; d < _dimensions.size(); d++) {
+			min[d] = std::max<int>(0, multiDimCoordinates[d] - connectionRadiusi);
+			max[d] = std::min<int>(_dimensions[d] - 1, multiDimCoordinates[d] + connectionRadiusi - 1);
+		}
+
+		parseCoords = min;
+
+		while (parseCoords != max) {
+			int linearCoord = getLinearCoordinate(parseCoords);
+
+			if (linearCoord != i) {
+				// Calculate distance for radial neuron culling
+				float distance = 0.0f;
 
+				for (int d = 0; d < multiDimCoordinates.size(); d++) {
+					float delta = static_cast<float>(multiDimCoordinates[d] - parseCoords[d]);
+					distance += delta * delta;
+				}
+
+				distance = std::sqrt(distance);
+
+				// If the neuron is within range
+				if (distance < connectionRadius)
+					_neighbours.push_back(linearCoord);
+			}
+
+			// Increment coordinates
+			parseCoords[0]++;
+
+			for (int d = 0; d < _dimensions.size() - 1; d++)
+			if (parseCoords[d] > max[d]) {
+				parseCoords[d] = min[d];
+				parseCoords[d + 1]++;
+			}
+			else
+				break;
+		}
+	}
+
+	_neighbourStarts[_boids.size()] = _neighbours.size();
+}
+
+int HyperNet::gatherPairInput(const Config &config, int b, int n, float* processorInputs) const {
+	int inputIndex = 0;
+
+	for (int i = 0; i < config._boidNumOutputs; i++)
+		processorInputs[inputIndex++] = _boids[b]->getOutput(i);
+
+	for (int i = 0; i < config._boidMemorySize; i++)
+		processorInputs[inputIndex++] = _boids[b]->getMemory(i);
+
+	for (int i = 0; i < config._boidNumOutputs; i++)
+		processorInputs[inputIndex++] = _boids[n]->getOutput(i);
+
+	for (int i = 0; i < config._boidMemorySize; i++)
+		processorInputs[inputIndex++] = _boids[n]->getMemory(i);
+
+	return inputIndex;
+}
+
+void HyperNet::step(const Config &config, float reward, std::mt19937 &generator, int substeps, float activationMultiplier) {
 	std::uniform_real_distribution<float> dist01(0.0f, 1.0f);
 
+	// Links in gathering order, boid by boid. Links only change after the substeps
+	_stepLinkIds.clear();
+	_stepLinkStarts.resize(_boids.size() + 1);
+
+	for (size_t b = 0; b < _boids.size(); b++) {
+		_stepLinkStarts[b] = _stepLinkIds.size();
+
+		for (std::unordered_map<int, int>::const_iterator it = _boids[b]->_links.begin(); it != _boids[b]->_links.end(); it++) {
+			assert(it->first != b);
+
+			_stepLinkIds.push_back(it->second);
+		}
+	}
+
+	_stepLinkStarts[_boids.size()] = _stepLinkIds.size();
+
+	// Each processor is run once per substep on a matrix with one row per encoder, link, boid or decoder
+	size_t encoderInputSize = _encoder.getNumInputs();
+	size_t encoderOutputSize = _encoder.getNumOutputs();
+	size_t linkInputSize = _linkProcessor.getNumInputs();
+	size_t linkOutputSize = _linkProcessor.getNumOutputs();
+	size_t boidInputSize = _boidFiringProcessor.getNumInputs();
+	size_t boidOutputSize = _boidFiringProcessor.getNumOutputs();
+	size_t decoderInputSize = _decoder.getNumInputs();
+	size_t decoderOutputSize = _decoder.getNumOutputs();
+
 	for (int s = 0; s < substeps; s++) {
-		int inputIndex = 0;
+		// Get processed output from encoders
+		_batchInputs.assign(config._numInputGroups * encoderInputSize, 0.0f);
 
-		for (int i = 0; i < config._numInputGroups; i++) {
-			// Get processed output from encoder
-			std::vector<float> groupInput(config._numInputsPerGroup, 0.0f);
+		for (int i = 0; i < config._numInputGroups; i++)
+			_encoders[i]->gatherInput(&_inputs[i * config._numInputsPerGroup], config._numInputsPerGroup, &_batchInputs[i * encoderInputSize]);
 
-			for (int j = 0; j < config._numInputsPerGroup; j++)
-				groupInput[j] = _inputs[inputIndex++];
+		_encoder.processBatch(_batchInputs, config._numInputGroups, _batchOutputs, activationMultiplier);
 
-			_encoders[i]->update(groupInput, *this, activationMultiplier);
+		for (int i = 0; i < config._numInputGroups; i++) {
+			_encoders[i]->setOutput(&_batchOutputs[i * encoderOutputSize]);
 
 			// Distribute output to boids
 			for (size_t j = 0; j < _inputIndices[i].size(); j++)
@@ -782,26 +882,86 @@ void HyperNet::step(const Config &config, float reward, std::mt19937 &generator,
 				_boids[_inputIndices[i][j]]->_inputs[k] = _encoders[i]->getOutput(k) * config._boidOutputScalar;
 		}
 
+		// Update links from the outputs of their input boids
+		_batchInputs.resize(_stepLinkIds.size() * linkInputSize);
+
+		for (size_t l = 0; l < _stepLinkIds.size(); l++) {
+			int linkId = _stepLinkIds[l];
+
+			const Boid &input = *_boids[_linkInputOffsets[linkId]];
+
+			float* pInputs = &_batchInputs[l * linkInputSize];
+
+			size_t inputIndex = 0;
+
+			for (size_t i = 0; i < input.getNumOutputs(); i++)
+				pInputs[inputIndex++] = input.getOutput(i);
+
+			for (int i = 0; i < config._linkMemorySize; i++)
+				pInputs[inputIndex++] = _linkMemories[linkId * config._linkMemorySize + i];
+
+			pInputs[inputIndex++] = reward;
+
+			// Additional random input
+			pInputs[inputIndex++] = dist01(generator);
+		}
+
+		_linkProcessor.processBatch(_batchInputs, _stepLinkIds.size(), _batchOutputs, activationMultiplier);
+
+		for (size_t l = 0; l < _stepLinkIds.size(); l++) {
+			int linkId = _stepLinkIds[l];
+
+			const float* pOutputs = &_batchOutputs[l * linkOutputSize];
+
+			size_t outputIndex = 0;
+
+			for (int i = 0; i < config._linkResponseSize; i++)
+				_linkResponses[linkId * config._linkResponseSize + i] = pOutputs[outputIndex++] * config._linkResponseScalar;
+
+			for (int i = 0; i < config._linkMemorySize; i++)
+				_linkMemories[linkId * config._linkMemorySize + i] = pOutputs[outputIndex++];
+		}
+
 		// Gather inputs from other boids
 		for (size_t b = 0; b < _boids.size(); b++)
-			_boids[b]->gatherInput(config, reward, *this, generator, b, activationMultiplier);
-		
+		for (int l = _stepLinkStarts[b]; l < _stepLinkStarts[b + 1]; l++) {
+			const float* pResponse = &_linkResponses[_stepLinkIds[l] * config._linkResponseSize];
+
+			for (size_t j = 0; j < _boids[b]->_inputs.size(); j++)
+				_boids[b]->_inputs[j] += pResponse[j];
+		}
+
 		// Update boids
+		_batchInputs.resize(_boids.size() * boidInputSize);
+
 		for (size_t b = 0; b < _boids.size(); b++)
-			_boids[b]->update(config, reward, *this, generator, b, activationMultiplier);
+			_boids[b]->gatherFiringInput(reward, dist01(generator), &_batchInputs[b * boidInputSize]);
 
-		int outputIndex = 0;
+		_boidFiringProcessor.processBatch(_batchInputs, _boids.size(), _batchOutputs, activationMultiplier);
+
+		for (size_t b = 0; b < _boids.size(); b++)
+			_boids[b]->setFiringOutput(config, &_batchOutputs[b * boidOutputSize]);
+
+		// Get outputs from boids
+		_batchInputs.resize(config._numOutputGroups * decoderInputSize);
 
 		for (int i = 0; i < config._numOutputGroups; i++) {
-			// Get outputs from boids
 			std::vector<float> boidOutputs(config._boidNumOutputs, 0.0f);
 
 			for (size_t j = 0; j < _outputIndices[i].size(); j++)
 			for (int k = 0; k < config._boidNumOutputs; k++)
 				boidOutputs[k] += _boids[_outputIndices[i][j]]->getOutput(k);
 
-			// Get processed output from decoder
-			_decoders[i]->update(boidOutputs, *this, activationMultiplier);
+			_decoders[i]->gatherInput(boidOutputs, &_batchInputs[i * decoderInputSize]);
+		}
+
+		// Get processed output from decoders
+		_decoder.processBatch(_batchInputs, config._numOutputGroups, _batchOutputs, activationMultiplier);
+
+		int outputIndex = 0;
+
+		for (int i = 0; i < config._numOutputGroups; i++) {
+			_decoders[i]->setOutput(&_batchOutputs[i * decoderOutputSize]);
 
 			for (int j = 0; j < config._numOutputsPerGroup; j++)
 				_outputs[outputIndex++] = _decoders[i]->getOutput(j);
@@ -809,117 +969,114 @@ void HyperNet::step(const Config &config, float reward, std::mt19937 &generator,
 	}
 
 	if (_connectDisconnectEnabled) {
-		// Decide whether to connect/disconnect. Not part of substeps for performance reasons
-		for (size_t b = 0; b < _boids.size(); b++) {
-			std::vector<int> multiDimCoordinates;
+		// Decide whether to connect/disconnect. Not part of substeps for performance reasons.
+		// Decisions only depend on the state before this phase, so each processor is run once on a matrix with one row per neighbour pair,
+		// and the links are changed afterwards in pair order
+		if (_neighbourStarts.size() != _boids.size() + 1 || _neighbourRadius != config._boidConnectionRadius)
+			buildNeighbourTable(config._boidConnectionRadius);
 
-			getMultiDimCoordinatesFromLinear(b, multiDimCoordinates);
+		_neighbourLinkIds.resize(_neighbours.size());
+		_neighbourRandoms.resize(_neighbours.size());
+		_neighbourDecisions.resize(_neighbours.size());
 
-			std::vector<int> min(_dimensions.size());
-			std::vector<int> max(_dimensions.size());
+		int numConnectRows = 0;
+		int numDisconnectRows = 0;
 
-			for (int d = 0; d < _dimensions.size(); d++) {
-				min[d] = std::max<int>(0, multiDimCoordinates[d] - connectionRadiusi);
-				max[d] = std::min<int>(_dimensions[d] - 1, multiDimCoordinates[d] + connectionRadiusi - 1);
-			}
+		for (size_t b = 0; b < _boids.size(); b++)
+		for (int k = _neighbourStarts[b]; k < _neighbourStarts[b + 1]; k++) {
+			std::unordered_map<int, int>::const_iterator it = _boids[b]->_links.find(_neighbours[k]);
 
-			std::vector<int> parseCoords = min;
+			if (it == _boids[b]->_links.end()) {
+				_neighbourLinkIds[k] = -1;
 
-			while (parseCoords != max) {
-				int parseCoordsLinear = getLinearCoordinate(parseCoords);
+				numConnectRows++;
+			}
+			else {
+				_neighbourLinkIds[k] = it->second;
 
-				if (parseCoordsLinear != b) {
-					// Calculate distance for radial neuron culling
-					float distance = 0.0f;
+				numDisconnectRows++;
+			}
 
-					for (int d = 0; d < multiDimCoordinates.size(); d++) {
-						float delta = static_cast<float>(multiDimCoordinates[d] - parseCoords[d]);
-						distance += delta * delta;
-					}
+			_neighbourRandoms[k] = dist01(generator);
+		}
 
-					distance = std::sqrt(distance);
+		// Links that do not exist, consult connector if a link should be made
+		size_t connectInputSize = _boidConnectProcessor.getNumInputs();
+		size_t connectOutputSize = _boidConnectProcessor.getNumOutputs();
 
-					// If the neuron is within range
-					if (distance < config._boidConnectionRadius) {
-						// Check for connect/disconnect
+		_batchInputs.resize(numConnectRows * connectInputSize);
 
-						// See if the boids are connected or not
-						std::unordered_map<int, std::shared_ptr<Link>>::iterator it = _boids[b]->_links.find(parseCoordsLinear);
+		int row = 0;
 
-						if (it == _boids[b]->_links.end()) {
-							// Link does not exist, consult connector if a link should be made
-							int inputIndex = 0;
+		for (size_t b = 0; b < _boids.size(); b++)
+		for (int k = _neighbourStarts[b]; k < _neighbourStarts[b + 1]; k++)
+		if (_neighbourLinkIds[k] == -1) {
+			float* pInputs = &_batchInputs[row * connectInputSize];
 
-							for (int i = 0; i < config._boidNumOutputs; i++)
-								_boidConnectProcessorInputBuffer[inputIndex++] = _boids[b]->getOutput(i);
+			int inputIndex = gatherPairInput(config, b, _neighbours[k], pInputs);
 
-							for (int i = 0; i < config._boidMemorySize; i++)
-								_boidConnectProcessorInputBuffer[inputIndex++] = _boids[b]->getMemory(i);
+			pInputs[inputIndex++] = reward;
+			pInputs[inputIndex++] = _neighbourRandoms[k];
+
+			row++;
+		}
 
-							for (int i = 0; i < config._boidNumOutputs; i++)
-								_boidConnectProcessorInputBuffer[inputIndex++] = _boids[parseCoordsLinear]->getOutput(i);
+		_boidConnectProcessor.processBatch(_batchInputs, numConnectRows, _batchOutputs, activationMultiplier);
 
-							for (int i = 0; i < config._boidMemorySize; i++)
-								_boidConnectProcessorInputBuffer[inputIndex++] = _boids[parseCoordsLinear]->getMemory(i);
+		row = 0;
 
-							_boidConnectProcessorInputBuffer[inputIndex++] = reward;
-							_boidConnectProcessorInputBuffer[inputIndex++] = dist01(generator);
+		for (size_t k = 0; k < _neighbours.size(); k++)
+		if (_neighbourLinkIds[k] == -1)
+			_neighbourDecisions[k] = _batchOutputs[(row++) * connectOutputSize] > 1.0f;
 
-							_boidConnectProcessor.process(_boidConnectProcessorInputBuffer, _boidConnectProcessorOutputBuffer, activationMultiplier);
+		// Links that exist, check if we should disconnect them
+		size_t disconnectInputSize = _boidDisconnectProcessor.getNumInputs();
+		size_t disconnectOutputSize = _boidDisconnectProcessor.getNumOutputs();
 
-							if (_boidConnectProcessorOutputBuffer[0] > 1.0f) {
-								// Connect
-								std::shared_ptr<Link> link(new Link(config, *this, parseCoordsLinear, generator));
+		_batchInputs.resize(numDisconnectRows * disconnectInputSize);
 
-								_boids[b]->_links[parseCoordsLinear] = link;
-							}
-						}
-						else {
-							// Link exists, check if we should disconnect it
-							int inputIndex = 0;
+		row = 0;
 
-							for (int i = 0; i < config._boidNumOutputs; i++)
-								_boidDisconnectProcessorInputBuffer[inputIndex++] = _boids[b]->getOutput(i);
+		for (size_t b = 0; b < _boids.size(); b++)
+		for (int k = _neighbourStarts[b]; k < _neighbourStarts[b + 1]; k++)
+		if (_neighbourLinkIds[k] != -1) {
+			int linkId = _neighbourLinkIds[k];
 
-							for (int i = 0; i < config._boidMemorySize; i++)
-								_boidDisconnectProcessorInputBuffer[inputIndex++] = _boids[b]->getMemory(i);
+			float* pInputs = &_batchInputs[row * disconnectInputSize];
 
-							for (int i = 0; i < config._boidNumOutputs; i++)
-								_boidDisconnectProcessorInputBuffer[inputIndex++] = _boids[parseCoordsLinear]->getOutput(i);
+			int inputIndex = gatherPairInput(config, b, _neighbours[k], pInputs);
 
-							for (int i = 0; i < config._boidMemorySize; i++)
-								_boidDisconnectProcessorInputBuffer[inputIndex++] = _boids[parseCoordsLinear]->getMemory(i);
+			// Add synapse as well
+			for (int i = 0; i < config._linkResponseSize; i++)
+				pInputs[inputIndex++] = _linkResponses[linkId * config._linkResponseSize + i];
 
-							// Add synapse as well
-							for (int i = 0; i < config._linkResponseSize; i++)
-								_boidDisconnectProcessorInputBuffer[inputIndex++] = it->second->getResponse(i);
+			for (int i = 0; i < config._linkMemorySize; i++)
+				pInputs[inputIndex++] = _linkMemories[linkId * config._linkMemorySize + i];
 
-							for (int i = 0; i < config._linkMemorySize; i++)
-								_boidDisconnectProcessorInputBuffer[inputIndex++] = it->second->getMemory(i);
+			pInputs[inputIndex++] = reward;
+			pInputs[inputIndex++] = _neighbourRandoms[k];
 
-							_boidDisconnectProcessorInputBuffer[inputIndex++] = reward;
-							_boidDisconnectProcessorInputBuffer[inputIndex++] = dist01(generator);
+			row++;
+		}
 
-							_boidDisconnectProcessor.process(_boidDisconnectProcessorInputBuffer, _boidDisconnectProcessorOutputBuffer, activationMultiplier);
+		_boidDisconnectProcessor.processBatch(_batchInputs, numDisconnectRows, _batchOutputs, activationMultiplier);
 
-							if (_boidDisconnectProcessorOutputBuffer[0] > 1.0f) {
-								// Disconnect
-								_boids[b]->_links.erase(it);
-							}
-						}
-					}
-				}
+		row = 0;
 
-				// Increment coordinates
-				parseCoords[0]++;
+		for (size_t k = 0; k < _neighbours.size(); k++)
+		if (_neighbourLinkIds[k] != -1)
+			_neighbourDecisions[k] = _batchOutputs[(row++) * disconnectOutputSize] > 1.0f;
 
-				for (int d = 0; d < _dimensions.size() - 1; d++)
-				if (parseCoords[d] > max[d]) {
-					parseCoords[d] = min[d];
-					parseCoords[d + 1]++;
-				}
-				else
-					break;
+		// Connect and disconnect
+		for (size_t b = 0; b < _boids.size(); b++)
+		for (int k = _neighbourStarts[b]; k < _neighbourStarts[b + 1]; k++)
+		if (_neighbourDecisions[k]) {
+			if (_neighbourLinkIds[k] == -1)
+				_boids[b]->_links[_neighbours[k]] = addLink(config, _neighbours[k], generator);
+			else {
+				removeLink(_neighbourLinkIds[k]);
+
+				_boids[b]->_links.erase(_neighbours[k]);
 			}
 		}
 	}
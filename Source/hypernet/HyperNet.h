@@ -70,6 +70,39 @@ namespace hn {
 		std::vector<std::shared_ptr<Encoder>> _encoders;
 		std::vector<std::shared_ptr<Decoder>> _decoders;
 
+		// Link state, indexed by link id. Ids of removed links are reused, unused ids have an input offset of -1
+		std::vector<int> _linkInputOffsets;
+		std::vector<float> _linkMemories;
+		std::vector<float> _linkResponses;
+		std::vector<int> _freeLinkIds;
+
+		// Link ids in gathering order, the links of boid b are [_stepLinkStarts[b], _stepLinkStarts[b + 1])
+		std::vector<int> _stepLinkIds;
+		std::vector<int> _stepLinkStarts;
+
+		// Input and output matrices of the batched processor passes in step
+		std::vector<float> _batchInputs;
+		std::vector<float> _batchOutputs;
+
+		// Boids within the connection radius, the neighbours of boid b are [_neighbourStarts[b], _neighbourStarts[b + 1]) in _neighbours.
+		// Built by generateNetwork, rebuilt by step when the radius or number of boids changes
+		std::vector<int> _neighbourStarts;
+		std::vector<int> _neighbours;
+		float _neighbourRadius;
+
+		// Connect/disconnect state of each neighbour pair, indexed like _neighbours. Link ids are -1 for unconnected pairs
+		std::vector<int> _neighbourLinkIds;
+		std::vector<float> _neighbourRandoms;
+		std::vector<char> _neighbourDecisions;
+
+		int addLink(const Config &config, int inputOffset, std::mt19937 &generator);
+		void removeLink(int linkId);
+
+		void buildNeighbourTable(float connectionRadius);
+
+		// Writes the outputs and memories of boid b and then of boid n, returns the number of values written
+		int gatherPairInput(const Config &config, int b, int n, float* processorInputs) const;
+
 	public:
 		bool _connectDisconnectEnabled;
 
@@ -115,7 +148,6 @@ namespace hn {
 		void readFromStream(std::istream &is);
 
 		friend class Boid;
-		friend class Link;
 		friend class Encoder;
 		friend class Decoder;
 	};
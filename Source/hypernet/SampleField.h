@@ -22,11 +22,38 @@ misrepresented as being the original software.
 #pragma once
 
 #include <vector>
-#include <memory>
-#include <functional>
+#include <algorithm>
+#include <limits>
 #include <cmath>
 
+#include <assert.h>
+
 namespace hn {
+	// Radial kernel, takes the squared distance between two points
+	struct KernelSquaredExponential {
+		float _invThetaSquared;
+
+		KernelSquaredExponential(float invThetaSquared = 0.1f)
+			: _invThetaSquared(invThetaSquared)
+		{}
+
+		float operator()(float distanceSquared) const {
+			return std::exp(-0.5f * _invThetaSquared * std::sqrt(distanceSquared));
+		}
+
+		// Squared distance beyond which the kernel falls below minInfluence
+		float getCutoffDistanceSquared(float minInfluence) const {
+			float distance = -2.0f * std::log(minInfluence) / _invThetaSquared;
+
+			return distance * distance;
+		}
+	};
+
+	// Kernel weighted average of samples. Samples are stored in flat arrays, queries write into caller buffers.
+	// Without a cutoff every sample contributes and queries scan them in order.
+	// With a cutoff (minimum influence) the samples are indexed by a k-d tree and only the ones within the cutoff distance are visited.
+	// Samples added after the last build are scanned linearly until enough accumulate to rebuild the tree
+	template <class Kernel = KernelSquaredExponential>
 	class SampleField {
 	public:
 		struct Sample {
@@ -39,23 +66,375 @@ namespace hn {
 			{}
 		};
 
+		struct Neighbour {
+			size_t _index;
+			float _influence;
+		};
+
 	private:
-		std::vector<Sample> _samples;
+		struct Node {
+			size_t _start, _end; // Range in _order
+			int _left, _right; // -1 for leaves
+		};
+
+		std::vector<float> _xs;
+		std::vector<float> _ys;
+		std::vector<float> _weights;
 
 		size_t _xSize, _ySize;
 
+		float _minInfluence;
+		float _cutoffDistanceSquared;
+
+		// K-d tree over the first _numIndexed samples, node bounding boxes are [node * _xSize, (node + 1) * _xSize) in _nodeMins and _nodeMaxs
+		std::vector<Node> _nodes;
+		std::vector<size_t> _order;
+		std::vector<float> _nodeMins;
+		std::vector<float> _nodeMaxs;
+		size_t _numIndexed;
+		size_t _leafSize;
+
+		int buildNode(size_t start, size_t end, size_t leafSize) {
+			int nodeIndex = _nodes.size();
+
+			Node node;
+			node._start = start;
+			node._end = end;
+			node._left = node._right = -1;
+
+			_nodes.push_back(node);
+
+			_nodeMins.resize(_nodes.size() * _xSize);
+			_nodeMaxs.resize(_nodes.size() * _xSize);
+
+			float* pMins = &_nodeMins[nodeIndex * _xSize];
+			float* pMaxs = &_nodeMaxs[nodeIndex * _xSize];
+
+			std::fill(pMins, pMins + _xSize, std::numeric_limits<float>::max());
+			std::fill(pMaxs, pMaxs + _xSize, -std::numeric_limits<float>::max());
+
+			for (size_t i = start; i < end; i++) {
+				const float* pX = getSampleX(_order[i]);
+
+				for (size_t xi = 0; xi < _xSize; xi++) {
+					pMins[xi] = std::min(pMins[xi], pX[xi]);
+					pMaxs[xi] = std::max(pMaxs[xi], pX[xi]);
+				}
+			}
+
+			if (end - start <= leafSize)
+				return nodeIndex;
+
+			// Split at the median of the widest dimension
+			size_t splitDim = 0;
+
+			for (size_t xi = 1; xi < _xSize; xi++)
+			if (pMaxs[xi] - pMins[xi] > pMaxs[splitDim] - pMins[splitDim])
+				splitDim = xi;
+
+			size_t mid = start + (end - start) / 2;
+
+			const std::vector<float> &xs = _xs;
+			const size_t xSize = _xSize;
+
+			std::nth_element(_order.begin() + start, _order.begin() + mid, _order.begin() + end,
+				[&xs, xSize, splitDim](size_t a, size_t b) { return xs[a * xSize + splitDim] < xs[b * xSize + splitDim]; });
+
+			int left = buildNode(start, mid, leafSize);
+			int right = buildNode(mid, end, leafSize);
+
+			_nodes[nodeIndex]._left = left;
+			_nodes[nodeIndex]._right = right;
+
+			return nodeIndex;
+		}
+
+		void buildIndex(size_t leafSize) {
+			_nodes.clear();
+			_nodeMins.clear();
+			_nodeMaxs.clear();
+
+			_numIndexed = getNumSamples();
+
+			_order.resize(_numIndexed);
+
+			for (size_t i = 0; i < _numIndexed; i++)
+				_order[i] = i;
+
+			if (_numIndexed > 0)
+				buildNode(0, _numIndexed, leafSize);
+		}
+
+		float getDistanceSquared(const float* x, size_t index) const {
+			const float* pX = getSampleX(index);
+
+			float distanceSquared = 0.0f;
+
+			for (size_t xi = 0; xi < _xSize; xi++) {
+				float difference = x[xi] - pX[xi];
+				distanceSquared += difference * difference;
+			}
+
+			return distanceSquared;
+		}
+
+		float getDistanceSquaredToNode(const float* x, int nodeIndex) const {
+			const float* pMins = &_nodeMins[nodeIndex * _xSize];
+			const float* pMaxs = &_nodeMaxs[nodeIndex * _xSize];
+
+			float distanceSquared = 0.0f;
+
+			for (size_t xi = 0; xi < _xSize; xi++) {
+				float difference = std::max(0.0f, std::max(pMins[xi] - x[xi], x[xi] - pMaxs[xi]));
+				distanceSquared += difference * difference;
+			}
+
+			return distanceSquared;
+		}
+
+		void addNeighbour(const float* x, size_t index, std::vector<Neighbour> &neighbours) const {
+			float distanceSquared = getDistanceSquared(x, index);
+
+			if (distanceSquared <= _cutoffDistanceSquared) {
+				Neighbour n;
+				n._index = index;
+				n._influence = _weights[index] * _kernel(distanceSquared);
+
+				neighbours.push_back(n);
+			}
+		}
+
 	public:
-		std::function<float(const std::vector<float> &, const std::vector<float> &)> _kernel;
+		Kernel _kernel;
+
+		SampleField()
+			: _xSize(0), _ySize(0), _minInfluence(0.0f), _cutoffDistanceSquared(std::numeric_limits<float>::infinity()),
+			_numIndexed(0), _leafSize(8)
+		{}
+
+		void create(size_t xSize, size_t ySize) {
+			assert(_xSize == 0 && _ySize == 0);
+
+			_xSize = xSize;
+			_ySize = ySize;
+		}
+
+		void addSample(const float* x, const float* y, float weight = 1.0f) {
+			assert(_xSize != 0 && _ySize != 0);
+
+			_xs.insert(_xs.end(), x, x + _xSize);
+			_ys.insert(_ys.end(), y, y + _ySize);
+			_weights.push_back(weight);
 
-		SampleField();
+			// Rebuild once the unindexed tail is a sizeable fraction of the tree
+			if (hasCutoff() && getNumSamples() - _numIndexed > std::max(_leafSize * 4, _numIndexed / 2))
+				buildIndex(_leafSize);
+		}
+
+		void addSample(const Sample &sample) {
+			assert(sample._x.size() == _xSize && sample._y.size() == _ySize);
+
+			addSample(sample._x.data(), sample._y.data());
+		}
 
-		void create(size_t xSize, size_t ySize);
+		// Samples whose influence would be below minInfluence are skipped, 0 disables the cutoff
+		void setCutoff(float minInfluence) {
+			_minInfluence = minInfluence;
 
-		void addSample(const Sample &sample);
+			_cutoffDistanceSquared = _minInfluence > 0.0f ? _kernel.getCutoffDistanceSquared(_minInfluence) : std::numeric_limits<float>::infinity();
 
-		std::vector<float> getYAtX(const std::vector<float> &x) const;
-		float getInfluenceAtX(const std::vector<float> &x) const;
-		float getVarianceAtX(const std::vector<float> &x) const;
+			if (hasCutoff())
+				buildIndex(_leafSize);
+			else {
+				_nodes.clear();
+				_order.clear();
+				_nodeMins.clear();
+				_nodeMaxs.clear();
+				_numIndexed = 0;
+			}
+		}
+
+		float getCutoff() const {
+			return _minInfluence;
+		}
+
+		bool hasCutoff() const {
+			return _cutoffDistanceSquared < std::numeric_limits<float>::infinity();
+		}
+
+		// Replaces groups of nearby samples by their weighted means (inducing points), leaving at most about maxNumSamples
+		void compress(size_t maxNumSamples) {
+			maxNumSamples = std::max<size_t>(2, maxNumSamples);
+
+			if (getNumSamples() <= maxNumSamples)
+				return;
+
+			// Leaves of a tree with this leaf size hold more than half of it, so there are at most maxNumSamples of them
+			size_t groupSize = (2 * getNumSamples() + maxNumSamples - 1) / maxNumSamples;
+
+			buildIndex(groupSize);
+
+			std::vector<float> xs;
+			std::vector<float> ys;
+			std::vector<float> weights;
+
+			for (size_t n = 0; n < _nodes.size(); n++) {
+				if (_nodes[n]._left != -1)
+					continue;
+
+				size_t xStart = xs.size();
+				size_t yStart = ys.size();
+
+				xs.resize(xStart + _xSize, 0.0f);
+				ys.resize(yStart + _ySize, 0.0f);
+
+				float totalWeight = 0.0f;
+
+				for (size_t i = _nodes[n]._start; i < _nodes[n]._end; i++) {
+					size_t index = _order[i];
+
+					const float* pX = getSampleX(index);
+					const float* pY = getSampleY(index);
+
+					for (size_t xi = 0; xi < _xSize; xi++)
+						xs[xStart + xi] += _weights[index] * pX[xi];
+
+					for (size_t yi = 0; yi < _ySize; yi++)
+						ys[yStart + yi] += _weights[index] * pY[yi];
+
+					totalWeight += _weights[index];
+				}
+
+				float totalWeightInv = 1.0f / totalWeight;
+
+				for (size_t xi = 0; xi < _xSize; xi++)
+					xs[xStart + xi] *= totalWeightInv;
+
+				for (size_t yi = 0; yi < _ySize; yi++)
+					ys[yStart + yi] *= totalWeightInv;
+
+				weights.push_back(totalWeight);
+			}
+
+			_xs.swap(xs);
+			_ys.swap(ys);
+			_weights.swap(weights);
+
+			setCutoff(_minInfluence);
+		}
+
+		// Samples within the cutoff and their influences on x
+		void getNeighbours(const float* x, std::vector<Neighbour> &neighbours) const {
+			neighbours.clear();
+
+			if (!hasCutoff()) {
+				for (size_t s = 0; s < getNumSamples(); s++) {
+					Neighbour n;
+					n._index = s;
+					n._influence = _weights[s] * _kernel(getDistanceSquared(x, s));
+
+					neighbours.push_back(n);
+				}
+
+				return;
+			}
+
+			if (!_nodes.empty()) {
+				int stack[64];
+				int stackSize = 0;
+
+				stack[stackSize++] = 0;
+
+				while (stackSize > 0) {
+					int nodeIndex = stack[--stackSize];
+
+					if (getDistanceSquaredToNode(x, nodeIndex) > _cutoffDistanceSquared)
+						continue;
+
+					const Node &node = _nodes[nodeIndex];
+
+					if (node._left == -1) {
+						for (size_t i = node._start; i < node._end; i++)
+							addNeighbour(x, _order[i], neighbours);
+					}
+					else {
+						stack[stackSize++] = node._right;
+						stack[stackSize++] = node._left;
+					}
+				}
+			}
+
+			for (size_t s = _numIndexed; s < getNumSamples(); s++)
+				addNeighbour(x, s, neighbours);
+		}
+
+		// Writes the kernel weighted average of the samples into y, returns the total influence
+		float getYAtX(const float* x, float* y, std::vector<Neighbour> &neighbours) const {
+			assert(_xSize != 0 && _ySize != 0);
+
+			getNeighbours(x, neighbours);
+
+			std::fill(y, y + _ySize, 0.0f);
+
+			float totalInfluence = 0.0f;
+
+			for (size_t n = 0; n < neighbours.size(); n++) {
+				const float* pY = getSampleY(neighbours[n]._index);
+
+				for (size_t yi = 0; yi < _ySize; yi++)
+					y[yi] += pY[yi] * neighbours[n]._influence;
+
+				totalInfluence += neighbours[n]._influence;
+			}
+
+			if (totalInfluence > 0.0f) {
+				float totalInfluenceInv = 1.0f / totalInfluence;
+
+				for (size_t yi = 0; yi < _ySize; yi++)
+					y[yi] *= totalInfluenceInv;
+			}
+
+			return totalInfluence;
+		}
+
+		float getInfluenceAtX(const float* x, std::vector<Neighbour> &neighbours) const {
+			getNeighbours(x, neighbours);
+
+			float totalInfluence = 0.0f;
+
+			for (size_t n = 0; n < neighbours.size(); n++)
+				totalInfluence += neighbours[n]._influence;
+
+			return totalInfluence;
+		}
+
+		// Influence weighted mean distance of the samples from the average, which is written into y
+		float getVarianceAtX(const float* x, float* y, std::vector<Neighbour> &neighbours) const {
+			float totalInfluence = getYAtX(x, y, neighbours);
+
+			if (totalInfluence <= 0.0f)
+				return 0.0f;
+
+			float variance = 0.0f;
+
+			for (size_t n = 0; n < neighbours.size(); n++) {
+				const float* pY = getSampleY(neighbours[n]._index);
+
+				float distance = 0.0f;
+
+				for (size_t yi = 0; yi < _ySize; yi++) {
+					float difference = pY[yi] - y[yi];
+
+					distance += difference * difference;
+				}
+
+				distance = std::sqrt(distance);
+
+				variance += distance * neighbours[n]._influence;
+			}
+
+			return variance / totalInfluence;
+		}
 
 		size_t getXSize() const {
 			return _xSize;
@@ -66,15 +445,27 @@ namespace hn {
 		}
 
 		size_t getNumSamples() const {
-			return _samples.size();
+			return _weights.size();
+		}
+
+		const float* getSampleX(size_t index) const {
+			return &_xs[index * _xSize];
+		}
+
+		const float* getSampleY(size_t index) const {
+			return &_ys[index * _ySize];
 		}
 
-		const Sample &getSample(size_t index) const {
-			return _samples[index];
+		float getSampleWeight(size_t index) const {
+			return _weights[index];
 		}
 
 		void clearSamples() {
-			_samples.clear();
+			_xs.clear();
+			_ys.clear();
+			_weights.clear();
+
+			setCutoff(_minInfluence);
 		}
 	};
 
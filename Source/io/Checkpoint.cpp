@@ -0,0 +1,85 @@
+/*
+AI Lib
+Copyright (C) 2014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <io/Checkpoint.h>
+
+#include <algorithm>
+#include <vector>
+
+uint32_t io::crc32(const void* data, size_t size) {
+	// Reflected polynomial 0xedb88320 (zlib, PNG)
+	static const std::vector<uint32_t> table = []() {
+		std::vector<uint32_t> t(256);
+
+		for (uint32_t i = 0; i < 256; i++) {
+			uint32_t c = i;
+
+			for (int k = 0; k < 8; k++)
+				c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+
+			t[i] = c;
+		}
+
+		return t;
+	}();
+
+	const unsigned char* pBytes = static_cast<const unsigned char*>(data);
+
+	uint32_t crc = 0xffffffffu;
+
+	for (size_t i = 0; i < size; i++)
+		crc = table[(crc ^ pBytes[i]) & 0xff] ^ (crc >> 8);
+
+	return crc ^ 0xffffffffu;
+}
+
+bool io::isLittleEndian() {
+	const uint32_t value = 1;
+
+	return *reinterpret_cast<const unsigned char*>(&value) == 1;
+}
+
+void io::swapBytes(void* data, size_t elementSize, size_t count) {
+	unsigned char* pBytes = static_cast<unsigned char*>(data);
+
+	for (size_t i = 0; i < count; i++)
+		std::reverse(pBytes + i * elementSize, pBytes + (i + 1) * elementSize);
+}
+
+void io::swapHeader(CheckpointHeader &header) {
+	if (isLittleEndian())
+		return;
+
+	swapBytes(&header._magic, sizeof(uint32_t), 1);
+	swapBytes(&header._version, sizeof(uint32_t), 1);
+	swapBytes(&header._numTensors, sizeof(uint32_t), 1);
+	swapBytes(&header._tableChecksum, sizeof(uint32_t), 1);
+}
+
+void io::swapTensorEntry(CheckpointTensorEntry &entry) {
+	if (isLittleEndian())
+		return;
+
+	swapBytes(&entry._dataType, sizeof(uint32_t), 1);
+	swapBytes(&entry._checksum, sizeof(uint32_t), 1);
+	swapBytes(&entry._count, sizeof(uint64_t), 1);
+	swapBytes(&entry._offset, sizeof(uint64_t), 1);
+}
@@ -0,0 +1,67 @@
+/*
+AI Lib
+Copyright (C) 2014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace io {
+	// Binary checkpoint layout, all values little-endian:
+	//   CheckpointHeader
+	//   CheckpointTensorEntry for each tensor
+	//   Tensor data, every block starting at a multiple of _checkpointAlignment bytes from the start of the file
+	// The header holds the CRC-32 of the tensor table, every table entry the CRC-32 of its data block
+	const uint32_t _checkpointMagic = 0x434c4941; // "AILC"
+	const uint32_t _checkpointVersion = 1;
+	const size_t _checkpointAlignment = 64;
+	const size_t _checkpointMaxNameLength = 96; // Including the terminating 0
+
+	enum CheckpointDataType {
+		_float32 = 0, _int32 = 1
+	};
+
+	struct CheckpointHeader {
+		uint32_t _magic;
+		uint32_t _version;
+		uint32_t _numTensors;
+		uint32_t _tableChecksum;
+	};
+
+	struct CheckpointTensorEntry {
+		char _name[_checkpointMaxNameLength];
+		uint32_t _dataType;
+		uint32_t _checksum;
+		uint64_t _count;
+		uint64_t _offset;
+	};
+
+	uint32_t crc32(const void* data, size_t size);
+
+	bool isLittleEndian();
+
+	// Reverse the byte order of count elements of elementSize bytes
+	void swapBytes(void* data, size_t elementSize, size_t count);
+
+	// Converts the header or a table entry between host and file byte order (a no-op on little-endian hosts)
+	void swapHeader(CheckpointHeader &header);
+	void swapTensorEntry(CheckpointTensorEntry &entry);
+}
@@ -0,0 +1,326 @@
+/*
+AI Lib
+Copyright (C) 2014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <io/CheckpointReader.h>
+
+#include <fstream>
+#include <iterator>
+#include <cstring>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace io;
+
+CheckpointReader::CheckpointReader()
+	: _pData(nullptr), _size(0),
+#if defined(_WIN32)
+	_fileHandle(nullptr), _mappingHandle(nullptr)
+#else
+	_fileDescriptor(-1)
+#endif
+{}
+
+CheckpointReader::~CheckpointReader() {
+	close();
+}
+
+bool CheckpointReader::open(const std::string &fileName, bool verifyChecksums) {
+	close();
+
+	if (!isLittleEndian()) {
+		std::ifstream is(fileName, std::ios::in | std::ios::binary);
+
+		if (!is.is_open())
+			return false;
+
+		return openFromStream(is, verifyChecksums);
+	}
+
+#if defined(_WIN32)
+	HANDLE fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	_fileHandle = fileHandle;
+
+	LARGE_INTEGER size;
+
+	if (!GetFileSizeEx(fileHandle, &size) || size.QuadPart == 0) {
+		close();
+
+		return false;
+	}
+
+	_size = static_cast<size_t>(size.QuadPart);
+
+	_mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (_mappingHandle == nullptr) {
+		close();
+
+		return false;
+	}
+
+	_pData = static_cast<const char*>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+	_fileDescriptor = ::open(fileName.c_str(), O_RDONLY);
+
+	if (_fileDescriptor < 0)
+		return false;
+
+	struct stat fileStat;
+
+	if (fstat(_fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0) {
+		close();
+
+		return false;
+	}
+
+	_size = static_cast<size_t>(fileStat.st_size);
+
+	void* pMapping = mmap(nullptr, _size, PROT_READ, MAP_SHARED, _fileDescriptor, 0);
+
+	_pData = pMapping == MAP_FAILED ? nullptr : static_cast<const char*>(pMapping);
+#endif
+
+	if (_pData == nullptr || !parse(verifyChecksums)) {
+		close();
+
+		return false;
+	}
+
+	return true;
+}
+
+bool CheckpointReader::openFromStream(std::istream &is, bool verifyChecksums) {
+	close();
+
+	_buffer.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+
+	if (_buffer.empty())
+		return false;
+
+	_pData = _buffer.data();
+	_size = _buffer.size();
+
+	if (!parse(verifyChecksums)) {
+		close();
+
+		return false;
+	}
+
+	// Convert the data blocks to host byte order in place, checksums were computed on the file bytes
+	if (!isLittleEndian())
+	for (std::unordered_map<std::string, Tensor>::iterator it = _tensors.begin(); it != _tensors.end(); it++)
+		swapBytes(&_buffer[it->second._data - _pData], 4, it->second._count);
+
+	return true;
+}
+
+bool CheckpointReader::parse(bool verifyChecksums) {
+	if (_size < sizeof(CheckpointHeader))
+		return false;
+
+	CheckpointHeader header;
+
+	std::memcpy(&header, _pData, sizeof(CheckpointHeader));
+
+	swapHeader(header);
+
+	if (header._magic != _checkpointMagic || header._version != _checkpointVersion)
+		return false;
+
+	size_t tableSize = static_cast<size_t>(header._numTensors) * sizeof(CheckpointTensorEntry);
+
+	if (_size - sizeof(CheckpointHeader) < tableSize)
+		return false;
+
+	const char* pTable = _pData + sizeof(CheckpointHeader);
+
+	if (crc32(pTable, tableSize) != header._tableChecksum)
+		return false;
+
+	for (uint32_t i = 0; i < header._numTensors; i++) {
+		CheckpointTensorEntry entry;
+
+		std::memcpy(&entry, pTable + i * sizeof(CheckpointTensorEntry), sizeof(CheckpointTensorEntry));
+
+		swapTensorEntry(entry);
+
+		entry._name[_checkpointMaxNameLength - 1] = '\0';
+
+		if (entry._dataType != _float32 && entry._dataType != _int32)
+			return false;
+
+		// Data block must lie within the file
+		if (entry._offset > _size || entry._count > (_size - entry._offset) / 4)
+			return false;
+
+		Tensor tensor;
+
+		tensor._dataType = static_cast<CheckpointDataType>(entry._dataType);
+		tensor._checksum = entry._checksum;
+		tensor._count = static_cast<size_t>(entry._count);
+		tensor._data = _pData + entry._offset;
+
+		_tensors[entry._name] = tensor;
+	}
+
+	return !verifyChecksums || this->verifyChecksums();
+}
+
+bool CheckpointReader::verifyChecksums() const {
+	for (std::unordered_map<std::string, Tensor>::const_iterator it = _tensors.begin(); it != _tensors.end(); it++)
+	if (crc32(it->second._data, it->second._count * 4) != it->second._checksum)
+		return false;
+
+	return true;
+}
+
+void CheckpointReader::unmap() {
+#if defined(_WIN32)
+	if (_mappingHandle != nullptr) {
+		if (_pData != nullptr)
+			UnmapViewOfFile(_pData);
+
+		CloseHandle(_mappingHandle);
+
+		_mappingHandle = nullptr;
+	}
+
+	if (_fileHandle != nullptr) {
+		CloseHandle(_fileHandle);
+
+		_fileHandle = nullptr;
+	}
+#else
+	if (_fileDescriptor >= 0) {
+		if (_pData != nullptr)
+			munmap(const_cast<char*>(_pData), _size);
+
+		::close(_fileDescriptor);
+
+		_fileDescriptor = -1;
+	}
+#endif
+}
+
+void CheckpointReader::close() {
+	unmap();
+
+	_buffer.clear();
+	_tensors.clear();
+
+	_pData = nullptr;
+	_size = 0;
+}
+
+const CheckpointReader::Tensor* CheckpointReader::findTensor(const std::string &name, CheckpointDataType dataType) const {
+	std::unordered_map<std::string, Tensor>::const_iterator it = _tensors.find(name);
+
+	if (it == _tensors.end() || it->second._dataType != dataType)
+		return nullptr;
+
+	return &it->second;
+}
+
+const float* CheckpointReader::getFloats(const std::string &name, size_t &count) const {
+	const Tensor* pTensor = findTensor(name, _float32);
+
+	if (pTensor == nullptr)
+		return nullptr;
+
+	count = pTensor->_count;
+
+	return reinterpret_cast<const float*>(pTensor->_data);
+}
+
+const int* CheckpointReader::getInts(const std::string &name, size_t &count) const {
+	const Tensor* pTensor = findTensor(name, _int32);
+
+	if (pTensor == nullptr)
+		return nullptr;
+
+	count = pTensor->_count;
+
+	return reinterpret_cast<const int*>(pTensor->_data);
+}
+
+bool CheckpointReader::readFloats(const std::string &name, std::vector<float> &data) const {
+	size_t count;
+
+	const float* pData = getFloats(name, count);
+
+	if (pData == nullptr)
+		return false;
+
+	data.assign(pData, pData + count);
+
+	return true;
+}
+
+bool CheckpointReader::readFloats(const std::string &name, float* data, size_t count) const {
+	size_t tensorCount;
+
+	const float* pData = getFloats(name, tensorCount);
+
+	if (pData == nullptr || tensorCount != count)
+		return false;
+
+	std::memcpy(data, pData, count * sizeof(float));
+
+	return true;
+}
+
+bool CheckpointReader::readInts(const std::string &name, std::vector<int> &data) const {
+	size_t count;
+
+	const int* pData = getInts(name, count);
+
+	if (pData == nullptr)
+		return false;
+
+	data.assign(pData, pData + count);
+
+	return true;
+}
+
+bool CheckpointReader::readInts(const std::string &name, int* data, size_t count) const {
+	size_t tensorCount;
+
+	const int* pData = getInts(name, tensorCount);
+
+	if (pData == nullptr || tensorCount != count)
+		return false;
+
+	std::memcpy(data, pData, count * sizeof(int));
+
+	return true;
+}
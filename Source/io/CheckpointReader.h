@@ -0,0 +1,104 @@
+/*
+AI Lib
+Copyright (C) 2014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <io/Checkpoint.h>
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <unordered_map>
+
+namespace io {
+	// Reads a binary checkpoint (see Checkpoint.h). open() memory-maps the file read-only, so tensor data is not copied:
+	// getFloats/getInts point straight into the mapping and the pages are shared with every other process that maps the same file.
+	// Pointers stay valid until close() or destruction. On big-endian hosts the file is loaded into memory and converted instead
+	class CheckpointReader {
+	private:
+		struct Tensor {
+			CheckpointDataType _dataType;
+			uint32_t _checksum;
+			size_t _count;
+			const char* _data;
+		};
+
+		std::unordered_map<std::string, Tensor> _tensors;
+
+		const char* _pData;
+		size_t _size;
+
+		// Either a file mapping or an owned copy of the file
+		std::vector<char> _buffer;
+
+#if defined(_WIN32)
+		void* _fileHandle;
+		void* _mappingHandle;
+#else
+		int _fileDescriptor;
+#endif
+
+		bool parse(bool verifyChecksums);
+		void unmap();
+
+		const Tensor* findTensor(const std::string &name, CheckpointDataType dataType) const;
+
+	public:
+		CheckpointReader();
+		~CheckpointReader();
+
+		CheckpointReader(const CheckpointReader &) = delete;
+		CheckpointReader &operator=(const CheckpointReader &) = delete;
+
+		// The table checksum is always checked. Checking the data checksums touches every page, so it is optional
+		bool open(const std::string &fileName, bool verifyChecksums = false);
+
+		// Reads the whole stream (opened in binary mode) into memory
+		bool openFromStream(std::istream &is, bool verifyChecksums = true);
+
+		void close();
+
+		// Checks the data checksums of all tensors
+		bool verifyChecksums() const;
+
+		bool hasTensor(const std::string &name) const {
+			return _tensors.find(name) != _tensors.end();
+		}
+
+		// Zero-copy access, nullptr if the tensor does not exist or has another data type
+		const float* getFloats(const std::string &name, size_t &count) const;
+		const int* getInts(const std::string &name, size_t &count) const;
+
+		// Copies, false if the tensor does not exist, has another data type or (for the pointer versions) another size
+		bool readFloats(const std::string &name, std::vector<float> &data) const;
+		bool readFloats(const std::string &name, float* data, size_t count) const;
+		bool readInts(const std::string &name, std::vector<int> &data) const;
+		bool readInts(const std::string &name, int* data, size_t count) const;
+
+		bool isOpen() const {
+			return _pData != nullptr;
+		}
+
+		int getNumTensors() const {
+			return _tensors.size();
+		}
+	};
+}
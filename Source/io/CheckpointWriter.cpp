@@ -0,0 +1,133 @@
+/*
+AI Lib
+Copyright (C) 2014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <io/CheckpointWriter.h>
+
+#include <fstream>
+#include <cstring>
+#include <assert.h>
+
+using namespace io;
+
+void CheckpointWriter::addTensor(const std::string &name, CheckpointDataType dataType, const void* data, size_t count) {
+	assert(name.size() < _checkpointMaxNameLength);
+
+	for (int i = 0; i < _tensors.size(); i++)
+		assert(_tensors[i]._name != name);
+
+	Tensor tensor;
+
+	tensor._name = name;
+	tensor._dataType = dataType;
+	tensor._count = count;
+	tensor._data.resize(count * 4);
+
+	if (count > 0)
+		std::memcpy(tensor._data.data(), data, tensor._data.size());
+
+	// Both data types have 4 byte elements
+	if (!isLittleEndian())
+		swapBytes(tensor._data.data(), 4, count);
+
+	_tensors.push_back(tensor);
+}
+
+void CheckpointWriter::addFloats(const std::string &name, const float* data, size_t count) {
+	addTensor(name, _float32, data, count);
+}
+
+void CheckpointWriter::addFloats(const std::string &name, const std::vector<float> &data) {
+	addTensor(name, _float32, data.data(), data.size());
+}
+
+void CheckpointWriter::addInts(const std::string &name, const int* data, size_t count) {
+	addTensor(name, _int32, data, count);
+}
+
+void CheckpointWriter::addInts(const std::string &name, const std::vector<int> &data) {
+	addTensor(name, _int32, data.data(), data.size());
+}
+
+bool CheckpointWriter::writeToStream(std::ostream &os) const {
+	std::vector<CheckpointTensorEntry> entries(_tensors.size());
+
+	// Data blocks follow the table, aligned
+	uint64_t offset = sizeof(CheckpointHeader) + entries.size() * sizeof(CheckpointTensorEntry);
+
+	for (int i = 0; i < _tensors.size(); i++) {
+		CheckpointTensorEntry &entry = entries[i];
+
+		offset = (offset + _checkpointAlignment - 1) / _checkpointAlignment * _checkpointAlignment;
+
+		std::memset(&entry, 0, sizeof(CheckpointTensorEntry));
+		std::memcpy(entry._name, _tensors[i]._name.c_str(), _tensors[i]._name.size());
+
+		entry._dataType = _tensors[i]._dataType;
+		entry._checksum = crc32(_tensors[i]._data.data(), _tensors[i]._data.size());
+		entry._count = _tensors[i]._count;
+		entry._offset = offset;
+
+		offset += _tensors[i]._data.size();
+
+		swapTensorEntry(entry);
+	}
+
+	CheckpointHeader header;
+
+	header._magic = _checkpointMagic;
+	header._version = _checkpointVersion;
+	header._numTensors = _tensors.size();
+	header._tableChecksum = crc32(entries.data(), entries.size() * sizeof(CheckpointTensorEntry));
+
+	swapHeader(header);
+
+	os.write(reinterpret_cast<const char*>(&header), sizeof(CheckpointHeader));
+	os.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(CheckpointTensorEntry));
+
+	uint64_t position = sizeof(CheckpointHeader) + entries.size() * sizeof(CheckpointTensorEntry);
+
+	const char padding[_checkpointAlignment] = {};
+
+	for (int i = 0; i < _tensors.size(); i++) {
+		uint64_t alignedPosition = (position + _checkpointAlignment - 1) / _checkpointAlignment * _checkpointAlignment;
+
+		os.write(padding, alignedPosition - position);
+		os.write(_tensors[i]._data.data(), _tensors[i]._data.size());
+
+		position = alignedPosition + _tensors[i]._data.size();
+	}
+
+	return static_cast<bool>(os);
+}
+
+bool CheckpointWriter::writeToFile(const std::string &fileName) const {
+	std::ofstream os(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+
+	if (!os.is_open())
+		return false;
+
+	if (!writeToStream(os))
+		return false;
+
+	os.close();
+
+	return !os.fail();
+}
@@ -0,0 +1,64 @@
+/*
+AI Lib
+Copyright (C) 2014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <io/Checkpoint.h>
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace io {
+	// Collects named tensors and writes them as a binary checkpoint (see Checkpoint.h).
+	// Tensor data is copied when added, so the source objects may change before writing
+	class CheckpointWriter {
+	private:
+		struct Tensor {
+			std::string _name;
+			CheckpointDataType _dataType;
+			size_t _count;
+			std::vector<char> _data;
+		};
+
+		std::vector<Tensor> _tensors;
+
+		void addTensor(const std::string &name, CheckpointDataType dataType, const void* data, size_t count);
+
+	public:
+		void addFloats(const std::string &name, const float* data, size_t count);
+		void addFloats(const std::string &name, const std::vector<float> &data);
+		void addInts(const std::string &name, const int* data, size_t count);
+		void addInts(const std::string &name, const std::vector<int> &data);
+
+		// Stream must be opened in binary mode
+		bool writeToStream(std::ostream &os) const;
+		bool writeToFile(const std::string &fileName) const;
+
+		void clear() {
+			_tensors.clear();
+		}
+
+		int getNumTensors() const {
+			return _tensors.size();
+		}
+	};
+}
@@ -41,7 +41,7 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 	for (int i = 0; i < numInputs; i++)
 		_inputIndices[i] = i;
 
-	_units.resize(numInputs + numMemoryLayers * memoryLayerSize * 4 + numHiddenLayers * hiddenLayerSize + numOutputs);
+	std::vector<Unit> units(numInputs + numMemoryLayers * memoryLayerSize * 4 + numHiddenLayers * hiddenLayerSize + numOutputs);
 
 	int inputIndex = 0;
 
@@ -64,15 +64,15 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 
 		// Create input gaters
 		for (int ui = 0; ui < memoryLayerSize; ui++) {
-			Unit &inputGate = _units[inputIndex];
+			Unit &inputGate = units[inputIndex];
 
-			inputGate._bias = inputGate._prevBias = weightDist(randomGenerator);
+			inputGate._bias = weightDist(randomGenerator);
 
 			// Input connections
 			for (int i = 0; i < numInputs; i++) {
 				Connection c;
 
-				c._weight = c._prevWeight = weightDist(randomGenerator);
+				c._weight = weightDist(randomGenerator);
 				c._inputIndex = i;
 
 				inputGate._ingoingConnections.push_back(c);
@@ -85,15 +85,15 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 
 		// Create forget gaters
 		for (int ui = 0; ui < memoryLayerSize; ui++) {
-			Unit &forgetGate = _units[inputIndex];
+			Unit &forgetGate = units[inputIndex];
 
-			forgetGate._bias = forgetGate._prevBias = weightDist(randomGenerator);
+			forgetGate._bias = weightDist(randomGenerator);
 
 			// Input connections
 			for (int i = 0; i < numInputs; i++) {
 				Connection c;
 
-				c._weight = c._prevWeight = weightDist(randomGenerator);
+				c._weight = weightDist(randomGenerator);
 				c._inputIndex = i;
 
 				forgetGate._ingoingConnections.push_back(c);
@@ -106,18 +106,18 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 
 		// Create memory units
 		for (int ui = 0; ui < memoryLayerSize; ui++) {
-			Unit &memoryUnit = _units[inputIndex];
+			Unit &memoryUnit = units[inputIndex];
 
-			memoryUnit._bias = memoryUnit._prevBias = weightDist(randomGenerator);
+			memoryUnit._bias = weightDist(randomGenerator);
 
 			// Input connections
 			for (int i = 0; i < numInputs; i++) {
 				Connection c;
 
 				c._gaterIndex = inputGatersStart + i;
-				_units[c._gaterIndex]._gatingConnections.push_back(inputIndex);
+				units[c._gaterIndex]._gatingConnections.push_back(inputIndex);
 
-				c._weight = c._prevWeight = weightDist(randomGenerator);
+				c._weight = weightDist(randomGenerator);
 				c._inputIndex = i;
 
 				memoryUnit._ingoingConnections.push_back(c);
@@ -127,9 +127,9 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 			Connection c;
 
 			c._gaterIndex = forgetGatersStart + inputIndex - memoryUnitsStart;
-			_units[c._gaterIndex]._gatingConnections.push_back(inputIndex);
+			units[c._gaterIndex]._gatingConnections.push_back(inputIndex);
 
-			c._weight = c._prevWeight = weightDist(randomGenerator);
+			c._weight = weightDist(randomGenerator);
 			c._inputIndex = inputIndex;
 
 			memoryUnit._ingoingConnections.push_back(c);
@@ -143,17 +143,17 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 
 		// Create output gaters
 		for (int ui = 0; ui < memoryLayerSize; ui++) {
-			Unit &outputGater = _units[inputIndex];
+			Unit &outputGater = units[inputIndex];
 
 			_orderedGaterIndices.push_back(inputIndex);
 
-			outputGater._bias = outputGater._prevBias = weightDist(randomGenerator);
+			outputGater._bias = weightDist(randomGenerator);
 
 			// Input connections
 			for (int i = 0; i < numInputs; i++) {
 				Connection c;
 
-				c._weight = c._prevWeight = weightDist(randomGenerator);
+				c._weight = weightDist(randomGenerator);
 				c._inputIndex = i;
 
 				outputGater._ingoingConnections.push_back(c);
@@ -166,30 +166,30 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 		for (int i = 0; i < memoryLayerSize; i++) {
 			Connection c;
 
-			c._weight = c._prevWeight = weightDist(randomGenerator);
+			c._weight = weightDist(randomGenerator);
 			c._inputIndex = i + memoryUnitsStart;
 
-			_units[i + inputGatersStart]._ingoingConnections.push_back(c);
+			units[i + inputGatersStart]._ingoingConnections.push_back(c);
 		}
 
 		// Add connections to forget gaters (not fully connected)
 		for (int i = 0; i < memoryLayerSize; i++) {
 			Connection c;
 
-			c._weight = c._prevWeight = weightDist(randomGenerator);
+			c._weight = weightDist(randomGenerator);
 			c._inputIndex = i + memoryUnitsStart;
 
-			_units[i + forgetGatersStart]._ingoingConnections.push_back(c);
+			units[i + forgetGatersStart]._ingoingConnections.push_back(c);
 		}
 
 		// Add connections to output gaters (not fully connected)
 		for (int i = 0; i < memoryLayerSize; i++) {
 			Connection c;
 
-			c._weight = c._prevWeight = weightDist(randomGenerator);
+			c._weight = weightDist(randomGenerator);
 			c._inputIndex = i + memoryUnitsStart;
 
-			_units[i + outputGatersStart]._ingoingConnections.push_back(c);
+			units[i + outputGatersStart]._ingoingConnections.push_back(c);
 		}
 
 		outputGatersStarts.push_back(outputGatersStart);
@@ -208,15 +208,15 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 
 		// Create input gaters
 		for (int ui = 0; ui < memoryLayerSize; ui++) {
-			Unit &inputGate = _units[inputIndex];
+			Unit &inputGate = units[inputIndex];
 
-			inputGate._bias = inputGate._prevBias = weightDist(randomGenerator);
+			inputGate._bias = weightDist(randomGenerator);
 
 			// Input connections
 			for (int i = 0; i < numInputs; i++) {
 				Connection c;
 
-				c._weight = c._prevWeight = weightDist(randomGenerator);
+				c._weight = weightDist(randomGenerator);
 				c._inputIndex = i;
 
 				inputGate._ingoingConnections.push_back(c);
@@ -226,7 +226,7 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 			for (int i = 0; i < memoryLayerSize; i++) {
 				Connection c;
 
-				c._weight = c._prevWeight = weightDist(randomGenerator);
+				c._weight = weightDist(randomGenerator);
 				c._inputIndex = prevMemoryUnitsStart + i;
 
 				inputGate._ingoingConnections.push_back(c);
@@ -239,15 +239,15 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 
 		// Create forget gaters
 		for (int ui = 0; ui < memoryLayerSize; ui++) {
-			Unit &forgetGate = _units[inputIndex];
+			Unit &forgetGate = units[inputIndex];
 
-			forgetGate._bias = forgetGate._prevBias = weightDist(randomGenerator);
+			forgetGate._bias = weightDist(randomGenerator);
 
 			// Input connections
 			for (int i = 0; i < numInputs; i++) {
 				Connection c;
 
-				c._weight = c._prevWeight = weightDist(randomGenerator);
+				c._weight = weightDist(randomGenerator);
 				c._inputIndex = i;
 
 				forgetGate._ingoingConnections.push_back(c);
@@ -257,7 +257,7 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 			for (int i = 0; i < memoryLayerSize; i++) {
 				Connection c;
 
-				c._weight = c._prevWeight = weightDist(randomGenerator);
+				c._weight = weightDist(randomGenerator);
 				c._inputIndex = prevMemoryUnitsStart + i;
 
 				forgetGate._ingoingConnections.push_back(c);
@@ -270,18 +270,18 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 
 		// Create memory units
 		for (int ui = 0; ui < memoryLayerSize; ui++) {
-			Unit &memoryUnit = _units[inputIndex];
+			Unit &memoryUnit = units[inputIndex];
 
-			memoryUnit._bias = memoryUnit._prevBias = weightDist(randomGenerator);
+			memoryUnit._bias = weightDist(randomGenerator);
 
 			// Input connections
 			for (int i = 0; i < numInputs; i++) {
 				Connection c;
 
 				c._gaterIndex = inputGatersStart + i;
-				_units[c._gaterIndex]._gatingConnections.push_back(inputIndex);
+				units[c._gaterIndex]._gatingConnections.push_back(inputIndex);
 
-				c._weight = c._prevWeight = weightDist(randomGenerator);
+				c._weight = weightDist(randomGenerator);
 				c._inputIndex = i;
 
 				memoryUnit._ingoingConnections.push_back(c);
@@ -292,9 +292,9 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 				Connection c;
 
 				c._gaterIndex = forgetGatersStart + inputIndex - memoryUnitsStart;
-				_units[c._gaterIndex]._gatingConnections.push_back(inputIndex);
+				units[c._gaterIndex]._gatingConnections.push_back(inputIndex);
 
-				c._weight = c._prevWeight = weightDist(randomGenerator);
+				c._weight = weightDist(randomGenerator);
 				c._inputIndex = inputIndex;
 
 				memoryUnit._ingoingConnections.push_back(c);
@@ -307,9 +307,9 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 				Connection c;
 
 				c._gaterIndex = inputGatersStart + i;
-				_units[c._gaterIndex]._gatingConnections.push_back(inputIndex);
+				units[c._gaterIndex]._gatingConnections.push_back(inputIndex);
 
-				c._weight = c._prevWeight = weightDist(randomGenerator);
+				c._weight = weightDist(randomGenerator);
 				c._inputIndex = prevMemoryUnitsStart + i;
 
 				memoryUnit._ingoingConnections.push_back(c);
@@ -322,15 +322,15 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 
 		// Create output gaters
 		for (int ui = 0; ui < memoryLayerSize; ui++) {
-			Unit &outputGater = _units[inputIndex];
+			Unit &outputGater = units[inputIndex];
 
-			outputGater._bias = outputGater._prevBias = weightDist(randomGenerator);
+			outputGater._bias = weightDist(randomGenerator);
 
 			// Input connections
 			for (int i = 0; i < numInputs; i++) {
 				Connection c;
 
-				c._weight = c._prevWeight = weightDist(randomGenerator);
+				c._weight = weightDist(randomGenerator);
 				c._inputIndex = i;
 
 				outputGater._ingoingConnections.push_back(c);
@@ -340,7 +340,7 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 			for (int i = 0; i < memoryLayerSize; i++) {
 				Connection c;
 
-				c._weight = c._prevWeight = weightDist(randomGenerator);
+				c._weight = weightDist(randomGenerator);
 				c._inputIndex = prevMemoryUnitsStart + i;
 
 				outputGater._ingoingConnections.push_back(c);
@@ -353,30 +353,30 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 		for (int i = 0; i < memoryLayerSize; i++) {
 			Connection c;
 
-			c._weight = c._prevWeight = weightDist(randomGenerator);
+			c._weight = weightDist(randomGenerator);
 			c._inputIndex = i + memoryUnitsStart;
 
-			_units[i + inputGatersStart]._ingoingConnections.push_back(c);
+			units[i + inputGatersStart]._ingoingConnections.push_back(c);
 		}
 
 		// Add connections to forget gaters (not fully connected)
 		for (int i = 0; i < memoryLayerSize; i++) {
 			Connection c;
 
-			c._weight = c._prevWeight = weightDist(randomGenerator);
+			c._weight = weightDist(randomGenerator);
 			c._inputIndex = i + memoryUnitsStart;
 
-			_units[i + forgetGatersStart]._ingoingConnections.push_back(c);
+			units[i + forgetGatersStart]._ingoingConnections.push_back(c);
 		}
 
 		// Add connections to output gaters (not fully connected)
 		for (int i = 0; i < memoryLayerSize; i++) {
 			Connection c;
 
-			c._weight = c._prevWeight = weightDist(randomGenerator);
+			c._weight = weightDist(randomGenerator);
 			c._inputIndex = i + memoryUnitsStart;
 
-			_units[i + outputGatersStart]._ingoingConnections.push_back(c);
+			units[i + outputGatersStart]._ingoingConnections.push_back(c);
 		}
 
 		outputGatersStarts.push_back(outputGatersStart);
@@ -390,15 +390,15 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 		int hiddenUnitsStart = inputIndex;
 
 		for (int ui = 0; ui < hiddenLayerSize; ui++) {
-			Unit &hiddenUnit = _units[inputIndex];
+			Unit &hiddenUnit = units[inputIndex];
 
-			hiddenUnit._bias = hiddenUnit._prevBias = weightDist(randomGenerator);
+			hiddenUnit._bias = weightDist(randomGenerator);
 
 			// Input connections
 			for (int i = 0; i < numInputs; i++) {
 				Connection c;
 
-				c._weight = c._prevWeight = weightDist(randomGenerator);
+				c._weight = weightDist(randomGenerator);
 				c._inputIndex = i;
 
 				hiddenUnit._ingoingConnections.push_back(c);
@@ -410,9 +410,9 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 					Connection c;
 
 					c._gaterIndex = outputGatersStarts[ogl] + i;
-					_units[c._gaterIndex]._gatingConnections.push_back(inputIndex);
+					units[c._gaterIndex]._gatingConnections.push_back(inputIndex);
 
-					c._weight = c._prevWeight = weightDist(randomGenerator);
+					c._weight = weightDist(randomGenerator);
 					c._inputIndex = memoryUnitsStarts[ogl] + i;
 
 					hiddenUnit._ingoingConnections.push_back(c);
@@ -430,15 +430,15 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 			hiddenUnitsStart = inputIndex;
 
 			for (int ui = 0; ui < hiddenLayerSize; ui++) {
-				Unit &hiddenUnit = _units[inputIndex];
+				Unit &hiddenUnit = units[inputIndex];
 
-				hiddenUnit._bias = hiddenUnit._prevBias = weightDist(randomGenerator);
+				hiddenUnit._bias = weightDist(randomGenerator);
 
 				// Previous hidden connections
 				for (int i = 0; i < hiddenLayerSize; i++) {
 					Connection c;
 
-					c._weight = c._prevWeight = weightDist(randomGenerator);
+					c._weight = weightDist(randomGenerator);
 					c._inputIndex = prevHiddenUnitsStart + i;
 
 					hiddenUnit._ingoingConnections.push_back(c);
@@ -458,15 +458,15 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 			for (int ui = 0; ui < numOutputs; ui++) {
 				_outputIndices.push_back(inputIndex);
 
-				Unit &outputUnit = _units[inputIndex];
+				Unit &outputUnit = units[inputIndex];
 
-				outputUnit._bias = outputUnit._prevBias = weightDist(randomGenerator);
+				outputUnit._bias = weightDist(randomGenerator);
 
 				// Previous hidden connections
 				for (int i = 0; i < hiddenLayerSize; i++) {
 					Connection c;
 
-					c._weight = c._prevWeight = weightDist(randomGenerator);
+					c._weight = weightDist(randomGenerator);
 					c._inputIndex = prevHiddenUnitsStart + i;
 
 					outputUnit._ingoingConnections.push_back(c);
@@ -483,15 +483,15 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 		for (int ui = 0; ui < numOutputs; ui++) {
 			_outputIndices.push_back(inputIndex);
 
-			Unit &outputUnit = _units[inputIndex];
+			Unit &outputUnit = units[inputIndex];
 
-			outputUnit._bias = outputUnit._prevBias = weightDist(randomGenerator);
+			outputUnit._bias = weightDist(randomGenerator);
 
 			// Input connections
 			for (int i = 0; i < numInputs; i++) {
 				Connection c;
 
-				c._weight = c._prevWeight = weightDist(randomGenerator);
+				c._weight = weightDist(randomGenerator);
 				c._inputIndex = i;
 
 				outputUnit._ingoingConnections.push_back(c);
@@ -503,9 +503,9 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 					Connection c;
 
 					c._gaterIndex = outputGatersStarts[ogl] + i;
-					_units[c._gaterIndex]._gatingConnections.push_back(inputIndex);
+					units[c._gaterIndex]._gatingConnections.push_back(inputIndex);
 
-					c._weight = c._prevWeight = weightDist(randomGenerator);
+					c._weight = weightDist(randomGenerator);
 					c._inputIndex = memoryUnitsStarts[ogl] + i;
 
 					outputUnit._ingoingConnections.push_back(c);
@@ -516,248 +516,455 @@ void LSTMG::createRandomLayered(int numInputs, int numOutputs,
 		}
 	}
 
-	// Build gaters maps as well as ingoing and outgoing connection arrays
-	for (int j = 0; j < _units.size(); j++)
-	for (int ci = 0; ci < _units[j]._ingoingConnections.size(); ci++) {
-		Connection &c = _units[j]._ingoingConnections[ci];
-
-		_units[c._inputIndex]._outgoingConnectionIndices.push_back(ConnectionIndex(j, ci));
-	}
-
 	// Build sorted list of gater indices
 	std::sort(_orderedGaterIndices.begin(), _orderedGaterIndices.end());
 
-	clear();
+	compile(units);
 }
 
-bool LSTMG::connectionExists(int j, int i) {
-	for (int ii = 0; ii < _units[j]._ingoingConnections.size(); ii++)
-	if (_units[j]._ingoingConnections[ii]._inputIndex == i)
-		return true;
+void LSTMG::compile(const std::vector<Unit> &units) {
+	int numUnits = units.size();
 
-	return false;
-}
+	_states.assign(numUnits, 0.0f);
+	_prevStates.assign(numUnits, 0.0f);
+	_activations.assign(numUnits, 0.0f);
+	_biases.resize(numUnits);
+	_biasEligibilities.assign(numUnits, 0.0f);
+	_prevGains.assign(numUnits, 0.0f);
+	_recurrentConnections.resize(numUnits);
 
-void LSTMG::clear() {
-	for (int j = 0; j < _units.size(); j++) {
-		_units[j]._state = _units[j]._activation = 0.0f;
+	_connectionStarts.resize(numUnits + 1);
+	_connectionUnits.clear();
+	_connectionInputs.clear();
+	_connectionGaters.clear();
+	_weights.clear();
+
+	_gatingStarts.resize(numUnits + 1);
+	_gatingUnits.clear();
+
+	_connectionStarts[0] = 0;
+	_gatingStarts[0] = 0;
+
+	for (int j = 0; j < numUnits; j++) {
+		const Unit &unit = units[j];
+
+		_biases[j] = unit._bias;
+		_recurrentConnections[j] = unit._recurrentConnectionIndex == -1 ? -1 : _connectionStarts[j] + unit._recurrentConnectionIndex;
+
+		for (int ci = 0; ci < unit._ingoingConnections.size(); ci++) {
+			_connectionUnits.push_back(j);
+			_connectionInputs.push_back(unit._ingoingConnections[ci]._inputIndex);
+			_connectionGaters.push_back(unit._ingoingConnections[ci]._gaterIndex);
+			_weights.push_back(unit._ingoingConnections[ci]._weight);
+		}
+
+		_connectionStarts[j + 1] = _weights.size();
+
+		_gatingUnits.insert(_gatingUnits.end(), unit._gatingConnections.begin(), unit._gatingConnections.end());
+
+		_gatingStarts[j + 1] = _gatingUnits.size();
+	}
+
+	_prevBiases = _biases;
+
+	int numConnections = _weights.size();
+
+	_prevWeights = _weights;
+	_eligibilities.assign(numConnections, 0.0f);
+	_connectionPrevGains.assign(numConnections, 0.0f);
+	_connectionPrevActivations.assign(numConnections, 0.0f);
+	_traces.assign(numConnections, 0.0f);
+
+	// Outgoing connections and gated connections, both bucketed by unit while keeping connection order
+	_outgoingStarts.assign(numUnits + 1, 0);
+	_gatedStarts.assign(numUnits + 1, 0);
+
+	for (int c = 0; c < numConnections; c++) {
+		_outgoingStarts[_connectionInputs[c] + 1]++;
+
+		if (_connectionGaters[c] != -1)
+			_gatedStarts[_connectionGaters[c] + 1]++;
+	}
 
-		for (int ci = 0; ci < _units[j]._ingoingConnections.size(); ci++) {
-			_units[j]._ingoingConnections[ci]._trace = 0.0f;
+	for (int j = 0; j < numUnits; j++) {
+		_outgoingStarts[j + 1] += _outgoingStarts[j];
+		_gatedStarts[j + 1] += _gatedStarts[j];
+	}
+
+	_outgoingUnits.resize(numConnections);
+	_outgoingConnections.resize(numConnections);
+	_gatedConnections.resize(_gatedStarts[numUnits]);
+
+	std::vector<int> outgoingCursors(_outgoingStarts.begin(), _outgoingStarts.end() - 1);
+	std::vector<int> gatedCursors(_gatedStarts.begin(), _gatedStarts.end() - 1);
+
+	for (int c = 0; c < numConnections; c++) {
+		int o = outgoingCursors[_connectionInputs[c]]++;
+
+		_outgoingUnits[o] = _connectionUnits[c];
+		_outgoingConnections[o] = c;
+
+		if (_connectionGaters[c] != -1)
+			_gatedConnections[gatedCursors[_connectionGaters[c]]++] = c;
+	}
+
+	// Gated units that backpropagate to their gater: for every occurrence of the gater in the ordered gater list,
+	// the gated units after the gater that increase past all previously chosen ones
+	std::vector<std::vector<int>> deltaGatedUnits(numUnits);
+	std::vector<int> lastKs(numUnits, 0);
+
+	for (int gi = 0; gi < _orderedGaterIndices.size(); gi++) {
+		int j = _orderedGaterIndices[gi];
 
-			_units[j]._ingoingConnections[ci]._extendedTraces.clear();
+		for (int gu = _gatingStarts[j]; gu < _gatingStarts[j + 1]; gu++) {
+			int k = _gatingUnits[gu];
 
-			if (_units[j]._ingoingConnections[ci]._inputIndex != j && !_units[j]._gatingConnections.empty()) {
-				for (int oi = 0; oi < _units[j]._outgoingConnectionIndices.size(); oi++)
-					_units[j]._ingoingConnections[ci]._extendedTraces.push_back(ExtendedTrace(0.0f, _units[j]._outgoingConnectionIndices[oi]._nodeIndex));
+			if (lastKs[j] < k && j < k) {
+				lastKs[j] = k;
+
+				deltaGatedUnits[j].push_back(k);
 			}
 		}
 	}
-}
 
-float LSTMG::gain(int j, int ci) {
-	int gaterIndex;
+	_deltaGatedStarts.resize(numUnits + 1);
+	_deltaGatedUnits.clear();
+
+	_deltaGatedStarts[0] = 0;
 
-	if (ci == -1) {
-		if (_units[j]._recurrentConnectionIndex == -1)
-			return 0.0f;
+	for (int j = 0; j < numUnits; j++) {
+		_deltaGatedUnits.insert(_deltaGatedUnits.end(), deltaGatedUnits[j].begin(), deltaGatedUnits[j].end());
 
-		gaterIndex = _units[j]._ingoingConnections[_units[j]._recurrentConnectionIndex]._gaterIndex;
+		_deltaGatedStarts[j + 1] = _deltaGatedUnits.size();
 	}
-	else
-		gaterIndex = _units[j]._ingoingConnections[ci]._gaterIndex;
 
-	if (gaterIndex != -1)
-		return _units[gaterIndex]._activation;
+	// Non-self connections into gaters get one extended trace per outgoing connection of the gater
+	_extendedTraceStarts.resize(numConnections + 1);
 
-	if (j == _units[j]._ingoingConnections[ci]._inputIndex)
-		return 0.0f;
+	_extendedTraceStarts[0] = 0;
 
-	assert(connectionExists(j, _units[j]._ingoingConnections[ci]._inputIndex));
+	for (int c = 0; c < numConnections; c++) {
+		int j = _connectionUnits[c];
 
-	return 1.0f;
+		int numTraces = 0;
+
+		if (_connectionInputs[c] != j && _gatingStarts[j] != _gatingStarts[j + 1])
+			numTraces = _outgoingStarts[j + 1] - _outgoingStarts[j];
+
+		_extendedTraceStarts[c + 1] = _extendedTraceStarts[c] + numTraces;
+	}
+
+	_extendedTraces.assign(_extendedTraceStarts[numConnections], 0.0f);
+
+	_terms.assign(numUnits, 0.0f);
+	_errorResps.assign(numUnits, 0.0f);
+	_errorProjs.assign(numUnits, 0.0f);
+
+	clear();
 }
 
-float LSTMG::theTerm(int j, int k) {
-	float term = 0.0f;
+void LSTMG::clear() {
+	std::fill(_states.begin(), _states.end(), 0.0f);
+	std::fill(_activations.begin(), _activations.end(), 0.0f);
+	std::fill(_traces.begin(), _traces.end(), 0.0f);
+	std::fill(_extendedTraces.begin(), _extendedTraces.end(), 0.0f);
+}
 
-	if (_units[k]._recurrentConnectionIndex != -1) {
-		int gaterIndex = _units[k]._ingoingConnections[_units[k]._recurrentConnectionIndex]._gaterIndex;
+void LSTMG::gatherTerms(int j) {
+	// Gated previous states first, then the gated weighted activations in connection order
+	for (int gc = _gatedStarts[j]; gc < _gatedStarts[j + 1]; gc++) {
+		int c = _gatedConnections[gc];
+		int k = _connectionUnits[c];
 
-		if (gaterIndex == j)
-			term = _units[k]._prevState;
+		if (c == _recurrentConnections[k])
+			_terms[k] = _prevStates[k];
 	}
 
-	for (int ii = 0; ii < _units[k]._ingoingConnections.size(); ii++)
-	if (_units[k]._ingoingConnections[ii]._gaterIndex == j)
-		term += _units[k]._ingoingConnections[ii]._weight * _units[k]._ingoingConnections[ii]._prevActivation;
+	for (int gc = _gatedStarts[j]; gc < _gatedStarts[j + 1]; gc++) {
+		int c = _gatedConnections[gc];
+
+		_terms[_connectionUnits[c]] += _weights[c] * _connectionPrevActivations[c];
+	}
+}
 
-	return term;
+void LSTMG::clearTerms(int j) {
+	for (int gc = _gatedStarts[j]; gc < _gatedStarts[j + 1]; gc++)
+		_terms[_connectionUnits[_gatedConnections[gc]]] = 0.0f;
 }
 
 void LSTMG::step(bool linearOutput) {
-	for (int j = 0; j < _units.size(); j++) {
-		_units[j]._prevGain = 0.0f;
-		_units[j]._prevActivation = 0.0f;
-	}
+	int numUnits = _states.size();
+	int firstOutput = numUnits - _outputIndices.size();
 
-	// Copy previous states
-	for (int j = 0; j < _units.size(); j++)
-		_units[j]._prevState = _units[j]._state;
+	std::fill(_prevGains.begin(), _prevGains.end(), 0.0f);
 
-	for (int j = _inputIndices.size(); j < _units.size(); j++) {
-		float sg = _units[j]._prevGain = gain(j, -1);
+	// Copy previous states
+	_prevStates = _states;
 
-		for (int ci = 0; ci < _units[j]._ingoingConnections.size(); ci++) {
-			int i = _units[j]._ingoingConnections[ci]._inputIndex;
+	for (int j = _inputIndices.size(); j < numUnits; j++) {
+		// Self connection gain, 0 without a self connection or when it is not gated
+		int rc = _recurrentConnections[j];
 
-			_units[j]._ingoingConnections[ci]._prevGain = gain(j, ci);
+		float sg = 0.0f;
 
-			_units[j]._ingoingConnections[ci]._prevActivation = _units[i]._activation;
-		}
+		if (rc != -1 && _connectionGaters[rc] != -1)
+			sg = _activations[_connectionGaters[rc]];
 
-		_units[j]._state *= gain(j, -1);
+		_prevGains[j] = sg;
 
-		for (int ci = 0; ci < _units[j]._ingoingConnections.size(); ci++) {
-			int i = _units[j]._ingoingConnections[ci]._inputIndex;
+		float state = _states[j] * sg;
 
-			float g = _units[j]._ingoingConnections[ci]._prevGain = gain(j, ci);
+		for (int c = _connectionStarts[j]; c < _connectionStarts[j + 1]; c++) {
+			int i = _connectionInputs[c];
+			int gater = _connectionGaters[c];
 
-			float a = _units[j]._ingoingConnections[ci]._prevActivation = _units[i]._activation;
+			float g = gater != -1 ? _activations[gater] : (i == j ? 0.0f : 1.0f);
+			float a = _activations[i];
 
-			Connection &c = _units[j]._ingoingConnections[ci];
+			_connectionPrevGains[c] = g;
+			_connectionPrevActivations[c] = a;
 
-			_units[j]._state += g * c._weight * _units[i]._activation;
+			state += g * _weights[c] * a;
 
-			c._trace *= sg;
-			c._trace += g * a;
+			_traces[c] *= sg;
+			_traces[c] += g * a;
 		}
 
+		// Add bias to state? Or keep out of state and use only for activation?
+		state += _biases[j];
+
+		_states[j] = state;
+
 		// If not output unit
-		if (!linearOutput || j < _units.size() - _outputIndices.size()) {
-			// Add bias to state? Or keep out of state and use only for activation?
-			_units[j]._state += _units[j]._bias;
+		if (!linearOutput || j < firstOutput)
+			_activations[j] = sigmoid(state);
+		else
+			_activations[j] = state;
+	}
 
-			_units[j]._activation = sigmoid(_units[j]._state);
-			//_units[j]._activation = sigmoid(_units[j]._state + _units[j]._bias);
-		}
-		else {
-			_units[j]._state += _units[j]._bias;
+	// Extended traces. Trace ti uses the gated input of unit ti and the self connection gain of unit ti
+	for (int j = 0; j < numUnits; j++) {
+		if (_extendedTraceStarts[_connectionStarts[j]] == _extendedTraceStarts[_connectionStarts[j + 1]])
+			continue;
+
+		gatherTerms(j);
 
-			_units[j]._activation = _units[j]._state;
+		float derivative = sigmoidDerivative(_prevStates[j]);
+
+		for (int c = _connectionStarts[j]; c < _connectionStarts[j + 1]; c++) {
+			float traceDerivative = derivative * _traces[c];
+
+			float* pTraces = &_extendedTraces[_extendedTraceStarts[c]];
+			int numTraces = _extendedTraceStarts[c + 1] - _extendedTraceStarts[c];
+
+			assert(numTraces <= numUnits);
+
+			for (int ti = 0; ti < numTraces; ti++)
+				pTraces[ti] = _prevGains[ti] * pTraces[ti] + traceDerivative * _terms[ti];
 		}
-	}
 
-	for (size_t j = 0; j < _units.size(); j++)
-	for (size_t ci = 0; ci < _units[j]._ingoingConnections.size(); ci++)
-	for (size_t ti = 0; ti < _units[j]._ingoingConnections[ci]._extendedTraces.size(); ti++) {
-		float terms = sigmoidDerivative(_units[j]._prevState) * _units[j]._ingoingConnections[ci]._trace * theTerm(j, ti);
-		_units[j]._ingoingConnections[ci]._extendedTraces[ti]._trace = _units[ti]._prevGain * _units[j]._ingoingConnections[ci]._extendedTraces[ti]._trace + terms;
+		clearTerms(j);
 	}
 }
 
 void LSTMG::getDeltas(const std::vector<float> &targets, float eligibilityDecay, bool linearOutput) {
-	std::vector<float> errorResp(_units.size(), 0.0f);
-	std::vector<float> errorProj(_units.size(), 0.0f);
+	int numUnits = _states.size();
+	int firstOutput = numUnits - _outputIndices.size();
+
+	std::fill(_errorResps.begin(), _errorResps.end(), 0.0f);
+	std::fill(_errorProjs.begin(), _errorProjs.end(), 0.0f);
 
 	// Output layer errors
 	for (int i = 0; i < _outputIndices.size(); i++)
-		errorResp[_outputIndices[i]] = targets[i] - _units[_outputIndices[i]]._activation;
+		_errorResps[_outputIndices[i]] = targets[i] - _activations[_outputIndices[i]];
 
 	// Loop over all units in reversed order of activation
-	for (int j = _units.size() - _outputIndices.size() - 1; j >= _inputIndices.size(); j--) {
-		errorResp[j] = errorProj[j] = 0.0f;
+	for (int j = firstOutput - 1; j >= static_cast<int>(_inputIndices.size()); j--) {
+		float errorProj = 0.0f;
 
-		for (int ci = 0; ci < _units[j]._outgoingConnectionIndices.size(); ci++) {
-			int k = _units[j]._outgoingConnectionIndices[ci]._nodeIndex;
+		for (int o = _outgoingStarts[j]; o < _outgoingStarts[j + 1]; o++) {
+			int c = _outgoingConnections[o];
 
-			errorProj[j] += errorResp[k] * _units[k]._ingoingConnections[_units[j]._outgoingConnectionIndices[ci]._connectionIndex]._prevGain * _units[k]._ingoingConnections[_units[j]._outgoingConnectionIndices[ci]._connectionIndex]._weight;
+			errorProj += _errorResps[_outgoingUnits[o]] * _connectionPrevGains[c] * _weights[c];
 		}
 
-		float jDeriv = sigmoidDerivative(_units[j]._state);
+		float jDeriv = sigmoidDerivative(_states[j]);
 
-		errorProj[j] *= jDeriv;
+		errorProj *= jDeriv;
 
-		int lastK = 0;
+		float errorResp = 0.0f;
 
-		for (int gi = 0; gi < _orderedGaterIndices.size(); gi++) {
-			if (j == _orderedGaterIndices[gi]) {
-				// For each connection
-				const std::vector<int> &gaterConnections = _units[j]._gatingConnections;
+		if (_deltaGatedStarts[j] != _deltaGatedStarts[j + 1]) {
+			gatherTerms(j);
 
-				for (int gci = 0; gci < gaterConnections.size(); gci++) {
-					int k = gaterConnections[gci];
+			for (int gu = _deltaGatedStarts[j]; gu < _deltaGatedStarts[j + 1]; gu++) {
+				int k = _deltaGatedUnits[gu];
 
-					if (lastK < k && j < k) {
-						lastK = k;
-
-						errorResp[j] += errorResp[k] * theTerm(j, k);
-					}
-				}
+				errorResp += _errorResps[k] * _terms[k];
 			}
+
+			clearTerms(j);
 		}
 
-		errorResp[j] = errorProj[j] + jDeriv * errorResp[j];
+		_errorProjs[j] = errorProj;
+		_errorResps[j] = errorProj + jDeriv * errorResp;
 	}
 
-	for (int j = 0; j < _units.size(); j++)
-	for (int ci = 0; ci < _units[j]._ingoingConnections.size(); ci++) {
-		int i = _units[j]._ingoingConnections[ci]._inputIndex;
+	for (int j = 0; j < numUnits; j++) {
+		if (j < firstOutput) {
+			float errorProj = _errorProjs[j];
+
+			const int* pTraceUnits = &_outgoingUnits[0] + _outgoingStarts[j];
+
+			for (int c = _connectionStarts[j]; c < _connectionStarts[j + 1]; c++) {
+				float eligibility = _eligibilities[c] * eligibilityDecay;
 
-		_units[j]._ingoingConnections[ci]._eligibility *= eligibilityDecay;
+				eligibility += errorProj * _traces[c];
 
-		// If not output
-		if (j < _units.size() - _outputIndices.size()) {
-			_units[j]._ingoingConnections[ci]._eligibility += errorProj[j] * _units[j]._ingoingConnections[ci]._trace;
+				for (int t = _extendedTraceStarts[c]; t < _extendedTraceStarts[c + 1]; t++)
+					eligibility += _errorResps[pTraceUnits[t - _extendedTraceStarts[c]]] * _extendedTraces[t];
 
-			for (int ti = 0; ti < _units[j]._ingoingConnections[ci]._extendedTraces.size(); ti++)
-				_units[j]._ingoingConnections[ci]._eligibility += errorResp[_units[j]._ingoingConnections[ci]._extendedTraces[ti]._index] * _units[j]._ingoingConnections[ci]._extendedTraces[ti]._trace;
+				_eligibilities[c] = eligibility;
+			}
+		}
+		else {
+			float errorResp = _errorResps[j];
+
+			for (int c = _connectionStarts[j]; c < _connectionStarts[j + 1]; c++) {
+				_eligibilities[c] *= eligibilityDecay;
+				_eligibilities[c] += errorResp * _traces[c];
+			}
 		}
-		else
-			_units[j]._ingoingConnections[ci]._eligibility += errorResp[j] * _units[j]._ingoingConnections[ci]._trace;
 	}
 
 	// Update biases
-	for (int j = 0; j < _units.size(); j++) {
-		_units[j]._biasEligibility *= eligibilityDecay;
-		_units[j]._biasEligibility += errorResp[j];
+	for (int j = 0; j < numUnits; j++) {
+		_biasEligibilities[j] *= eligibilityDecay;
+		_biasEligibilities[j] += _errorResps[j];
 	}
 }
 
 void LSTMG::moveAlongDeltas(float error, float momentum) {
-	for (int j = 0; j < _units.size(); j++)
-	for (int ci = 0; ci < _units[j]._ingoingConnections.size(); ci++) {
-		float d = error * _units[j]._ingoingConnections[ci]._eligibility + momentum * _units[j]._ingoingConnections[ci]._prevWeight;
-		_units[j]._ingoingConnections[ci]._weight += d;
-		_units[j]._ingoingConnections[ci]._prevWeight = d;
+	for (int c = 0; c < _weights.size(); c++) {
+		float d = error * _eligibilities[c] + momentum * _prevWeights[c];
+		_weights[c] += d;
+		_prevWeights[c] = d;
 	}
 
 	// Update biases
-	for (int j = 0; j < _units.size(); j++) {
-		float d = error * _units[j]._biasEligibility + momentum * _units[j]._prevBias;
-		_units[j]._bias += d;
-		_units[j]._prevBias = d;
+	for (int j = 0; j < _biases.size(); j++) {
+		float d = error * _biasEligibilities[j] + momentum * _prevBiases[j];
+		_biases[j] += d;
+		_prevBiases[j] = d;
 	}
 }
 
 void LSTMG::moveAlongDeltasAndHebbian(float error, float hebbianAlpha, float momentum) {
-	for (int j = 0; j < _units.size(); j++) {
-		float postTerm = _units[j]._activation;
-
-		for (int ci = 0; ci < _units[j]._ingoingConnections.size(); ci++) {
-			float preTerm = _units[_units[j]._ingoingConnections[ci]._inputIndex]._activation;
-			float d = error * _units[j]._ingoingConnections[ci]._eligibility + momentum * _units[j]._ingoingConnections[ci]._prevWeight + hebbianAlpha * postTerm * (preTerm - _units[j]._ingoingConnections[ci]._weight * postTerm);
-			_units[j]._ingoingConnections[ci]._weight += d;
-			_units[j]._ingoingConnections[ci]._prevWeight = d;
+	for (int j = 0; j < _biases.size(); j++) {
+		float postTerm = _activations[j];
+
+		for (int c = _connectionStarts[j]; c < _connectionStarts[j + 1]; c++) {
+			float preTerm = _activations[_connectionInputs[c]];
+			float d = error * _eligibilities[c] + momentum * _prevWeights[c] + hebbianAlpha * postTerm * (preTerm - _weights[c] * postTerm);
+			_weights[c] += d;
+			_prevWeights[c] = d;
 		}
 	}
 
 	// Update biases
-	for (int j = 0; j < _units.size(); j++) {
-		float postTerm = _units[j]._activation;
+	for (int j = 0; j < _biases.size(); j++) {
+		float postTerm = _activations[j];
 
-		float d = error * _units[j]._biasEligibility + momentum * _units[j]._prevBias + hebbianAlpha * postTerm * (1.0f - _units[j]._bias * postTerm);
-		_units[j]._bias += d;
-		_units[j]._prevBias = d;
+		float d = error * _biasEligibilities[j] + momentum * _prevBiases[j] + hebbianAlpha * postTerm * (1.0f - _biases[j] * postTerm);
+		_biases[j] += d;
+		_prevBiases[j] = d;
 	}
+}
+
+void LSTMG::writeToCheckpoint(io::CheckpointWriter &writer, const std::string &prefix) const {
+	int numUnits = _biases.size();
+
+	int dims[1] = { numUnits };
+
+	writer.addInts(prefix + "dims", dims, 1);
+	writer.addInts(prefix + "inputIndices", _inputIndices);
+	writer.addInts(prefix + "outputIndices", _outputIndices);
+	writer.addInts(prefix + "orderedGaterIndices", _orderedGaterIndices);
+
+	// Per unit values, ingoing connections and gated units as compressed rows (starts has one entry per unit plus one)
+	std::vector<int> recurrentConnectionIndices(numUnits);
+
+	for (int j = 0; j < numUnits; j++)
+		recurrentConnectionIndices[j] = _recurrentConnections[j] == -1 ? -1 : _recurrentConnections[j] - _connectionStarts[j];
+
+	writer.addFloats(prefix + "biases", _biases);
+	writer.addInts(prefix + "recurrentConnectionIndices", recurrentConnectionIndices);
+	writer.addInts(prefix + "connectionStarts", _connectionStarts);
+	writer.addInts(prefix + "connectionInputIndices", _connectionInputs);
+	writer.addInts(prefix + "connectionGaterIndices", _connectionGaters);
+	writer.addFloats(prefix + "connectionWeights", _weights);
+	writer.addInts(prefix + "gatingStarts", _gatingStarts);
+	writer.addInts(prefix + "gatingConnections", _gatingUnits);
+}
+
+bool LSTMG::readFromCheckpoint(const io::CheckpointReader &reader, const std::string &prefix) {
+	int dims[1];
+
+	if (!reader.readInts(prefix + "dims", dims, 1))
+		return false;
+
+	int numUnits = dims[0];
+
+	std::vector<float> biases;
+	std::vector<int> recurrentConnectionIndices;
+	std::vector<int> connectionStarts;
+	std::vector<int> connectionInputIndices;
+	std::vector<int> connectionGaterIndices;
+	std::vector<float> connectionWeights;
+	std::vector<int> gatingStarts;
+	std::vector<int> gatingConnections;
+
+	if (!reader.readInts(prefix + "inputIndices", _inputIndices) ||
+		!reader.readInts(prefix + "outputIndices", _outputIndices) ||
+		!reader.readInts(prefix + "orderedGaterIndices", _orderedGaterIndices) ||
+		!reader.readFloats(prefix + "biases", biases) ||
+		!reader.readInts(prefix + "recurrentConnectionIndices", recurrentConnectionIndices) ||
+		!reader.readInts(prefix + "connectionStarts", connectionStarts) ||
+		!reader.readInts(prefix + "connectionInputIndices", connectionInputIndices) ||
+		!reader.readInts(prefix + "connectionGaterIndices", connectionGaterIndices) ||
+		!reader.readFloats(prefix + "connectionWeights", connectionWeights) ||
+		!reader.readInts(prefix + "gatingStarts", gatingStarts) ||
+		!reader.readInts(prefix + "gatingConnections", gatingConnections))
+		return false;
+
+	if (biases.size() != numUnits || recurrentConnectionIndices.size() != numUnits ||
+		connectionStarts.size() != numUnits + 1 || gatingStarts.size() != numUnits + 1 ||
+		connectionStarts.back() != connectionWeights.size() || connectionInputIndices.size() != connectionWeights.size() || connectionGaterIndices.size() != connectionWeights.size() ||
+		gatingStarts.back() != gatingConnections.size())
+		return false;
+
+	std::vector<Unit> units(numUnits);
+
+	for (int j = 0; j < numUnits; j++) {
+		Unit &unit = units[j];
+
+		unit._bias = biases[j];
+		unit._recurrentConnectionIndex = recurrentConnectionIndices[j];
+
+		for (int ci = connectionStarts[j]; ci < connectionStarts[j + 1]; ci++) {
+			Connection c;
+
+			c._inputIndex = connectionInputIndices[ci];
+			c._gaterIndex = connectionGaterIndices[ci];
+			c._weight = connectionWeights[ci];
+
+			unit._ingoingConnections.push_back(c);
+		}
+
+		unit._gatingConnections.assign(gatingConnections.begin() + gatingStarts[j], gatingConnections.begin() + gatingStarts[j + 1]);
+	}
+
+	compile(units);
+
+	return true;
 }
\ No newline at end of file
@@ -23,76 +23,38 @@ misrepresented as being the original software.
 
 #include <unordered_map>
 #include <lstm/TupleHash.h>
+#include <io/CheckpointWriter.h>
+#include <io/CheckpointReader.h>
 #include <random>
 
 namespace lstm {
+	// Gated recurrent graph. The graph is built as Unit/Connection descriptions and then compiled into flat arrays:
+	// ingoing connections as compressed rows per unit, traces in their own arrays and the connections each gater gates listed per gater.
+	// Units are stored in activation order, so step, getDeltas and moveAlongDeltas stream through the arrays front to back (or back to front)
 	class LSTMG {
 	public:
-		struct ExtendedTrace {
-			float _trace;
-			int _index;
-
-			ExtendedTrace() {}
-			ExtendedTrace(float trace, int index)
-				: _trace(trace), _index(index)
-			{}
-		};
-
 		struct Connection {
 			int _inputIndex;
-
-			float _weight;
-			float _trace;
 			int _gaterIndex;
 
-			float _eligibility;
-			float _prevWeight;
-
-			float _prevGain;
-			float _prevActivation;
-
-			std::vector<ExtendedTrace> _extendedTraces;
+			float _weight;
 
 			Connection()
-				: _inputIndex(-1), _weight(0.0f), _trace(0.0f), _gaterIndex(-1),
-				_eligibility(0.0f), _prevWeight(0.0f), _prevGain(0.0f),
-				_prevActivation(0.0f)
-			{}
-		};
-
-		struct ConnectionIndex {
-			int _nodeIndex;
-			int _connectionIndex;
-
-			ConnectionIndex() {}
-			ConnectionIndex(int nodeIndex, int connectionIndex)
-				: _nodeIndex(nodeIndex), _connectionIndex(connectionIndex)
+				: _inputIndex(-1), _gaterIndex(-1), _weight(0.0f)
 			{}
 		};
 
 		struct Unit {
-			float _state;
-			float _prevState;
-			float _activation;
-
 			float _bias;
-			float _biasEligibility;
-			float _prevBias;
-
-			float _prevGain;
-			float _prevActivation;
 
 			int _recurrentConnectionIndex;
 
 			std::vector<Connection> _ingoingConnections;
-			std::vector<ConnectionIndex> _outgoingConnectionIndices;
 
 			std::vector<int> _gatingConnections;
 
 			Unit()
-				: _state(0.0f), _prevState(0.0f), _activation(0.0f), _bias(0.0f),
-				_biasEligibility(0.0f), _prevBias(0.0f), _prevGain(0.0f), _prevActivation(0.0f),
-				_recurrentConnectionIndex(-1)
+				: _bias(0.0f), _recurrentConnectionIndex(-1)
 			{}
 		};
 
@@ -110,14 +72,64 @@ namespace lstm {
 		std::vector<int> _inputIndices;
 		std::vector<int> _outputIndices;
 
-		std::vector<Unit> _units;
-
 		std::vector<int> _orderedGaterIndices;
 
-		float gain(int j, int ci);
-		float theTerm(int j, int ci);
-
-		bool connectionExists(int j, int i);
+		// Units
+		std::vector<float> _states;
+		std::vector<float> _prevStates;
+		std::vector<float> _activations;
+		std::vector<float> _biases;
+		std::vector<float> _biasEligibilities;
+		std::vector<float> _prevBiases;
+		std::vector<float> _prevGains;
+
+		// Connection index of the self connection, -1 if there is none
+		std::vector<int> _recurrentConnections;
+
+		// Ingoing connections of unit j are [_connectionStarts[j], _connectionStarts[j + 1])
+		std::vector<int> _connectionStarts;
+		std::vector<int> _connectionUnits;
+		std::vector<int> _connectionInputs;
+		std::vector<int> _connectionGaters;
+		std::vector<float> _weights;
+		std::vector<float> _prevWeights;
+		std::vector<float> _eligibilities;
+		std::vector<float> _connectionPrevGains;
+		std::vector<float> _connectionPrevActivations;
+
+		// Traces, extended traces of connection c are [_extendedTraceStarts[c], _extendedTraceStarts[c + 1]).
+		// Extended trace ti of a connection into unit j belongs to outgoing connection ti of j
+		std::vector<float> _traces;
+		std::vector<int> _extendedTraceStarts;
+		std::vector<float> _extendedTraces;
+
+		// Outgoing connections of unit j are [_outgoingStarts[j], _outgoingStarts[j + 1]), as (unit, connection) pairs
+		std::vector<int> _outgoingStarts;
+		std::vector<int> _outgoingUnits;
+		std::vector<int> _outgoingConnections;
+
+		// Units gated by unit j as created, [_gatingStarts[j], _gatingStarts[j + 1])
+		std::vector<int> _gatingStarts;
+		std::vector<int> _gatingUnits;
+
+		// Connections gated by unit j ordered by the unit they go into, [_gatedStarts[j], _gatedStarts[j + 1])
+		std::vector<int> _gatedStarts;
+		std::vector<int> _gatedConnections;
+
+		// Gated units whose errors are propagated back to gater j, [_deltaGatedStarts[j], _deltaGatedStarts[j + 1])
+		std::vector<int> _deltaGatedStarts;
+		std::vector<int> _deltaGatedUnits;
+
+		// Scratch, _terms is 0 everywhere outside of gatherTerms/clearTerms pairs
+		std::vector<float> _terms;
+		std::vector<float> _errorResps;
+		std::vector<float> _errorProjs;
+
+		void compile(const std::vector<Unit> &units);
+
+		// Sets _terms[k] to the gated input of unit k through gater j (sum of gated weighted activations plus the gated previous state)
+		void gatherTerms(int j);
+		void clearTerms(int j);
 
 	public:
 		void createRandomLayered(int numInputs, int numOutputs,
@@ -134,16 +146,20 @@ namespace lstm {
 		void moveAlongDeltas(float error, float momentum = 0.0f);
 		void moveAlongDeltasAndHebbian(float error, float hebbianAlpha, float momentum = 0.0f);
 
+		// Binary checkpoint of the topology and weights, tensor names start with prefix
+		void writeToCheckpoint(io::CheckpointWriter &writer, const std::string &prefix) const;
+		bool readFromCheckpoint(const io::CheckpointReader &reader, const std::string &prefix);
+
 		void setInput(int index, float value) {
-			_units[_inputIndices[index]]._activation = value;
+			_activations[_inputIndices[index]] = value;
 		}
 
 		float getInput(int index) const {
-			return _units[_inputIndices[index]]._activation;
+			return _activations[_inputIndices[index]];
 		}
 
 		float getOutput(int index) const {
-			return _units[_outputIndices[index]]._activation;
+			return _activations[_outputIndices[index]];
 		}
 
 		int getNumInputs() const {
@@ -25,6 +25,8 @@ misrepresented as being the original software.
 
 #include <iostream>
 
+#include <assert.h>
+
 using namespace lstm;
 
 void LSTMNet::createRandom(size_t numInputs, size_t numOutputs, size_t hiddenSize, size_t numMemoryCells, float minWeight, float maxWeight, std::mt19937 &generator) {
@@ -32,7 +34,6 @@ void LSTMNet::createRandom(size_t numInputs, size_t numOutputs, size_t hiddenSiz
 
 	_outputNodes.resize(numOutputs);
 	_hiddenGroups.resize(numOutputs);
-	_memoryCells.resize(numMemoryCells);
 
 	std::uniform_real_distribution<float> weightDist(minWeight, maxWeight);
 
@@ -69,192 +70,59 @@ void LSTMNet::createRandom(size_t numInputs, size_t numOutputs, size_t hiddenSiz
 		}
 	}
 
-	for (size_t i = 0; i < numMemoryCells; i++) {
-		_memoryCells[i]._outputGate._bias._weight = weightDist(generator);
-		_memoryCells[i]._outputGate._bias._trace = 0.0f;
-		_memoryCells[i]._outputGate._prevOutput = _memoryCells[i]._outputGate._output = 0.0f;
+	_numMemoryCells = numMemoryCells;
+	_numGateInputs = numGateInputs;
 
-		_memoryCells[i]._inputGate._bias._weight = weightDist(generator);
-		_memoryCells[i]._inputGate._bias._trace = 0.0f;
-		_memoryCells[i]._inputGate._bias._derivative = 0.0f;
-		_memoryCells[i]._inputGate._prevOutput = _memoryCells[i]._inputGate._output = 0.0f;
+	const size_t numGateRows = numMemoryCells * 4;
 
-		_memoryCells[i]._forgetGate._bias._weight = weightDist(generator);
-		_memoryCells[i]._forgetGate._bias._trace = 0.0f;
-		_memoryCells[i]._forgetGate._bias._derivative = 0.0f;
-		_memoryCells[i]._forgetGate._prevOutput = _memoryCells[i]._forgetGate._output = 0.0f;
+	_gateWeights.resize(numGateRows * numGateInputs);
+	_gateTraces.assign(numGateRows * numGateInputs, 0.0f);
+	_gateDerivatives.assign(numGateRows * numGateInputs, 0.0f);
 
-		_memoryCells[i]._outputGate._synapses.resize(numGateInputs);
-		_memoryCells[i]._inputGate._synapses.resize(numGateInputs);
-		_memoryCells[i]._forgetGate._synapses.resize(numGateInputs);
+	_gateBiases.resize(numGateRows);
+	_gateBiasTraces.assign(numGateRows, 0.0f);
+	_gateBiasDerivatives.assign(numGateRows, 0.0f);
 
-		for (size_t j = 0; j < numGateInputs; j++) {
-			_memoryCells[i]._outputGate._synapses[j]._weight = weightDist(generator);
-			_memoryCells[i]._outputGate._synapses[j]._trace = 0.0f;
+	_gateOutputs.assign(numGateRows, 0.0f);
+	_gatePrevOutputs.assign(numMemoryCells * 3, 0.0f);
 
-			_memoryCells[i]._inputGate._synapses[j]._weight = weightDist(generator);
-			_memoryCells[i]._inputGate._synapses[j]._trace = 0.0f;
-			_memoryCells[i]._inputGate._synapses[j]._derivative = 0.0f;
+	_cellStates.assign(numMemoryCells, 0.0f);
+	_cellOutputs.assign(numMemoryCells, 0.0f);
+	_cellPrevOutputs.assign(numMemoryCells, 0.0f);
 
-			_memoryCells[i]._forgetGate._synapses[j]._weight = weightDist(generator);
-			_memoryCells[i]._forgetGate._synapses[j]._trace = 0.0f;
-			_memoryCells[i]._forgetGate._synapses[j]._derivative = 0.0f;
-		}
+	_gateInputs.assign(numGateInputs, 0.0f);
+	_updateInputs.assign(numMemoryCellInputs, 0.0f);
 
-		_memoryCells[i]._net = 0.0f;
-		_memoryCells[i]._bias._weight = weightDist(generator);
-		_memoryCells[i]._bias._trace = 0.0f;
-		_memoryCells[i]._bias._derivative = 0.0f;
-		_memoryCells[i]._prevOutput = _memoryCells[i]._output = 0.0f;
-		_memoryCells[i]._state = 0.0f;
+	// Same generator order as when every cell held its own gates: the three gate biases, the three gates' weights interleaved,
+	// then the cell input bias and weights
+	for (size_t i = 0; i < numMemoryCells; i++) {
+		const size_t outputRow = i;
+		const size_t inputRow = numMemoryCells + i;
+		const size_t forgetRow = numMemoryCells * 2 + i;
+		const size_t cellRow = numMemoryCells * 3 + i;
 
-		_memoryCells[i]._synapses.resize(numGateInputs);
+		_gateBiases[outputRow] = weightDist(generator);
+		_gateBiases[inputRow] = weightDist(generator);
+		_gateBiases[forgetRow] = weightDist(generator);
 
 		for (size_t j = 0; j < numGateInputs; j++) {
-			_memoryCells[i]._synapses[j]._weight = weightDist(generator);
-			_memoryCells[i]._synapses[j]._trace = 0.0f;
-			_memoryCells[i]._synapses[j]._derivative = 0.0f;
-		}
-	}
-}
-
-void LSTMNet::step() {
-	// Update hidden units
-	for (size_t i = 0; i < _hiddenGroups.size(); i++)
-	for (size_t j = 0; j < _hiddenGroups[i].size(); j++) {
-		float sum = _hiddenGroups[i][j]._bias._weight;
-
-		size_t si = 0;
-
-		for (size_t k = 0; k < _currentInputs.size(); k++)
-			sum += _currentInputs[k] * _hiddenGroups[i][j]._synapses[si++]._weight;
-
-		for (size_t k = 0; k < _memoryCells.size(); k++)
-			sum += _memoryCells[k]._prevOutput * _hiddenGroups[i][j]._synapses[si++]._weight;
-
-		_hiddenGroups[i][j]._output = sigmoid(sum);
-	}
-
-	// Update memory cells
-	for (size_t i = 0; i < _memoryCells.size(); i++) {
-		float sum;
-		size_t si;
-
-		// ----------------------------- Update Gates -----------------------------
-
-		// Output
-		sum = _memoryCells[i]._outputGate._bias._weight;
-
-		si = 0;
-
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			sum += _memoryCells[j]._outputGate._prevOutput * _memoryCells[i]._outputGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._inputGate._prevOutput * _memoryCells[i]._outputGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._forgetGate._prevOutput * _memoryCells[i]._outputGate._synapses[si++]._weight;
-
-			sum += _memoryCells[j]._prevOutput * _memoryCells[i]._outputGate._synapses[si++]._weight;
-		}
-
-		for (size_t j = 0; j < _currentInputs.size(); j++)
-			sum += _currentInputs[j] * _memoryCells[i]._outputGate._synapses[si++]._weight;
-
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++)
-			sum += _hiddenGroups[j][k]._prevOutput * _memoryCells[i]._outputGate._synapses[si++]._weight;
-
-		_memoryCells[i]._outputGate._output = sigmoid(sum);
-
-		// Input
-		sum = _memoryCells[i]._inputGate._bias._weight;
-
-		si = 0;
-
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			sum += _memoryCells[j]._outputGate._prevOutput * _memoryCells[i]._inputGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._inputGate._prevOutput * _memoryCells[i]._inputGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._forgetGate._prevOutput * _memoryCells[i]._inputGate._synapses[si++]._weight;
-
-			sum += _memoryCells[j]._prevOutput * _memoryCells[i]._inputGate._synapses[si++]._weight;
-		}
-
-		for (size_t j = 0; j < _currentInputs.size(); j++)
-			sum += _currentInputs[j] * _memoryCells[i]._inputGate._synapses[si++]._weight;
-
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++)
-			sum += _hiddenGroups[j][k]._prevOutput * _memoryCells[i]._inputGate._synapses[si++]._weight;
-
-		_memoryCells[i]._inputGate._output = sigmoid(sum);
-
-		// Forget
-		sum = _memoryCells[i]._forgetGate._bias._weight;
-
-		si = 0;
-
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			sum += _memoryCells[j]._outputGate._prevOutput * _memoryCells[i]._forgetGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._inputGate._prevOutput * _memoryCells[i]._forgetGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._forgetGate._prevOutput * _memoryCells[i]._forgetGate._synapses[si++]._weight;
-
-			sum += _memoryCells[j]._prevOutput * _memoryCells[i]._forgetGate._synapses[si++]._weight;
+			_gateWeights[outputRow * numGateInputs + j] = weightDist(generator);
+			_gateWeights[inputRow * numGateInputs + j] = weightDist(generator);
+			_gateWeights[forgetRow * numGateInputs + j] = weightDist(generator);
 		}
 
-		for (size_t j = 0; j < _currentInputs.size(); j++)
-			sum += _currentInputs[j] * _memoryCells[i]._forgetGate._synapses[si++]._weight;
-
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++)
-			sum += _hiddenGroups[j][k]._prevOutput * _memoryCells[i]._forgetGate._synapses[si++]._weight;
-
-		_memoryCells[i]._forgetGate._output = sigmoid(sum);
-
-		// ----------------------------- Update CEC -----------------------------
-
-		sum = _memoryCells[i]._bias._weight;
-
-		si = 0;
-
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			sum += _memoryCells[j]._outputGate._prevOutput * _memoryCells[i]._synapses[si++]._weight;
-			sum += _memoryCells[j]._inputGate._prevOutput * _memoryCells[i]._synapses[si++]._weight;
-			sum += _memoryCells[j]._forgetGate._prevOutput * _memoryCells[i]._synapses[si++]._weight;
-
-			sum += _memoryCells[j]._prevOutput * _memoryCells[i]._synapses[si++]._weight;
-		}
-
-		for (size_t j = 0; j < _currentInputs.size(); j++)
-			sum += _currentInputs[j] * _memoryCells[i]._synapses[si++]._weight;
-
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++)
-			sum += _hiddenGroups[j][k]._prevOutput * _memoryCells[i]._synapses[si++]._weight;
-
-		float memoryCellInput = sigmoid(sum) * 4.0f - 2.0f;
+		_gateBiases[cellRow] = weightDist(generator);
 
-		_memoryCells[i]._net = memoryCellInput;
-
-		_memoryCells[i]._state = _memoryCells[i]._forgetGate._output * _memoryCells[i]._state + _memoryCells[i]._inputGate._output * memoryCellInput;
-
-		_memoryCells[i]._output = (sigmoid(_memoryCells[i]._state) * 2.0f - 1.0f) * _memoryCells[i]._outputGate._output;
-	}
-
-	// Update output units
-	for (size_t i = 0; i < _outputNodes.size(); i++) {
-		float sum = _outputNodes[i]._bias._weight;
-
-		size_t si = 0;
-
-		for (size_t j = 0; j < _hiddenGroups[i].size(); j++)
-			sum += _hiddenGroups[i][j]._prevOutput * _outputNodes[i]._synapses[si++]._weight;
-
-		for (size_t j = 0; j < _memoryCells.size(); j++)
-			sum += _memoryCells[j]._prevOutput * _outputNodes[i]._synapses[si++]._weight;
-
-		_outputNodes[i]._output = sum;
+		for (size_t j = 0; j < numGateInputs; j++)
+			_gateWeights[cellRow * numGateInputs + j] = weightDist(generator);
 	}
 }
 
-void LSTMNet::updateQ(const std::vector<float> &targets, float error, float gammaLambda) {
+void LSTMNet::activate() {
+	const size_t numMemoryCells = _numMemoryCells;
+	const size_t numGateInputs = _numGateInputs;
+	const size_t numGateRows = numMemoryCells * 4;
+
 	// Update hidden units
 	for (size_t i = 0; i < _hiddenGroups.size(); i++)
 	for (size_t j = 0; j < _hiddenGroups[i].size(); j++) {
@@ -265,113 +133,89 @@ void LSTMNet::updateQ(const std::vector<float> &targets, float error, float gamm
 		for (size_t k = 0; k < _currentInputs.size(); k++)
 			sum += _currentInputs[k] * _hiddenGroups[i][j]._synapses[si++]._weight;
 
-		for (size_t k = 0; k < _memoryCells.size(); k++)
-			sum += _memoryCells[k]._prevOutput * _hiddenGroups[i][j]._synapses[si++]._weight;
+		for (size_t k = 0; k < numMemoryCells; k++)
+			sum += _cellPrevOutputs[k] * _hiddenGroups[i][j]._synapses[si++]._weight;
 
 		_hiddenGroups[i][j]._output = sigmoid(sum);
 	}
 
-	// Update memory cells
-	for (size_t i = 0; i < _memoryCells.size(); i++) {
-		float sum;
-		size_t si;
+	// ----------------------------- Gate Inputs -----------------------------
 
-		// ----------------------------- Update Gates -----------------------------
-
-		// Output
-		sum = _memoryCells[i]._outputGate._bias._weight;
-
-		si = 0;
+	size_t si = 0;
 
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			sum += _memoryCells[j]._outputGate._prevOutput * _memoryCells[i]._outputGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._inputGate._prevOutput * _memoryCells[i]._outputGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._forgetGate._prevOutput * _memoryCells[i]._outputGate._synapses[si++]._weight;
+	for (size_t j = 0; j < numMemoryCells; j++) {
+		_gateInputs[si++] = _gatePrevOutputs[j];
+		_gateInputs[si++] = _gatePrevOutputs[numMemoryCells + j];
+		_gateInputs[si++] = _gatePrevOutputs[numMemoryCells * 2 + j];
 
-			sum += _memoryCells[j]._prevOutput * _memoryCells[i]._outputGate._synapses[si++]._weight;
-		}
-
-		for (size_t j = 0; j < _currentInputs.size(); j++)
-			sum += _currentInputs[j] * _memoryCells[i]._outputGate._synapses[si++]._weight;
-
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++)
-			sum += _hiddenGroups[j][k]._prevOutput * _memoryCells[i]._outputGate._synapses[si++]._weight;
-
-		_memoryCells[i]._outputGate._output = sigmoid(sum);
-
-		// Input
-		sum = _memoryCells[i]._inputGate._bias._weight;
+		_gateInputs[si++] = _cellPrevOutputs[j];
+	}
 
-		si = 0;
+	for (size_t j = 0; j < _currentInputs.size(); j++)
+		_gateInputs[si++] = _currentInputs[j];
 
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			sum += _memoryCells[j]._outputGate._prevOutput * _memoryCells[i]._inputGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._inputGate._prevOutput * _memoryCells[i]._inputGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._forgetGate._prevOutput * _memoryCells[i]._inputGate._synapses[si++]._weight;
+	for (size_t j = 0; j < _hiddenGroups.size(); j++)
+	for (size_t k = 0; k < _hiddenGroups[j].size(); k++)
+		_gateInputs[si++] = _hiddenGroups[j][k]._prevOutput;
 
-			sum += _memoryCells[j]._prevOutput * _memoryCells[i]._inputGate._synapses[si++]._weight;
-		}
+	// ----------------------------- Gate Sums -----------------------------
 
-		for (size_t j = 0; j < _currentInputs.size(); j++)
-			sum += _currentInputs[j] * _memoryCells[i]._inputGate._synapses[si++]._weight;
+	// All gates in one matrix-vector product, four rows at a time. Every row is still summed from its bias in input order
+	const float* pInputs = _gateInputs.data();
 
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++)
-			sum += _hiddenGroups[j][k]._prevOutput * _memoryCells[i]._inputGate._synapses[si++]._weight;
+	size_t r = 0;
 
-		_memoryCells[i]._inputGate._output = sigmoid(sum);
+	for (; r + 4 <= numGateRows; r += 4) {
+		const float* pWeights0 = &_gateWeights[r * numGateInputs];
+		const float* pWeights1 = pWeights0 + numGateInputs;
+		const float* pWeights2 = pWeights1 + numGateInputs;
+		const float* pWeights3 = pWeights2 + numGateInputs;
 
-		// Forget
-		sum = _memoryCells[i]._forgetGate._bias._weight;
+		float sum0 = _gateBiases[r];
+		float sum1 = _gateBiases[r + 1];
+		float sum2 = _gateBiases[r + 2];
+		float sum3 = _gateBiases[r + 3];
 
-		si = 0;
-
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			sum += _memoryCells[j]._outputGate._prevOutput * _memoryCells[i]._forgetGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._inputGate._prevOutput * _memoryCells[i]._forgetGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._forgetGate._prevOutput * _memoryCells[i]._forgetGate._synapses[si++]._weight;
-
-			sum += _memoryCells[j]._prevOutput * _memoryCells[i]._forgetGate._synapses[si++]._weight;
+		for (size_t k = 0; k < numGateInputs; k++) {
+			sum0 += pInputs[k] * pWeights0[k];
+			sum1 += pInputs[k] * pWeights1[k];
+			sum2 += pInputs[k] * pWeights2[k];
+			sum3 += pInputs[k] * pWeights3[k];
 		}
 
-		for (size_t j = 0; j < _currentInputs.size(); j++)
-			sum += _currentInputs[j] * _memoryCells[i]._forgetGate._synapses[si++]._weight;
-
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++)
-			sum += _hiddenGroups[j][k]._prevOutput * _memoryCells[i]._forgetGate._synapses[si++]._weight;
-
-		_memoryCells[i]._forgetGate._output = sigmoid(sum);
+		_gateOutputs[r] = sum0;
+		_gateOutputs[r + 1] = sum1;
+		_gateOutputs[r + 2] = sum2;
+		_gateOutputs[r + 3] = sum3;
+	}
 
-		// ----------------------------- Update CEC -----------------------------
+	for (; r < numGateRows; r++) {
+		const float* pWeights = &_gateWeights[r * numGateInputs];
 
-		sum = _memoryCells[i]._bias._weight;
+		float sum = _gateBiases[r];
 
-		si = 0;
+		for (size_t k = 0; k < numGateInputs; k++)
+			sum += pInputs[k] * pWeights[k];
 
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			sum += _memoryCells[j]._outputGate._prevOutput * _memoryCells[i]._synapses[si++]._weight;
-			sum += _memoryCells[j]._inputGate._prevOutput * _memoryCells[i]._synapses[si++]._weight;
-			sum += _memoryCells[j]._forgetGate._prevOutput * _memoryCells[i]._synapses[si++]._weight;
+		_gateOutputs[r] = sum;
+	}
 
-			sum += _memoryCells[j]._prevOutput * _memoryCells[i]._synapses[si++]._weight;
-		}
+	// ----------------------------- Squash -----------------------------
 
-		for (size_t j = 0; j < _currentInputs.size(); j++)
-			sum += _currentInputs[j] * _memoryCells[i]._synapses[si++]._weight;
+	for (size_t r = 0; r < numGateRows; r++)
+		_gateOutputs[r] = sigmoid(_gateOutputs[r]);
 
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++)
-			sum += _hiddenGroups[j][k]._prevOutput * _memoryCells[i]._synapses[si++]._weight;
+	float* pCellInputs = &_gateOutputs[numMemoryCells * 3];
 
-		float memoryCellInput = sigmoid(sum) * 4.0f - 2.0f;
+	for (size_t i = 0; i < numMemoryCells; i++)
+		pCellInputs[i] = pCellInputs[i] * 4.0f - 2.0f;
 
-		_memoryCells[i]._net = memoryCellInput;
+	// ----------------------------- Update CEC -----------------------------
 
-		_memoryCells[i]._state = _memoryCells[i]._forgetGate._output * _memoryCells[i]._state + _memoryCells[i]._inputGate._output * memoryCellInput;
+	for (size_t i = 0; i < numMemoryCells; i++) {
+		_cellStates[i] = _gateOutputs[numMemoryCells * 2 + i] * _cellStates[i] + _gateOutputs[numMemoryCells + i] * pCellInputs[i];
 
-		_memoryCells[i]._output = (sigmoid(_memoryCells[i]._state) * 2.0f - 1.0f) * _memoryCells[i]._outputGate._output;
+		_cellOutputs[i] = (sigmoid(_cellStates[i]) * 2.0f - 1.0f) * _gateOutputs[i];
 	}
 
 	// Update output units
@@ -383,25 +227,16 @@ void LSTMNet::updateQ(const std::vector<float> &targets, float error, float gamm
 		for (size_t j = 0; j < _hiddenGroups[i].size(); j++)
 			sum += _hiddenGroups[i][j]._prevOutput * _outputNodes[i]._synapses[si++]._weight;
 
-		for (size_t j = 0; j < _memoryCells.size(); j++)
-			sum += _memoryCells[j]._prevOutput * _outputNodes[i]._synapses[si++]._weight;
+		for (size_t j = 0; j < numMemoryCells; j++)
+			sum += _cellPrevOutputs[j] * _outputNodes[i]._synapses[si++]._weight;
 
 		_outputNodes[i]._output = sum;
 	}
+}
 
-	// ------------------------------------------ Offset Outputs ------------------------------------------
-
-	std::vector<float> offsets(_outputNodes.size());
-
-	for (size_t i = 0; i < _outputNodes.size(); i++) {
-		float original = _outputNodes[i]._output;
-
-		_outputNodes[i]._output = targets[i];
-
-		offsets[i] = _outputNodes[i]._output - original;
-	}
-
-	// ------------------------------------------ Update weights ------------------------------------------
+void LSTMNet::update(const std::vector<float> &offsets, float error, float gammaLambda) {
+	const size_t numMemoryCells = _numMemoryCells;
+	const size_t numGateInputs = _numGateInputs;
 
 	size_t si;
 
@@ -421,9 +256,9 @@ void LSTMNet::updateQ(const std::vector<float> &targets, float error, float gamm
 			si++;
 		}
 
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
+		for (size_t j = 0; j < numMemoryCells; j++) {
 			_outputNodes[i]._synapses[si]._weight += error * _outputNodes[i]._synapses[si]._trace;
-			_outputNodes[i]._synapses[si]._trace = gammaLambda * _outputNodes[i]._synapses[si]._trace + z * _memoryCells[j]._output;
+			_outputNodes[i]._synapses[si]._trace = gammaLambda * _outputNodes[i]._synapses[si]._trace + z * _cellOutputs[j];
 
 			si++;
 		}
@@ -446,19 +281,45 @@ void LSTMNet::updateQ(const std::vector<float> &targets, float error, float gamm
 			si++;
 		}
 
-		for (size_t k = 0; k < _memoryCells.size(); k++) {
+		for (size_t k = 0; k < numMemoryCells; k++) {
 			_hiddenGroups[i][j]._synapses[si]._weight += error * _hiddenGroups[i][j]._synapses[si]._trace;
-			_hiddenGroups[i][j]._synapses[si]._trace = gammaLambda * _hiddenGroups[i][j]._synapses[si]._trace + cTerm * _memoryCells[k]._output;
+			_hiddenGroups[i][j]._synapses[si]._trace = gammaLambda * _hiddenGroups[i][j]._synapses[si]._trace + cTerm * _cellOutputs[k];
 
 			si++;
 		}
 	}
 
+	// Memory cell weights are updated with the current cell outputs, inputs and hidden outputs, in that order
+	si = 0;
+
+	for (size_t j = 0; j < numMemoryCells; j++)
+		_updateInputs[si++] = _cellOutputs[j];
+
+	for (size_t j = 0; j < _currentInputs.size(); j++)
+		_updateInputs[si++] = _currentInputs[j];
+
+	for (size_t j = 0; j < _hiddenGroups.size(); j++)
+	for (size_t k = 0; k < _hiddenGroups[j].size(); k++)
+		_updateInputs[si++] = _hiddenGroups[j][k]._output;
+
+	const size_t numUpdateInputs = si;
+
+	const float* pUpdateInputs = _updateInputs.data();
+
 	// Update memory cells
-	for (size_t i = 0; i < _memoryCells.size(); i++) {
+	for (size_t i = 0; i < numMemoryCells; i++) {
+		const size_t outputRow = i;
+		const size_t inputRow = numMemoryCells + i;
+		const size_t forgetRow = numMemoryCells * 2 + i;
+		const size_t cellRow = numMemoryCells * 3 + i;
+
+		const float outputGate = _gateOutputs[outputRow];
+		const float inputGate = _gateOutputs[inputRow];
+		const float forgetGate = _gateOutputs[forgetRow];
+
 		// ----------------------------- Update Gates -----------------------------
 
-		const float sigmoidNet = sigmoid(_memoryCells[i]._state);
+		const float sigmoidNet = sigmoid(_cellStates[i]);
 		const float hNet = sigmoidNet * 2.0f - 1.0f;
 		const float hPrimeNet = 2.0f * sigmoidNet * (1.0f - sigmoidNet);
 
@@ -476,145 +337,86 @@ void LSTMNet::updateQ(const std::vector<float> &targets, float error, float gamm
 		float coeff;
 
 		// Output
-		coeff = hNet * (wKc + sum) * _memoryCells[i]._outputGate._output * (1.0f - _memoryCells[i]._outputGate._output);
-
-		_memoryCells[i]._outputGate._bias._weight += error * _memoryCells[i]._outputGate._bias._trace;
-		_memoryCells[i]._outputGate._bias._trace = gammaLambda * _memoryCells[i]._outputGate._bias._trace + coeff;
-
-		si = 0;
-
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			_memoryCells[i]._outputGate._synapses[si]._weight += error * _memoryCells[i]._outputGate._synapses[si]._trace;
-			_memoryCells[i]._outputGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._outputGate._synapses[si]._trace + coeff * _memoryCells[j]._output;
-
-			si++;
-		}
-
-		for (size_t j = 0; j < _currentInputs.size(); j++) {
-			_memoryCells[i]._outputGate._synapses[si]._weight += error * _memoryCells[i]._outputGate._synapses[si]._trace;
-			_memoryCells[i]._outputGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._outputGate._synapses[si]._trace + coeff * _currentInputs[j];
+		coeff = hNet * (wKc + sum) * outputGate * (1.0f - outputGate);
 
-			si++;
-		}
+		_gateBiases[outputRow] += error * _gateBiasTraces[outputRow];
+		_gateBiasTraces[outputRow] = gammaLambda * _gateBiasTraces[outputRow] + coeff;
 
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++) {
-			_memoryCells[i]._outputGate._synapses[si]._weight += error * _memoryCells[i]._outputGate._synapses[si]._trace;
-			_memoryCells[i]._outputGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._outputGate._synapses[si]._trace + coeff * _hiddenGroups[j][k]._output;
+		{
+			float* pWeights = &_gateWeights[outputRow * numGateInputs];
+			float* pTraces = &_gateTraces[outputRow * numGateInputs];
 
-			si++;
+			for (size_t s = 0; s < numUpdateInputs; s++) {
+				pWeights[s] += error * pTraces[s];
+				pTraces[s] = gammaLambda * pTraces[s] + coeff * pUpdateInputs[s];
+			}
 		}
 
 		// CEC
-		coeff = (wKc + sum) * _memoryCells[i]._outputGate._output * hPrimeNet;
+		coeff = (wKc + sum) * outputGate * hPrimeNet;
 
-		const float sigmoidNetCEC = sigmoid(_memoryCells[i]._net);
+		const float sigmoidNetCEC = sigmoid(_gateOutputs[cellRow]);
 		const float scaledSigmoidNetCEC = 4.0f * sigmoidNetCEC;
-		const float gPrimeTimesInputGate = scaledSigmoidNetCEC * (1.0f - sigmoidNetCEC) * _memoryCells[i]._inputGate._output;
-
-		_memoryCells[i]._bias._weight += error * _memoryCells[i]._synapses[si]._trace;
-		_memoryCells[i]._bias._trace = gammaLambda * _memoryCells[i]._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-		_memoryCells[i]._bias._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gPrimeTimesInputGate;
+		const float gPrimeTimesInputGate = scaledSigmoidNetCEC * (1.0f - sigmoidNetCEC) * inputGate;
 
-		si = 0;
+		float* pCellWeights = &_gateWeights[cellRow * numGateInputs];
+		float* pCellTraces = &_gateTraces[cellRow * numGateInputs];
+		float* pCellDerivatives = &_gateDerivatives[cellRow * numGateInputs];
 
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			_memoryCells[i]._synapses[si]._weight += error * _memoryCells[i]._synapses[si]._trace;
-			_memoryCells[i]._synapses[si]._trace = gammaLambda * _memoryCells[i]._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gPrimeTimesInputGate * _memoryCells[j]._output;
+		// Biases use the entry after the updated weights
+		_gateBiases[cellRow] += error * pCellTraces[numUpdateInputs];
+		_gateBiasTraces[cellRow] = gammaLambda * pCellTraces[numUpdateInputs] + coeff * pCellDerivatives[numUpdateInputs];
+		_gateBiasDerivatives[cellRow] = pCellDerivatives[numUpdateInputs] * forgetGate + gPrimeTimesInputGate;
 
-			si++;
-		}
-
-		for (size_t j = 0; j < _currentInputs.size(); j++) {
-			_memoryCells[i]._synapses[si]._weight += error * _memoryCells[i]._synapses[si]._trace;
-			_memoryCells[i]._synapses[si]._trace = gammaLambda * _memoryCells[i]._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gPrimeTimesInputGate * _currentInputs[j];
-
-			si++;
-		}
-
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++) {
-			_memoryCells[i]._synapses[si]._weight += error * _memoryCells[i]._synapses[si]._trace;
-			_memoryCells[i]._synapses[si]._trace = gammaLambda * _memoryCells[i]._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gPrimeTimesInputGate * _hiddenGroups[j][k]._output;
-
-			si++;
+		for (size_t s = 0; s < numUpdateInputs; s++) {
+			pCellWeights[s] += error * pCellTraces[s];
+			pCellTraces[s] = gammaLambda * pCellTraces[s] + coeff * pCellDerivatives[s];
+			pCellDerivatives[s] = pCellDerivatives[s] * forgetGate + gPrimeTimesInputGate * pUpdateInputs[s];
 		}
 
 		// Input
 		// coeff is unchanged from previous, since it is the same equation. Therefore the following line has been commented out
-		//coeff = (wKc + sum) * _memoryCells[i]._outputGate._output * hPrimeNet;
-
-		const float gTimesInputPrime = scaledSigmoidNetCEC * _memoryCells[i]._inputGate._output * (1.0f - _memoryCells[i]._inputGate._output);
-
-		_memoryCells[i]._inputGate._bias._weight += error * _memoryCells[i]._inputGate._synapses[si]._trace;
-		_memoryCells[i]._inputGate._bias._trace = gammaLambda * _memoryCells[i]._inputGate._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-		_memoryCells[i]._inputGate._bias._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gTimesInputPrime;
+		//coeff = (wKc + sum) * outputGate * hPrimeNet;
 
-		si = 0;
+		const float gTimesInputPrime = scaledSigmoidNetCEC * inputGate * (1.0f - inputGate);
 
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			_memoryCells[i]._inputGate._synapses[si]._weight += error * _memoryCells[i]._inputGate._synapses[si]._trace;
-			_memoryCells[i]._inputGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._inputGate._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._inputGate._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gTimesInputPrime * _memoryCells[j]._output;
+		float* pInputTraces = &_gateTraces[inputRow * numGateInputs];
 
-			si++;
-		}
+		_gateBiases[inputRow] += error * pInputTraces[numUpdateInputs];
+		_gateBiasTraces[inputRow] = gammaLambda * pInputTraces[numUpdateInputs] + coeff * pCellDerivatives[numUpdateInputs];
+		_gateBiasDerivatives[inputRow] = pCellDerivatives[numUpdateInputs] * forgetGate + gTimesInputPrime;
 
-		for (size_t j = 0; j < _currentInputs.size(); j++) {
-			_memoryCells[i]._inputGate._synapses[si]._weight += error * _memoryCells[i]._inputGate._synapses[si]._trace;
-			_memoryCells[i]._inputGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._inputGate._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._inputGate._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gTimesInputPrime * _currentInputs[j];
+		{
+			float* pWeights = &_gateWeights[inputRow * numGateInputs];
+			float* pDerivatives = &_gateDerivatives[inputRow * numGateInputs];
 
-			si++;
-		}
-
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++) {
-			_memoryCells[i]._inputGate._synapses[si]._weight += error * _memoryCells[i]._inputGate._synapses[si]._trace;
-			_memoryCells[i]._inputGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._inputGate._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._inputGate._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gTimesInputPrime * _hiddenGroups[j][k]._output;
-
-			si++;
+			for (size_t s = 0; s < numUpdateInputs; s++) {
+				pWeights[s] += error * pInputTraces[s];
+				pInputTraces[s] = gammaLambda * pInputTraces[s] + coeff * pCellDerivatives[s];
+				pDerivatives[s] = pCellDerivatives[s] * forgetGate + gTimesInputPrime * pUpdateInputs[s];
+			}
 		}
 
 		// Forget
 		// coeff is unchanged from previous, since it is the same equation. Therefore the following line has been commented out
-		//coeff = (wKc + sum) * _memoryCells[i]._outputGate._output * hPrimeNet;
-
-		const float stateTimesForgetPrime = _memoryCells[i]._state * _memoryCells[i]._forgetGate._output * (1.0f - _memoryCells[i]._forgetGate._output);
-
-		_memoryCells[i]._forgetGate._bias._weight += error * _memoryCells[i]._inputGate._synapses[si]._trace;
-		_memoryCells[i]._forgetGate._bias._trace = gammaLambda * _memoryCells[i]._inputGate._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-		_memoryCells[i]._forgetGate._bias._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gTimesInputPrime;
+		//coeff = (wKc + sum) * outputGate * hPrimeNet;
 
-		si = 0;
-
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			_memoryCells[i]._forgetGate._synapses[si]._weight += error * _memoryCells[i]._forgetGate._synapses[si]._trace;
-			_memoryCells[i]._forgetGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._forgetGate._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._forgetGate._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + stateTimesForgetPrime * _memoryCells[j]._output;
+		const float stateTimesForgetPrime = _cellStates[i] * forgetGate * (1.0f - forgetGate);
 
-			si++;
-		}
-
-		for (size_t j = 0; j < _currentInputs.size(); j++) {
-			_memoryCells[i]._forgetGate._synapses[si]._weight += error * _memoryCells[i]._forgetGate._synapses[si]._trace;
-			_memoryCells[i]._forgetGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._forgetGate._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._forgetGate._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + stateTimesForgetPrime * _currentInputs[j];
-
-			si++;
-		}
+		_gateBiases[forgetRow] += error * pInputTraces[numUpdateInputs];
+		_gateBiasTraces[forgetRow] = gammaLambda * pInputTraces[numUpdateInputs] + coeff * pCellDerivatives[numUpdateInputs];
+		_gateBiasDerivatives[forgetRow] = pCellDerivatives[numUpdateInputs] * forgetGate + gTimesInputPrime;
 
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++) {
-			_memoryCells[i]._forgetGate._synapses[si]._weight += error * _memoryCells[i]._forgetGate._synapses[si]._trace;
-			_memoryCells[i]._forgetGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._forgetGate._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._forgetGate._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + stateTimesForgetPrime * _hiddenGroups[j][k]._output;
+		{
+			float* pWeights = &_gateWeights[forgetRow * numGateInputs];
+			float* pTraces = &_gateTraces[forgetRow * numGateInputs];
+			float* pDerivatives = &_gateDerivatives[forgetRow * numGateInputs];
 
-			si++;
+			for (size_t s = 0; s < numUpdateInputs; s++) {
+				pWeights[s] += error * pTraces[s];
+				pTraces[s] = gammaLambda * pTraces[s] + coeff * pCellDerivatives[s];
+				pDerivatives[s] = pCellDerivatives[s] * forgetGate + stateTimesForgetPrime * pUpdateInputs[s];
+			}
 		}
 	}
 
@@ -624,399 +426,499 @@ void LSTMNet::updateQ(const std::vector<float> &targets, float error, float gamm
 	for (size_t j = 0; j < _hiddenGroups[i].size(); j++)
 		_hiddenGroups[i][j]._prevOutput = _hiddenGroups[i][j]._output;
 
-	for (size_t i = 0; i < _memoryCells.size(); i++) {
-		_memoryCells[i]._outputGate._prevOutput = _memoryCells[i]._outputGate._output;
-		_memoryCells[i]._forgetGate._prevOutput = _memoryCells[i]._forgetGate._output;
-		_memoryCells[i]._inputGate._prevOutput = _memoryCells[i]._inputGate._output;
+	std::copy(_gateOutputs.begin(), _gateOutputs.begin() + numMemoryCells * 3, _gatePrevOutputs.begin());
 
-		_memoryCells[i]._prevOutput = _memoryCells[i]._output;
-	}
+	_cellPrevOutputs = _cellOutputs;
 
 	for (size_t i = 0; i < _outputNodes.size(); i++)
 		_outputNodes[i]._prevOutput = _outputNodes[i]._output;
 }
 
-void LSTMNet::stepReinforce(float error, float gammaLambda, float offsetStdDev, std::mt19937 &generator) {
-	// Update hidden units
-	for (size_t i = 0; i < _hiddenGroups.size(); i++)
-	for (size_t j = 0; j < _hiddenGroups[i].size(); j++) {
-		float sum = _hiddenGroups[i][j]._bias._weight;
-
-		size_t si = 0;
+void LSTMNet::step() {
+	activate();
+}
 
-		for (size_t k = 0; k < _currentInputs.size(); k++)
-			sum += _currentInputs[k] * _hiddenGroups[i][j]._synapses[si++]._weight;
+void LSTMNet::updateQ(const std::vector<float> &targets, float error, float gammaLambda) {
+	activate();
 
-		for (size_t k = 0; k < _memoryCells.size(); k++)
-			sum += _memoryCells[k]._prevOutput * _hiddenGroups[i][j]._synapses[si++]._weight;
+	// ------------------------------------------ Offset Outputs ------------------------------------------
 
-		_hiddenGroups[i][j]._output = sigmoid(sum);
-	}
+	std::vector<float> offsets(_outputNodes.size());
 
-	// Update memory cells
-	for (size_t i = 0; i < _memoryCells.size(); i++) {
-		float sum;
-		size_t si;
+	for (size_t i = 0; i < _outputNodes.size(); i++) {
+		float original = _outputNodes[i]._output;
 
-		// ----------------------------- Update Gates -----------------------------
+		_outputNodes[i]._output = targets[i];
 
-		// Output
-		sum = _memoryCells[i]._outputGate._bias._weight;
+		offsets[i] = _outputNodes[i]._output - original;
+	}
 
-		si = 0;
+	// ------------------------------------------ Update weights ------------------------------------------
 
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			sum += _memoryCells[j]._outputGate._prevOutput * _memoryCells[i]._outputGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._inputGate._prevOutput * _memoryCells[i]._outputGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._forgetGate._prevOutput * _memoryCells[i]._outputGate._synapses[si++]._weight;
+	update(offsets, error, gammaLambda);
+}
 
-			sum += _memoryCells[j]._prevOutput * _memoryCells[i]._outputGate._synapses[si++]._weight;
-		}
+void LSTMNet::stepReinforce(float error, float gammaLambda, float offsetStdDev, std::mt19937 &generator) {
+	activate();
 
-		for (size_t j = 0; j < _currentInputs.size(); j++)
-			sum += _currentInputs[j] * _memoryCells[i]._outputGate._synapses[si++]._weight;
+	// ------------------------------------------ Offset Outputs ------------------------------------------
 
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++)
-			sum += _hiddenGroups[j][k]._prevOutput * _memoryCells[i]._outputGate._synapses[si++]._weight;
+	std::vector<float> offsets(_outputNodes.size());
 
-		_memoryCells[i]._outputGate._output = sigmoid(sum);
+	std::normal_distribution<float> distOutputOffset(0.0f, offsetStdDev);
 
-		// Input
-		sum = _memoryCells[i]._inputGate._bias._weight;
+	for (size_t i = 0; i < _outputNodes.size(); i++) {
+		float original = _outputNodes[i]._output;
+		float delta = distOutputOffset(generator);
 
-		si = 0;
+		_outputNodes[i]._output = std::min(1.0f, std::max(-1.0f, _outputNodes[i]._output + delta));
 
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			sum += _memoryCells[j]._outputGate._prevOutput * _memoryCells[i]._inputGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._inputGate._prevOutput * _memoryCells[i]._inputGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._forgetGate._prevOutput * _memoryCells[i]._inputGate._synapses[si++]._weight;
+		offsets[i] = _outputNodes[i]._output - original;
+	}
 
-			sum += _memoryCells[j]._prevOutput * _memoryCells[i]._inputGate._synapses[si++]._weight;
-		}
+	// ------------------------------------------ Update weights ------------------------------------------
 
-		for (size_t j = 0; j < _currentInputs.size(); j++)
-			sum += _currentInputs[j] * _memoryCells[i]._inputGate._synapses[si++]._weight;
+	update(offsets, error, gammaLambda);
+}
 
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++)
-			sum += _hiddenGroups[j][k]._prevOutput * _memoryCells[i]._inputGate._synapses[si++]._weight;
+void LSTMNet::allocateArena(size_t batchSize, size_t truncation) {
+	const size_t numInputs = _currentInputs.size();
+	const size_t numOutputs = _outputNodes.size();
+	const size_t hiddenSize = numOutputs > 0 ? _hiddenGroups[0].size() : 0;
+	const size_t numHidden = numOutputs * hiddenSize;
+	const size_t numMemoryCells = _numMemoryCells;
+	const size_t numGateRows = numMemoryCells * 4;
+	const size_t numSlots = truncation + 1;
+
+	_arena._batchSize = batchSize;
+	_arena._truncation = truncation;
+
+	size_t size = 0;
+
+	_arena._hiddenOutputs = size; size += numSlots * batchSize * numHidden;
+	_arena._gateInputs = size; size += numSlots * batchSize * _numGateInputs;
+	_arena._gateOutputs = size; size += numSlots * batchSize * numGateRows;
+	_arena._cellStates = size; size += numSlots * batchSize * numMemoryCells;
+	_arena._cellOutputs = size; size += numSlots * batchSize * numMemoryCells;
+	_arena._outputs = size; size += numSlots * batchSize * numOutputs;
+
+	_arena._gateSumGradients = size; size += batchSize * numGateRows;
+	_arena._gateInputGradients = size; size += batchSize * _numGateInputs;
+
+	for (int i = 0; i < 2; i++) {
+		_arena._hiddenOutputGradients[i] = size; size += batchSize * numHidden;
+		_arena._gateOutputGradients[i] = size; size += batchSize * numMemoryCells * 3;
+		_arena._cellStateGradients[i] = size; size += batchSize * numMemoryCells;
+		_arena._cellOutputGradients[i] = size; size += batchSize * numMemoryCells;
+	}
 
-		_memoryCells[i]._inputGate._output = sigmoid(sum);
+	_arena._gateWeightGradients = size; size += numGateRows * _numGateInputs;
+	_arena._gateBiasGradients = size; size += numGateRows;
+	_arena._hiddenWeightGradients = size; size += numHidden * (numInputs + numMemoryCells);
+	_arena._hiddenBiasGradients = size; size += numHidden;
+	_arena._outputWeightGradients = size; size += numOutputs * (hiddenSize + numMemoryCells);
+	_arena._outputBiasGradients = size; size += numOutputs;
 
-		// Forget
-		sum = _memoryCells[i]._forgetGate._bias._weight;
+	if (_arena._data.size() < size)
+		_arena._data.resize(size);
+}
 
-		si = 0;
+void LSTMNet::forwardChunk(const float* inputs, const float* targets, size_t firstStep, size_t numSteps, float &error) {
+	const size_t numInputs = _currentInputs.size();
+	const size_t numOutputs = _outputNodes.size();
+	const size_t hiddenSize = numOutputs > 0 ? _hiddenGroups[0].size() : 0;
+	const size_t numHidden = numOutputs * hiddenSize;
+	const size_t numMemoryCells = _numMemoryCells;
+	const size_t numGateInputs = _numGateInputs;
+	const size_t numGateRows = numMemoryCells * 4;
+	const size_t batchSize = _arena._batchSize;
 
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			sum += _memoryCells[j]._outputGate._prevOutput * _memoryCells[i]._forgetGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._inputGate._prevOutput * _memoryCells[i]._forgetGate._synapses[si++]._weight;
-			sum += _memoryCells[j]._forgetGate._prevOutput * _memoryCells[i]._forgetGate._synapses[si++]._weight;
+	float* pData = _arena._data.data();
 
-			sum += _memoryCells[j]._prevOutput * _memoryCells[i]._forgetGate._synapses[si++]._weight;
-		}
+	for (size_t t = 1; t <= numSteps; t++) {
+		const size_t step = firstStep + t - 1;
 
-		for (size_t j = 0; j < _currentInputs.size(); j++)
-			sum += _currentInputs[j] * _memoryCells[i]._forgetGate._synapses[si++]._weight;
+		float* pHidden = pData + _arena._hiddenOutputs + t * batchSize * numHidden;
+		float* pGateInputs = pData + _arena._gateInputs + t * batchSize * numGateInputs;
+		float* pGates = pData + _arena._gateOutputs + t * batchSize * numGateRows;
+		float* pStates = pData + _arena._cellStates + t * batchSize * numMemoryCells;
+		float* pCells = pData + _arena._cellOutputs + t * batchSize * numMemoryCells;
+		float* pOutputs = pData + _arena._outputs + t * batchSize * numOutputs;
 
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++)
-			sum += _hiddenGroups[j][k]._prevOutput * _memoryCells[i]._forgetGate._synapses[si++]._weight;
+		const float* pPrevHidden = pHidden - batchSize * numHidden;
+		const float* pPrevGates = pGates - batchSize * numGateRows;
+		const float* pPrevStates = pStates - batchSize * numMemoryCells;
+		const float* pPrevCells = pCells - batchSize * numMemoryCells;
 
-		_memoryCells[i]._forgetGate._output = sigmoid(sum);
+		// Hidden units and gate inputs, same order as activate
+		for (size_t b = 0; b < batchSize; b++) {
+			const float* pInput = inputs + (step * batchSize + b) * numInputs;
+			const float* pPrevCell = pPrevCells + b * numMemoryCells;
 
-		// ----------------------------- Update CEC -----------------------------
+			for (size_t i = 0; i < numOutputs; i++)
+			for (size_t j = 0; j < hiddenSize; j++) {
+				const Node &node = _hiddenGroups[i][j];
 
-		sum = _memoryCells[i]._bias._weight;
+				float sum = node._bias._weight;
 
-		si = 0;
+				for (size_t k = 0; k < numInputs; k++)
+					sum += pInput[k] * node._synapses[k]._weight;
 
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			sum += _memoryCells[j]._outputGate._prevOutput * _memoryCells[i]._synapses[si++]._weight;
-			sum += _memoryCells[j]._inputGate._prevOutput * _memoryCells[i]._synapses[si++]._weight;
-			sum += _memoryCells[j]._forgetGate._prevOutput * _memoryCells[i]._synapses[si++]._weight;
+				for (size_t k = 0; k < numMemoryCells; k++)
+					sum += pPrevCell[k] * node._synapses[numInputs + k]._weight;
 
-			sum += _memoryCells[j]._prevOutput * _memoryCells[i]._synapses[si++]._weight;
-		}
+				pHidden[b * numHidden + i * hiddenSize + j] = sigmoid(sum);
+			}
 
-		for (size_t j = 0; j < _currentInputs.size(); j++)
-			sum += _currentInputs[j] * _memoryCells[i]._synapses[si++]._weight;
+			const float* pPrevGate = pPrevGates + b * numGateRows;
 
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++)
-			sum += _hiddenGroups[j][k]._prevOutput * _memoryCells[i]._synapses[si++]._weight;
+			float* pGateInput = pGateInputs + b * numGateInputs;
 
-		float memoryCellInput = sigmoid(sum) * 4.0f - 2.0f;
+			size_t si = 0;
 
-		_memoryCells[i]._net = memoryCellInput;
+			for (size_t j = 0; j < numMemoryCells; j++) {
+				pGateInput[si++] = pPrevGate[j];
+				pGateInput[si++] = pPrevGate[numMemoryCells + j];
+				pGateInput[si++] = pPrevGate[numMemoryCells * 2 + j];
 
-		_memoryCells[i]._state = _memoryCells[i]._forgetGate._output * _memoryCells[i]._state + _memoryCells[i]._inputGate._output * memoryCellInput;
+				pGateInput[si++] = pPrevCell[j];
+			}
 
-		_memoryCells[i]._output = (sigmoid(_memoryCells[i]._state) * 2.0f - 1.0f) * _memoryCells[i]._outputGate._output;
-	}
+			for (size_t k = 0; k < numInputs; k++)
+				pGateInput[si++] = pInput[k];
 
-	// Update output units
-	for (size_t i = 0; i < _outputNodes.size(); i++) {
-		float sum = _outputNodes[i]._bias._weight;
+			for (size_t k = 0; k < numHidden; k++)
+				pGateInput[si++] = pPrevHidden[b * numHidden + k];
+		}
 
-		size_t si = 0;
+		// Gate sums of the whole batch, each weight row is reused for all sequences
+		for (size_t r = 0; r < numGateRows; r++) {
+			const float* pWeights = &_gateWeights[r * numGateInputs];
 
-		for (size_t j = 0; j < _hiddenGroups[i].size(); j++)
-			sum += _hiddenGroups[i][j]._prevOutput * _outputNodes[i]._synapses[si++]._weight;
+			for (size_t b = 0; b < batchSize; b++) {
+				const float* pGateInput = pGateInputs + b * numGateInputs;
 
-		for (size_t j = 0; j < _memoryCells.size(); j++)
-			sum += _memoryCells[j]._prevOutput * _outputNodes[i]._synapses[si++]._weight;
+				float sum = _gateBiases[r];
 
-		_outputNodes[i]._output = sum;
-	}
+				for (size_t k = 0; k < numGateInputs; k++)
+					sum += pGateInput[k] * pWeights[k];
 
-	// ------------------------------------------ Offset Outputs ------------------------------------------
+				pGates[b * numGateRows + r] = sum;
+			}
+		}
 
-	std::vector<float> offsets(_outputNodes.size());
+		// Gate rows hold the sigmoid of the sum, also for the cell input (scaled when used)
+		for (size_t i = 0; i < batchSize * numGateRows; i++)
+			pGates[i] = sigmoid(pGates[i]);
 
-	std::normal_distribution<float> distOutputOffset(0.0f, offsetStdDev);
+		for (size_t b = 0; b < batchSize; b++) {
+			const float* pGate = pGates + b * numGateRows;
 
-	for (size_t i = 0; i < _outputNodes.size(); i++) {
-		float original = _outputNodes[i]._output;
-		float delta = distOutputOffset(generator);
+			for (size_t i = 0; i < numMemoryCells; i++) {
+				float cellInput = pGate[numMemoryCells * 3 + i] * 4.0f - 2.0f;
 
-		_outputNodes[i]._output = std::min(1.0f, std::max(-1.0f, _outputNodes[i]._output + delta));
+				float state = pGate[numMemoryCells * 2 + i] * pPrevStates[b * numMemoryCells + i] + pGate[numMemoryCells + i] * cellInput;
 
-		offsets[i] = _outputNodes[i]._output - original;
-	}
+				pStates[b * numMemoryCells + i] = state;
+				pCells[b * numMemoryCells + i] = (sigmoid(state) * 2.0f - 1.0f) * pGate[i];
+			}
 
-	// ------------------------------------------ Update weights ------------------------------------------
+			// Outputs from the previous hidden and cell outputs
+			const float* pTarget = targets + (step * batchSize + b) * numOutputs;
 
-	size_t si;
+			for (size_t i = 0; i < numOutputs; i++) {
+				float sum = _outputNodes[i]._bias._weight;
 
-	// Update output for selected action output unit
-	for (size_t i = 0; i < _outputNodes.size(); i++) {
-		float z = offsets[i];
+				for (size_t j = 0; j < hiddenSize; j++)
+					sum += pPrevHidden[b * numHidden + i * hiddenSize + j] * _outputNodes[i]._synapses[j]._weight;
 
-		_outputNodes[i]._bias._weight += error * _outputNodes[i]._bias._trace;
-		_outputNodes[i]._bias._trace = gammaLambda * _outputNodes[i]._bias._trace + z;
+				for (size_t j = 0; j < numMemoryCells; j++)
+					sum += pPrevCells[b * numMemoryCells + j] * _outputNodes[i]._synapses[hiddenSize + j]._weight;
 
-		si = 0;
+				pOutputs[b * numOutputs + i] = sum;
 
-		for (size_t j = 0; j < _hiddenGroups[i].size(); j++) {
-			_outputNodes[i]._synapses[si]._weight += error * _outputNodes[i]._synapses[si]._trace;
-			_outputNodes[i]._synapses[si]._trace = gammaLambda * _outputNodes[i]._synapses[si]._trace + z * _hiddenGroups[i][j]._output;
+				float delta = pTarget[i] - sum;
 
-			si++;
+				error += delta * delta;
+			}
 		}
+	}
+}
 
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			_outputNodes[i]._synapses[si]._weight += error * _outputNodes[i]._synapses[si]._trace;
-			_outputNodes[i]._synapses[si]._trace = gammaLambda * _outputNodes[i]._synapses[si]._trace + z * _memoryCells[j]._output;
-
-			si++;
+void LSTMNet::backwardChunk(const float* inputs, const float* targets, size_t firstStep, size_t numSteps) {
+	const size_t numInputs = _currentInputs.size();
+	const size_t numOutputs = _outputNodes.size();
+	const size_t hiddenSize = numOutputs > 0 ? _hiddenGroups[0].size() : 0;
+	const size_t numHidden = numOutputs * hiddenSize;
+	const size_t numMemoryCells = _numMemoryCells;
+	const size_t numGateInputs = _numGateInputs;
+	const size_t numGateRows = numMemoryCells * 4;
+	const size_t batchSize = _arena._batchSize;
+
+	float* pData = _arena._data.data();
+
+	float* pGateSumGradients = pData + _arena._gateSumGradients;
+	float* pGateInputGradients = pData + _arena._gateInputGradients;
+
+	float* pGateWeightGradients = pData + _arena._gateWeightGradients;
+	float* pGateBiasGradients = pData + _arena._gateBiasGradients;
+	float* pHiddenWeightGradients = pData + _arena._hiddenWeightGradients;
+	float* pHiddenBiasGradients = pData + _arena._hiddenBiasGradients;
+	float* pOutputWeightGradients = pData + _arena._outputWeightGradients;
+	float* pOutputBiasGradients = pData + _arena._outputBiasGradients;
+
+	std::fill(pGateWeightGradients, pData + _arena._outputBiasGradients + numOutputs, 0.0f);
+
+	// Gradients with respect to the values of the current step [0] and of the previous step [1], the state before the chunk gets none
+	int current = 0;
+
+	std::fill(pData + _arena._hiddenOutputGradients[0], pData + _arena._gateWeightGradients, 0.0f);
+
+	for (size_t t = numSteps; t >= 1; t--) {
+		const size_t step = firstStep + t - 1;
+		const int previous = 1 - current;
+
+		const float* pHidden = pData + _arena._hiddenOutputs + t * batchSize * numHidden;
+		const float* pGateInputs = pData + _arena._gateInputs + t * batchSize * numGateInputs;
+		const float* pGates = pData + _arena._gateOutputs + t * batchSize * numGateRows;
+		const float* pStates = pData + _arena._cellStates + t * batchSize * numMemoryCells;
+		const float* pOutputs = pData + _arena._outputs + t * batchSize * numOutputs;
+
+		const float* pPrevHidden = pHidden - batchSize * numHidden;
+		const float* pPrevStates = pStates - batchSize * numMemoryCells;
+		const float* pPrevCells = pData + _arena._cellOutputs + (t - 1) * batchSize * numMemoryCells;
+
+		float* pHiddenGradients = pData + _arena._hiddenOutputGradients[current];
+		float* pGateOutputGradients = pData + _arena._gateOutputGradients[current];
+		float* pStateGradients = pData + _arena._cellStateGradients[current];
+		float* pCellGradients = pData + _arena._cellOutputGradients[current];
+
+		float* pPrevHiddenGradients = pData + _arena._hiddenOutputGradients[previous];
+		float* pPrevGateOutputGradients = pData + _arena._gateOutputGradients[previous];
+		float* pPrevStateGradients = pData + _arena._cellStateGradients[previous];
+		float* pPrevCellGradients = pData + _arena._cellOutputGradients[previous];
+
+		std::fill(pPrevHiddenGradients, pPrevHiddenGradients + batchSize * numHidden, 0.0f);
+		std::fill(pPrevGateOutputGradients, pPrevGateOutputGradients + batchSize * numMemoryCells * 3, 0.0f);
+		std::fill(pPrevCellGradients, pPrevCellGradients + batchSize * numMemoryCells, 0.0f);
+
+		// Cell outputs and states back to the gate sums
+		for (size_t b = 0; b < batchSize; b++) {
+			const float* pGate = pGates + b * numGateRows;
+			const float* pGateOutputGradient = pGateOutputGradients + b * numMemoryCells * 3;
+
+			float* pGateSumGradient = pGateSumGradients + b * numGateRows;
+
+			for (size_t i = 0; i < numMemoryCells; i++) {
+				const float outputGate = pGate[i];
+				const float inputGate = pGate[numMemoryCells + i];
+				const float forgetGate = pGate[numMemoryCells * 2 + i];
+				const float sigmoidCellInput = pGate[numMemoryCells * 3 + i];
+				const float cellInput = sigmoidCellInput * 4.0f - 2.0f;
+
+				const float sigmoidState = sigmoid(pStates[b * numMemoryCells + i]);
+				const float cellGradient = pCellGradients[b * numMemoryCells + i];
+
+				float outputGateGradient = pGateOutputGradient[i] + cellGradient * (sigmoidState * 2.0f - 1.0f);
+				float stateGradient = pStateGradients[b * numMemoryCells + i] + cellGradient * outputGate * 2.0f * sigmoidState * (1.0f - sigmoidState);
+
+				float inputGateGradient = pGateOutputGradient[numMemoryCells + i] + stateGradient * cellInput;
+				float forgetGateGradient = pGateOutputGradient[numMemoryCells * 2 + i] + stateGradient * pPrevStates[b * numMemoryCells + i];
+				float cellInputGradient = stateGradient * inputGate;
+
+				pPrevStateGradients[b * numMemoryCells + i] = stateGradient * forgetGate;
+
+				pGateSumGradient[i] = outputGateGradient * outputGate * (1.0f - outputGate);
+				pGateSumGradient[numMemoryCells + i] = inputGateGradient * inputGate * (1.0f - inputGate);
+				pGateSumGradient[numMemoryCells * 2 + i] = forgetGateGradient * forgetGate * (1.0f - forgetGate);
+				pGateSumGradient[numMemoryCells * 3 + i] = cellInputGradient * 4.0f * sigmoidCellInput * (1.0f - sigmoidCellInput);
+			}
 		}
-	}
 
-	// Update hidden units
-	for (size_t i = 0; i < _hiddenGroups.size(); i++)
-	for (size_t j = 0; j < _hiddenGroups[i].size(); j++) {
-		float cTerm = offsets[i] * _outputNodes[i]._synapses[j]._weight * _hiddenGroups[i][j]._output * (1.0f - _hiddenGroups[i][j]._output);
+		// Gate weight gradients and gate input gradients of the whole batch
+		std::fill(pGateInputGradients, pGateInputGradients + batchSize * numGateInputs, 0.0f);
 
-		_hiddenGroups[i][j]._bias._weight += error * _hiddenGroups[i][j]._bias._trace;
-		_hiddenGroups[i][j]._bias._trace = gammaLambda * _hiddenGroups[i][j]._bias._trace + cTerm;
+		for (size_t r = 0; r < numGateRows; r++) {
+			const float* pWeights = &_gateWeights[r * numGateInputs];
 
-		si = 0;
+			float* pWeightGradients = pGateWeightGradients + r * numGateInputs;
 
-		for (size_t k = 0; k < _currentInputs.size(); k++) {
-			_hiddenGroups[i][j]._synapses[si]._weight += error * _hiddenGroups[i][j]._synapses[si]._trace;
-			_hiddenGroups[i][j]._synapses[si]._trace = gammaLambda * _hiddenGroups[i][j]._synapses[si]._trace + cTerm * _currentInputs[k];
+			for (size_t b = 0; b < batchSize; b++) {
+				const float gradient = pGateSumGradients[b * numGateRows + r];
 
-			si++;
-		}
+				if (gradient == 0.0f)
+					continue;
 
-		for (size_t k = 0; k < _memoryCells.size(); k++) {
-			_hiddenGroups[i][j]._synapses[si]._weight += error * _hiddenGroups[i][j]._synapses[si]._trace;
-			_hiddenGroups[i][j]._synapses[si]._trace = gammaLambda * _hiddenGroups[i][j]._synapses[si]._trace + cTerm * _memoryCells[k]._output;
+				const float* pGateInput = pGateInputs + b * numGateInputs;
 
-			si++;
-		}
-	}
+				float* pGateInputGradient = pGateInputGradients + b * numGateInputs;
 
-	// Update memory cells
-	for (size_t i = 0; i < _memoryCells.size(); i++) {
-		// ----------------------------- Update Gates -----------------------------
+				for (size_t k = 0; k < numGateInputs; k++) {
+					pWeightGradients[k] += gradient * pGateInput[k];
+					pGateInputGradient[k] += gradient * pWeights[k];
+				}
 
-		const float sigmoidNet = sigmoid(_memoryCells[i]._state);
-		const float hNet = sigmoidNet * 2.0f - 1.0f;
-		const float hPrimeNet = 2.0f * sigmoidNet * (1.0f - sigmoidNet);
+				pGateBiasGradients[r] += gradient;
+			}
+		}
 
-		float wKc = 0.0f;
+		for (size_t b = 0; b < batchSize; b++) {
+			const float* pGateInputGradient = pGateInputGradients + b * numGateInputs;
 
-		for (size_t j = 0; j < _outputNodes.size(); j++)
-			wKc += _outputNodes[j]._synapses[_hiddenGroups[j].size() + i]._weight;
+			size_t si = 0;
 
-		float sum = 0.0f;
+			for (size_t j = 0; j < numMemoryCells; j++) {
+				pPrevGateOutputGradients[b * numMemoryCells * 3 + j] += pGateInputGradient[si++];
+				pPrevGateOutputGradients[b * numMemoryCells * 3 + numMemoryCells + j] += pGateInputGradient[si++];
+				pPrevGateOutputGradients[b * numMemoryCells * 3 + numMemoryCells * 2 + j] += pGateInputGradient[si++];
 
-		for (size_t j = 0; j < _outputNodes.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++)
-			sum += offsets[j] * _outputNodes[j]._synapses[k]._weight * _hiddenGroups[j][k]._synapses[_currentInputs.size() + i]._weight * _hiddenGroups[j][k]._output * (1.0f - _hiddenGroups[j][k]._output);
+				pPrevCellGradients[b * numMemoryCells + j] += pGateInputGradient[si++];
+			}
 
-		float coeff;
+			si += numInputs;
 
-		// Output
-		coeff = hNet * (wKc + sum) * _memoryCells[i]._outputGate._output * (1.0f - _memoryCells[i]._outputGate._output);
+			for (size_t k = 0; k < numHidden; k++)
+				pPrevHiddenGradients[b * numHidden + k] += pGateInputGradient[si++];
+		}
 
-		_memoryCells[i]._outputGate._bias._weight += error * _memoryCells[i]._outputGate._bias._trace;
-		_memoryCells[i]._outputGate._bias._trace = gammaLambda * _memoryCells[i]._outputGate._bias._trace + coeff;
+		// Hidden units of this step and outputs (which read the previous step)
+		for (size_t b = 0; b < batchSize; b++) {
+			const float* pInput = inputs + (step * batchSize + b) * numInputs;
+			const float* pTarget = targets + (step * batchSize + b) * numOutputs;
+			const float* pPrevCell = pPrevCells + b * numMemoryCells;
 
-		si = 0;
+			float* pPrevCellGradient = pPrevCellGradients + b * numMemoryCells;
 
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			_memoryCells[i]._outputGate._synapses[si]._weight += error * _memoryCells[i]._outputGate._synapses[si]._trace;
-			_memoryCells[i]._outputGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._outputGate._synapses[si]._trace + coeff * _memoryCells[j]._output;
+			for (size_t i = 0; i < numOutputs; i++)
+			for (size_t j = 0; j < hiddenSize; j++) {
+				const size_t n = i * hiddenSize + j;
+				const Node &node = _hiddenGroups[i][j];
 
-			si++;
-		}
+				const float output = pHidden[b * numHidden + n];
+				const float gradient = pHiddenGradients[b * numHidden + n] * output * (1.0f - output);
 
-		for (size_t j = 0; j < _currentInputs.size(); j++) {
-			_memoryCells[i]._outputGate._synapses[si]._weight += error * _memoryCells[i]._outputGate._synapses[si]._trace;
-			_memoryCells[i]._outputGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._outputGate._synapses[si]._trace + coeff * _currentInputs[j];
+				float* pWeightGradients = pHiddenWeightGradients + n * (numInputs + numMemoryCells);
 
-			si++;
-		}
+				for (size_t k = 0; k < numInputs; k++)
+					pWeightGradients[k] += gradient * pInput[k];
 
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++) {
-			_memoryCells[i]._outputGate._synapses[si]._weight += error * _memoryCells[i]._outputGate._synapses[si]._trace;
-			_memoryCells[i]._outputGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._outputGate._synapses[si]._trace + coeff * _hiddenGroups[j][k]._output;
+				for (size_t k = 0; k < numMemoryCells; k++) {
+					pWeightGradients[numInputs + k] += gradient * pPrevCell[k];
+					pPrevCellGradient[k] += gradient * node._synapses[numInputs + k]._weight;
+				}
 
-			si++;
-		}
+				pHiddenBiasGradients[n] += gradient;
+			}
 
-		// CEC
-		coeff = (wKc + sum) * _memoryCells[i]._outputGate._output * hPrimeNet;
+			for (size_t i = 0; i < numOutputs; i++) {
+				const Node &node = _outputNodes[i];
 
-		const float sigmoidNetCEC = sigmoid(_memoryCells[i]._net);
-		const float scaledSigmoidNetCEC = 4.0f * sigmoidNetCEC;
-		const float gPrimeTimesInputGate = scaledSigmoidNetCEC * (1.0f - sigmoidNetCEC) * _memoryCells[i]._inputGate._output;
+				const float gradient = pOutputs[b * numOutputs + i] - pTarget[i];
 
-		_memoryCells[i]._bias._weight += error * _memoryCells[i]._synapses[si]._trace;
-		_memoryCells[i]._bias._trace = gammaLambda * _memoryCells[i]._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-		_memoryCells[i]._bias._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gPrimeTimesInputGate;
+				float* pWeightGradients = pOutputWeightGradients + i * (hiddenSize + numMemoryCells);
 
-		si = 0;
+				for (size_t j = 0; j < hiddenSize; j++) {
+					pWeightGradients[j] += gradient * pPrevHidden[b * numHidden + i * hiddenSize + j];
+					pPrevHiddenGradients[b * numHidden + i * hiddenSize + j] += gradient * node._synapses[j]._weight;
+				}
 
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			_memoryCells[i]._synapses[si]._weight += error * _memoryCells[i]._synapses[si]._trace;
-			_memoryCells[i]._synapses[si]._trace = gammaLambda * _memoryCells[i]._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gPrimeTimesInputGate * _memoryCells[j]._output;
+				for (size_t j = 0; j < numMemoryCells; j++) {
+					pWeightGradients[hiddenSize + j] += gradient * pPrevCell[j];
+					pPrevCellGradient[j] += gradient * node._synapses[hiddenSize + j]._weight;
+				}
 
-			si++;
+				pOutputBiasGradients[i] += gradient;
+			}
 		}
 
-		for (size_t j = 0; j < _currentInputs.size(); j++) {
-			_memoryCells[i]._synapses[si]._weight += error * _memoryCells[i]._synapses[si]._trace;
-			_memoryCells[i]._synapses[si]._trace = gammaLambda * _memoryCells[i]._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gPrimeTimesInputGate * _currentInputs[j];
+		current = previous;
+	}
+}
 
-			si++;
-		}
+void LSTMNet::applyGradients(float alpha) {
+	const size_t numInputs = _currentInputs.size();
+	const size_t numOutputs = _outputNodes.size();
+	const size_t hiddenSize = numOutputs > 0 ? _hiddenGroups[0].size() : 0;
+	const size_t numMemoryCells = _numMemoryCells;
+	const size_t numGateRows = numMemoryCells * 4;
 
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++) {
-			_memoryCells[i]._synapses[si]._weight += error * _memoryCells[i]._synapses[si]._trace;
-			_memoryCells[i]._synapses[si]._trace = gammaLambda * _memoryCells[i]._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gPrimeTimesInputGate * _hiddenGroups[j][k]._output;
+	const float* pData = _arena._data.data();
 
-			si++;
-		}
+	const float scale = alpha / _arena._batchSize;
 
-		// Input
-		// coeff is unchanged from previous, since it is the same equation. Therefore the following line has been commented out
-		//coeff = (wKc + sum) * _memoryCells[i]._outputGate._output * hPrimeNet;
+	const float* pGateWeightGradients = pData + _arena._gateWeightGradients;
+	const float* pGateBiasGradients = pData + _arena._gateBiasGradients;
 
-		const float gTimesInputPrime = scaledSigmoidNetCEC * _memoryCells[i]._inputGate._output * (1.0f - _memoryCells[i]._inputGate._output);
+	for (size_t i = 0; i < _gateWeights.size(); i++)
+		_gateWeights[i] -= scale * pGateWeightGradients[i];
 
-		_memoryCells[i]._inputGate._bias._weight += error * _memoryCells[i]._inputGate._synapses[si]._trace;
-		_memoryCells[i]._inputGate._bias._trace = gammaLambda * _memoryCells[i]._inputGate._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-		_memoryCells[i]._inputGate._bias._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gTimesInputPrime;
+	for (size_t r = 0; r < numGateRows; r++)
+		_gateBiases[r] -= scale * pGateBiasGradients[r];
 
-		si = 0;
+	for (size_t i = 0; i < numOutputs; i++) {
+		for (size_t j = 0; j < hiddenSize; j++) {
+			const size_t n = i * hiddenSize + j;
 
-		for (size_t j = 0; j < _memoryCells.size(); j++) {
-			_memoryCells[i]._inputGate._synapses[si]._weight += error * _memoryCells[i]._inputGate._synapses[si]._trace;
-			_memoryCells[i]._inputGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._inputGate._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._inputGate._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gTimesInputPrime * _memoryCells[j]._output;
+			Node &node = _hiddenGroups[i][j];
 
-			si++;
-		}
+			const float* pWeightGradients = pData + _arena._hiddenWeightGradients + n * (numInputs + numMemoryCells);
 
-		for (size_t j = 0; j < _currentInputs.size(); j++) {
-			_memoryCells[i]._inputGate._synapses[si]._weight += error * _memoryCells[i]._inputGate._synapses[si]._trace;
-			_memoryCells[i]._inputGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._inputGate._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._inputGate._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gTimesInputPrime * _currentInputs[j];
+			for (size_t k = 0; k < node._synapses.size(); k++)
+				node._synapses[k]._weight -= scale * pWeightGradients[k];
 
-			si++;
+			node._bias._weight -= scale * pData[_arena._hiddenBiasGradients + n];
 		}
 
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++) {
-			_memoryCells[i]._inputGate._synapses[si]._weight += error * _memoryCells[i]._inputGate._synapses[si]._trace;
-			_memoryCells[i]._inputGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._inputGate._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._inputGate._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gTimesInputPrime * _hiddenGroups[j][k]._output;
-
-			si++;
-		}
+		Node &node = _outputNodes[i];
 
-		// Forget
-		// coeff is unchanged from previous, since it is the same equation. Therefore the following line has been commented out
-		//coeff = (wKc + sum) * _memoryCells[i]._outputGate._output * hPrimeNet;
+		const float* pWeightGradients = pData + _arena._outputWeightGradients + i * (hiddenSize + numMemoryCells);
 
-		const float stateTimesForgetPrime = _memoryCells[i]._state * _memoryCells[i]._forgetGate._output * (1.0f - _memoryCells[i]._forgetGate._output);
+		for (size_t k = 0; k < node._synapses.size(); k++)
+			node._synapses[k]._weight -= scale * pWeightGradients[k];
 
-		_memoryCells[i]._forgetGate._bias._weight += error * _memoryCells[i]._inputGate._synapses[si]._trace;
-		_memoryCells[i]._forgetGate._bias._trace = gammaLambda * _memoryCells[i]._inputGate._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-		_memoryCells[i]._forgetGate._bias._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + gTimesInputPrime;
+		node._bias._weight -= scale * pData[_arena._outputBiasGradients + i];
+	}
+}
 
-		si = 0;
+float LSTMNet::trainSequences(const std::vector<float> &inputs, const std::vector<float> &targets, size_t batchSize, size_t sequenceLength, size_t truncation, float alpha) {
+	const size_t numOutputs = _outputNodes.size();
+	const size_t numHidden = numOutputs * (numOutputs > 0 ? _hiddenGroups[0].size() : 0);
+	const size_t numMemoryCells = _numMemoryCells;
+	const size_t numGateRows = numMemoryCells * 4;
 
-		for (size_t j = 0; j < _memoryCells.size(); j++) {	
-			_memoryCells[i]._forgetGate._synapses[si]._weight += error * _memoryCells[i]._forgetGate._synapses[si]._trace;
-			_memoryCells[i]._forgetGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._forgetGate._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._forgetGate._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + stateTimesForgetPrime * _memoryCells[j]._output;
+	assert(inputs.size() == sequenceLength * batchSize * _currentInputs.size());
+	assert(targets.size() == sequenceLength * batchSize * numOutputs);
 
-			si++;
-		}
+	if (batchSize == 0 || sequenceLength == 0)
+		return 0.0f;
 
-		for (size_t j = 0; j < _currentInputs.size(); j++) {
-			_memoryCells[i]._forgetGate._synapses[si]._weight += error * _memoryCells[i]._forgetGate._synapses[si]._trace;
-			_memoryCells[i]._forgetGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._forgetGate._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._forgetGate._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + stateTimesForgetPrime * _currentInputs[j];
+	truncation = std::max<size_t>(1, std::min(truncation, sequenceLength));
 
-			si++;
-		}
+	allocateArena(batchSize, truncation);
 
-		for (size_t j = 0; j < _hiddenGroups.size(); j++)
-		for (size_t k = 0; k < _hiddenGroups[j].size(); k++) {
-			_memoryCells[i]._forgetGate._synapses[si]._weight += error * _memoryCells[i]._forgetGate._synapses[si]._trace;
-			_memoryCells[i]._forgetGate._synapses[si]._trace = gammaLambda * _memoryCells[i]._forgetGate._synapses[si]._trace + coeff * _memoryCells[i]._synapses[si]._derivative;
-			_memoryCells[i]._forgetGate._synapses[si]._derivative = _memoryCells[i]._synapses[si]._derivative * _memoryCells[i]._forgetGate._output + stateTimesForgetPrime * _hiddenGroups[j][k]._output;
+	float* pData = _arena._data.data();
 
-			si++;
-		}
-	}
+	// Sequences start from a cleared network
+	std::fill(pData + _arena._hiddenOutputs, pData + _arena._hiddenOutputs + batchSize * numHidden, 0.0f);
+	std::fill(pData + _arena._gateOutputs, pData + _arena._gateOutputs + batchSize * numGateRows, 0.0f);
+	std::fill(pData + _arena._cellStates, pData + _arena._cellStates + batchSize * numMemoryCells, 0.0f);
+	std::fill(pData + _arena._cellOutputs, pData + _arena._cellOutputs + batchSize * numMemoryCells, 0.0f);
 
-	// --------------------------------- Set Previous Outputs to Current ---------------------------------
+	float error = 0.0f;
 
-	for (size_t i = 0; i < _hiddenGroups.size(); i++)
-	for (size_t j = 0; j < _hiddenGroups[i].size(); j++)
-		_hiddenGroups[i][j]._prevOutput = _hiddenGroups[i][j]._output;
+	for (size_t firstStep = 0; firstStep < sequenceLength; firstStep += truncation) {
+		size_t numSteps = std::min(truncation, sequenceLength - firstStep);
 
-	for (size_t i = 0; i < _memoryCells.size(); i++) {
-		_memoryCells[i]._outputGate._prevOutput = _memoryCells[i]._outputGate._output;
-		_memoryCells[i]._forgetGate._prevOutput = _memoryCells[i]._forgetGate._output;
-		_memoryCells[i]._inputGate._prevOutput = _memoryCells[i]._inputGate._output;
+		forwardChunk(inputs.data(), targets.data(), firstStep, numSteps, error);
+		backwardChunk(inputs.data(), targets.data(), firstStep, numSteps);
+		applyGradients(alpha);
 
-		_memoryCells[i]._prevOutput = _memoryCells[i]._output;
+		// The last step becomes the carried in state of the next chunk
+		std::copy(pData + _arena._hiddenOutputs + numSteps * batchSize * numHidden, pData + _arena._hiddenOutputs + (numSteps + 1) * batchSize * numHidden, pData + _arena._hiddenOutputs);
+		std::copy(pData + _arena._gateOutputs + numSteps * batchSize * numGateRows, pData + _arena._gateOutputs + (numSteps + 1) * batchSize * numGateRows, pData + _arena._gateOutputs);
+		std::copy(pData + _arena._cellStates + numSteps * batchSize * numMemoryCells, pData + _arena._cellStates + (numSteps + 1) * batchSize * numMemoryCells, pData + _arena._cellStates);
+		std::copy(pData + _arena._cellOutputs + numSteps * batchSize * numMemoryCells, pData + _arena._cellOutputs + (numSteps + 1) * batchSize * numMemoryCells, pData + _arena._cellOutputs);
 	}
 
-	for (size_t i = 0; i < _outputNodes.size(); i++)
-		_outputNodes[i]._prevOutput = _outputNodes[i]._output;
+	return error / (batchSize * sequenceLength);
 }
\ No newline at end of file
@@ -32,12 +32,6 @@ namespace lstm {
 			float _trace;
 		};
 
-		struct MemorySynapse {
-			float _weight;
-			float _trace;
-			float _derivative;
-		};
-
 		struct Node {
 			std::vector<Synapse> _synapses;
 			Synapse _bias;
@@ -46,46 +40,103 @@ namespace lstm {
 			float _output;
 		};
 
-		struct MemoryNode {
-			std::vector<MemorySynapse> _synapses;
-			MemorySynapse _bias;
-
-			float _prevOutput;
-			float _output;
-		};
-
-		struct MemoryCell {
-			MemoryNode _inputGate;
-			Node _outputGate;
-			MemoryNode _forgetGate;
-
-			std::vector<MemorySynapse> _synapses;
-			MemorySynapse _bias;
-
-			float _net;
-			float _state;
-			float _prevOutput;
-			float _output;
-		};
-
 		static float sigmoid(float x) {
 			return 1.0f / (1.0f + std::exp(-x));
 		}
 
 	private:
+		// Activations and gradients of sequence training, one buffer that only grows. Offsets are in floats.
+		// Per step quantities have truncation + 1 slots (slot 0 is the state carried in from the previous chunk), each holding batchSize rows
+		struct SequenceArena {
+			size_t _batchSize;
+			size_t _truncation;
+
+			size_t _hiddenOutputs;
+			size_t _gateInputs;
+			size_t _gateOutputs;
+			size_t _cellStates;
+			size_t _cellOutputs;
+			size_t _outputs;
+
+			size_t _gateSumGradients;
+			size_t _gateInputGradients;
+			size_t _hiddenOutputGradients[2];
+			size_t _gateOutputGradients[2];
+			size_t _cellStateGradients[2];
+			size_t _cellOutputGradients[2];
+
+			size_t _gateWeightGradients;
+			size_t _gateBiasGradients;
+			size_t _hiddenWeightGradients;
+			size_t _hiddenBiasGradients;
+			size_t _outputWeightGradients;
+			size_t _outputBiasGradients;
+
+			std::vector<float> _data;
+
+			SequenceArena()
+				: _batchSize(0), _truncation(0)
+			{}
+		};
+
 		std::vector<Node> _outputNodes;
 		std::vector<std::vector<Node>> _hiddenGroups;
-		std::vector<MemoryCell> _memoryCells;
+
+		// Memory cells as one gate layer. Rows [0, M) are the output gates, [M, 2M) the input gates, [2M, 3M) the forget gates
+		// and [3M, 4M) the cell inputs, M being the number of memory cells.
+		// Weights, traces and derivatives are separate row-major [4M x numGateInputs] matrices
+		size_t _numMemoryCells;
+		size_t _numGateInputs;
+
+		std::vector<float> _gateWeights;
+		std::vector<float> _gateTraces;
+		std::vector<float> _gateDerivatives;
+
+		std::vector<float> _gateBiases;
+		std::vector<float> _gateBiasTraces;
+		std::vector<float> _gateBiasDerivatives;
+
+		// Gate activations (the cell input rows hold the squashed cell input), previous activations of the 3M gates
+		std::vector<float> _gateOutputs;
+		std::vector<float> _gatePrevOutputs;
+
+		std::vector<float> _cellStates;
+		std::vector<float> _cellOutputs;
+		std::vector<float> _cellPrevOutputs;
 
 		std::vector<float> _currentInputs;
 
+		// Gate layer input vector and weight update input vector
+		std::vector<float> _gateInputs;
+		std::vector<float> _updateInputs;
+
+		SequenceArena _arena;
+
+		void activate();
+		void update(const std::vector<float> &offsets, float error, float gammaLambda);
+
+		void allocateArena(size_t batchSize, size_t truncation);
+		void forwardChunk(const float* inputs, const float* targets, size_t firstStep, size_t numSteps, float &error);
+		void backwardChunk(const float* inputs, const float* targets, size_t firstStep, size_t numSteps);
+		void applyGradients(float alpha);
+
 	public:
+		LSTMNet()
+			: _numMemoryCells(0), _numGateInputs(0)
+		{}
+
 		void createRandom(size_t numInputs, size_t numOutputs, size_t hiddenSize, size_t numMemoryCells, float minWeight, float maxWeight, std::mt19937 &generator);
 
 		void step();
 		void updateQ(const std::vector<float> &targets, float error, float gammaLambda);
 		void stepReinforce(float error, float gammaLambda, float offsetStdDev, std::mt19937 &generator);
 
+		// Supervised truncated backpropagation through time over a batch of equal length sequences that start from a cleared network.
+		// inputs and targets are time-major: step t of sequence b starts at (t * batchSize + b) * getNumInputs() (getNumOutputs() for targets).
+		// Sequences are cut into chunks of truncation steps, weights move along the gradient of half the summed squared error (divided by batchSize) after each chunk.
+		// Runs on its own activations, the online state of the network is left as is. Returns the mean squared error per step and sequence
+		float trainSequences(const std::vector<float> &inputs, const std::vector<float> &targets, size_t batchSize, size_t sequenceLength, size_t truncation, float alpha);
+
 		void setInput(size_t index, float value) {
 			_currentInputs[index] = value;
 		}
@@ -109,5 +160,9 @@ namespace lstm {
 		size_t getHiddenSize() {
 			return _hiddenGroups[0].size();
 		}
+
+		size_t getNumMemoryCells() const {
+			return _numMemoryCells;
+		}
 	};
 }
\ No newline at end of file
@@ -22,7 +22,6 @@ misrepresented as being the original software.
 #include <nn/Cacla.h>
 #include <algorithm>
 #include <iostream>
-#include <SFML/Window.hpp>
 
 using namespace nn;
 
@@ -89,38 +88,32 @@ void Cacla::step(float reward, float dt) {
 
 	std::normal_distribution<float> pseudoRehearsalInputDistribution(_pseudoRehearsalSampleMean, _pseudoRehearsalSampleStdDev);
 
-	for (size_t i = 0; i < _numPseudoRehearsalSamplesActor; i++) {
-		// Generate actor sample
-		actorRehearsalSamples[i]._inputs.resize(_actor.getNumInputs());
-
-		for (size_t j = 0; j < _actor.getNumInputs(); j++) {
-			actorRehearsalSamples[i]._inputs[j] = pseudoRehearsalInputDistribution(_generator);
-			_actor.setInput(j, actorRehearsalSamples[i]._inputs[j]);
-		}
+	// Generate actor samples, evaluated as one batch
+	std::vector<float> rehearsalInputs(_numPseudoRehearsalSamplesActor * _actor.getNumInputs());
+	std::vector<float> rehearsalOutputs(_numPseudoRehearsalSamplesActor * _actor.getNumOutputs());
 
-		_actor.activateLinearOutputLayer();
+	for (size_t i = 0; i < rehearsalInputs.size(); i++)
+		rehearsalInputs[i] = pseudoRehearsalInputDistribution(_generator);
 
-		actorRehearsalSamples[i]._outputs.resize(_actor.getNumOutputs());
+	_actor.activateBatchLinearOutputLayer(rehearsalInputs.data(), _numPseudoRehearsalSamplesActor, rehearsalOutputs.data());
 
-		for (size_t j = 0; j < _actor.getNumOutputs(); j++)
-			actorRehearsalSamples[i]._outputs[j] = _actor.getOutput(j);
+	for (size_t i = 0; i < _numPseudoRehearsalSamplesActor; i++) {
+		actorRehearsalSamples[i]._inputs.assign(rehearsalInputs.begin() + i * _actor.getNumInputs(), rehearsalInputs.begin() + (i + 1) * _actor.getNumInputs());
+		actorRehearsalSamples[i]._outputs.assign(rehearsalOutputs.begin() + i * _actor.getNumOutputs(), rehearsalOutputs.begin() + (i + 1) * _actor.getNumOutputs());
 	}
 
-	for (size_t i = 0; i < _numPseudoRehearsalSamplesCritic; i++) {
-		// Generate critic sample
-		criticRehearsalSamples[i]._inputs.resize(_critic.getNumInputs());
+	// Generate critic samples, evaluated as one batch
+	rehearsalInputs.resize(_numPseudoRehearsalSamplesCritic * _critic.getNumInputs());
+	rehearsalOutputs.resize(_numPseudoRehearsalSamplesCritic * _critic.getNumOutputs());
 
-		for (size_t j = 0; j < _critic.getNumInputs(); j++) {
-			criticRehearsalSamples[i]._inputs[j] = pseudoRehearsalInputDistribution(_generator);
-			_critic.setInput(j, criticRehearsalSamples[i]._inputs[j]);
-		}
-
-		_critic.activateLinearOutputLayer();
+	for (size_t i = 0; i < rehearsalInputs.size(); i++)
+		rehearsalInputs[i] = pseudoRehearsalInputDistribution(_generator);
 
-		criticRehearsalSamples[i]._outputs.resize(_critic.getNumOutputs());
+	_critic.activateBatchLinearOutputLayer(rehearsalInputs.data(), _numPseudoRehearsalSamplesCritic, rehearsalOutputs.data());
 
-		for (size_t j = 0; j < _critic.getNumOutputs(); j++)
-			criticRehearsalSamples[i]._outputs[j] = _critic.getOutput(j);
+	for (size_t i = 0; i < _numPseudoRehearsalSamplesCritic; i++) {
+		criticRehearsalSamples[i]._inputs.assign(rehearsalInputs.begin() + i * _critic.getNumInputs(), rehearsalInputs.begin() + (i + 1) * _critic.getNumInputs());
+		criticRehearsalSamples[i]._outputs.assign(rehearsalOutputs.begin() + i * _critic.getNumOutputs(), rehearsalOutputs.begin() + (i + 1) * _critic.getNumOutputs());
 	}
 
 	float newPrevValue = reward + _gamma * value;
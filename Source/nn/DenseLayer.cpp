@@ -0,0 +1,391 @@
+/*
+AI Lib
+Copyright (C) 2014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <nn/DenseLayer.h>
+
+#include <algorithm>
+
+using namespace nn;
+
+float DenseLayer::weightedSum(const float* pWeights, const float* pInputs, size_t numInputs, float bias) {
+	// Sums in the same order as the per-synapse version so results are identical
+	float sum = bias;
+
+	for (size_t i = 0; i < numInputs; i++)
+		sum += pWeights[i] * pInputs[i];
+
+	return sum;
+}
+
+void DenseLayer::resize(size_t numInputs, size_t numOutputs) {
+	_numInputs = numInputs;
+
+	size_t numWeights = numInputs * numOutputs;
+
+	_weights.resize(numWeights, 0.0f);
+	_traces.resize(numWeights, 0.0f);
+	_tracesAdditional.resize(numWeights, 0.0f);
+
+	_biases.resize(numOutputs, 0.0f);
+	_biasTraces.resize(numOutputs, 0.0f);
+	_biasTracesAdditional.resize(numOutputs, 0.0f);
+
+	_outputs.resize(numOutputs, 0.0f);
+	_outputTraces.resize(numOutputs, 0.0f);
+}
+
+void DenseLayer::activate(const std::vector<float> &inputs, float activationMultiplier, float outputTraceDecay) {
+	const float* pWeights = _weights.data();
+
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++, pWeights += _numInputs) {
+		_outputs[n] = Neuron::sigmoid(activationMultiplier * weightedSum(pWeights, inputs.data(), _numInputs, _biases[n]));
+
+		_outputTraces[n] += (2.0f * _outputs[n] - 1.0f - _outputTraces[n]) * outputTraceDecay;
+	}
+}
+
+void DenseLayer::activateTraceless(const std::vector<float> &inputs, float activationMultiplier) {
+	const float* pWeights = _weights.data();
+
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++, pWeights += _numInputs)
+		_outputs[n] = Neuron::sigmoid(activationMultiplier * weightedSum(pWeights, inputs.data(), _numInputs, _biases[n]));
+}
+
+void DenseLayer::activateAndReinforce(const std::vector<float> &inputs, float activationMultiplier, float outputTraceDecay, float weightTraceDecay, float error) {
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++) {
+		float* pWeights = _weights.data() + n * _numInputs;
+		float* pTraces = _traces.data() + n * _numInputs;
+
+		_outputs[n] = Neuron::sigmoid(activationMultiplier * weightedSum(pWeights, inputs.data(), _numInputs, _biases[n]));
+
+		_outputTraces[n] += (2.0f * _outputs[n] - 1.0f - _outputTraces[n]) * outputTraceDecay;
+
+		float centered = 2.0f * _outputs[n] - 1.0f;
+
+		for (size_t i = 0; i < _numInputs; i++) {
+			pWeights[i] += error * pTraces[i];
+			pTraces[i] += -weightTraceDecay * pTraces[i] + centered * inputs[i];
+		}
+
+		_biases[n] += error * _biasTraces[n];
+		_biasTraces[n] += -weightTraceDecay * _biasTraces[n] + 2.0f * _outputs[n] - 1.0f;
+	}
+}
+
+void DenseLayer::activateAndReinforceTraceless(const std::vector<float> &inputs, float activationMultiplier, float error) {
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++) {
+		float* pWeights = _weights.data() + n * _numInputs;
+
+		_outputs[n] = Neuron::sigmoid(activationMultiplier * weightedSum(pWeights, inputs.data(), _numInputs, _biases[n]));
+
+		float delta = error * (2.0f * _outputs[n] - 1.0f);
+
+		for (size_t i = 0; i < _numInputs; i++)
+			pWeights[i] += delta * inputs[i];
+
+		_biases[n] += delta;
+	}
+}
+
+void DenseLayer::activateLinear(const std::vector<float> &inputs, float activationMultiplier) {
+	const float* pWeights = _weights.data();
+
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++, pWeights += _numInputs)
+		_outputs[n] = activationMultiplier * weightedSum(pWeights, inputs.data(), _numInputs, _biases[n]);
+}
+
+void DenseLayer::activateArp(const std::vector<float> &inputs, float activationMultiplier, std::mt19937 &generator) {
+	std::uniform_real_distribution<float> dist01(0.0f, 1.0f);
+
+	const float* pWeights = _weights.data();
+
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++, pWeights += _numInputs) {
+		// Firing probability
+		_outputTraces[n] = Neuron::sigmoid(activationMultiplier * weightedSum(pWeights, inputs.data(), _numInputs, _biases[n]));
+
+		_outputs[n] = dist01(generator) < _outputTraces[n] ? 1.0f : -1.0f;
+	}
+}
+
+void DenseLayer::reinforce(const std::vector<float> &inputs, float error, float weightTraceDecay) {
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++) {
+		float* pWeights = _weights.data() + n * _numInputs;
+		float* pTraces = _traces.data() + n * _numInputs;
+
+		float centered = 2.0f * _outputs[n] - 1.0f;
+
+		for (size_t i = 0; i < _numInputs; i++) {
+			pWeights[i] += error * pTraces[i];
+			pTraces[i] += -weightTraceDecay * pTraces[i] + centered * inputs[i];
+		}
+
+		_biases[n] += error * _biasTraces[n];
+		_biasTraces[n] += -weightTraceDecay * _biasTraces[n] + 2.0f * _outputs[n] - 1.0f;
+	}
+}
+
+void DenseLayer::reinforceTraceless(const std::vector<float> &inputs, float error) {
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++) {
+		float* pWeights = _weights.data() + n * _numInputs;
+
+		float delta = error * (2.0f * _outputs[n] - 1.0f);
+
+		for (size_t i = 0; i < _numInputs; i++)
+			pWeights[i] += delta * inputs[i];
+
+		_biases[n] += delta;
+	}
+}
+
+void DenseLayer::reinforceArp(const std::vector<float> &inputs, float reward, float alpha, float lambda) {
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++) {
+		float* pWeights = _weights.data() + n * _numInputs;
+
+		float expectedOutput = 2.0f * _outputTraces[n] - 1.0f;
+
+		float rewardTerm = reward * (_outputs[n] - expectedOutput);
+		float penaltyTerm = lambda * (1.0f - reward) * (-_outputs[n] - expectedOutput);
+
+		for (size_t i = 0; i < _numInputs; i++)
+			pWeights[i] += alpha * (rewardTerm * inputs[i] + penaltyTerm * inputs[i]);
+
+		_biases[n] += alpha * (rewardTerm + penaltyTerm);
+	}
+}
+
+void DenseLayer::reinforceArpWithTraces(const std::vector<float> &inputs, float reward, float alpha, float lambda, float weightTraceDecay) {
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++) {
+		float* pWeights = _weights.data() + n * _numInputs;
+		float* pTraces = _traces.data() + n * _numInputs;
+		float* pTracesAdditional = _tracesAdditional.data() + n * _numInputs;
+
+		float expectedOutput = 2.0f * _outputTraces[n] - 1.0f;
+
+		float rewardTerm = _outputs[n] - expectedOutput;
+		float penaltyTerm = -_outputs[n] - expectedOutput;
+
+		float penaltyScale = lambda * (1.0f - reward);
+
+		for (size_t i = 0; i < _numInputs; i++) {
+			pTraces[i] += -weightTraceDecay * pTraces[i] + rewardTerm * inputs[i];
+			pTracesAdditional[i] += -weightTraceDecay * pTracesAdditional[i] + penaltyTerm * inputs[i];
+			pWeights[i] += alpha * (reward * pTraces[i] + penaltyScale * pTracesAdditional[i]);
+		}
+
+		_biasTraces[n] += -weightTraceDecay * _biasTraces[n] + _outputs[n] - expectedOutput;
+		_biasTracesAdditional[n] += -weightTraceDecay * _biasTracesAdditional[n] - _outputs[n] - expectedOutput;
+		_biases[n] += alpha * (reward * _biasTraces[n] + penaltyScale * _biasTracesAdditional[n]);
+	}
+}
+
+void DenseLayer::reinforceArpMomentum(const std::vector<float> &inputs, float reward, float alpha, float lambda, float momentum) {
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++) {
+		float* pWeights = _weights.data() + n * _numInputs;
+		float* pTraces = _traces.data() + n * _numInputs;
+
+		float expectedOutput = 2.0f * _outputTraces[n] - 1.0f;
+
+		float rewardTerm = reward * (_outputs[n] - expectedOutput);
+		float penaltyTerm = lambda * (1.0f - reward) * (-_outputs[n] - expectedOutput);
+
+		for (size_t i = 0; i < _numInputs; i++) {
+			float dWeight = alpha * (rewardTerm * inputs[i] + penaltyTerm * inputs[i]) + momentum * pTraces[i];
+			pWeights[i] += dWeight;
+			pTraces[i] = dWeight;
+		}
+
+		float dBias = alpha * (rewardTerm + penaltyTerm) + momentum * _biasTraces[n];
+		_biases[n] += dBias;
+		_biasTraces[n] = dBias;
+	}
+}
+
+void DenseLayer::moveAlongGradient(const std::vector<float> &inputs, const std::vector<float> &gradient, float alpha) {
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++) {
+		float* pWeights = _weights.data() + n * _numInputs;
+
+		// Update bias
+		_biases[n] += alpha * gradient[n];
+
+		float scaledGradient = alpha * gradient[n];
+
+		for (size_t i = 0; i < _numInputs; i++)
+			pWeights[i] += scaledGradient * inputs[i];
+	}
+}
+
+void DenseLayer::moveAlongGradientSign(const std::vector<float> &inputs, const std::vector<float> &gradient, float alpha) {
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++) {
+		float* pWeights = _weights.data() + n * _numInputs;
+
+		// Update bias
+		_biases[n] += alpha * gradient[n];
+
+		for (size_t i = 0; i < _numInputs; i++)
+			pWeights[i] += gradient[n] * inputs[i] > 0.0f ? alpha : -alpha;
+	}
+}
+
+void DenseLayer::moveAlongGradientMomentum(const std::vector<float> &inputs, const std::vector<float> &gradient, float alpha, float momentum) {
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++) {
+		float* pWeights = _weights.data() + n * _numInputs;
+		float* pTraces = _traces.data() + n * _numInputs;
+
+		// Update bias
+		float dBias = alpha * gradient[n] + momentum * _biasTraces[n];
+
+		_biases[n] += dBias;
+		_biasTraces[n] = dBias;
+
+		float scaledGradient = alpha * gradient[n];
+
+		for (size_t i = 0; i < _numInputs; i++) {
+			float dWeight = scaledGradient * inputs[i] + momentum * pTraces[i];
+
+			pWeights[i] += dWeight;
+			pTraces[i] = dWeight;
+		}
+	}
+}
+
+void DenseLayer::updateTraces(const std::vector<float> &inputs, const std::vector<float> &gradient, float tdError, float alpha, float traceDecay) {
+	float scaledError = alpha * tdError;
+
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++) {
+		float* pWeights = _weights.data() + n * _numInputs;
+		float* pTraces = _traces.data() + n * _numInputs;
+
+		// Update bias
+		_biasTraces[n] += -traceDecay * _biasTraces[n] + gradient[n];
+		_biases[n] += scaledError * _biasTraces[n];
+
+		for (size_t i = 0; i < _numInputs; i++) {
+			pTraces[i] += -traceDecay * pTraces[i] + gradient[n] * inputs[i];
+			pWeights[i] += scaledError * pTraces[i];
+		}
+	}
+}
+
+void DenseLayer::backpropagate(const std::vector<float> &gradient, std::vector<float> &inputGradient) const {
+	inputGradient.assign(_numInputs, 0.0f);
+
+	// Row-wise accumulation keeps the weight reads sequential
+	const float* pWeights = _weights.data();
+
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++, pWeights += _numInputs) {
+		float g = gradient[n];
+
+		for (size_t i = 0; i < _numInputs; i++)
+			inputGradient[i] += g * pWeights[i];
+	}
+}
+
+void DenseLayer::decayWeights(float decay) {
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++)
+		_biases[n] += -decay * _biases[n];
+
+	for (size_t w = 0, numWeights = _weights.size(); w < numWeights; w++)
+		_weights[w] += -decay * _weights[w];
+}
+
+void DenseLayer::activateBatch(const float* inputs, size_t batchSize, float* outputs, float activationMultiplier, bool linear) const {
+	// Samples are processed in blocks so that each weight row is reused while it is in cache
+	const size_t blockSize = 16;
+
+	size_t numOutputs = getNumOutputs();
+
+	for (size_t blockStart = 0; blockStart < batchSize; blockStart += blockSize) {
+		size_t blockEnd = std::min(batchSize, blockStart + blockSize);
+
+		const float* pWeights = _weights.data();
+
+		for (size_t n = 0; n < numOutputs; n++, pWeights += _numInputs)
+		for (size_t b = blockStart; b < blockEnd; b++) {
+			float sum = activationMultiplier * weightedSum(pWeights, inputs + b * _numInputs, _numInputs, _biases[n]);
+
+			outputs[b * numOutputs + n] = linear ? sum : Neuron::sigmoid(sum);
+		}
+	}
+}
+
+void DenseLayer::backpropagateBatch(const float* gradients, size_t batchSize, float* inputGradients) const {
+	size_t numOutputs = getNumOutputs();
+
+	for (size_t b = 0; b < batchSize; b++) {
+		const float* pGradients = gradients + b * numOutputs;
+		float* pInputGradients = inputGradients + b * _numInputs;
+
+		std::fill(pInputGradients, pInputGradients + _numInputs, 0.0f);
+
+		const float* pWeights = _weights.data();
+
+		for (size_t n = 0; n < numOutputs; n++, pWeights += _numInputs) {
+			float g = pGradients[n];
+
+			for (size_t i = 0; i < _numInputs; i++)
+				pInputGradients[i] += g * pWeights[i];
+		}
+	}
+}
+
+void DenseLayer::accumulateGradientBatch(const float* inputs, const float* gradients, size_t batchSize, float* weightGradient, float* biasGradient) const {
+	size_t numOutputs = getNumOutputs();
+
+	// Row outer so each gradient row stays in cache while the batch is summed into it
+	for (size_t n = 0; n < numOutputs; n++) {
+		float* pWeightGradient = weightGradient + n * _numInputs;
+
+		for (size_t b = 0; b < batchSize; b++) {
+			float g = gradients[b * numOutputs + n];
+
+			const float* pInputs = inputs + b * _numInputs;
+
+			biasGradient[n] += g;
+
+			for (size_t i = 0; i < _numInputs; i++)
+				pWeightGradient[i] += g * pInputs[i];
+		}
+	}
+}
+
+void DenseLayer::moveAlongWeightGradient(const std::vector<float> &weightGradient, const std::vector<float> &biasGradient, float alpha) {
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++)
+		_biases[n] += alpha * biasGradient[n];
+
+	for (size_t w = 0, numWeights = _weights.size(); w < numWeights; w++)
+		_weights[w] += alpha * weightGradient[w];
+}
+
+void DenseLayer::moveAlongWeightGradientMomentum(const std::vector<float> &weightGradient, const std::vector<float> &biasGradient, float alpha, float momentum) {
+	for (size_t n = 0, numOutputs = getNumOutputs(); n < numOutputs; n++) {
+		float dBias = alpha * biasGradient[n] + momentum * _biasTraces[n];
+
+		_biases[n] += dBias;
+		_biasTraces[n] = dBias;
+	}
+
+	for (size_t w = 0, numWeights = _weights.size(); w < numWeights; w++) {
+		float dWeight = alpha * weightGradient[w] + momentum * _traces[w];
+
+		_weights[w] += dWeight;
+		_traces[w] = dWeight;
+	}
+}
@@ -0,0 +1,107 @@
+/*
+AI Lib
+Copyright (C) 2014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#pragma once
+
+#include <nn/Neuron.h>
+
+#include <random>
+#include <vector>
+
+namespace nn {
+	// Fully connected layer of neurons. Weights and their traces are stored as row-major matrices
+	// (one row of getNumInputs() entries per neuron), everything else as one array per quantity
+	class DenseLayer {
+	private:
+		size_t _numInputs;
+
+		static float weightedSum(const float* pWeights, const float* pInputs, size_t numInputs, float bias);
+
+	public:
+		std::vector<float> _weights;
+		std::vector<float> _traces;
+		std::vector<float> _tracesAdditional;
+
+		std::vector<float> _biases;
+		std::vector<float> _biasTraces;
+		std::vector<float> _biasTracesAdditional;
+
+		std::vector<float> _outputs;
+		std::vector<float> _outputTraces;
+
+		DenseLayer()
+			: _numInputs(0)
+		{}
+
+		// Resize all arrays, new entries are 0
+		void resize(size_t numInputs, size_t numOutputs);
+
+		// Activations, inputs are the outputs of the previous layer
+		void activate(const std::vector<float> &inputs, float activationMultiplier, float outputTraceDecay);
+		void activateTraceless(const std::vector<float> &inputs, float activationMultiplier);
+		void activateAndReinforce(const std::vector<float> &inputs, float activationMultiplier, float outputTraceDecay, float weightTraceDecay, float error);
+		void activateAndReinforceTraceless(const std::vector<float> &inputs, float activationMultiplier, float error);
+		void activateLinear(const std::vector<float> &inputs, float activationMultiplier);
+
+		void activateArp(const std::vector<float> &inputs, float activationMultiplier, std::mt19937 &generator);
+
+		// Stand-alone reinforce
+		void reinforce(const std::vector<float> &inputs, float error, float weightTraceDecay);
+		void reinforceTraceless(const std::vector<float> &inputs, float error);
+
+		// Associative reward-penalty (stochastic)
+		void reinforceArp(const std::vector<float> &inputs, float reward, float alpha, float lambda);
+		void reinforceArpWithTraces(const std::vector<float> &inputs, float reward, float alpha, float lambda, float weightTraceDecay);
+		void reinforceArpMomentum(const std::vector<float> &inputs, float reward, float alpha, float lambda, float momentum);
+
+		// Gradient descent, gradient has one entry per neuron
+		void moveAlongGradient(const std::vector<float> &inputs, const std::vector<float> &gradient, float alpha);
+		void moveAlongGradientSign(const std::vector<float> &inputs, const std::vector<float> &gradient, float alpha);
+		void moveAlongGradientMomentum(const std::vector<float> &inputs, const std::vector<float> &gradient, float alpha, float momentum);
+
+		// Eligibility trace update followed by weight update (TD(lambda))
+		void updateTraces(const std::vector<float> &inputs, const std::vector<float> &gradient, float tdError, float alpha, float traceDecay);
+
+		// Propagate gradient to the inputs (transposed matrix-vector product), no activation derivative applied
+		void backpropagate(const std::vector<float> &gradient, std::vector<float> &inputGradient) const;
+
+		void decayWeights(float decay);
+
+		// Minibatch kernels. All matrices are row-major with one row per sample
+		void activateBatch(const float* inputs, size_t batchSize, float* outputs, float activationMultiplier, bool linear) const;
+		void backpropagateBatch(const float* gradients, size_t batchSize, float* inputGradients) const;
+
+		// Adds the summed weight and bias gradients of the batch to weightGradient (row-major like _weights) and biasGradient
+		void accumulateGradientBatch(const float* inputs, const float* gradients, size_t batchSize, float* weightGradient, float* biasGradient) const;
+
+		// Gradient descent using accumulated weight-space gradients
+		void moveAlongWeightGradient(const std::vector<float> &weightGradient, const std::vector<float> &biasGradient, float alpha);
+		void moveAlongWeightGradientMomentum(const std::vector<float> &weightGradient, const std::vector<float> &biasGradient, float alpha, float momentum);
+
+		size_t getNumInputs() const {
+			return _numInputs;
+		}
+
+		size_t getNumOutputs() const {
+			return _biases.size();
+		}
+	};
+}
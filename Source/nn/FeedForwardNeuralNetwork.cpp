@@ -44,6 +44,16 @@ void FeedForwardNeuralNetwork::Gradient::setValue(float value) {
 		_hiddenLayersGradient[l][g] = value;
 }
 
+void FeedForwardNeuralNetwork::BatchGradient::setValue(float value) {
+	std::fill(_outputWeightGradient.begin(), _outputWeightGradient.end(), value);
+	std::fill(_outputBiasGradient.begin(), _outputBiasGradient.end(), value);
+
+	for (size_t l = 0; l < _hiddenLayersWeightGradient.size(); l++) {
+		std::fill(_hiddenLayersWeightGradient[l].begin(), _hiddenLayersWeightGradient[l].end(), value);
+		std::fill(_hiddenLayersBiasGradient[l].begin(), _hiddenLayersBiasGradient[l].end(), value);
+	}
+}
+
 void FeedForwardNeuralNetwork::BrownianPerturbationSet::update(float dt) {
 	for (BrownianPerturbation &p : _outputPerturbations)
 		p.update(_generator, dt);
@@ -71,96 +81,49 @@ void FeedForwardNeuralNetwork::BrownianPerturbationSet::reset() {
 		p.reset();
 }
 
-const FeedForwardNeuralNetwork &FeedForwardNeuralNetwork::operator=(const FeedForwardNeuralNetwork &other) {
-	_activationMultiplier = other._activationMultiplier;
-	_outputTraceDecay = other._outputTraceDecay;
-	_weightTraceDecay = other._weightTraceDecay;
+void FeedForwardNeuralNetwork::resizeLayers(size_t numInputs, size_t numOutputs,
+	size_t numHiddenLayers, size_t numNeuronsPerHiddenLayer)
+{
+	_inputs.resize(numInputs, 0.0f);
 
-	_inputs.resize(other.getNumInputs());
-	_outputs.resize(other.getNumOutputs());
+	_hidden.resize(numHiddenLayers);
 
-	if (other.getNumHiddenLayers() == 0) {
+	if (numHiddenLayers == 0) {
 		// Connect outputs directly to inputs
-		for (size_t n = 0; n < _outputs.size(); n++) {
-			_outputs[n]._output = other._outputs[n]._output;
-			_outputs[n]._outputTrace = other._outputs[n]._outputTrace;
-
-			_outputs[n]._bias = other._outputs[n]._bias;
-
-			_outputs[n]._synapses.resize(_inputs.size());
-
-			for (size_t i = 0; i < _inputs.size(); i++) {
-				_outputs[n]._synapses[i]._pInput = &_inputs[i];
-
-				_outputs[n]._synapses[i]._trace = other._outputs[n]._synapses[i]._trace;
-
-				_outputs[n]._synapses[i]._weight = other._outputs[n]._synapses[i]._weight;
-			}
-		}
-	} else {
-		_hidden.resize(other.getNumHiddenLayers());
-
+		_outputs.resize(numInputs, numOutputs);
+	}
+	else {
 		// First hidden layer
-		_hidden[0].resize(other.getNumNeuronsPerHiddenLayer());
-
-		for (size_t n = 0; n < _hidden[0].size(); n++) {
-			_hidden[0][n]._output = other._hidden[0][n]._output;
-			_hidden[0][n]._outputTrace = other._hidden[0][n]._outputTrace;
-
-			_hidden[0][n]._bias = other._hidden[0][n]._bias;
-
-			_hidden[0][n]._synapses.resize(_inputs.size());
-
-			for (size_t i = 0; i < _inputs.size(); i++) {
-				_hidden[0][n]._synapses[i]._pInput = &_inputs[i];
-
-				_hidden[0][n]._synapses[i]._trace = other._hidden[0][n]._synapses[i]._trace;
-
-				_hidden[0][n]._synapses[i]._weight = other._hidden[0][n]._synapses[i]._weight;
-			}
-		}
+		_hidden[0].resize(numInputs, numNeuronsPerHiddenLayer);
 
 		// All other hidden layers
-		for (size_t l = 1; l < other.getNumHiddenLayers(); l++) {
-			size_t prevLayerIndex = l - 1;
-
-			_hidden[l].resize(other.getNumNeuronsPerHiddenLayer());
+		for (size_t l = 1; l < numHiddenLayers; l++)
+			_hidden[l].resize(numNeuronsPerHiddenLayer, numNeuronsPerHiddenLayer);
 
-			for (size_t n = 0; n < _hidden[l].size(); n++) {
-				_hidden[l][n]._output = other._hidden[l][n]._output;
-				_hidden[l][n]._outputTrace = other._hidden[l][n]._outputTrace;
-
-				_hidden[l][n]._bias = other._hidden[l][n]._bias;
-
-				_hidden[l][n]._synapses.resize(other.getNumNeuronsPerHiddenLayer());
-
-				for (size_t i = 0; i < other.getNumNeuronsPerHiddenLayer(); i++) {
-					_hidden[l][n]._synapses[i]._pInput = &_hidden[prevLayerIndex][i];
-
-					_hidden[l][n]._synapses[i]._trace = other._hidden[l][n]._synapses[i]._trace;
-
-					_hidden[l][n]._synapses[i]._weight = other._hidden[l][n]._synapses[i]._weight;
-				}
-			}
-		}
-
-		for (size_t n = 0; n < _outputs.size(); n++) {
-			_outputs[n]._output = other._outputs[n]._output;
-			_outputs[n]._outputTrace = other._outputs[n]._outputTrace;
+		_outputs.resize(numNeuronsPerHiddenLayer, numOutputs);
+	}
+}
 
-			_outputs[n]._bias = other._outputs[n]._bias;
+const FeedForwardNeuralNetwork &FeedForwardNeuralNetwork::operator=(const FeedForwardNeuralNetwork &other) {
+	_activationMultiplier = other._activationMultiplier;
+	_outputTraceDecay = other._outputTraceDecay;
+	_weightTraceDecay = other._weightTraceDecay;
 
-			_outputs[n]._synapses.resize(other.getNumNeuronsPerHiddenLayer());
+	resizeLayers(other.getNumInputs(), other.getNumOutputs(), other.getNumHiddenLayers(), other.getNumNeuronsPerHiddenLayer());
 
-			for (size_t i = 0; i < other.getNumNeuronsPerHiddenLayer(); i++) {
-				_outputs[n]._synapses[i]._pInput = &_hidden.back()[i];
+	// Bias traces and additional traces are not part of the copied state
+	auto copyLayer = [](DenseLayer &layer, const DenseLayer &otherLayer) {
+		layer._weights = otherLayer._weights;
+		layer._traces = otherLayer._traces;
+		layer._biases = otherLayer._biases;
+		layer._outputs = otherLayer._outputs;
+		layer._outputTraces = otherLayer._outputTraces;
+	};
 
-				_outputs[n]._synapses[i]._trace = other._outputs[n]._synapses[i]._trace;
+	for (size_t l = 0; l < _hidden.size(); l++)
+		copyLayer(_hidden[l], other._hidden[l]);
 
-				_outputs[n]._synapses[i]._weight = other._outputs[n]._synapses[i]._weight;
-			}
-		}
-	}
+	copyLayer(_outputs, other._outputs);
 
 	return *this;
 }
@@ -169,69 +132,23 @@ void FeedForwardNeuralNetwork::createRandom(size_t numInputs, size_t numOutputs,
 	size_t numHiddenLayers, size_t numNeuronsPerHiddenLayer,
 	float minWeight, float maxWeight, std::mt19937 &generator)
 {
-	_inputs.resize(numInputs);
-	_outputs.resize(numOutputs);
+	resizeLayers(numInputs, numOutputs, numHiddenLayers, numNeuronsPerHiddenLayer);
 
 	std::uniform_real_distribution<float> distribution(minWeight, maxWeight);
 
-	if (numHiddenLayers == 0) {
-		// Connect outputs directly to inputs
-		for (Neuron &neuron : _outputs) {
-			neuron._bias = distribution(generator);
-
-			neuron._synapses.resize(numInputs);
+	auto randomizeLayer = [&](DenseLayer &layer) {
+		for (size_t n = 0; n < layer.getNumOutputs(); n++) {
+			layer._biases[n] = distribution(generator);
 
-			for (size_t i = 0; i < numInputs; i++) {
-				neuron._synapses[i]._pInput = &_inputs[i];
-				neuron._synapses[i]._weight = distribution(generator);
-			}
+			for (size_t i = 0; i < layer.getNumInputs(); i++)
+				layer._weights[n * layer.getNumInputs() + i] = distribution(generator);
 		}
-	} else {
-		_hidden.resize(numHiddenLayers);
+	};
 
-		// First hidden layer
-		_hidden[0].resize(numNeuronsPerHiddenLayer);
-
-		for (Neuron &neuron : _hidden[0]) {
-			neuron._bias = distribution(generator);
+	for (size_t l = 0; l < _hidden.size(); l++)
+		randomizeLayer(_hidden[l]);
 
-			neuron._synapses.resize(numInputs);
-
-			for (size_t i = 0; i < numInputs; i++) {
-				neuron._synapses[i]._pInput = &_inputs[i];
-				neuron._synapses[i]._weight = distribution(generator);
-			}
-		}
-
-		// All other hidden layers
-		for (size_t l = 1; l < numHiddenLayers; l++) {
-			size_t prevLayerIndex = l - 1;
-
-			_hidden[l].resize(numNeuronsPerHiddenLayer);
-
-			for (Neuron &neuron : _hidden[l]) {
-				neuron._bias = distribution(generator);
-
-				neuron._synapses.resize(numNeuronsPerHiddenLayer);
-
-				for (size_t i = 0; i < numNeuronsPerHiddenLayer; i++) {
-					neuron._synapses[i]._pInput = &_hidden[prevLayerIndex][i];
-					neuron._synapses[i]._weight = distribution(generator);
-				}
-			}
-		}
-
-		for (Neuron &neuron : _outputs) {
-			neuron._bias = distribution(generator);
-
-			neuron._synapses.resize(numNeuronsPerHiddenLayer);
-
-			for (size_t i = 0; i < numNeuronsPerHiddenLayer; i++) {
-				neuron._synapses[i]._pInput = &_hidden.back()[i];
-				neuron._synapses[i]._weight = distribution(generator);
-			}
-		}
-	}
+	randomizeLayer(_outputs);
 }
 
 void FeedForwardNeuralNetwork::createFromParents(const FeedForwardNeuralNetwork &parent1, const FeedForwardNeuralNetwork &parent2,
@@ -245,88 +162,30 @@ void FeedForwardNeuralNetwork::createFromParents(const FeedForwardNeuralNetwork
 	_outputTraceDecay = parent1._outputTraceDecay;
 	_weightTraceDecay = parent1._weightTraceDecay;
 
-	_inputs.resize(parent1.getNumInputs());
-	_outputs.resize(parent1.getNumOutputs());
-
-	if (parent1.getNumHiddenLayers() == 0) {
-		// Connect outputs directly to inputs
-		for (size_t n = 0; n < _outputs.size(); n++) {
-			_outputs[n]._bias = distribution(generator) < averageWeightsChance ?
-				(parent1._outputs[n]._bias + parent2._outputs[n]._bias) * 0.5f :
-				(distribution(generator) < 0.5f ? parent1._outputs[n]._bias : parent2._outputs[n]._bias);
-
-			_outputs[n]._synapses.resize(_inputs.size());
-
-			for (size_t i = 0; i < _inputs.size(); i++) {
-				_outputs[n]._synapses[i]._pInput = &_inputs[i];
-
-				_outputs[n]._synapses[i]._weight = distribution(generator) < averageWeightsChance ?
-					(parent1._outputs[n]._synapses[i]._weight + parent2._outputs[n]._synapses[i]._weight) * 0.5f :
-					(distribution(generator) < 0.5f ? parent1._outputs[n]._synapses[i]._weight : parent2._outputs[n]._synapses[i]._weight);
-			}
-		}
-	} else {
-		_hidden.resize(parent1.getNumHiddenLayers());
-
-		// First hidden layer
-		_hidden[0].resize(parent1.getNumNeuronsPerHiddenLayer());
+	resizeLayers(parent1.getNumInputs(), parent1.getNumOutputs(), parent1.getNumHiddenLayers(), parent1.getNumNeuronsPerHiddenLayer());
 
-		for (size_t n = 0; n < _hidden[0].size(); n++) {
-			_hidden[0][n]._bias = distribution(generator) < averageWeightsChance ?
-				(parent1._hidden[0][n]._bias + parent2._hidden[0][n]._bias) * 0.5f :
-				(distribution(generator) < 0.5f ? parent1._hidden[0][n]._bias : parent2._hidden[0][n]._bias);
+	auto crossover = [&](float value1, float value2) -> float {
+		return distribution(generator) < averageWeightsChance ?
+			(value1 + value2) * 0.5f :
+			(distribution(generator) < 0.5f ? value1 : value2);
+	};
 
-			_hidden[0][n]._synapses.resize(_inputs.size());
+	auto crossoverLayer = [&](DenseLayer &layer, const DenseLayer &layer1, const DenseLayer &layer2) {
+		for (size_t n = 0; n < layer.getNumOutputs(); n++) {
+			layer._biases[n] = crossover(layer1._biases[n], layer2._biases[n]);
 
-			for (size_t i = 0; i < _inputs.size(); i++) {
-				_hidden[0][n]._synapses[i]._pInput = &_inputs[i];
+			for (size_t i = 0; i < layer.getNumInputs(); i++) {
+				size_t w = n * layer.getNumInputs() + i;
 
-				_hidden[0][n]._synapses[i]._weight = distribution(generator) < averageWeightsChance ?
-					(parent1._hidden[0][n]._synapses[i]._weight + parent2._hidden[0][n]._synapses[i]._weight) * 0.5f :
-					(distribution(generator) < 0.5f ? parent1._hidden[0][n]._synapses[i]._weight : parent2._hidden[0][n]._synapses[i]._weight);
+				layer._weights[w] = crossover(layer1._weights[w], layer2._weights[w]);
 			}
 		}
+	};
 
-		// All other hidden layers
-		for (size_t i = 1; i < parent1.getNumHiddenLayers(); i++) {
-			size_t prevLayerIndex = i - 1;
-
-			_hidden[i].resize(parent1.getNumNeuronsPerHiddenLayer());
-
-			for (size_t n = 0; n < _hidden[i].size(); n++) {
-				_hidden[i][n]._bias = distribution(generator) < averageWeightsChance ?
-					(parent1._hidden[i][n]._bias + parent2._hidden[i][n]._bias) * 0.5f :
-					(distribution(generator) < 0.5f ? parent1._hidden[i][n]._bias : parent2._hidden[i][n]._bias);
-
+	for (size_t l = 0; l < _hidden.size(); l++)
+		crossoverLayer(_hidden[l], parent1._hidden[l], parent2._hidden[l]);
 
-				_hidden[i][n]._synapses.resize(parent1.getNumNeuronsPerHiddenLayer());
-
-				for (size_t i = 0; i < parent1.getNumNeuronsPerHiddenLayer(); i++) {
-					_hidden[i][n]._synapses[i]._pInput = &_hidden[prevLayerIndex][i];
-
-					_hidden[i][n]._synapses[i]._weight = distribution(generator) < averageWeightsChance ?
-						(parent1._hidden[i][n]._synapses[i]._weight + parent2._hidden[i][n]._synapses[i]._weight) * 0.5f :
-						(distribution(generator) < 0.5f ? parent1._hidden[i][n]._synapses[i]._weight : parent2._hidden[i][n]._synapses[i]._weight);
-				}
-			}
-		}
-
-		for (size_t n = 0; n < _outputs.size(); n++) {
-			_outputs[n]._bias = distribution(generator) < averageWeightsChance ?
-				(parent1._outputs[n]._bias + parent2._outputs[n]._bias) * 0.5f :
-				(distribution(generator) < 0.5f ? parent1._outputs[n]._bias : parent2._outputs[n]._bias);
-
-			_outputs[n]._synapses.resize(parent1.getNumNeuronsPerHiddenLayer());
-
-			for (size_t i = 0; i < parent1.getNumNeuronsPerHiddenLayer(); i++) {
-				_outputs[n]._synapses[i]._pInput = &_hidden.back()[i];
-
-				_outputs[n]._synapses[i]._weight = distribution(generator) < averageWeightsChance ?
-					(parent1._outputs[n]._synapses[i]._weight + parent2._outputs[n]._synapses[i]._weight) * 0.5f :
-					(distribution(generator) < 0.5f ? parent1._outputs[n]._synapses[i]._weight : parent2._outputs[n]._synapses[i]._weight);
-			}
-		}
-	}
+	crossoverLayer(_outputs, parent1._outputs, parent2._outputs);
 }
 
 void FeedForwardNeuralNetwork::mutate(float weightMutationChance, float maxWeightPerturbation, unsigned long seed) {
@@ -335,158 +194,113 @@ void FeedForwardNeuralNetwork::mutate(float weightMutationChance, float maxWeigh
 	std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
 	std::uniform_real_distribution<float> distributionPerturb(-maxWeightPerturbation, maxWeightPerturbation);
 
-	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (Neuron &n : _hidden[l]) {
-		n._bias += distribution(generator) < weightMutationChance ? distributionPerturb(generator) : 0.0f;
+	auto mutateLayer = [&](DenseLayer &layer) {
+		for (size_t n = 0; n < layer.getNumOutputs(); n++) {
+			layer._biases[n] += distribution(generator) < weightMutationChance ? distributionPerturb(generator) : 0.0f;
 
-		for (Neuron::Synapse &s : n._synapses)
-			s._weight += distribution(generator) < weightMutationChance ? distributionPerturb(generator) : 0.0f;
-	}
+			for (size_t i = 0; i < layer.getNumInputs(); i++)
+				layer._weights[n * layer.getNumInputs() + i] += distribution(generator) < weightMutationChance ? distributionPerturb(generator) : 0.0f;
+		}
+	};
 
-	for (Neuron &n : _outputs) {
-		n._bias += distribution(generator) < weightMutationChance ? distributionPerturb(generator) : 0.0f;
+	for (size_t l = 0; l < getNumHiddenLayers(); l++)
+		mutateLayer(_hidden[l]);
 
-		for (Neuron::Synapse &s : n._synapses)
-			s._weight += distribution(generator) < weightMutationChance ? distributionPerturb(generator) : 0.0f;
-	}
+	mutateLayer(_outputs);
 }
 
 void FeedForwardNeuralNetwork::activate() {
-	for (Sensor &s : _inputs)
-		s.activate(_activationMultiplier, _outputTraceDecay);
-
 	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (Neuron &n : _hidden[l])
-		n.activate(_activationMultiplier, _outputTraceDecay);
+		_hidden[l].activate(getHiddenLayerInputs(l), _activationMultiplier, _outputTraceDecay);
 
-	for (Neuron &n : _outputs)
-		n.activate(_activationMultiplier, _outputTraceDecay);
+	_outputs.activate(getOutputLayerInputs(), _activationMultiplier, _outputTraceDecay);
 }
 
 void FeedForwardNeuralNetwork::activateTraceless() {
 	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (Neuron &n : _hidden[l])
-		n.activateTraceless(_activationMultiplier);
+		_hidden[l].activateTraceless(getHiddenLayerInputs(l), _activationMultiplier);
 
-	for (Neuron &n : _outputs)
-		n.activateTraceless(_activationMultiplier);
+	_outputs.activateTraceless(getOutputLayerInputs(), _activationMultiplier);
 }
 
 void FeedForwardNeuralNetwork::activateAndReinforce(float error) {
-	for (Sensor &s : _inputs)
-		s.activate(_activationMultiplier, _outputTraceDecay);
-
 	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (Neuron &n : _hidden[l])
-		n.activateAndReinforce(_activationMultiplier, _outputTraceDecay, _weightTraceDecay, error);
+		_hidden[l].activateAndReinforce(getHiddenLayerInputs(l), _activationMultiplier, _outputTraceDecay, _weightTraceDecay, error);
 
-	for (Neuron &n : _outputs)
-		n.activateAndReinforce(_activationMultiplier, _outputTraceDecay, _weightTraceDecay, error);
+	_outputs.activateAndReinforce(getOutputLayerInputs(), _activationMultiplier, _outputTraceDecay, _weightTraceDecay, error);
 }
 
 void FeedForwardNeuralNetwork::activateAndReinforceTraceless(float error) {
 	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (Neuron &n : _hidden[l])
-		n.activateAndReinforceTraceless(_activationMultiplier, error);
+		_hidden[l].activateAndReinforceTraceless(getHiddenLayerInputs(l), _activationMultiplier, error);
 
-	for (Neuron &n : _outputs)
-		n.activateAndReinforceTraceless(_activationMultiplier, error);
+	_outputs.activateAndReinforceTraceless(getOutputLayerInputs(), _activationMultiplier, error);
 }
 
 void FeedForwardNeuralNetwork::activateLinearOutputLayer() {
-	for (Sensor &s : _inputs)
-		s.activate(_activationMultiplier, _outputTraceDecay);
-
 	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (Neuron &n : _hidden[l])
-		n.activate(_activationMultiplier, _outputTraceDecay);
+		_hidden[l].activate(getHiddenLayerInputs(l), _activationMultiplier, _outputTraceDecay);
 
-	for (Neuron &n : _outputs)
-		n.activateLinear(_activationMultiplier);
+	_outputs.activateLinear(getOutputLayerInputs(), _activationMultiplier);
 }
 
 void FeedForwardNeuralNetwork::activateArp(std::mt19937 &generator) {
-	for (Sensor &s : _inputs)
-		s.activateArp(_activationMultiplier, _outputTraceDecay);
-
 	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (size_t n = 0; n < getNumNeuronsPerHiddenLayer(); n++)
-		_hidden[l][n].activateArp(_activationMultiplier, _outputTraceDecay, generator);
+		_hidden[l].activateArp(getHiddenLayerInputs(l), _activationMultiplier, generator);
 
-	for (size_t n = 0; n < getNumOutputs(); n++)
-		_outputs[n].activateArp(_activationMultiplier, _outputTraceDecay, generator);
+	_outputs.activateArp(getOutputLayerInputs(), _activationMultiplier, generator);
 }
 
 void FeedForwardNeuralNetwork::reinforce(float error) {
 	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (Neuron &n : _hidden[l])
-		n.reinforce(error, _weightTraceDecay);
+		_hidden[l].reinforce(getHiddenLayerInputs(l), error, _weightTraceDecay);
 
-	for (Neuron &n : _outputs)
-		n.reinforce(error, _weightTraceDecay);
+	_outputs.reinforce(getOutputLayerInputs(), error, _weightTraceDecay);
 }
 
 void FeedForwardNeuralNetwork::reinforceTraceless(float error) {
 	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (Neuron &n : _hidden[l])
-		n.reinforceTraceless(error);
+		_hidden[l].reinforceTraceless(getHiddenLayerInputs(l), error);
 
-	for (Neuron &n : _outputs)
-		n.reinforceTraceless(error);
+	_outputs.reinforceTraceless(getOutputLayerInputs(), error);
 }
 
 void FeedForwardNeuralNetwork::reinforceArp(float reward, float alpha, float lambda) {
 	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (Neuron &n : _hidden[l])
-		n.reinforceArp(reward, alpha, lambda);
+		_hidden[l].reinforceArp(getHiddenLayerInputs(l), reward, alpha, lambda);
 
-	for (Neuron &n : _outputs)
-		n.reinforceArp(reward, alpha, lambda);
+	_outputs.reinforceArp(getOutputLayerInputs(), reward, alpha, lambda);
 }
 
 void FeedForwardNeuralNetwork::reinforceArpWithTraces(float reward, float alpha, float lambda) {
 	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (Neuron &n : _hidden[l])
-		n.reinforceArpWithTraces(reward, alpha, lambda, _weightTraceDecay);
+		_hidden[l].reinforceArpWithTraces(getHiddenLayerInputs(l), reward, alpha, lambda, _weightTraceDecay);
 
-	for (Neuron &n : _outputs)
-		n.reinforceArpWithTraces(reward, alpha, lambda, _weightTraceDecay);
+	_outputs.reinforceArpWithTraces(getOutputLayerInputs(), reward, alpha, lambda, _weightTraceDecay);
 }
 
 void FeedForwardNeuralNetwork::reinforceArpMomentum(float reward, float alpha, float lambda, float momentum) {
 	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (Neuron &n : _hidden[l])
-		n.reinforceArpMomentum(reward, alpha, lambda, momentum);
+		_hidden[l].reinforceArpMomentum(getHiddenLayerInputs(l), reward, alpha, lambda, momentum);
 
-	for (Neuron &n : _outputs)
-		n.reinforceArpMomentum(reward, alpha, lambda, momentum);
+	_outputs.reinforceArpMomentum(getOutputLayerInputs(), reward, alpha, lambda, momentum);
 }
 
 void FeedForwardNeuralNetwork::zeroTraces() {
-	for (Sensor &s : _inputs)
-		s._outputTrace = 0.0f;
-
-	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (Neuron &n : _hidden[l]) {
-		n._outputTrace = 0.0f;
-
-		for (Neuron::Synapse &s : n._synapses)
-			s._trace = 0.0f;
+	for (size_t l = 0; l < getNumHiddenLayers(); l++) {
+		std::fill(_hidden[l]._outputTraces.begin(), _hidden[l]._outputTraces.end(), 0.0f);
+		std::fill(_hidden[l]._traces.begin(), _hidden[l]._traces.end(), 0.0f);
 	}
 
-	for (Neuron &n : _outputs) {
-		n._outputTrace = 0.0f;
-
-		for (Neuron::Synapse &s : n._synapses)
-			s._trace = 0.0f;
-	}
+	std::fill(_outputs._outputTraces.begin(), _outputs._outputTraces.end(), 0.0f);
+	std::fill(_outputs._traces.begin(), _outputs._traces.end(), 0.0f);
 }
 
 void FeedForwardNeuralNetwork::getGradient(const std::vector<float> &targets, Gradient &grad) {
 	std::vector<float> error(targets.size());
 
 	for (size_t n = 0; n < getNumOutputs(); n++)
-		error[n] = targets[n] - _outputs[n]._output;
+		error[n] = targets[n] - _outputs._outputs[n];
 
 	getGradientFromError(error, grad);
 }
@@ -496,13 +310,13 @@ void FeedForwardNeuralNetwork::getGradientLinearOutputLayer(const std::vector<fl
 	std::vector<float> error(targets.size());
 
 	for (size_t n = 0; n < getNumOutputs(); n++)
-		error[n] = targets[n] - _outputs[n]._output;
+		error[n] = targets[n] - _outputs._outputs[n];
 
 	getGradientFromError(error, grad);
 }
 
 void FeedForwardNeuralNetwork::getGradientFromError(const std::vector<float> &error, Gradient &grad) {
-	grad._outputGradient.resize(_outputs.size());
+	grad._outputGradient.resize(getNumOutputs());
 
 	for (size_t n = 0; n < getNumOutputs(); n++)
 		grad._outputGradient[n] = error[n];
@@ -510,39 +324,28 @@ void FeedForwardNeuralNetwork::getGradientFromError(const std::vector<float> &er
 	if (!_hidden.empty()) {
 		grad._hiddenLayersGradient.resize(_hidden.size());
 
-		for (size_t l = 0; l < getNumHiddenLayers(); l++)
-			grad._hiddenLayersGradient[l].resize(getNumNeuronsPerHiddenLayer());
-
 		size_t lastHiddenLayerIndex = _hidden.size() - 1;
 
 		// Last hidden layer
-		for (size_t n = 0; n < getNumNeuronsPerHiddenLayer(); n++) {
-			float sum = 0.0f;
+		_outputs.backpropagate(grad._outputGradient, grad._hiddenLayersGradient[lastHiddenLayerIndex]);
 
-			for (size_t c = 0; c < getNumOutputs(); c++)
-				sum += grad._outputGradient[c] * _outputs[c]._synapses[n]._weight;
-
-			grad._hiddenLayersGradient[lastHiddenLayerIndex][n] = sum * _hidden[lastHiddenLayerIndex][n]._output * (1.0f - _hidden[lastHiddenLayerIndex][n]._output);
-		}
+		for (size_t n = 0; n < getNumNeuronsPerHiddenLayer(); n++)
+			grad._hiddenLayersGradient[lastHiddenLayerIndex][n] = grad._hiddenLayersGradient[lastHiddenLayerIndex][n] * _hidden[lastHiddenLayerIndex]._outputs[n] * (1.0f - _hidden[lastHiddenLayerIndex]._outputs[n]);
 
 		// All other hidden layers
 		for (int l = static_cast<int>(getNumHiddenLayers()) - 2; l >= 0; l--) {
 			int nextLayerIndex = l + 1;
 
-			for (size_t n = 0; n < getNumNeuronsPerHiddenLayer(); n++) {
-				float sum = 0.0f;
-
-				for (size_t c = 0; c < getNumNeuronsPerHiddenLayer(); c++)
-					sum += grad._hiddenLayersGradient[nextLayerIndex][c] * _hidden[nextLayerIndex][c]._synapses[n]._weight;
+			_hidden[nextLayerIndex].backpropagate(grad._hiddenLayersGradient[nextLayerIndex], grad._hiddenLayersGradient[l]);
 
-				grad._hiddenLayersGradient[l][n] = sum * _hidden[l][n]._output * (1.0f - _hidden[l][n]._output);
-			}
+			for (size_t n = 0; n < getNumNeuronsPerHiddenLayer(); n++)
+				grad._hiddenLayersGradient[l][n] = grad._hiddenLayersGradient[l][n] * _hidden[l]._outputs[n] * (1.0f - _hidden[l]._outputs[n]);
 		}
 	}
 }
 
 void FeedForwardNeuralNetwork::getEmptyGradient(Gradient &grad) {
-	grad._outputGradient.resize(_outputs.size());
+	grad._outputGradient.resize(getNumOutputs());
 
 	if (!_hidden.empty()) {
 		grad._hiddenLayersGradient.resize(_hidden.size());
@@ -555,189 +358,162 @@ void FeedForwardNeuralNetwork::getEmptyGradient(Gradient &grad) {
 void FeedForwardNeuralNetwork::moveAlongGradient(const Gradient &grad, float alpha) {
 	// Update weights
 	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (size_t n = 0; n < getNumNeuronsPerHiddenLayer(); n++) {
-		// Update bias
-		_hidden[l][n]._bias += alpha * grad._hiddenLayersGradient[l][n];
-
-		for (size_t c = 0; c < _hidden[l][n]._synapses.size(); c++)
-			_hidden[l][n]._synapses[c]._weight += alpha * grad._hiddenLayersGradient[l][n] * _hidden[l][n]._synapses[c]._pInput->_output;
-	}
-
-	// Update weights
-	for (size_t n = 0; n < getNumOutputs(); n++) {
-		// Update bias
-		_outputs[n]._bias += alpha * grad._outputGradient[n];
+		_hidden[l].moveAlongGradient(getHiddenLayerInputs(l), grad._hiddenLayersGradient[l], alpha);
 
-		for (size_t c = 0; c < _outputs[n]._synapses.size(); c++)
-			_outputs[n]._synapses[c]._weight += alpha * grad._outputGradient[n] * _outputs[n]._synapses[c]._pInput->_output;
-	}
+	_outputs.moveAlongGradient(getOutputLayerInputs(), grad._outputGradient, alpha);
 }
 
 void FeedForwardNeuralNetwork::moveAlongGradientSign(const Gradient &grad, float alpha) {
 	// Update weights
 	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (size_t n = 0; n < getNumNeuronsPerHiddenLayer(); n++) {
-		// Update bias
-		_hidden[l][n]._bias += alpha * grad._hiddenLayersGradient[l][n];
-
-		for (size_t c = 0; c < _hidden[l][n]._synapses.size(); c++)
-			_hidden[l][n]._synapses[c]._weight += grad._hiddenLayersGradient[l][n] * _hidden[l][n]._synapses[c]._pInput->_output > 0.0f ? alpha : -alpha;
-	}
+		_hidden[l].moveAlongGradientSign(getHiddenLayerInputs(l), grad._hiddenLayersGradient[l], alpha);
 
-	// Update weights
-	for (size_t n = 0; n < getNumOutputs(); n++) {
-		// Update bias
-		_outputs[n]._bias += alpha * grad._outputGradient[n];
-
-		for (size_t c = 0; c < _outputs[n]._synapses.size(); c++)
-			_outputs[n]._synapses[c]._weight += grad._outputGradient[n] * _outputs[n]._synapses[c]._pInput->_output > 0.0f ? alpha : -alpha;
-	}
+	_outputs.moveAlongGradientSign(getOutputLayerInputs(), grad._outputGradient, alpha);
 }
 
 void FeedForwardNeuralNetwork::moveAlongGradientMomentum(const Gradient &grad, float alpha, float momentum) {
 	// Update weights
 	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (size_t n = 0; n < getNumNeuronsPerHiddenLayer(); n++) {
-		// Update bias
-		float dBias = alpha * grad._hiddenLayersGradient[l][n] + momentum * _hidden[l][n]._biasTrace;
+		_hidden[l].moveAlongGradientMomentum(getHiddenLayerInputs(l), grad._hiddenLayersGradient[l], alpha, momentum);
+
+	_outputs.moveAlongGradientMomentum(getOutputLayerInputs(), grad._outputGradient, alpha, momentum);
+}
 
-		_hidden[l][n]._bias += dBias;
-		_hidden[l][n]._biasTrace = dBias;
+void FeedForwardNeuralNetwork::propagateBatch(const float* inputs, size_t batchSize, float* outputs, bool linearOutputLayer) {
+	_batchSize = batchSize;
 
-		for (size_t c = 0; c < _hidden[l][n]._synapses.size(); c++) {
-			float dWeight = alpha * grad._hiddenLayersGradient[l][n] * _hidden[l][n]._synapses[c]._pInput->_output + momentum * _hidden[l][n]._synapses[c]._trace;
+	_batchInputs.assign(inputs, inputs + batchSize * getNumInputs());
 
-			_hidden[l][n]._synapses[c]._weight += dWeight;
-			_hidden[l][n]._synapses[c]._trace = dWeight;
-		}
-	}
+	_batchHiddenOutputs.resize(_hidden.size());
 
-	// Update weights
-	for (size_t n = 0; n < getNumOutputs(); n++) {
-		// Update bias
-		float dBias = alpha * grad._outputGradient[n] + momentum * _outputs[n]._biasTrace;
+	const float* pLayerInputs = _batchInputs.data();
 
-		_outputs[n]._bias += dBias;
-		_outputs[n]._biasTrace = dBias;
+	for (size_t l = 0; l < _hidden.size(); l++) {
+		_batchHiddenOutputs[l].resize(batchSize * _hidden[l].getNumOutputs());
 
-		for (size_t c = 0; c < _outputs[n]._synapses.size(); c++) {
-			float dWeight = alpha * grad._outputGradient[n] * _outputs[n]._synapses[c]._pInput->_output + momentum * _outputs[n]._synapses[c]._trace;
+		_hidden[l].activateBatch(pLayerInputs, batchSize, _batchHiddenOutputs[l].data(), _activationMultiplier, false);
 
-			_outputs[n]._synapses[c]._weight += dWeight;
-			_outputs[n]._synapses[c]._trace = dWeight;
-		}
+		pLayerInputs = _batchHiddenOutputs[l].data();
 	}
+
+	_batchOutputs.resize(batchSize * getNumOutputs());
+
+	_outputs.activateBatch(pLayerInputs, batchSize, _batchOutputs.data(), _activationMultiplier, linearOutputLayer);
+
+	if (outputs != nullptr)
+		std::copy(_batchOutputs.begin(), _batchOutputs.end(), outputs);
 }
 
-void FeedForwardNeuralNetwork::storeCurrentOutputsInTraces() {
-	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (size_t n = 0; n < getNumNeuronsPerHiddenLayer(); n++)
-		_hidden[l][n]._outputTrace = _hidden[l][n]._output;
+void FeedForwardNeuralNetwork::activateBatch(const float* inputs, size_t batchSize, float* outputs) {
+	propagateBatch(inputs, batchSize, outputs, false);
+}
 
-	for (size_t n = 0; n < getNumOutputs(); n++)
-		_outputs[n]._outputTrace = _outputs[n]._output;
+void FeedForwardNeuralNetwork::activateBatchLinearOutputLayer(const float* inputs, size_t batchSize, float* outputs) {
+	propagateBatch(inputs, batchSize, outputs, true);
 }
 
-void FeedForwardNeuralNetwork::updateValueFunction(float tdError, float alpha, float traceDecay) {
-	Gradient grad;
-	getGradientFromError(std::vector<float>(1, 1.0f), grad);
+void FeedForwardNeuralNetwork::accumulateGradientBatch(const float* targets, BatchGradient &grad) {
+	_batchOutputGradients.resize(_batchOutputs.size());
 
-	// Update weights
-	for (size_t n = 0; n < getNumOutputs(); n++) {
-		// Update bias
-		_outputs[n]._biasTrace += -traceDecay * _outputs[n]._biasTrace + grad._outputGradient[n];
-		_outputs[n]._bias += alpha * tdError * _outputs[n]._biasTrace;
-
-		for (size_t c = 0; c < _outputs[n]._synapses.size(); c++) {
-			_outputs[n]._synapses[c]._trace += -traceDecay * _outputs[n]._synapses[c]._trace + grad._outputGradient[n] * _outputs[n]._synapses[c]._pInput->_output;
-			_outputs[n]._synapses[c]._weight += alpha * tdError * _outputs[n]._synapses[c]._trace;
-		}
-	}
+	for (size_t i = 0; i < _batchOutputs.size(); i++)
+		_batchOutputGradients[i] = targets[i] - _batchOutputs[i];
 
-	size_t lastHiddenLayerIndex = _hidden.size() - 1;
+	_batchHiddenGradients.resize(_hidden.size());
 
-	// Last hidden layer
-	for (size_t n = 0; n < getNumNeuronsPerHiddenLayer(); n++) {
-		// Update bias
-		_hidden[lastHiddenLayerIndex][n]._biasTrace += -traceDecay * _hidden[lastHiddenLayerIndex][n]._biasTrace + grad._hiddenLayersGradient[lastHiddenLayerIndex][n];
-		_hidden[lastHiddenLayerIndex][n]._bias += alpha * tdError * _hidden[lastHiddenLayerIndex][n]._biasTrace;
+	// Backpropagate, last hidden layer first
+	const float* pNextGradients = _batchOutputGradients.data();
+	const DenseLayer* pNextLayer = &_outputs;
 
-		for (size_t c = 0; c < _hidden[lastHiddenLayerIndex][n]._synapses.size(); c++) {
-			_hidden[lastHiddenLayerIndex][n]._synapses[c]._trace += -traceDecay * _hidden[lastHiddenLayerIndex][n]._synapses[c]._trace + grad._hiddenLayersGradient[lastHiddenLayerIndex][n] * _hidden[lastHiddenLayerIndex][n]._synapses[c]._pInput->_output;
-			_hidden[lastHiddenLayerIndex][n]._synapses[c]._weight += alpha * tdError * _hidden[lastHiddenLayerIndex][n]._synapses[c]._trace;
-		}
+	for (int l = static_cast<int>(_hidden.size()) - 1; l >= 0; l--) {
+		std::vector<float> &gradients = _batchHiddenGradients[l];
+		const std::vector<float> &outputs = _batchHiddenOutputs[l];
+
+		gradients.resize(outputs.size());
+
+		pNextLayer->backpropagateBatch(pNextGradients, _batchSize, gradients.data());
+
+		for (size_t i = 0; i < gradients.size(); i++)
+			gradients[i] = gradients[i] * outputs[i] * (1.0f - outputs[i]);
+
+		pNextGradients = gradients.data();
+		pNextLayer = &_hidden[l];
 	}
 
-	// All other hidden layers
-	for (int l = static_cast<int>(getNumHiddenLayers()) - 2; l >= 0; l--) {
-		int nextLayerIndex = l + 1;
+	// Sum weight gradients
+	for (size_t l = 0; l < _hidden.size(); l++)
+		_hidden[l].accumulateGradientBatch(l == 0 ? _batchInputs.data() : _batchHiddenOutputs[l - 1].data(), _batchHiddenGradients[l].data(), _batchSize,
+		grad._hiddenLayersWeightGradient[l].data(), grad._hiddenLayersBiasGradient[l].data());
 
-		for (size_t n = 0; n < getNumNeuronsPerHiddenLayer(); n++) {
-			// Update bias
-			_hidden[l][n]._biasTrace += -traceDecay * _hidden[l][n]._biasTrace + grad._hiddenLayersGradient[l][n];
-			_hidden[l][n]._bias += alpha * tdError * _hidden[l][n]._biasTrace;
+	_outputs.accumulateGradientBatch(_hidden.empty() ? _batchInputs.data() : _batchHiddenOutputs.back().data(), _batchOutputGradients.data(), _batchSize,
+		grad._outputWeightGradient.data(), grad._outputBiasGradient.data());
+}
 
-			for (size_t c = 0; c < _hidden[lastHiddenLayerIndex][n]._synapses.size(); c++) {
-				_hidden[l][n]._synapses[c]._trace += -traceDecay * _hidden[l][n]._synapses[c]._trace + grad._hiddenLayersGradient[l][n] * _hidden[l][n]._synapses[c]._pInput->_output;
-				_hidden[l][n]._synapses[c]._weight += alpha * tdError * _hidden[l][n]._synapses[c]._trace;
-			}
-		}
+void FeedForwardNeuralNetwork::getEmptyBatchGradient(BatchGradient &grad) {
+	grad._outputWeightGradient.assign(_outputs._weights.size(), 0.0f);
+	grad._outputBiasGradient.assign(getNumOutputs(), 0.0f);
+
+	grad._hiddenLayersWeightGradient.resize(_hidden.size());
+	grad._hiddenLayersBiasGradient.resize(_hidden.size());
+
+	for (size_t l = 0; l < getNumHiddenLayers(); l++) {
+		grad._hiddenLayersWeightGradient[l].assign(_hidden[l]._weights.size(), 0.0f);
+		grad._hiddenLayersBiasGradient[l].assign(_hidden[l].getNumOutputs(), 0.0f);
 	}
 }
 
-void FeedForwardNeuralNetwork::decayWeights(float decay) {
+void FeedForwardNeuralNetwork::moveAlongBatchGradient(const BatchGradient &grad, float alpha) {
 	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (size_t n = 0; n < getNumNeuronsPerHiddenLayer(); n++) {
-		_hidden[l][n]._bias += -decay * _hidden[l][n]._bias;
+		_hidden[l].moveAlongWeightGradient(grad._hiddenLayersWeightGradient[l], grad._hiddenLayersBiasGradient[l], alpha);
 
-		for (size_t c = 0; c < _hidden[l][n]._synapses.size(); c++)
-			_hidden[l][n]._synapses[c]._weight += -decay * _hidden[l][n]._synapses[c]._weight;
-	}
+	_outputs.moveAlongWeightGradient(grad._outputWeightGradient, grad._outputBiasGradient, alpha);
+}
 
-	for (size_t n = 0; n < getNumOutputs(); n++) {
-		_outputs[n]._bias += -decay * _outputs[n]._bias;
+void FeedForwardNeuralNetwork::moveAlongBatchGradientMomentum(const BatchGradient &grad, float alpha, float momentum) {
+	for (size_t l = 0; l < getNumHiddenLayers(); l++)
+		_hidden[l].moveAlongWeightGradientMomentum(grad._hiddenLayersWeightGradient[l], grad._hiddenLayersBiasGradient[l], alpha, momentum);
 
-		for (size_t c = 0; c < _outputs[n]._synapses.size(); c++)
-			_outputs[n]._synapses[c]._weight += -decay * _outputs[n]._synapses[c]._weight;
-	}
+	_outputs.moveAlongWeightGradientMomentum(grad._outputWeightGradient, grad._outputBiasGradient, alpha, momentum);
 }
 
-void FeedForwardNeuralNetwork::decayWeightsExcludingOutputLayer(float decay) {
+void FeedForwardNeuralNetwork::storeCurrentOutputsInTraces() {
 	for (size_t l = 0; l < getNumHiddenLayers(); l++)
-	for (size_t n = 0; n < getNumNeuronsPerHiddenLayer(); n++) {
-		_hidden[l][n]._bias += -decay * _hidden[l][n]._bias;
+		_hidden[l]._outputTraces = _hidden[l]._outputs;
 
-		for (size_t c = 0; c < _hidden[l][n]._synapses.size(); c++)
-			_hidden[l][n]._synapses[c]._weight += -decay * _hidden[l][n]._synapses[c]._weight;
-	}
+	_outputs._outputTraces = _outputs._outputs;
 }
 
-void FeedForwardNeuralNetwork::getInputGradient(const Gradient &existingGrad, std::vector<float> &inputGrad) {
-	inputGrad.resize(getNumInputs());
+void FeedForwardNeuralNetwork::updateValueFunction(float tdError, float alpha, float traceDecay) {
+	Gradient grad;
+	getGradientFromError(std::vector<float>(1, 1.0f), grad);
+
+	_outputs.updateTraces(getOutputLayerInputs(), grad._outputGradient, tdError, alpha, traceDecay);
 
-	if (_hidden.empty()) {
-		for (size_t i = 0; i < inputGrad.size(); i++) {
-			float sum = 0.0f;
+	// Hidden layers, last to first
+	for (int l = static_cast<int>(getNumHiddenLayers()) - 1; l >= 0; l--)
+		_hidden[l].updateTraces(getHiddenLayerInputs(l), grad._hiddenLayersGradient[l], tdError, alpha, traceDecay);
+}
 
-			for (size_t c = 0; c < getNumOutputs(); c++)
-				sum += existingGrad._outputGradient[c] * _outputs[c]._synapses[i]._weight;
+void FeedForwardNeuralNetwork::decayWeights(float decay) {
+	for (size_t l = 0; l < getNumHiddenLayers(); l++)
+		_hidden[l].decayWeights(decay);
 
-			inputGrad[i] = sum;
-		}
-	} else {
-		for (size_t i = 0; i < inputGrad.size(); i++) {
-			float sum = 0.0f;
+	_outputs.decayWeights(decay);
+}
 
-			for (size_t c = 0; c < getNumNeuronsPerHiddenLayer(); c++)
-				sum += existingGrad._hiddenLayersGradient[0][c] * _hidden[0][c]._synapses[i]._weight;
+void FeedForwardNeuralNetwork::decayWeightsExcludingOutputLayer(float decay) {
+	for (size_t l = 0; l < getNumHiddenLayers(); l++)
+		_hidden[l].decayWeights(decay);
+}
 
-			inputGrad[i] = sum;
-		}
-	}
+void FeedForwardNeuralNetwork::getInputGradient(const Gradient &existingGrad, std::vector<float> &inputGrad) {
+	if (_hidden.empty())
+		_outputs.backpropagate(existingGrad._outputGradient, inputGrad);
+	else
+		_hidden[0].backpropagate(existingGrad._hiddenLayersGradient[0], inputGrad);
 }
 
 void FeedForwardNeuralNetwork::getBrownianPerturbationSet(BrownianPerturbationSet &set) {
-	set._outputPerturbations.resize(_outputs.size());
+	set._outputPerturbations.resize(getNumOutputs());
 
 	if (!_hidden.empty()) {
 		set._hiddenLayerPerturbations.resize(_hidden.size());
@@ -751,26 +527,22 @@ void FeedForwardNeuralNetwork::writeToStream(std::ostream &stream) {
 	stream << getNumInputs() << " " << getNumOutputs() << " " << getNumHiddenLayers() << " " << getNumNeuronsPerHiddenLayer() << std::endl;
 	stream << _activationMultiplier << " " << _outputTraceDecay << " " << _weightTraceDecay << std::endl;
 
-	if (!_hidden.empty()) {
-		for (size_t l = 0, numHiddenLayers = _hidden.size(); l < numHiddenLayers; l++)
-		for (size_t n = 0; n < getNumNeuronsPerHiddenLayer(); n++) {
-			stream << _hidden[l][n]._bias << " ";
+	// One line per neuron, bias followed by weights
+	auto writeLayer = [&stream](const DenseLayer &layer) {
+		for (size_t n = 0; n < layer.getNumOutputs(); n++) {
+			stream << layer._biases[n] << " ";
 
-			for (size_t c = 0; c < _hidden[l][n]._synapses.size(); c++)
-				stream << _hidden[l][n]._synapses[c]._weight << " ";
+			for (size_t i = 0; i < layer.getNumInputs(); i++)
+				stream << layer._weights[n * layer.getNumInputs() + i] << " ";
 
 			stream << std::endl;
 		}
-	}
-
-	for (size_t n = 0; n < getNumOutputs(); n++) {
-		stream << _outputs[n]._bias << " ";
+	};
 
-		for (size_t c = 0; c < _outputs[n]._synapses.size(); c++)
-			stream << _outputs[n]._synapses[c]._weight << " ";
+	for (size_t l = 0; l < _hidden.size(); l++)
+		writeLayer(_hidden[l]);
 
-		stream << std::endl;
-	}
+	writeLayer(_outputs);
 }
 
 void FeedForwardNeuralNetwork::readFromStream(std::istream &stream) {
@@ -780,124 +552,112 @@ void FeedForwardNeuralNetwork::readFromStream(std::istream &stream) {
 
 	stream >> _activationMultiplier >> _outputTraceDecay >> _weightTraceDecay;
 
-	_inputs.resize(numInputs);
-	_outputs.resize(numOutputs);
-
-	if (numHiddenLayers == 0) {
-		// Connect outputs directly to inputs
-		for (size_t n = 0; n < numOutputs; n++) {
-			stream >> _outputs[n]._bias;
+	resizeLayers(numInputs, numOutputs, numHiddenLayers, numNeuronsPerHiddenLayer);
 
-			_outputs[n]._synapses.resize(numInputs);
+	auto readLayer = [&stream](DenseLayer &layer) {
+		for (size_t n = 0; n < layer.getNumOutputs(); n++) {
+			stream >> layer._biases[n];
 
-			for (size_t i = 0; i < numInputs; i++) {
-				_outputs[n]._synapses[i]._pInput = &_inputs[i];
-				stream >> _outputs[n]._synapses[i]._weight;
-			}
+			for (size_t i = 0; i < layer.getNumInputs(); i++)
+				stream >> layer._weights[n * layer.getNumInputs() + i];
 		}
-	} else {
-		_hidden.resize(numHiddenLayers);
+	};
 
-		// First hidden layer
-		_hidden[0].resize(numNeuronsPerHiddenLayer);
+	for (size_t l = 0; l < _hidden.size(); l++)
+		readLayer(_hidden[l]);
+
+	readLayer(_outputs);
+}
 
-		for (size_t n = 0; n < numNeuronsPerHiddenLayer; n++) {
-			stream >> _hidden[0][n]._bias;
+void FeedForwardNeuralNetwork::getWeightVector(std::vector<float> &weights) {
+	weights.clear();
+	weights.reserve(getWeightVectorSize());
 
-			_hidden[0][n]._synapses.resize(numInputs);
+	auto appendLayer = [&weights](const DenseLayer &layer) {
+		for (size_t n = 0; n < layer.getNumOutputs(); n++) {
+			weights.push_back(layer._biases[n]);
 
-			for (size_t i = 0; i < numInputs; i++) {
-				_hidden[0][n]._synapses[i]._pInput = &_inputs[i];
-				stream >> _hidden[0][n]._synapses[i]._weight;
-			}
+			weights.insert(weights.end(), layer._weights.begin() + n * layer.getNumInputs(), layer._weights.begin() + (n + 1) * layer.getNumInputs());
 		}
+	};
 
-		// All other hidden layers
-		for (size_t l = 1; l < numHiddenLayers; l++) {
-			size_t prevLayerIndex = l - 1;
+	for (size_t l = 0; l < _hidden.size(); l++)
+		appendLayer(_hidden[l]);
 
-			_hidden[l].resize(numNeuronsPerHiddenLayer);
+	appendLayer(_outputs);
+}
 
-			for (size_t n = 0; n < numNeuronsPerHiddenLayer; n++) {
-				stream >> _hidden[l][n]._bias;
+void FeedForwardNeuralNetwork::setWeightVector(const std::vector<float> &weights) {
+	size_t index = 0;
 
-				_hidden[l][n]._synapses.resize(numNeuronsPerHiddenLayer);
+	auto extractLayer = [&weights, &index](DenseLayer &layer) {
+		for (size_t n = 0; n < layer.getNumOutputs(); n++) {
+			layer._biases[n] = weights[index++];
 
-				for (size_t i = 0; i < numNeuronsPerHiddenLayer; i++) {
-					_hidden[l][n]._synapses[i]._pInput = &_hidden[prevLayerIndex][i];
-					stream >> _hidden[l][n]._synapses[i]._weight;
-				}
-			}
-		}
+			std::copy(weights.begin() + index, weights.begin() + index + layer.getNumInputs(), layer._weights.begin() + n * layer.getNumInputs());
 
-		for (size_t n = 0; n < numOutputs; n++) {
-			stream >> _outputs[n]._bias;
+			index += layer.getNumInputs();
+		}
+	};
 
-			_outputs[n]._synapses.resize(numNeuronsPerHiddenLayer);
+	for (size_t l = 0; l < _hidden.size(); l++)
+		extractLayer(_hidden[l]);
 
-			for (size_t i = 0; i < numNeuronsPerHiddenLayer; i++) {
-				_outputs[n]._synapses[i]._pInput = &_hidden.back()[i];
-				stream >> _outputs[n]._synapses[i]._weight;
-			}
-		}
-	}
+	extractLayer(_outputs);
 }
 
-void FeedForwardNeuralNetwork::getWeightVector(std::vector<float> &weights) {
-	weights.clear();
+void FeedForwardNeuralNetwork::writeToCheckpoint(io::CheckpointWriter &writer, const std::string &prefix) const {
+	int dims[4] = { static_cast<int>(getNumInputs()), static_cast<int>(getNumOutputs()), static_cast<int>(getNumHiddenLayers()), static_cast<int>(getNumNeuronsPerHiddenLayer()) };
+	float params[3] = { _activationMultiplier, _outputTraceDecay, _weightTraceDecay };
 
-	if (!_hidden.empty()) {
-		for (size_t l = 0, numHiddenLayers = _hidden.size(); l < numHiddenLayers; l++)
-		for (size_t n = 0; n < getNumNeuronsPerHiddenLayer(); n++) {
-			weights.push_back(_hidden[l][n]._bias);
+	writer.addInts(prefix + "dims", dims, 4);
+	writer.addFloats(prefix + "params", params, 3);
 
-			for (size_t c = 0; c < _hidden[l][n]._synapses.size(); c++)
-				weights.push_back(_hidden[l][n]._synapses[c]._weight);
-		}
+	for (size_t l = 0; l < _hidden.size(); l++) {
+		writer.addFloats(prefix + "hidden" + std::to_string(l) + "/weights", _hidden[l]._weights);
+		writer.addFloats(prefix + "hidden" + std::to_string(l) + "/biases", _hidden[l]._biases);
 	}
 
-	for (size_t n = 0; n < getNumOutputs(); n++) {
-		weights.push_back(_outputs[n]._bias);
-
-		for (size_t c = 0; c < _outputs[n]._synapses.size(); c++)
-			weights.push_back(_outputs[n]._synapses[c]._weight);
-	}
+	writer.addFloats(prefix + "output/weights", _outputs._weights);
+	writer.addFloats(prefix + "output/biases", _outputs._biases);
 }
 
-void FeedForwardNeuralNetwork::setWeightVector(const std::vector<float> &weights) {
-	size_t index = 0;
+bool FeedForwardNeuralNetwork::readFromCheckpoint(const io::CheckpointReader &reader, const std::string &prefix) {
+	int dims[4];
+	float params[3];
 
-	if (!_hidden.empty()) {
-		for (size_t l = 0, numHiddenLayers = _hidden.size(); l < numHiddenLayers; l++)
-		for (size_t n = 0; n < getNumNeuronsPerHiddenLayer(); n++) {
-			_hidden[l][n]._bias = weights[index++];
+	if (!reader.readInts(prefix + "dims", dims, 4) || !reader.readFloats(prefix + "params", params, 3))
+		return false;
 
-			for (size_t c = 0; c < _hidden[l][n]._synapses.size(); c++)
-				_hidden[l][n]._synapses[c]._weight = weights[index++];
-		}
-	}
+	if (dims[0] < 0 || dims[1] < 0 || dims[2] < 0 || dims[3] < 0)
+		return false;
 
-	for (size_t n = 0; n < getNumOutputs(); n++) {
-		_outputs[n]._bias = weights[index++];
+	resizeLayers(dims[0], dims[1], dims[2], dims[3]);
 
-		for (size_t c = 0; c < _outputs[n]._synapses.size(); c++)
-			_outputs[n]._synapses[c]._weight = weights[index++];
-	}
+	// Layer matrices are copied straight out of the checkpoint
+	for (size_t l = 0; l < _hidden.size(); l++)
+	if (!reader.readFloats(prefix + "hidden" + std::to_string(l) + "/weights", _hidden[l]._weights.data(), _hidden[l]._weights.size()) ||
+		!reader.readFloats(prefix + "hidden" + std::to_string(l) + "/biases", _hidden[l]._biases.data(), _hidden[l]._biases.size()))
+		return false;
+
+	if (!reader.readFloats(prefix + "output/weights", _outputs._weights.data(), _outputs._weights.size()) ||
+		!reader.readFloats(prefix + "output/biases", _outputs._biases.data(), _outputs._biases.size()))
+		return false;
+
+	_activationMultiplier = params[0];
+	_outputTraceDecay = params[1];
+	_weightTraceDecay = params[2];
+
+	return true;
 }
 
 size_t FeedForwardNeuralNetwork::getWeightVectorSize() const {
 	size_t size = 0;
 
-	if (!_hidden.empty()) {
-		for (size_t l = 0, numHiddenLayers = _hidden.size(); l < numHiddenLayers; l++)
-		for (size_t n = 0; n < getNumNeuronsPerHiddenLayer(); n++) {
-			size += 1 + _hidden[l][n]._synapses.size();
-		}
-	}
+	for (size_t l = 0; l < _hidden.size(); l++)
+		size += _hidden[l]._biases.size() + _hidden[l]._weights.size();
 
-	for (size_t n = 0; n < getNumOutputs(); n++) {
-		size += 1 + _outputs[n]._synapses.size();
-	}
+	size += _outputs._biases.size() + _outputs._weights.size();
 
 	return size;
-}
\ No newline at end of file
+}
@@ -21,8 +21,10 @@ misrepresented as being the original software.
 
 #pragma once
 
-#include <nn/Neuron.h>
+#include <nn/DenseLayer.h>
 #include <nn/BrownianPerturbation.h>
+#include <io/CheckpointWriter.h>
+#include <io/CheckpointReader.h>
 
 #include <iostream>
 
@@ -39,6 +41,16 @@ namespace nn {
 			void setValue(float value);
 		};
 
+		// Structure for weight-space gradient summed over a minibatch, weight gradients are row-major like the layer weights
+		struct BatchGradient {
+			std::vector<float> _outputWeightGradient;
+			std::vector<float> _outputBiasGradient;
+			std::vector<std::vector<float>> _hiddenLayersWeightGradient;
+			std::vector<std::vector<float>> _hiddenLayersBiasGradient;
+
+			void setValue(float value);
+		};
+
 		// Structure for random perturbations for each output in the network
 		struct BrownianPerturbationSet {
 			std::mt19937 _generator;
@@ -52,9 +64,32 @@ namespace nn {
 		};
 
 	private:
-		std::vector<Sensor> _inputs;
-		std::vector<Neuron> _outputs;
-		std::vector<std::vector<Neuron>> _hidden;
+		std::vector<float> _inputs;
+		DenseLayer _outputs;
+		std::vector<DenseLayer> _hidden;
+
+		// Activations and error gradients of the last minibatch, one row per sample
+		size_t _batchSize;
+		std::vector<float> _batchInputs;
+		std::vector<float> _batchOutputs;
+		std::vector<float> _batchOutputGradients;
+		std::vector<std::vector<float>> _batchHiddenOutputs;
+		std::vector<std::vector<float>> _batchHiddenGradients;
+
+		void propagateBatch(const float* inputs, size_t batchSize, float* outputs, bool linearOutputLayer);
+
+		void resizeLayers(size_t numInputs, size_t numOutputs,
+			size_t numHiddenLayers, size_t numNeuronsPerHiddenLayer);
+
+		// Outputs of the layer feeding into the output layer
+		const std::vector<float> &getOutputLayerInputs() const {
+			return _hidden.empty() ? _inputs : _hidden.back()._outputs;
+		}
+
+		// Outputs of the layer feeding into hidden layer l
+		const std::vector<float> &getHiddenLayerInputs(size_t l) const {
+			return l == 0 ? _inputs : _hidden[l - 1]._outputs;
+		}
 
 	public:
 		float _activationMultiplier; // Sensitivity of neurons
@@ -62,10 +97,12 @@ namespace nn {
 		float _weightTraceDecay; // Decay rate of weight traces
 
 		FeedForwardNeuralNetwork()
-			: _activationMultiplier(1.0f), _outputTraceDecay(0.01f), _weightTraceDecay(0.01f)
+			: _batchSize(0), _activationMultiplier(1.0f), _outputTraceDecay(0.01f), _weightTraceDecay(0.01f)
 		{}
 
-		FeedForwardNeuralNetwork(const FeedForwardNeuralNetwork &other) {
+		FeedForwardNeuralNetwork(const FeedForwardNeuralNetwork &other)
+			: _batchSize(0)
+		{
 			*this = other;
 		}
 
@@ -113,6 +150,19 @@ namespace nn {
 		void moveAlongGradientSign(const Gradient &grad, float alpha);
 		void moveAlongGradientMomentum(const Gradient &grad, float alpha, float momentum);
 
+		// Minibatch passes. Inputs are [batchSize x numInputs] and outputs [batchSize x numOutputs], row-major.
+		// These do not touch the single-sample inputs, outputs or traces. Outputs may be nullptr
+		void activateBatch(const float* inputs, size_t batchSize, float* outputs);
+		void activateBatchLinearOutputLayer(const float* inputs, size_t batchSize, float* outputs);
+
+		// Backpropagate errors of the last activateBatch call against targets ([batchSize x numOutputs]) and add the summed gradient to grad
+		void accumulateGradientBatch(const float* targets, BatchGradient &grad);
+
+		void getEmptyBatchGradient(BatchGradient &grad);
+
+		void moveAlongBatchGradient(const BatchGradient &grad, float alpha);
+		void moveAlongBatchGradientMomentum(const BatchGradient &grad, float alpha, float momentum);
+
 		void storeCurrentOutputsInTraces();
 		void updateValueFunction(float tdError, float alpha, float traceDecay);
 
@@ -126,6 +176,10 @@ namespace nn {
 		void writeToStream(std::ostream &stream);
 		void readFromStream(std::istream &stream);
 
+		// Binary checkpoint of the structure, parameters and weights (no traces), tensor names start with prefix
+		void writeToCheckpoint(io::CheckpointWriter &writer, const std::string &prefix) const;
+		bool readFromCheckpoint(const io::CheckpointReader &reader, const std::string &prefix);
+
 		void getWeightVector(std::vector<float> &weights);
 		void setWeightVector(const std::vector<float> &weights);
 		size_t getWeightVectorSize() const;
@@ -135,7 +189,7 @@ namespace nn {
 		}
 
 		size_t getNumOutputs() const {
-			return _outputs.size();
+			return _outputs.getNumOutputs();
 		}
 
 		size_t getNumHiddenLayers() const {
@@ -143,23 +197,23 @@ namespace nn {
 		}
 
 		size_t getNumNeuronsPerHiddenLayer() const {
-			return getNumHiddenLayers() == 0 ? 0 : _hidden[0].size();
+			return getNumHiddenLayers() == 0 ? 0 : _hidden[0].getNumOutputs();
 		}
 
 		float getInput(size_t i) const {
-			return _inputs[i]._output;
+			return _inputs[i];
 		}
 
 		void setInput(size_t i, float value) {
-			_inputs[i]._output = value;
+			_inputs[i] = value;
 		}
 
 		float getOutput(size_t i) const {
-			return _outputs[i]._output;
+			return _outputs._outputs[i];
 		}
 
 		float getHiddenOutput(size_t l, size_t i) const {
-			return _hidden[l][i]._output;
+			return _hidden[l]._outputs[i];
 		}
 	};
 }
\ No newline at end of file
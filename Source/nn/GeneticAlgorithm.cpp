@@ -41,7 +41,10 @@ _maxWeight(1.0f)
 
 // Default values
 GeneticAlgorithm::GeneticAlgorithm()
-: _weightMutationChance(0.125f),
+: _seed(0),
+_numThreads(1),
+_generation(0),
+_weightMutationChance(0.125f),
 _maxWeightPerturbation(0.0625f),
 _averageWeightChance(0.5f),
 _greedExponent(2.0f)
@@ -50,6 +53,9 @@ _greedExponent(2.0f)
 void GeneticAlgorithm::create(size_t populationSize, const NetworkDesc &desc, unsigned long seed) {
 	_generator.seed(seed);
 
+	_seed = seed;
+	_generation = 0;
+
 	_population.resize(populationSize);
 	_fitnesses.assign(populationSize, 0.0f);
 
@@ -74,6 +80,21 @@ void GeneticAlgorithm::rescaleFitnesses() {
 	}
 }
 
+void GeneticAlgorithm::evaluate(const std::function<float(FeedForwardNeuralNetwork &member, std::mt19937 &generator)> &fitnessFunc) {
+	int populationSize = _population.size();
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(_numThreads)
+	for (int i = 0; i < populationSize; i++) {
+		std::seed_seq memberSeed { _seed, static_cast<unsigned long>(_generation), static_cast<unsigned long>(i) };
+
+		std::mt19937 memberGenerator(memberSeed);
+
+		FeedForwardNeuralNetwork member = _population[i];
+
+		_fitnesses[i] = fitnessFunc(member, memberGenerator);
+	}
+}
+
 size_t GeneticAlgorithm::rouletteWheel(float totalFitness) {
 	std::uniform_real_distribution<float> distribution(0.0f, totalFitness);
 
@@ -112,4 +133,6 @@ void GeneticAlgorithm::generation() {
 
 	// Set new population as current population
 	_population = newPopulation;
+
+	_generation++;
 }
\ No newline at end of file
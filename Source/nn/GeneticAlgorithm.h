@@ -25,6 +25,8 @@ misrepresented as being the original software.
 
 #include <random>
 #include <memory>
+#include <functional>
+#include <algorithm>
 
 namespace nn {
 	class GeneticAlgorithm {
@@ -34,6 +36,12 @@ namespace nn {
 
 		std::mt19937 _generator;
 
+		unsigned long _seed;
+
+		int _numThreads;
+
+		size_t _generation;
+
 		// Rescale to all positive fitnesses
 		void rescaleFitnesses();
 
@@ -66,6 +74,11 @@ namespace nn {
 
 		void create(size_t populationSize, const NetworkDesc &desc, unsigned long seed);
 
+		// Evaluates every member on a copy and sets the fitnesses. Members are evaluated by _numThreads threads (OpenMP),
+		// each with its own random stream seeded from (create seed, generation, member), so fitnesses do not depend on
+		// the number of threads. fitnessFunc is called concurrently
+		void evaluate(const std::function<float(FeedForwardNeuralNetwork &member, std::mt19937 &generator)> &fitnessFunc);
+
 		// Creates a new generation based on set fitnesses
 		void generation();
 
@@ -84,6 +97,18 @@ namespace nn {
 		const FeedForwardNeuralNetwork &getPopulationMember(size_t i) const {
 			return _population[i];
 		}
+
+		void setNumThreads(int numThreads) {
+			_numThreads = std::max(1, numThreads);
+		}
+
+		int getNumThreads() const {
+			return _numThreads;
+		}
+
+		size_t getGeneration() const {
+			return _generation;
+		}
 	};
 }
 
@@ -119,21 +119,18 @@ void PSOAgent::step(float reward, float dt) {
 
 	std::normal_distribution<float> pseudoRehearsalInputDistribution(_pseudoRehearsalSampleMean, _pseudoRehearsalSampleStdDev);
 
-	for (size_t i = 0; i < _numPseudoRehearsalSamplesCritic; i++) {
-		// Generate critic sample
-		criticRehearsalSamples[i]._inputs.resize(_critic.getNumInputs());
+	// Generate critic samples, evaluated as one batch
+	std::vector<float> rehearsalInputs(_numPseudoRehearsalSamplesCritic * _critic.getNumInputs());
+	std::vector<float> rehearsalOutputs(_numPseudoRehearsalSamplesCritic * _critic.getNumOutputs());
 
-		for (size_t j = 0; j < _actor.getNumInputs(); j++) {
-			criticRehearsalSamples[i]._inputs[j] = pseudoRehearsalInputDistribution(_generator);
-			_critic.setInput(j, criticRehearsalSamples[i]._inputs[j]);
-		}
+	for (size_t i = 0; i < rehearsalInputs.size(); i++)
+		rehearsalInputs[i] = pseudoRehearsalInputDistribution(_generator);
 
-		_critic.activateLinearOutputLayer();
+	_critic.activateBatchLinearOutputLayer(rehearsalInputs.data(), _numPseudoRehearsalSamplesCritic, rehearsalOutputs.data());
 
-		criticRehearsalSamples[i]._outputs.resize(_critic.getNumOutputs());
-
-		for (size_t j = 0; j < _critic.getNumOutputs(); j++)
-			criticRehearsalSamples[i]._outputs[j] = _critic.getOutput(j);
+	for (size_t i = 0; i < _numPseudoRehearsalSamplesCritic; i++) {
+		criticRehearsalSamples[i]._inputs.assign(rehearsalInputs.begin() + i * _critic.getNumInputs(), rehearsalInputs.begin() + (i + 1) * _critic.getNumInputs());
+		criticRehearsalSamples[i]._outputs.assign(rehearsalOutputs.begin() + i * _critic.getNumOutputs(), rehearsalOutputs.begin() + (i + 1) * _critic.getNumOutputs());
 	}
 
 	float newPrevValue = reward + _gamma * value;
@@ -129,25 +129,19 @@ void QAgent::step(float fitness) {
 		currentInputs[i] = _qNetwork.getInput(i);
 
 	// Get pseudorehearsal samples
-	std::vector<IOSet> rehearsalSamples(_numPseudoRehearsalSamples);
-
 	std::normal_distribution<float> pseudoRehearsalInputDistribution(_pseudoRehearsalSampleMean, _pseudoRehearsalSampleStdDev);
 
-	for (size_t i = 0; i < _numPseudoRehearsalSamples; i++) {
-		// Generate sample
-		rehearsalSamples[i]._inputs.resize(_qNetwork.getNumInputs());
-
-		for (size_t j = 0; j < _qNetwork.getNumInputs(); j++) {
-			rehearsalSamples[i]._inputs[j] = pseudoRehearsalInputDistribution(_generator);
-			_qNetwork.setInput(j, rehearsalSamples[i]._inputs[j]);
-		}
+	// Generate samples, evaluated as one batch
+	_rehearsalInputs.resize(_numPseudoRehearsalSamples * _qNetwork.getNumInputs());
+	_rehearsalOutputs.resize(_numPseudoRehearsalSamples);
 
-		_qNetwork.activateLinearOutputLayer();
+	for (size_t i = 0; i < _rehearsalInputs.size(); i++)
+		_rehearsalInputs[i] = pseudoRehearsalInputDistribution(_generator);
 
-		rehearsalSamples[i]._output = _qNetwork.getOutput(0);
-	}
+	_qNetwork.activateBatchLinearOutputLayer(_rehearsalInputs.data(), _numPseudoRehearsalSamples, _rehearsalOutputs.data());
 
-	for (size_t i = 0; i < _numInputs; i++)
+	// Previous state and action
+	for (size_t i = 0; i < _qNetwork.getNumInputs(); i++)
 		_qNetwork.setInput(i, _prevInputs[i]);
 
 	_qNetwork.activateLinearOutputLayer();
@@ -194,13 +188,15 @@ void QAgent::step(float fitness) {
 
 		// Train on rehearsal samples
 		for (size_t i = 0; i < _numPseudoRehearsalSamples; i++) {
+			const float* pInputs = &_rehearsalInputs[i * _qNetwork.getNumInputs()];
+
 			for (size_t j = 0; j < _qNetwork.getNumInputs(); j++)
-				_qNetwork.setInput(j, rehearsalSamples[i]._inputs[j]);
+				_qNetwork.setInput(j, pInputs[j]);
 
 			_qNetwork.activateLinearOutputLayer();
 
 			FeedForwardNeuralNetwork::Gradient grad;
-			_qNetwork.getGradientLinearOutputLayer(std::vector<float>(1, rehearsalSamples[i]._output), grad);
+			_qNetwork.getGradientLinearOutputLayer(std::vector<float>(1, _rehearsalOutputs[i]), grad);
 
 			_qNetwork.moveAlongGradientMomentum(grad, _qUpdateAlpha, _momentum);
 		}
@@ -22,7 +22,6 @@ misrepresented as being the original software.
 #pragma once
 
 #include <nn/FeedForwardNeuralNetwork.h>
-#include <list>
 #include <random>
 #include <assert.h>
 
@@ -41,12 +40,9 @@ namespace nn {
 
 		std::vector<float> _prevInputs;
 
-		struct QInputOutputTuple {
-			std::vector<float> _inputs;
-			float _output;
-		};
-
-		std::list<QInputOutputTuple> _replayBuffer;
+		// Pseudo-rehearsal samples of the current step, one row of network inputs per sample
+		std::vector<float> _rehearsalInputs;
+		std::vector<float> _rehearsalOutputs;
 
 		std::vector<float> _outputBuffer;
 
@@ -29,318 +29,365 @@ misrepresented as being the original software.
 
 using namespace sdr;
 
-void SDRNetwork::createRandom(int inputWidth, int inputHeight, const std::vector<LayerDesc> &layerDescs, int numOutputs, float minSDRWeight, float maxSDRWeight, float minInhibitionWeight, float maxInhibitionWeight, float minBackWeight, float maxBackWeight, std::mt19937 &generator) {
-	std::uniform_real_distribution<float> sdrWeightDist(minSDRWeight, maxSDRWeight);
-	std::uniform_real_distribution<float> inhibitionDist(minInhibitionWeight, maxInhibitionWeight);
-	std::uniform_real_distribution<float> backWeightDist(minBackWeight, maxBackWeight);
-
+void SDRNetwork::create(int inputWidth, int inputHeight, const std::vector<LayerDesc> &layerDescs, int numOutputs) {
 	_inputWidth = inputWidth;
 	_inputHeight = inputHeight;
 
-	int numInputs = _inputWidth * _inputHeight;
-
 	_layerDescs = layerDescs;
 
+	_layers.clear();
 	_layers.resize(_layerDescs.size());
 
-	int prevLayerWidth = _inputWidth;
-	int prevLayerHeight = _inputHeight;
-
 	for (int l = 0; l < _layers.size(); l++) {
-		int numNodes = _layerDescs[l]._width * _layerDescs[l]._height;
-		int numWeights = std::pow(_layerDescs[l]._receptiveRadius * 2 + 1, 2);
-		int numInhibition = std::pow(_layerDescs[l]._inhibitionRadius * 2 + 1, 2);
+		Layer &layer = _layers[l];
+		const LayerDesc &desc = _layerDescs[l];
 
-		_layers[l]._nodes.resize(numNodes);
+		int prevLayerWidth = getPrevLayerWidth(l);
+		int prevLayerHeight = getPrevLayerHeight(l);
 
-		float rbfWidthInv = 1.0f / _layerDescs[l]._width;
-		float rbfHeightInv = 1.0f / _layerDescs[l]._height;
+		int windowSize = desc._receptiveRadius * 2 + 1;
+		int inhibitionWindowSize = desc._inhibitionRadius * 2 + 1;
 
-		for (int rx = 0; rx < _layerDescs[l]._width; rx++)
-		for (int ry = 0; ry < _layerDescs[l]._height; ry++) {
-			int i = rx + ry * _layerDescs[l]._width;
+		layer._numNodes = desc._width * desc._height;
+		layer._numTaps = windowSize * windowSize;
+		layer._numInhibitionTaps = inhibitionWindowSize * inhibitionWindowSize;
 
-			_layers[l]._nodes[i]._sdrWeights.resize(numWeights);
-			_layers[l]._nodes[i]._sdrInhibition.resize(numInhibition);
-			_layers[l]._nodes[i]._backWeights.resize(numWeights);
+		// Field centers
+		float rbfWidthInv = 1.0f / desc._width;
+		float rbfHeightInv = 1.0f / desc._height;
 
-			_layers[l]._nodes[i]._backBias._weight = backWeightDist(generator);
-			_layers[l]._nodes[i]._sdrBias = sdrWeightDist(generator);
+		layer._centerXs.resize(desc._width);
+		layer._centerYs.resize(desc._height);
 
-			for (int j = 0; j < numWeights; j++) {
-				_layers[l]._nodes[i]._sdrWeights[j] = sdrWeightDist(generator);
+		for (int rx = 0; rx < desc._width; rx++) {
+			float rxn = rx * rbfWidthInv;
 
-				_layers[l]._nodes[i]._backWeights[j]._weight = backWeightDist(generator);
-			}
+			layer._centerXs[rx] = std::round(rxn * prevLayerWidth);
+		}
 
-			for (int j = 0; j < numInhibition; j++)
-				_layers[l]._nodes[i]._sdrInhibition[j] = inhibitionDist(generator);
+		for (int ry = 0; ry < desc._height; ry++) {
+			float ryn = ry * rbfHeightInv;
 
-			// If not first layer, add back connections to previous layer
-			if (l > 0) {
-				float rxn = rx * rbfWidthInv;
-				float ryn = ry * rbfHeightInv;
+			layer._centerYs[ry] = std::round(ryn * prevLayerHeight);
+		}
 
-				int x = std::round(rxn * prevLayerWidth);
-				int y = std::round(ryn * prevLayerHeight);
+		// Input planes are padded by the receptive radius, plus one on the far sides since centers can round up to the previous layer size
+		layer._planeWidth = prevLayerWidth + windowSize;
 
-				int weightIndex = 0;
+		layer._sdrInputPlane.assign(layer._planeWidth * (prevLayerHeight + windowSize), 0.0f);
+		layer._backInputPlane.assign(layer._sdrInputPlane.size(), 0.0f);
 
-				for (int dx = -_layerDescs[l]._receptiveRadius; dx <= _layerDescs[l]._receptiveRadius; dx++)
-				for (int dy = -_layerDescs[l]._receptiveRadius; dy <= _layerDescs[l]._receptiveRadius; dy++) {
-					int xn = x + dx;
-					int yn = y + dy;
+		layer._fieldStarts.resize(layer._numNodes);
 
-					if (xn >= 0 && xn < prevLayerWidth && yn >= 0 && yn < prevLayerHeight) {
-						int j = xn + yn * prevLayerWidth;
+		for (int rx = 0; rx < desc._width; rx++)
+		for (int ry = 0; ry < desc._height; ry++)
+			layer._fieldStarts[rx + ry * desc._width] = layer._centerXs[rx] + layer._centerYs[ry] * layer._planeWidth;
 
-						BackConnection bc;
-						bc._nodeIndex = i;
-						bc._weightIndex = weightIndex;
+		layer._tapOffsets.resize(layer._numTaps);
 
-						_layers[l - 1]._nodes[j]._backConnections.push_back(bc);
-					}
+		for (int x = 0; x < windowSize; x++)
+		for (int y = 0; y < windowSize; y++)
+			layer._tapOffsets[y + x * windowSize] = x + y * layer._planeWidth;
 
-					weightIndex++;
-				}
-			}
-		}
+		// Inhibition
+		layer._activationPlaneWidth = desc._width + inhibitionWindowSize - 1;
 
-		prevLayerWidth = _layerDescs[l]._width;
-		prevLayerHeight = _layerDescs[l]._height;
-	}
+		layer._activationPlane.assign(layer._activationPlaneWidth * (desc._height + inhibitionWindowSize - 1), 0.0f);
 
-	_outputNodes.resize(numOutputs);
+		layer._inhibitionStarts.resize(layer._numNodes);
 
-	for (int i = 0; i < _outputNodes.size(); i++) {
-		_outputNodes[i]._connections.resize(_layerDescs.back()._width * _layerDescs.back()._height);
+		for (int rx = 0; rx < desc._width; rx++)
+		for (int ry = 0; ry < desc._height; ry++)
+			layer._inhibitionStarts[rx + ry * desc._width] = rx + ry * layer._activationPlaneWidth;
 
-		for (int j = 0; j < _outputNodes[i]._connections.size(); j++)
-			_outputNodes[i]._connections[j]._weight = backWeightDist(generator);
+		layer._inhibitionTapOffsets.resize(layer._numInhibitionTaps);
+		layer._inhibitionFalloffs.resize(layer._numInhibitionTaps);
 
-		_outputNodes[i]._bias._weight = backWeightDist(generator);
-	}
-}
+		int weightIndex = 0;
 
-void SDRNetwork::getOutput(const std::vector<float> &input, std::vector<float> &output, std::mt19937 &generator) {
-	int prevLayerWidth = _inputWidth;
-	int prevLayerHeight = _inputHeight;
+		for (int dx = -desc._inhibitionRadius; dx <= desc._inhibitionRadius; dx++)
+		for (int dy = -desc._inhibitionRadius; dy <= desc._inhibitionRadius; dy++) {
+			layer._inhibitionTapOffsets[weightIndex] = (dx + desc._inhibitionRadius) + (dy + desc._inhibitionRadius) * layer._activationPlaneWidth;
 
-	std::vector<float> prevLayerOutput = input;
+			if (dx != 0 && dy != 0) {
+				float dist2 = dx * dx + dy * dy;
 
-	std::uniform_real_distribution<float> uniformDist(0.0f, 1.0f);
+				layer._inhibitionFalloffs[weightIndex] = std::exp(-desc._similarityDistanceFactor * dist2);
+			}
+			else
+				layer._inhibitionFalloffs[weightIndex] = 0.0f;
 
-	for (int l = 0; l < _layers.size(); l++) {
-		float rbfWidthInv = 1.0f / _layerDescs[l]._width;
-		float rbfHeightInv = 1.0f / _layerDescs[l]._height;
+			weightIndex++;
+		}
 
-		for (int rx = 0; rx < _layerDescs[l]._width; rx++)
-		for (int ry = 0; ry < _layerDescs[l]._height; ry++) {
-			int i = rx + ry * _layerDescs[l]._width;
+		// Parameters
+		layer._sdrWeights.assign(layer._numTaps * layer._numNodes, 0.0f);
+		layer._sdrInhibition.assign(layer._numInhibitionTaps * layer._numNodes, 0.0f);
+		layer._sdrBiases.assign(layer._numNodes, 0.0f);
+		layer._backWeights.assign(layer._numTaps * layer._numNodes, 0.0f);
+		layer._backPrevDWeights.assign(layer._numTaps * layer._numNodes, 0.0f);
+		layer._backBiases.assign(layer._numNodes, 0.0f);
+		layer._backPrevDBiases.assign(layer._numNodes, 0.0f);
 
-			float rxn = rx * rbfWidthInv;
-			float ryn = ry * rbfHeightInv;
+		layer._sdrActivations.assign(layer._numNodes, 0.0f);
+		layer._sdrOutputs.assign(layer._numNodes, 0.0f);
+		layer._backSigs.assign(layer._numNodes, 0.0f);
+		layer._backOutputs.assign(layer._numNodes, 0.0f);
+		layer._backErrors.assign(layer._numNodes, 0.0f);
 
-			int x = std::round(rxn * prevLayerWidth);
-			int y = std::round(ryn * prevLayerHeight);
+		layer._backConnectionStarts.assign(layer._numNodes + 1, 0);
+		layer._backConnections.clear();
 
-			float sum = 0.0f;
+		// If not first layer, add back connections to previous layer
+		if (l > 0) {
+			Layer &prevLayer = _layers[l - 1];
 
-			int weightIndex = 0;
-	
-			for (int dx = -_layerDescs[l]._receptiveRadius; dx <= _layerDescs[l]._receptiveRadius; dx++)
-			for (int dy = -_layerDescs[l]._receptiveRadius; dy <= _layerDescs[l]._receptiveRadius; dy++) {
-				int xn = x + dx;
-				int yn = y + dy;
+			// Count, then fill in the same order
+			for (int pass = 0; pass < 2; pass++) {
+				std::vector<int> fill(prevLayer._backConnectionStarts.begin(), prevLayer._backConnectionStarts.end() - 1);
+
+				for (int rx = 0; rx < desc._width; rx++)
+				for (int ry = 0; ry < desc._height; ry++) {
+					int i = rx + ry * desc._width;
 
-				if (xn >= 0 && xn < prevLayerWidth && yn >= 0 && yn < prevLayerHeight) {
-					int j = xn + yn * prevLayerWidth;
+					int x = layer._centerXs[rx];
+					int y = layer._centerYs[ry];
 
-					sum += prevLayerOutput[j] * _layers[l]._nodes[i]._sdrWeights[weightIndex];
+					weightIndex = 0;
+
+					for (int dx = -desc._receptiveRadius; dx <= desc._receptiveRadius; dx++)
+					for (int dy = -desc._receptiveRadius; dy <= desc._receptiveRadius; dy++) {
+						int xn = x + dx;
+						int yn = y + dy;
+
+						if (xn >= 0 && xn < prevLayerWidth && yn >= 0 && yn < prevLayerHeight) {
+							int j = xn + yn * prevLayerWidth;
+
+							if (pass == 0)
+								prevLayer._backConnectionStarts[j + 1]++;
+							else {
+								BackConnection bc;
+								bc._nodeIndex = i;
+								bc._weightIndex = weightIndex;
+
+								prevLayer._backConnections[fill[j]++] = bc;
+							}
+						}
+
+						weightIndex++;
+					}
 				}
 
-				weightIndex++;
-			}
+				if (pass == 0) {
+					for (int j = 0; j < prevLayer._numNodes; j++)
+						prevLayer._backConnectionStarts[j + 1] += prevLayer._backConnectionStarts[j];
 
-			_layers[l]._nodes[i]._sdrActivation = std::max(_layerDescs[l]._sdrActivationLeak, sum);// std::max(0.0f, sum);
+					prevLayer._backConnections.resize(prevLayer._backConnectionStarts.back());
+				}
+			}
 		}
+	}
 
-		// Sparsify
-		for (int rx = 0; rx < _layerDescs[l]._width; rx++)
-		for (int ry = 0; ry < _layerDescs[l]._height; ry++) {
-			int i = rx + ry * _layerDescs[l]._width;
-
-			float sum = std::max(_layerDescs[l]._sdrActivationLeak, _layers[l]._nodes[i]._sdrActivation);
+	int numLastLayerNodes = _layers.back()._numNodes;
 
-			int weightIndex = 0;
+	_outputWeights.assign(numOutputs * numLastLayerNodes, 0.0f);
+	_outputBiases.assign(numOutputs, 0.0f);
+	_outputErrors.assign(numOutputs, 0.0f);
+}
 
-			for (int dx = -_layerDescs[l]._inhibitionRadius; dx <= _layerDescs[l]._inhibitionRadius; dx++)
-			for (int dy = -_layerDescs[l]._inhibitionRadius; dy <= _layerDescs[l]._inhibitionRadius; dy++) {
-				if (dx != 0 && dy != 0) {
-					int x = rx + dx;
-					int y = ry + dy;
+void SDRNetwork::createRandom(int inputWidth, int inputHeight, const std::vector<LayerDesc> &layerDescs, int numOutputs, float minSDRWeight, float maxSDRWeight, float minInhibitionWeight, float maxInhibitionWeight, float minBackWeight, float maxBackWeight, std::mt19937 &generator) {
+	std::uniform_real_distribution<float> sdrWeightDist(minSDRWeight, maxSDRWeight);
+	std::uniform_real_distribution<float> inhibitionDist(minInhibitionWeight, maxInhibitionWeight);
+	std::uniform_real_distribution<float> backWeightDist(minBackWeight, maxBackWeight);
 
-					if (x >= 0 && x < _layerDescs[l]._width && y >= 0 && y < _layerDescs[l]._height) {
-						int j = x + y * _layerDescs[l]._width;
+	create(inputWidth, inputHeight, layerDescs, numOutputs);
 
-						float dist2 = dx * dx + dy * dy;
+	for (int l = 0; l < _layers.size(); l++)
+	for (int rx = 0; rx < _layerDescs[l]._width; rx++)
+	for (int ry = 0; ry < _layerDescs[l]._height; ry++) {
+		Layer &layer = _layers[l];
 
-						float dFactor = std::exp(-_layerDescs[l]._similarityDistanceFactor * dist2);
+		int i = rx + ry * _layerDescs[l]._width;
 
-						sum -= dFactor * _layers[l]._nodes[i]._sdrInhibition[weightIndex] * _layers[l]._nodes[j]._sdrActivation * _layers[l]._nodes[i]._sdrActivation;
-					}
-				}
+		layer._backBiases[i] = backWeightDist(generator);
+		layer._sdrBiases[i] = sdrWeightDist(generator);
 
-				weightIndex++;
-			}
+		for (int j = 0; j < layer._numTaps; j++) {
+			layer._sdrWeights[j * layer._numNodes + i] = sdrWeightDist(generator);
 
-			_layers[l]._nodes[i]._sdrOutput = std::max(0.0f, sum);
+			layer._backWeights[j * layer._numNodes + i] = backWeightDist(generator);
 		}
 
-		prevLayerOutput.resize(_layers[l]._nodes.size());
+		for (int j = 0; j < layer._numInhibitionTaps; j++)
+			layer._sdrInhibition[j * layer._numNodes + i] = inhibitionDist(generator);
+	}
+
+	int numLastLayerNodes = _layers.back()._numNodes;
 
-		for (int i = 0; i < _layers[l]._nodes.size(); i++)
-			prevLayerOutput[i] = _layers[l]._nodes[i]._sdrOutput;
+	for (int i = 0; i < _outputBiases.size(); i++) {
+		for (int j = 0; j < numLastLayerNodes; j++)
+			_outputWeights[i * numLastLayerNodes + j] = backWeightDist(generator);
 
-		prevLayerWidth = _layerDescs[l]._width;
-		prevLayerHeight = _layerDescs[l]._height;
+		_outputBiases[i] = backWeightDist(generator);
 	}
+}
 
-	// Activate through weights
-	prevLayerWidth = _inputWidth;
-	prevLayerHeight = _inputHeight;
+void SDRNetwork::fillInputPlane(int l, std::vector<float> &plane, const float* values) {
+	int prevLayerWidth = getPrevLayerWidth(l);
+	int prevLayerHeight = getPrevLayerHeight(l);
+	int radius = _layerDescs[l]._receptiveRadius;
+	int planeWidth = _layers[l]._planeWidth;
 
-	prevLayerOutput = input;
+	for (int y = 0; y < prevLayerHeight; y++)
+		std::copy(values + y * prevLayerWidth, values + (y + 1) * prevLayerWidth, &plane[radius + (y + radius) * planeWidth]);
+}
 
-	for (int l = 0; l < _layers.size(); l++) {
-		float rbfWidthInv = 1.0f / _layerDescs[l]._width;
-		float rbfHeightInv = 1.0f / _layerDescs[l]._height;
+void SDRNetwork::accumulateReceptiveFields(int l, const std::vector<float> &weights, const std::vector<float> &plane, float* sums) const {
+	const Layer &layer = _layers[l];
 
-		for (int rx = 0; rx < _layerDescs[l]._width; rx++)
-		for (int ry = 0; ry < _layerDescs[l]._height; ry++) {
-			int i = rx + ry * _layerDescs[l]._width;
+	const int* pFieldStarts = layer._fieldStarts.data();
 
-			float rxn = rx * rbfWidthInv;
-			float ryn = ry * rbfHeightInv;
+	// Each node still sums its taps in order, the inner loop runs over the nodes of a tile
+	for (int start = 0; start < layer._numNodes; start += _tileSize) {
+		int end = std::min(layer._numNodes, start + _tileSize);
 
-			int x = std::round(rxn * prevLayerWidth);
-			int y = std::round(ryn * prevLayerHeight);
+		for (int t = 0; t < layer._numTaps; t++) {
+			const float* pWeights = &weights[t * layer._numNodes];
+			const float* pPlane = &plane[layer._tapOffsets[t]];
 
-			float sum = _layers[l]._nodes[i]._backBias._weight;
+			for (int i = start; i < end; i++)
+				sums[i] += pWeights[i] * pPlane[pFieldStarts[i]];
+		}
+	}
+}
 
-			int weightIndex = 0;
+void SDRNetwork::getOutput(const std::vector<float> &input, std::vector<float> &output, std::mt19937 &generator) {
+	const float* pPrevLayerOutput = input.data();
 
-			for (int dx = -_layerDescs[l]._receptiveRadius; dx <= _layerDescs[l]._receptiveRadius; dx++)
-			for (int dy = -_layerDescs[l]._receptiveRadius; dy <= _layerDescs[l]._receptiveRadius; dy++) {
-				int xn = x + dx;
-				int yn = y + dy;
+	for (int l = 0; l < _layers.size(); l++) {
+		Layer &layer = _layers[l];
+		const LayerDesc &desc = _layerDescs[l];
 
-				if (xn >= 0 && xn < prevLayerWidth && yn >= 0 && yn < prevLayerHeight) {
-					int j = xn + yn * prevLayerWidth;
+		fillInputPlane(l, layer._sdrInputPlane, pPrevLayerOutput);
 
-					sum += _layers[l]._nodes[i]._backWeights[weightIndex]._weight * prevLayerOutput[j];
-				}
+		std::fill(layer._sdrActivations.begin(), layer._sdrActivations.end(), 0.0f);
 
-				weightIndex++;
-			}
+		accumulateReceptiveFields(l, layer._sdrWeights, layer._sdrInputPlane, layer._sdrActivations.data());
 
-			_layers[l]._nodes[i]._backSig = sigmoid(sum);
-			_layers[l]._nodes[i]._backOutput = _layers[l]._nodes[i]._backSig * _layers[l]._nodes[i]._sdrOutput;
-		}
+		for (int i = 0; i < layer._numNodes; i++)
+			layer._sdrActivations[i] = std::max(desc._sdrActivationLeak, layer._sdrActivations[i]);// std::max(0.0f, sum);
 
-		prevLayerOutput.resize(_layers[l]._nodes.size());
+		// Sparsify
+		for (int y = 0; y < desc._height; y++)
+			std::copy(&layer._sdrActivations[y * desc._width], &layer._sdrActivations[(y + 1) * desc._width],
+				&layer._activationPlane[desc._inhibitionRadius + (y + desc._inhibitionRadius) * layer._activationPlaneWidth]);
 
-		for (int i = 0; i < _layers[l]._nodes.size(); i++)
-			prevLayerOutput[i] = _layers[l]._nodes[i]._backOutput;
+		for (int i = 0; i < layer._numNodes; i++)
+			layer._sdrOutputs[i] = std::max(desc._sdrActivationLeak, layer._sdrActivations[i]);
 
-		prevLayerWidth = _layerDescs[l]._width;
-		prevLayerHeight = _layerDescs[l]._height;
-	}
+		const float* pActivations = layer._sdrActivations.data();
+		const int* pInhibitionStarts = layer._inhibitionStarts.data();
+		float* pOutputs = layer._sdrOutputs.data();
 
-	if (output.size() != _outputNodes.size())
-		output.resize(_outputNodes.size());
+		for (int start = 0; start < layer._numNodes; start += _tileSize) {
+			int end = std::min(layer._numNodes, start + _tileSize);
 
-	for (int i = 0; i < _outputNodes.size(); i++) {
-		float sum = _outputNodes[i]._bias._weight;
+			for (int t = 0; t < layer._numInhibitionTaps; t++) {
+				float dFactor = layer._inhibitionFalloffs[t];
 
-		for (int rx = 0; rx < _layerDescs.back()._width; rx++)
-		for (int ry = 0; ry < _layerDescs.back()._height; ry++) {
-			int j = rx + ry * _layerDescs.back()._width;
+				const float* pInhibition = &layer._sdrInhibition[t * layer._numNodes];
+				const float* pPlane = &layer._activationPlane[layer._inhibitionTapOffsets[t]];
 
-			sum += _layers.back()._nodes[j]._backOutput * _outputNodes[i]._connections[j]._weight;
+				for (int i = start; i < end; i++)
+					pOutputs[i] -= dFactor * pInhibition[i] * pPlane[pInhibitionStarts[i]] * pActivations[i];
+			}
 		}
 
-		output[i] = sum;
-	}
-}
+		for (int i = 0; i < layer._numNodes; i++)
+			layer._sdrOutputs[i] = std::max(0.0f, layer._sdrOutputs[i]);
 
-void SDRNetwork::updateUnsupervised(const std::vector<float> &input, float sdrWeightAlpha, float inhibitionAlpha, float biasAlpha) {
-	int prevLayerWidth = _inputWidth;
-	int prevLayerHeight = _inputHeight;
+		pPrevLayerOutput = layer._sdrOutputs.data();
+	}
 
-	std::vector<float> prevLayerOutput = input;
+	// Activate through weights
+	pPrevLayerOutput = input.data();
 
 	for (int l = 0; l < _layers.size(); l++) {
-		float rbfWidthInv = 1.0f / _layerDescs[l]._width;
-		float rbfHeightInv = 1.0f / _layerDescs[l]._height;
+		Layer &layer = _layers[l];
 
-		/*std::vector<float> reconstruction(prevLayerWidth * prevLayerHeight, 0.0f);
+		fillInputPlane(l, layer._backInputPlane, pPrevLayerOutput);
 
-		for (int rx = 0; rx < _layerDescs[l]._width; rx++)
-			for (int ry = 0; ry < _layerDescs[l]._height; ry++) {
-				int i = rx + ry * _layerDescs[l]._width;
+		std::copy(layer._backBiases.begin(), layer._backBiases.end(), layer._backSigs.begin());
 
-				float rxn = rx * rbfWidthInv;
-				float ryn = ry * rbfHeightInv;
+		accumulateReceptiveFields(l, layer._backWeights, layer._backInputPlane, layer._backSigs.data());
 
-				int x = std::round(rxn * prevLayerWidth);
-				int y = std::round(ryn * prevLayerHeight);
+		for (int i = 0; i < layer._numNodes; i++) {
+			layer._backSigs[i] = sigmoid(layer._backSigs[i]);
+			layer._backOutputs[i] = layer._backSigs[i] * layer._sdrOutputs[i];
+		}
 
-				int weightIndex = 0;
+		pPrevLayerOutput = layer._backOutputs.data();
+	}
 
-				for (int dx = -_layerDescs[l]._receptiveRadius; dx <= _layerDescs[l]._receptiveRadius; dx++)
-					for (int dy = -_layerDescs[l]._receptiveRadius; dy <= _layerDescs[l]._receptiveRadius; dy++) {
-						int xn = x + dx;
-						int yn = y + dy;
+	if (output.size() != _outputBiases.size())
+		output.resize(_outputBiases.size());
 
-						if (xn >= 0 && xn < prevLayerWidth && yn >= 0 && yn < prevLayerHeight) {
-							int j = xn + yn * prevLayerWidth;
+	const Layer &lastLayer = _layers.back();
 
-							reconstruction[j] += _layers[l]._nodes[i]._sdrOutput * _layers[l]._nodes[i]._sdrWeights[weightIndex];
-						}
+	for (int i = 0; i < _outputBiases.size(); i++) {
+		const float* pWeights = &_outputWeights[i * lastLayer._numNodes];
 
-						weightIndex++;
-					}
-			}
+		float sum = _outputBiases[i];
+
+		for (int rx = 0; rx < _layerDescs.back()._width; rx++)
+		for (int ry = 0; ry < _layerDescs.back()._height; ry++) {
+			int j = rx + ry * _layerDescs.back()._width;
 
-		std::vector<float> error(prevLayerWidth * prevLayerHeight);
+			sum += lastLayer._backOutputs[j] * pWeights[j];
+		}
 
-		for (int i = 0; i < error.size(); i++)
-			error[i] = prevLayerOutput[i] - reconstruction[i];*/
+		output[i] = sum;
+	}
+}
 
-		for (int rx = 0; rx < _layerDescs[l]._width; rx++)
-		for (int ry = 0; ry < _layerDescs[l]._height; ry++) {
-			int i = rx + ry * _layerDescs[l]._width;
+void SDRNetwork::updateUnsupervised(const std::vector<float> &input, float sdrWeightAlpha, float inhibitionAlpha, float biasAlpha) {
+	const float* pPrevLayerOutput = input.data();
 
-			float rxn = rx * rbfWidthInv;
-			float ryn = ry * rbfHeightInv;
+	for (int l = 0; l < _layers.size(); l++) {
+		Layer &layer = _layers[l];
+		const LayerDesc &desc = _layerDescs[l];
+
+		int prevLayerWidth = getPrevLayerWidth(l);
+		int prevLayerHeight = getPrevLayerHeight(l);
 
-			int x = std::round(rxn * prevLayerWidth);
-			int y = std::round(ryn * prevLayerHeight);
+		fillInputPlane(l, layer._sdrInputPlane, pPrevLayerOutput);
 
-			float learn = _layers[l]._nodes[i]._sdrOutput;
+		const float* pActivations = layer._sdrActivations.data();
+		const float* pOutputs = layer._sdrOutputs.data();
+
+		// Rows of nodes share the center y of their fields, taps outside the previous layer are not updated
+		for (int ry = 0; ry < desc._height; ry++) {
+			int rowStart = ry * desc._width;
 
 			int weightIndex = 0;
 
-			for (int dx = -_layerDescs[l]._receptiveRadius; dx <= _layerDescs[l]._receptiveRadius; dx++)
-			for (int dy = -_layerDescs[l]._receptiveRadius; dy <= _layerDescs[l]._receptiveRadius; dy++) {
-				int xn = x + dx;
-				int yn = y + dy;
+			for (int dx = -desc._receptiveRadius; dx <= desc._receptiveRadius; dx++)
+			for (int dy = -desc._receptiveRadius; dy <= desc._receptiveRadius; dy++) {
+				int yn = layer._centerYs[ry] + dy;
+
+				if (yn >= 0 && yn < prevLayerHeight) {
+					float* pWeights = &layer._sdrWeights[weightIndex * layer._numNodes];
+					const float* pPlane = &layer._sdrInputPlane[layer._tapOffsets[weightIndex]];
+
+					for (int rx = 0; rx < desc._width; rx++) {
+						int i = rowStart + rx;
+						int xn = layer._centerXs[rx] + dx;
 
-				if (xn >= 0 && xn < prevLayerWidth && yn >= 0 && yn < prevLayerHeight) {
-					int j = xn + yn * prevLayerWidth;
+						float weight = pWeights[i];
+						float newWeight = weight + sdrWeightAlpha * pOutputs[i] * (pPlane[layer._fieldStarts[i]] - pActivations[i] * weight);
 
-					_layers[l]._nodes[i]._sdrWeights[weightIndex] += sdrWeightAlpha * learn * (prevLayerOutput[j] - _layers[l]._nodes[i]._sdrActivation * _layers[l]._nodes[i]._sdrWeights[weightIndex]);
+						pWeights[i] = (xn >= 0 && xn < prevLayerWidth) ? newWeight : weight;
+					}
 				}
 
 				weightIndex++;
@@ -348,205 +395,305 @@ void SDRNetwork::updateUnsupervised(const std::vector<float> &input, float sdrWe
 
 			weightIndex = 0;
 
-			for (int dx = -_layerDescs[l]._inhibitionRadius; dx <= _layerDescs[l]._inhibitionRadius; dx++)
-				for (int dy = -_layerDescs[l]._inhibitionRadius; dy <= _layerDescs[l]._inhibitionRadius; dy++) {
-					int x = rx + dx;
-					int y = ry + dy;
+			for (int dx = -desc._inhibitionRadius; dx <= desc._inhibitionRadius; dx++)
+			for (int dy = -desc._inhibitionRadius; dy <= desc._inhibitionRadius; dy++) {
+				int y = ry + dy;
 
-					if (x >= 0 && x < _layerDescs[l]._width && y >= 0 && y < _layerDescs[l]._height) {
-						int j = x + y * _layerDescs[l]._width;
+				if (y >= 0 && y < desc._height) {
+					float* pInhibition = &layer._sdrInhibition[weightIndex * layer._numNodes];
 
-						_layers[l]._nodes[i]._sdrInhibition[weightIndex] = std::max(0.0f, _layers[l]._nodes[i]._sdrInhibition[weightIndex] + inhibitionAlpha * ((_layers[l]._nodes[i]._sdrOutput > 0.0f ? 1.0f : 0.0f) - _layerDescs[l]._sparsity) * std::max(0.0f, _layers[l]._nodes[j]._sdrActivation - _layers[l]._nodes[i]._sdrActivation));
-					}
+					int rxStart = std::max(0, -dx);
+					int rxEnd = std::min(desc._width, desc._width - dx);
+
+					int neighbourOffset = dx + dy * desc._width;
+
+					for (int rx = rxStart; rx < rxEnd; rx++) {
+						int i = rowStart + rx;
 
-					weightIndex++;
+						pInhibition[i] = std::max(0.0f, pInhibition[i] + inhibitionAlpha * ((pOutputs[i] > 0.0f ? 1.0f : 0.0f) - desc._sparsity) * std::max(0.0f, pActivations[i + neighbourOffset] - pActivations[i]));
+					}
 				}
 
-			_layers[l]._nodes[i]._sdrBias += biasAlpha * (_layerDescs[l]._sparsity - _layers[l]._nodes[i]._sdrOutput);
+				weightIndex++;
+			}
 		}
 
-		prevLayerOutput.resize(_layers[l]._nodes.size());
+		for (int i = 0; i < layer._numNodes; i++)
+			layer._sdrBiases[i] += biasAlpha * (desc._sparsity - layer._sdrOutputs[i]);
 
-		for (int i = 0; i < _layers[l]._nodes.size(); i++)
-			prevLayerOutput[i] = _layers[l]._nodes[i]._sdrOutput;
-
-		prevLayerWidth = _layerDescs[l]._width;
-		prevLayerHeight = _layerDescs[l]._height;
+		pPrevLayerOutput = layer._sdrOutputs.data();
 	}
 }
 
 void SDRNetwork::updateSupervised(const std::vector<float> &input, const std::vector<float> &output, const std::vector<float> &target, float backWeightAlpha, float backWeightOutputLayerAlpha, float momentum) {
-	for (int i = 0; i < _outputNodes.size(); i++)
-		_outputNodes[i]._error = target[i] - output[i];
+	for (int i = 0; i < _outputBiases.size(); i++)
+		_outputErrors[i] = target[i] - output[i];
 
-	// Back propagate - first layer
-	for (int rx = 0; rx < _layerDescs.back()._width; rx++)
-	for (int ry = 0; ry < _layerDescs.back()._height; ry++) {
-		int i = rx + ry * _layerDescs.back()._width;
+	Layer &lastLayer = _layers.back();
 
+	// Back propagate - first layer
+	for (int i = 0; i < lastLayer._numNodes; i++) {
 		float sum = 0.0f;
 
-		for (int j = 0; j < _outputNodes.size(); j++)
-			sum += _outputNodes[j]._connections[i]._weight * _outputNodes[j]._error;
+		for (int j = 0; j < _outputBiases.size(); j++)
+			sum += _outputWeights[j * lastLayer._numNodes + i] * _outputErrors[j];
 
-		_layers.back()._nodes[i]._backError = sum * _layers.back()._nodes[i]._backSig * (1.0f - _layers.back()._nodes[i]._backSig) * _layers.back()._nodes[i]._sdrOutput;
+		lastLayer._backErrors[i] = sum * lastLayer._backSigs[i] * (1.0f - lastLayer._backSigs[i]) * lastLayer._sdrOutputs[i];
 	}
 
 	// Back propagate - all other layers (exclude first, want to use sparseness as input)
 	for (int l = _layerDescs.size() - 2; l >= 0; l--) {
-		int nl = l + 1;
-
-		for (int rx = 0; rx < _layerDescs[l]._width; rx++)
-		for (int ry = 0; ry < _layerDescs[l]._height; ry++) {
-			int i = rx + ry * _layerDescs[l]._width;
+		Layer &layer = _layers[l];
+		const Layer &nextLayer = _layers[l + 1];
 
+		for (int i = 0; i < layer._numNodes; i++) {
 			float sum = 0.0f;
 
-			for (int j = 0; j < _layers[l]._nodes[i]._backConnections.size(); j++) {
-				int ni = _layers[l]._nodes[i]._backConnections[j]._nodeIndex;
-				int wi = _layers[l]._nodes[i]._backConnections[j]._weightIndex;
+			for (int j = layer._backConnectionStarts[i]; j < layer._backConnectionStarts[i + 1]; j++) {
+				int ni = layer._backConnections[j]._nodeIndex;
+				int wi = layer._backConnections[j]._weightIndex;
 
-				sum += _layers[nl]._nodes[ni]._backWeights[wi]._weight * _layers[nl]._nodes[ni]._backError;
+				sum += nextLayer._backWeights[wi * nextLayer._numNodes + ni] * nextLayer._backErrors[ni];
 			}
 
-			_layers[l]._nodes[i]._backError = sum *  _layers[l]._nodes[i]._backSig * (1.0f - _layers[l]._nodes[i]._backSig) * _layers[l]._nodes[i]._sdrOutput;
+			layer._backErrors[i] = sum * layer._backSigs[i] * (1.0f - layer._backSigs[i]) * layer._sdrOutputs[i];
 		}
 	}
 
 	// Update weights
-	for (int i = 0; i < _outputNodes.size(); i++) {
-		float alphaError = backWeightOutputLayerAlpha * _outputNodes[i]._error;
+	for (int i = 0; i < _outputBiases.size(); i++) {
+		float alphaError = backWeightOutputLayerAlpha * _outputErrors[i];
 
-		for (int rx = 0; rx < _layerDescs.back()._width; rx++)
-		for (int ry = 0; ry < _layerDescs.back()._height; ry++) {
-			int j = rx + ry * _layerDescs.back()._width;
+		float* pWeights = &_outputWeights[i * lastLayer._numNodes];
 
-			_outputNodes[i]._connections[j]._weight += alphaError * _layers.back()._nodes[j]._backOutput;
-		}
+		for (int j = 0; j < lastLayer._numNodes; j++)
+			pWeights[j] += alphaError * lastLayer._backOutputs[j];
 
-		_outputNodes[i]._bias._weight += alphaError;
+		_outputBiases[i] += alphaError;
 	}
 
-	int prevLayerWidth = _inputWidth;
-	int prevLayerHeight = _inputHeight;
-
-	std::vector<float> prevLayerOutput = input;
+	const float* pPrevLayerOutput = input.data();
 
 	for (int l = 0; l < _layers.size(); l++) {
-		float rbfWidthInv = 1.0f / _layerDescs[l]._width;
-		float rbfHeightInv = 1.0f / _layerDescs[l]._height;
+		Layer &layer = _layers[l];
+		const LayerDesc &desc = _layerDescs[l];
 
-		for (int rx = 0; rx < _layerDescs[l]._width; rx++)
-		for (int ry = 0; ry < _layerDescs[l]._height; ry++) {
-			int i = rx + ry * _layerDescs[l]._width;
+		int prevLayerWidth = getPrevLayerWidth(l);
+		int prevLayerHeight = getPrevLayerHeight(l);
 
-			float rxn = rx * rbfWidthInv;
-			float ryn = ry * rbfHeightInv;
+		fillInputPlane(l, layer._backInputPlane, pPrevLayerOutput);
+
+		const float* pErrors = layer._backErrors.data();
 
-			int x = std::round(rxn * prevLayerWidth);
-			int y = std::round(ryn * prevLayerHeight);
+		for (int ry = 0; ry < desc._height; ry++) {
+			int rowStart = ry * desc._width;
 
 			int weightIndex = 0;
 
-			for (int dx = -_layerDescs[l]._receptiveRadius; dx <= _layerDescs[l]._receptiveRadius; dx++)
-			for (int dy = -_layerDescs[l]._receptiveRadius; dy <= _layerDescs[l]._receptiveRadius; dy++) {
-				int xn = x + dx;
-				int yn = y + dy;
+			for (int dx = -desc._receptiveRadius; dx <= desc._receptiveRadius; dx++)
+			for (int dy = -desc._receptiveRadius; dy <= desc._receptiveRadius; dy++) {
+				int yn = layer._centerYs[ry] + dy;
+
+				if (yn >= 0 && yn < prevLayerHeight) {
+					float* pWeights = &layer._backWeights[weightIndex * layer._numNodes];
+					float* pPrevDWeights = &layer._backPrevDWeights[weightIndex * layer._numNodes];
+					const float* pPlane = &layer._backInputPlane[layer._tapOffsets[weightIndex]];
 
-				if (xn >= 0 && xn < prevLayerWidth && yn >= 0 && yn < prevLayerHeight) {
-					int j = xn + yn * prevLayerWidth;
+					for (int rx = 0; rx < desc._width; rx++) {
+						int i = rowStart + rx;
+						int xn = layer._centerXs[rx] + dx;
 
-					float prevWeight = _layers[l]._nodes[i]._backWeights[weightIndex]._weight;
+						bool inBounds = xn >= 0 && xn < prevLayerWidth;
 
-					_layers[l]._nodes[i]._backWeights[weightIndex]._weight += _layers[l]._nodes[i]._backWeights[weightIndex]._prevDWeight * momentum + backWeightAlpha * _layers[l]._nodes[i]._backError * prevLayerOutput[j];
-				
-					_layers[l]._nodes[i]._backWeights[weightIndex]._prevDWeight = _layers[l]._nodes[i]._backWeights[weightIndex]._weight - prevWeight;
+						float prevWeight = pWeights[i];
+						float newWeight = prevWeight + (pPrevDWeights[i] * momentum + backWeightAlpha * pErrors[i] * pPlane[layer._fieldStarts[i]]);
+
+						pWeights[i] = inBounds ? newWeight : prevWeight;
+						pPrevDWeights[i] = inBounds ? newWeight - prevWeight : pPrevDWeights[i];
+					}
 				}
 
 				weightIndex++;
 			}
+		}
 
-			float prevWeight = _layers[l]._nodes[i]._backBias._weight;
+		for (int i = 0; i < layer._numNodes; i++) {
+			float prevWeight = layer._backBiases[i];
 
-			_layers[l]._nodes[i]._backBias._weight += _layers[l]._nodes[i]._backBias._prevDWeight * momentum + backWeightAlpha * _layers[l]._nodes[i]._backError;
+			layer._backBiases[i] += layer._backPrevDBiases[i] * momentum + backWeightAlpha * layer._backErrors[i];
 
-			_layers[l]._nodes[i]._backBias._prevDWeight = _layers[l]._nodes[i]._backBias._weight - prevWeight;
+			layer._backPrevDBiases[i] = layer._backBiases[i] - prevWeight;
 		}
 
-		prevLayerOutput.resize(_layers[l]._nodes.size());
-
-		for (int i = 0; i < _layers[l]._nodes.size(); i++)
-			prevLayerOutput[i] = _layers[l]._nodes[i]._backOutput;
-
-		prevLayerWidth = _layerDescs[l]._width;
-		prevLayerHeight = _layerDescs[l]._height;
+		pPrevLayerOutput = layer._backOutputs.data();
 	}
 }
 
-void SDRNetwork::getImages(std::vector<sf::Image> &images) {
+void SDRNetwork::getImages(std::vector<std::vector<float>> &images) const {
 	images.clear();
 	images.reserve(_layers.size());
 
-	float maxActivation = 0.0001f;
-
 	for (int l = 0; l < _layers.size(); l++) {
-		for (int x = 0; x < _layerDescs[l]._width; x++)
-			for (int y = 0; y < _layerDescs[l]._height; y++) {
-				maxActivation = std::max(maxActivation, _layers[l]._nodes[x + y * _layerDescs[l]._width]._sdrOutput);
-			}
-	}
-
-	float activationMult = 1.0f / maxActivation;
-
-	for (int l = 0; l < _layers.size(); l++) {
-		sf::Image img;
-
-		img.create(_layerDescs[l]._width, _layerDescs[l]._height);
+		std::vector<float> img(_layers[l]._numNodes);
 
-		for (int x = 0; x < img.getSize().x; x++)
-		for (int y = 0; y < img.getSize().y; y++) {
-			sf::Color color = sf::Color::White;
-
-			color.r = color.b = color.g = std::min(1.0f, std::max(0.0f, _layers[l]._nodes[x + y * _layerDescs[l]._width]._sdrOutput)) * 255.0f;
-
-			img.setPixel(x, y, color);
-		}
+		for (int i = 0; i < _layers[l]._numNodes; i++)
+			img[i] = std::min(1.0f, std::max(0.0f, _layers[l]._sdrOutputs[i]));
 
 		images.push_back(img);
 	}
 }
 
-void SDRNetwork::getReceptiveFields(int layer, sf::Image &image) {
+void SDRNetwork::getReceptiveFields(int layer, std::vector<float> &image, int &width, int &height) const {
 	int windowSize = _layerDescs[layer]._receptiveRadius * 2 + 1;
 
-	image.create(windowSize * _layerDescs[layer]._width, windowSize * _layerDescs[layer]._height);
+	width = windowSize * _layerDescs[layer]._width;
+	height = windowSize * _layerDescs[layer]._height;
+
+	image.resize(width * height);
+
+	const std::vector<float> &weights = _layers[layer]._sdrWeights;
+	int numNodes = _layers[layer]._numNodes;
 
 	float minWeight = 9999.0f;
 	float maxWeight = -9999.0f;
 
+	for (int i = 0; i < weights.size(); i++) {
+		minWeight = std::min(minWeight, weights[i]);
+
+		maxWeight = std::max(maxWeight, weights[i]);
+	}
+
+	float mult = 1.0f / (maxWeight - minWeight);
+
 	for (int wx = 0; wx < _layerDescs[layer]._width; wx++)
 		for (int wy = 0; wy < _layerDescs[layer]._height; wy++) {
 			for (int x = 0; x < windowSize; x++)
-				for (int y = 0; y < windowSize; y++) {
-					float w = _layers[layer]._nodes[wx + wy * _layerDescs[layer]._width]._sdrWeights[y + x * windowSize];
+				for (int y = 0; y < windowSize; y++)
+					image[(wx * windowSize + x) + (wy * windowSize + y) * width] = mult * (weights[(y + x * windowSize) * numNodes + wx + wy * _layerDescs[layer]._width] - minWeight);
+		}
+}
 
-					minWeight = std::min(minWeight, w);
+void SDRNetwork::writeToCheckpoint(io::CheckpointWriter &writer, const std::string &prefix) const {
+	int dims[3] = { _inputWidth, _inputHeight, static_cast<int>(_outputBiases.size()) };
 
-					maxWeight = std::max(maxWeight, w);
-				}
+	writer.addInts(prefix + "dims", dims, 3);
+
+	std::vector<int> layerDescInts;
+	std::vector<float> layerDescFloats;
+
+	for (int l = 0; l < _layerDescs.size(); l++) {
+		int descInts[4] = { _layerDescs[l]._width, _layerDescs[l]._height, _layerDescs[l]._receptiveRadius, _layerDescs[l]._inhibitionRadius };
+		float descFloats[3] = { _layerDescs[l]._sparsity, _layerDescs[l]._sdrActivationLeak, _layerDescs[l]._similarityDistanceFactor };
+
+		layerDescInts.insert(layerDescInts.end(), descInts, descInts + 4);
+		layerDescFloats.insert(layerDescFloats.end(), descFloats, descFloats + 3);
+	}
+
+	writer.addInts(prefix + "layerDescInts", layerDescInts);
+	writer.addFloats(prefix + "layerDescFloats", layerDescFloats);
+
+	// Per layer, node-major matrices (transposed from the tap-major layout)
+	for (int l = 0; l < _layers.size(); l++) {
+		const Layer &layer = _layers[l];
+
+		std::vector<float> sdrWeights(layer._numNodes * layer._numTaps);
+		std::vector<float> sdrInhibition(layer._numNodes * layer._numInhibitionTaps);
+		std::vector<float> backWeights(layer._numNodes * layer._numTaps);
+
+		for (int i = 0; i < layer._numNodes; i++) {
+			for (int j = 0; j < layer._numTaps; j++) {
+				sdrWeights[i * layer._numTaps + j] = layer._sdrWeights[j * layer._numNodes + i];
+				backWeights[i * layer._numTaps + j] = layer._backWeights[j * layer._numNodes + i];
+			}
+
+			for (int j = 0; j < layer._numInhibitionTaps; j++)
+				sdrInhibition[i * layer._numInhibitionTaps + j] = layer._sdrInhibition[j * layer._numNodes + i];
 		}
 
-	float mult = 1.0f / (maxWeight - minWeight);
+		std::string layerPrefix = prefix + "layer" + std::to_string(l) + "/";
 
-	for (int wx = 0; wx < _layerDescs[layer]._width; wx++)
-		for (int wy = 0; wy < _layerDescs[layer]._height; wy++) {
-			for (int x = 0; x < windowSize; x++)
-				for (int y = 0; y < windowSize; y++) {
-					sf::Color color = sf::Color::White;
+		writer.addFloats(layerPrefix + "sdrWeights", sdrWeights);
+		writer.addFloats(layerPrefix + "sdrInhibition", sdrInhibition);
+		writer.addFloats(layerPrefix + "sdrBiases", layer._sdrBiases);
+		writer.addFloats(layerPrefix + "backWeights", backWeights);
+		writer.addFloats(layerPrefix + "backBiases", layer._backBiases);
+	}
 
-					color.r = color.b = color.g = mult * (_layers[layer]._nodes[wx + wy * _layerDescs[layer]._width]._sdrWeights[y + x * windowSize] - minWeight) * 255.0f;
+	writer.addFloats(prefix + "outputWeights", _outputWeights);
+	writer.addFloats(prefix + "outputBiases", _outputBiases);
+}
 
-					image.setPixel(wx * windowSize + x, wy * windowSize + y, color);
-				}
+bool SDRNetwork::readFromCheckpoint(const io::CheckpointReader &reader, const std::string &prefix) {
+	int dims[3];
+
+	if (!reader.readInts(prefix + "dims", dims, 3))
+		return false;
+
+	std::vector<int> layerDescInts;
+	std::vector<float> layerDescFloats;
+
+	if (!reader.readInts(prefix + "layerDescInts", layerDescInts) || !reader.readFloats(prefix + "layerDescFloats", layerDescFloats))
+		return false;
+
+	if (layerDescInts.empty() || layerDescInts.size() % 4 != 0 || layerDescFloats.size() != layerDescInts.size() / 4 * 3)
+		return false;
+
+	std::vector<LayerDesc> layerDescs(layerDescInts.size() / 4);
+
+	for (int l = 0; l < layerDescs.size(); l++) {
+		layerDescs[l]._width = layerDescInts[l * 4 + 0];
+		layerDescs[l]._height = layerDescInts[l * 4 + 1];
+		layerDescs[l]._receptiveRadius = layerDescInts[l * 4 + 2];
+		layerDescs[l]._inhibitionRadius = layerDescInts[l * 4 + 3];
+		layerDescs[l]._sparsity = layerDescFloats[l * 3 + 0];
+		layerDescs[l]._sdrActivationLeak = layerDescFloats[l * 3 + 1];
+		layerDescs[l]._similarityDistanceFactor = layerDescFloats[l * 3 + 2];
+	}
+
+	create(dims[0], dims[1], layerDescs, dims[2]);
+
+	for (int l = 0; l < _layers.size(); l++) {
+		Layer &layer = _layers[l];
+
+		std::string layerPrefix = prefix + "layer" + std::to_string(l) + "/";
+
+		int numNodes = layer._numNodes;
+		int numWeights = layer._numTaps;
+		int numInhibition = layer._numInhibitionTaps;
+
+		std::vector<float> sdrWeights, sdrInhibition, sdrBiases, backWeights, backBiases;
+
+		if (!reader.readFloats(layerPrefix + "sdrWeights", sdrWeights) || sdrWeights.size() != numNodes * numWeights ||
+			!reader.readFloats(layerPrefix + "sdrInhibition", sdrInhibition) || sdrInhibition.size() != numNodes * numInhibition ||
+			!reader.readFloats(layerPrefix + "sdrBiases", sdrBiases) || sdrBiases.size() != numNodes ||
+			!reader.readFloats(layerPrefix + "backWeights", backWeights) || backWeights.size() != numNodes * numWeights ||
+			!reader.readFloats(layerPrefix + "backBiases", backBiases) || backBiases.size() != numNodes)
+			return false;
+
+		for (int i = 0; i < numNodes; i++) {
+			for (int j = 0; j < numWeights; j++) {
+				layer._sdrWeights[j * numNodes + i] = sdrWeights[i * numWeights + j];
+				layer._backWeights[j * numNodes + i] = backWeights[i * numWeights + j];
+			}
+
+			for (int j = 0; j < numInhibition; j++)
+				layer._sdrInhibition[j * numNodes + i] = sdrInhibition[i * numInhibition + j];
 		}
+
+		layer._sdrBiases = sdrBiases;
+		layer._backBiases = backBiases;
+	}
+
+	int numConnections = _layers.back()._numNodes;
+
+	std::vector<float> outputWeights, outputBiases;
+
+	if (!reader.readFloats(prefix + "outputWeights", outputWeights) || outputWeights.size() != _outputBiases.size() * numConnections ||
+		!reader.readFloats(prefix + "outputBiases", outputBiases) || outputBiases.size() != _outputBiases.size())
+		return false;
+
+	_outputWeights = outputWeights;
+	_outputBiases = outputBiases;
+
+	return true;
 }
\ No newline at end of file
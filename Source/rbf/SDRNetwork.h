@@ -21,52 +21,17 @@ misrepresented as being the original software.
 
 #pragma once
 
+#include <io/CheckpointWriter.h>
+#include <io/CheckpointReader.h>
+
 #include <vector>
 #include <random>
 #include <algorithm>
-
-#include <SFML/Graphics.hpp>
+#include <cmath>
 
 namespace sdr {
 	class SDRNetwork {
 	public:
-		struct BackConnection {
-			int _nodeIndex;
-			int _weightIndex;
-		};
-
-		struct BackWeight {
-			float _weight;
-			float _prevDWeight;
-
-			BackWeight()
-				: _prevDWeight(0.0f)
-			{}
-		};
-
-		struct Node {
-			std::vector<float> _sdrWeights;
-			std::vector<float> _sdrInhibition;
-			std::vector<BackWeight> _backWeights;
-			BackWeight _backBias;
-
-			float _sdrBias;
-
-			std::vector<BackConnection> _backConnections;
-
-			float _sdrActivation;
-			float _sdrOutput;
-
-			float _backOutput;
-			float _backSig;
-
-			float _backError;
-
-			Node()
-				: _sdrActivation(0.0f), _sdrOutput(0.0f), _backOutput(0.0f), _backSig(0.0f), _backError(0.0f)
-			{}
-		};
-
 		struct LayerDesc {
 			int _width, _height;
 			int _receptiveRadius;
@@ -84,34 +49,92 @@ namespace sdr {
 			{}
 		};
 
-		struct Layer {
-			std::vector<Node> _nodes;	
-		};
+		static float sigmoid(float x) {
+			return 1.0f / (1.0f + std::exp(-x));
+		}
 
-		struct OutputConnection {
-			float _weight;
+	private:
+		struct BackConnection {
+			int _nodeIndex;
+			int _weightIndex;
 		};
 
-		struct OutputNode {
-			std::vector<OutputConnection> _connections;
-
-			OutputConnection _bias;
+		// Node i is at (i % width, i / width). Per tap arrays are tap-major ([tap * _numNodes + node]) so the kernels run over
+		// contiguous rows of nodes, taps are ordered dx-major and dy-minor like the checkpoint tensors
+		struct Layer {
+			int _numNodes;
+			int _numTaps;
+			int _numInhibitionTaps;
+
+			// Previous layer outputs (or the input) padded with zeros so that taps need no bounds checks.
+			// Receptive fields start at _fieldStarts[node] + _tapOffsets[tap], node field centers are (_centerXs[x], _centerYs[y])
+			int _planeWidth;
+			std::vector<float> _sdrInputPlane;
+			std::vector<float> _backInputPlane;
+			std::vector<int> _fieldStarts;
+			std::vector<int> _tapOffsets;
+			std::vector<int> _centerXs;
+			std::vector<int> _centerYs;
+
+			// Activations padded by the inhibition radius, with the distance falloff of every inhibition tap (0 for skipped taps)
+			int _activationPlaneWidth;
+			std::vector<float> _activationPlane;
+			std::vector<int> _inhibitionStarts;
+			std::vector<int> _inhibitionTapOffsets;
+			std::vector<float> _inhibitionFalloffs;
 
-			float _error;
+			std::vector<float> _sdrWeights;
+			std::vector<float> _sdrInhibition;
+			std::vector<float> _sdrBiases;
+			std::vector<float> _backWeights;
+			std::vector<float> _backPrevDWeights;
+			std::vector<float> _backBiases;
+			std::vector<float> _backPrevDBiases;
+
+			std::vector<float> _sdrActivations;
+			std::vector<float> _sdrOutputs;
+			std::vector<float> _backSigs;
+			std::vector<float> _backOutputs;
+			std::vector<float> _backErrors;
+
+			// Connections into the next layer, those of node i are [_backConnectionStarts[i], _backConnectionStarts[i + 1])
+			std::vector<int> _backConnectionStarts;
+			std::vector<BackConnection> _backConnections;
 		};
 
-		static float sigmoid(float x) {
-			return 1.0f / (1.0f + std::exp(-x));
-		}
-
-	private:
 		std::vector<Layer> _layers;
 		std::vector<LayerDesc> _layerDescs;
-		std::vector<OutputNode> _outputNodes;
+
+		// Output layer, weights are [output * numLastLayerNodes + node]
+		std::vector<float> _outputWeights;
+		std::vector<float> _outputBiases;
+		std::vector<float> _outputErrors;
 
 		int _inputWidth, _inputHeight;
 
+		// Nodes processed together by the receptive field kernels
+		int _tileSize;
+
+		int getPrevLayerWidth(int l) const {
+			return l == 0 ? _inputWidth : _layerDescs[l - 1]._width;
+		}
+
+		int getPrevLayerHeight(int l) const {
+			return l == 0 ? _inputHeight : _layerDescs[l - 1]._height;
+		}
+
+		// Copies values of the previous layer (or the input) into the interior of a padded input plane of layer l
+		void fillInputPlane(int l, std::vector<float> &plane, const float* values);
+
+		// sums[node] += weights[tap, node] * plane[field of node + tap] for all taps
+		void accumulateReceptiveFields(int l, const std::vector<float> &weights, const std::vector<float> &plane, float* sums) const;
+
 	public:
+		SDRNetwork()
+			: _inputWidth(0), _inputHeight(0), _tileSize(64)
+		{}
+
+		void create(int inputWidth, int inputHeight, const std::vector<LayerDesc> &layerDescs, int numOutputs);
 		void createRandom(int inputWidth, int inputHeight, const std::vector<LayerDesc> &layerDescs, int numOutputs, float minSDRWeight, float maxSDRWeight, float minInhibitionWeight, float maxInhibitionWeight, float minBackWeight, float maxBackWeight, std::mt19937 &generator);
 
 		void getOutput(const std::vector<float> &input, std::vector<float> &output, std::mt19937 &generator);
@@ -119,11 +142,32 @@ namespace sdr {
 		void updateUnsupervised(const std::vector<float> &input, float sdrWeightAlpha, float inhibitionAlpha, float biasAlpha);
 		void updateSupervised(const std::vector<float> &input, const std::vector<float> &output, const std::vector<float> &target, float backWeightAlpha, float backWeightOutputLayerAlpha, float momentum);
 
-		void getImages(std::vector<sf::Image> &images);
-		void getReceptiveFields(int layer, sf::Image &image);
+		// Binary checkpoint, tensor names start with prefix
+		void writeToCheckpoint(io::CheckpointWriter &writer, const std::string &prefix) const;
+		bool readFromCheckpoint(const io::CheckpointReader &reader, const std::string &prefix);
+
+		// Greyscale visualizations with values in [0, 1], stored row-major (x + y * width)
+		void getImages(std::vector<std::vector<float>> &images) const;
+		void getReceptiveFields(int layer, std::vector<float> &image, int &width, int &height) const;
+
+		void setTileSize(int tileSize) {
+			_tileSize = std::max(1, tileSize);
+		}
+
+		int getTileSize() const {
+			return _tileSize;
+		}
+
+		int getNumLayers() const {
+			return _layers.size();
+		}
+
+		const LayerDesc &getLayerDesc(int layer) const {
+			return _layerDescs[layer];
+		}
 
 		int getNumOutputs() const {
-			return _outputNodes.size();
+			return _outputBiases.size();
 		}
 	};
 }
\ No newline at end of file
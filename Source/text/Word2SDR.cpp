@@ -22,6 +22,7 @@ misrepresented as being the original software.
 #include <text/Word2SDR.h>
 
 #include <algorithm>
+#include <iostream>
 
 using namespace text;
 
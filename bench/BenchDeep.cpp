@@ -0,0 +1,194 @@
+/*
+AI Lib
+Copyright (C) 2014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <deep/FA.h>
+#include <deep/ConvNet2D.h>
+#include <deep/FERL.h>
+#include <deep/RBM.h>
+
+#include <random>
+
+// Items are hidden neurons per step
+
+static void BM_FA_process(benchmark::State &state) {
+	const int numInputs = 16;
+	const int numOutputs = 4;
+	const int numHiddenLayers = 2;
+	const int numHidden = state.range(0);
+
+	std::mt19937 generator(1234);
+
+	deep::FA fa;
+
+	fa.createRandom(numInputs, numOutputs, numHiddenLayers, numHidden, 0.1f, generator);
+
+	std::uniform_real_distribution<float> inputDist(-1.0f, 1.0f);
+
+	std::vector<float> inputs(numInputs);
+	std::vector<float> outputs(numOutputs);
+
+	for (int i = 0; i < numInputs; i++)
+		inputs[i] = inputDist(generator);
+
+	for (auto _ : state) {
+		fa.process(inputs, outputs);
+
+		benchmark::DoNotOptimize(outputs.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * numHiddenLayers * numHidden);
+}
+
+BENCHMARK(BM_FA_process)->Arg(16)->Arg(64)->Arg(256);
+
+static void BM_FA_backpropagate(benchmark::State &state) {
+	const int numInputs = 16;
+	const int numOutputs = 4;
+	const int numHiddenLayers = 2;
+	const int numHidden = state.range(0);
+
+	std::mt19937 generator(1234);
+
+	deep::FA fa;
+
+	fa.createRandom(numInputs, numOutputs, numHiddenLayers, numHidden, 0.1f, generator);
+
+	std::uniform_real_distribution<float> inputDist(-1.0f, 1.0f);
+
+	std::vector<float> inputs(numInputs);
+	std::vector<float> targets(numOutputs);
+
+	for (int i = 0; i < numInputs; i++)
+		inputs[i] = inputDist(generator);
+
+	for (int i = 0; i < numOutputs; i++)
+		targets[i] = inputDist(generator);
+
+	for (auto _ : state)
+		fa.backpropagate(inputs, targets, 0.001f, 0.0f);
+
+	state.SetItemsProcessed(state.iterations() * numHiddenLayers * numHidden);
+}
+
+BENCHMARK(BM_FA_backpropagate)->Arg(16)->Arg(64)->Arg(256);
+
+// Items are input pixels per step
+
+static void BM_ConvNet2D_activate(benchmark::State &state) {
+	const int inputSize = state.range(0);
+
+	std::mt19937 generator(1234);
+
+	deep::ConvNet2D convNet;
+
+	std::vector<deep::ConvNet2D::LayerPairDesc> descs(2);
+
+	convNet.createRandom(inputSize, inputSize, 1, descs, -0.1f, 0.1f, generator);
+
+	std::uniform_real_distribution<float> inputDist(-1.0f, 1.0f);
+
+	for (int x = 0; x < inputSize; x++)
+	for (int y = 0; y < inputSize; y++)
+		convNet.setInput(x, y, 0, inputDist(generator));
+
+	for (auto _ : state) {
+		convNet.activate();
+
+		benchmark::DoNotOptimize(convNet.getOutput(0, 0, 0));
+	}
+
+	state.SetItemsProcessed(state.iterations() * inputSize * inputSize);
+}
+
+BENCHMARK(BM_ConvNet2D_activate)->Arg(32)->Arg(64)->Arg(128);
+
+// Items are training samples, MNIST sized RBM with sparse binary inputs. The batch argument 1 is the per-sample activate + learn path
+
+static void BM_RBM_learn(benchmark::State &state) {
+	const int numVisible = 784;
+	const int numHidden = 500;
+	const int batchSize = state.range(0);
+
+	std::mt19937 generator(1234);
+
+	deep::RBM rbm;
+
+	rbm.createRandom(numVisible, numHidden, -0.01f, 0.01f, generator);
+
+	std::uniform_real_distribution<float> dist01(0.0f, 1.0f);
+
+	std::vector<float> batch(batchSize * numVisible);
+
+	for (int i = 0; i < batch.size(); i++)
+		batch[i] = dist01(generator) < 0.2f ? 1.0f : 0.0f;
+
+	for (auto _ : state) {
+		if (batchSize == 1) {
+			for (int i = 0; i < numVisible; i++)
+				rbm.setVisible(i, batch[i]);
+
+			rbm.activate(generator);
+			rbm.learn(0.01f, generator);
+		}
+		else
+			rbm.learnBatch(batch.data(), batchSize, 1, 0.01f, generator);
+
+		benchmark::DoNotOptimize(rbm.getWeight(0, 0));
+	}
+
+	state.SetItemsProcessed(state.iterations() * batchSize);
+}
+
+BENCHMARK(BM_RBM_learn)->Arg(1)->Arg(32)->Arg(128);
+
+// Items are agent steps. Replay is kept short so the action search and update dominate
+
+static void BM_FERL_step(benchmark::State &state) {
+	const int numState = 8;
+	const int numAction = 4;
+	const int numHidden = state.range(0);
+
+	std::mt19937 generator(1234);
+
+	deep::FERL ferl;
+
+	ferl.createRandom(numState, numAction, numHidden, 0.1f, generator);
+
+	std::uniform_real_distribution<float> inputDist(-1.0f, 1.0f);
+
+	std::vector<float> inputs(numState);
+	std::vector<float> action(numAction);
+
+	for (auto _ : state) {
+		for (int i = 0; i < numState; i++)
+			inputs[i] = inputDist(generator);
+
+		ferl.step(inputs, action, inputDist(generator), 0.5f, 0.98f, 0.95f, 1.0f, 8, 6, 0.01f, 0.05f, 0.05f, 64, 8, 0.005f, 0.1f, generator);
+
+		benchmark::DoNotOptimize(action.data());
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_FERL_step)->Arg(8)->Arg(32)->Arg(128);
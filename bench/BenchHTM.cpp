@@ -0,0 +1,125 @@
+/*
+AI Lib
+Copyright (C) 2014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <htm/Region.h>
+#include <htm/FlatRegion.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+
+// Items are columns per step, the second spatial pooling argument is the number of threads (only used with AILIB_USE_OPENMP). The input is a square moving along a Lissajous curve,
+// so segments keep being created while the temporal pooler learns
+
+static float boostFunction(float active, float minimum) {
+	return (1.0f - minimum) + std::max(0.0f, -(minimum - active));
+}
+
+static void setMovingSquare(std::vector<bool> &input, int size, int t) {
+	std::fill(input.begin(), input.end(), false);
+
+	int dotX = std::round(size * 0.5f + std::cos(t * 0.1f) * size * 0.4f);
+	int dotY = std::round(size * 0.5f + std::sin(t * 0.2f) * size * 0.2f);
+
+	for (int dx = -2; dx <= 2; dx++)
+	for (int dy = -2; dy <= 2; dy++) {
+		int x = dotX + dx;
+		int y = dotY + dy;
+
+		if (x >= 0 && y >= 0 && x < size && y < size)
+			input[x + size * y] = true;
+	}
+}
+
+template<class RegionType>
+static void BM_Region_spatialPooling(benchmark::State &state) {
+	const int size = state.range(0);
+
+	std::mt19937 generator(1234);
+
+	std::function<float(float, float)> boostFunc = boostFunction;
+
+	RegionType region;
+
+	region.createRandom(size, size, 8, 6, 0, size, size, 5, 0.02f, 2.0f, -0.02f, 0.301f, 0.1f, generator);
+
+	region.setNumThreads(state.range(1));
+
+	std::vector<bool> input(size * size);
+
+	int t = 0;
+
+	for (auto _ : state) {
+		setMovingSquare(input, size, t++);
+
+		region.stepBegin();
+
+		region.spatialPooling(input, 0.3f, 3.0f, 18, 0.02f, 0.015f, 0.01f, 0.05f, 0.05f, 0.015f, boostFunc);
+
+		benchmark::DoNotOptimize(region.getOutput(0));
+	}
+
+	state.SetItemsProcessed(state.iterations() * size * size);
+}
+
+BENCHMARK_TEMPLATE(BM_Region_spatialPooling, htm::Region)->Args({ 16, 1 })->Args({ 32, 1 })->Args({ 64, 1 })->Args({ 64, 4 });
+BENCHMARK_TEMPLATE(BM_Region_spatialPooling, htm::FlatRegion)->Args({ 16, 1 })->Args({ 32, 1 })->Args({ 64, 1 })->Args({ 64, 4 });
+
+template<class RegionType>
+static void BM_Region_temporalPoolingLearn(benchmark::State &state) {
+	const int size = state.range(0);
+
+	std::mt19937 generator(1234);
+
+	std::function<float(float, float)> boostFunc = boostFunction;
+
+	RegionType region;
+
+	region.createRandom(size, size, 8, 6, 0, size, size, 5, 0.02f, 2.0f, -0.02f, 0.301f, 0.1f, generator);
+
+	std::vector<bool> input(size * size);
+
+	int t = 0;
+
+	for (auto _ : state) {
+		state.PauseTiming();
+
+		setMovingSquare(input, size, t++);
+
+		region.stepBegin();
+
+		region.spatialPooling(input, 0.3f, 3.0f, 18, 0.02f, 0.015f, 0.01f, 0.05f, 0.05f, 0.015f, boostFunc);
+
+		state.ResumeTiming();
+
+		region.temporalPoolingLearn(0.3f, 4, 1, 10, 32, 0.02f, 0.015f, 0.301f, 6, generator);
+
+		benchmark::DoNotOptimize(region.getOutput(0));
+	}
+
+	state.SetItemsProcessed(state.iterations() * size * size);
+}
+
+BENCHMARK_TEMPLATE(BM_Region_temporalPoolingLearn, htm::Region)->Arg(16)->Arg(32)->Arg(64);
+BENCHMARK_TEMPLATE(BM_Region_temporalPoolingLearn, htm::FlatRegion)->Arg(16)->Arg(32)->Arg(64);
@@ -0,0 +1,62 @@
+/*
+AI Lib
+Copyright (C) 2014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <hypernet/HyperNet.h>
+
+#include <random>
+
+// Items are boids per step
+
+static void BM_HyperNet_step(benchmark::State &state) {
+	const int numHidden = state.range(0);
+
+	std::mt19937 generator(1234);
+
+	hn::Config config;
+
+	config._numInputGroups = 2;
+	config._numInputsPerGroup = 1;
+	config._numOutputGroups = 1;
+	config._numOutputsPerGroup = 1;
+
+	hn::HyperNet hypernet;
+
+	hypernet.createRandom(config, 0, 0.02f, -2.0f, 2.0f, generator, 6.0f);
+
+	hypernet.generateFeedForward(config, 1, numHidden, generator);
+
+	std::uniform_real_distribution<float> inputDist(-10.0f, 10.0f);
+
+	for (auto _ : state) {
+		hypernet.setInput(0, inputDist(generator));
+		hypernet.setInput(1, inputDist(generator));
+
+		hypernet.step(config, 0.0f, generator, 4, 6.0f);
+
+		benchmark::DoNotOptimize(hypernet.getOutput(0));
+	}
+
+	state.SetItemsProcessed(state.iterations() * (2 + numHidden + 1));
+}
+
+BENCHMARK(BM_HyperNet_step)->Arg(4)->Arg(16)->Arg(64);
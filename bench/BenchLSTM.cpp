@@ -19,43 +19,37 @@ misrepresented as being the original software.
 3. This notice may not be removed or altered from any source distribution.
 */
 
-#pragma once
+#include <benchmark/benchmark.h>
 
-#include <hypernet/Config.h>
-#include <hypernet/FunctionApproximator.h>
+#include <lstm/LSTMG.h>
 
-namespace hn {
-	class Link {
-	private:
-		int _inputOffset;
-		
-		std::vector<float> _linkMemory;
+#include <random>
 
-		std::vector<float> _response;
+// Items are memory cells per step
 
-	public:
-		Link(const Config &config, class HyperNet &hypernet, int inputOffset, std::mt19937 &generator);
+static void BM_LSTMG_step(benchmark::State &state) {
+	const int numInputs = 8;
+	const int numOutputs = 4;
+	const int memoryLayerSize = state.range(0);
 
-		void update(const Config &config, float reward, class HyperNet &hypernet, std::mt19937 &generator, float activationMultiplier);
+	std::mt19937 generator(1234);
 
-		size_t getResponseSize() const {
-			return _response.size();
-		}
+	lstm::LSTMG lstmg;
 
-		float getResponse(size_t index) const {
-			return _response[index];
-		}
+	lstmg.createRandomLayered(numInputs, numOutputs, 1, memoryLayerSize, 1, memoryLayerSize, -0.1f, 0.1f, generator);
 
-		int getInputOffset() const {
-			return _inputOffset;
-		}
+	std::uniform_real_distribution<float> inputDist(-1.0f, 1.0f);
 
-		size_t getMemorySize() const {
-			return _linkMemory.size();
-		}
+	for (auto _ : state) {
+		for (int i = 0; i < numInputs; i++)
+			lstmg.setInput(i, inputDist(generator));
 
-		float getMemory(size_t index) const {
-			return _linkMemory[index];
-		}
-	};
-}
\ No newline at end of file
+		lstmg.step(false);
+
+		benchmark::DoNotOptimize(lstmg.getOutput(0));
+	}
+
+	state.SetItemsProcessed(state.iterations() * memoryLayerSize);
+}
+
+BENCHMARK(BM_LSTMG_step)->Arg(4)->Arg(16)->Arg(64);
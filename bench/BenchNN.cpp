@@ -0,0 +1,90 @@
+/*
+AI Lib
+Copyright (C) 2014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <nn/FeedForwardNeuralNetwork.h>
+
+#include <random>
+
+// Items are neurons (hidden and output) evaluated per step
+
+static void BM_FeedForwardNeuralNetwork_activate(benchmark::State &state) {
+	const size_t numInputs = state.range(0);
+	const size_t numHidden = state.range(0);
+	const size_t numHiddenLayers = 2;
+	const size_t numOutputs = 8;
+
+	std::mt19937 generator(1234);
+
+	nn::FeedForwardNeuralNetwork ffnn;
+
+	ffnn.createRandom(numInputs, numOutputs, numHiddenLayers, numHidden, -0.5f, 0.5f, generator);
+
+	std::uniform_real_distribution<float> inputDist(-1.0f, 1.0f);
+
+	for (size_t i = 0; i < numInputs; i++)
+		ffnn.setInput(i, inputDist(generator));
+
+	for (auto _ : state) {
+		ffnn.activate();
+
+		benchmark::DoNotOptimize(ffnn.getOutput(0));
+	}
+
+	state.SetItemsProcessed(state.iterations() * (numHiddenLayers * numHidden + numOutputs));
+}
+
+BENCHMARK(BM_FeedForwardNeuralNetwork_activate)->Arg(16)->Arg(64)->Arg(256)->Arg(1024);
+
+// Items are samples per call
+
+static void BM_FeedForwardNeuralNetwork_activateBatch(benchmark::State &state) {
+	const size_t numInputs = state.range(0);
+	const size_t numHidden = state.range(0);
+	const size_t numHiddenLayers = 2;
+	const size_t numOutputs = 8;
+	const size_t batchSize = 64;
+
+	std::mt19937 generator(1234);
+
+	nn::FeedForwardNeuralNetwork ffnn;
+
+	ffnn.createRandom(numInputs, numOutputs, numHiddenLayers, numHidden, -0.5f, 0.5f, generator);
+
+	std::uniform_real_distribution<float> inputDist(-1.0f, 1.0f);
+
+	std::vector<float> inputs(batchSize * numInputs);
+	std::vector<float> outputs(batchSize * numOutputs);
+
+	for (size_t i = 0; i < inputs.size(); i++)
+		inputs[i] = inputDist(generator);
+
+	for (auto _ : state) {
+		ffnn.activateBatch(inputs.data(), batchSize, outputs.data());
+
+		benchmark::DoNotOptimize(outputs.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * batchSize);
+}
+
+BENCHMARK(BM_FeedForwardNeuralNetwork_activateBatch)->Arg(16)->Arg(64)->Arg(256)->Arg(1024);
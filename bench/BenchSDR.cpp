@@ -0,0 +1,65 @@
+/*
+AI Lib
+Copyright (C) 2014 Eric Laukien
+
+This software is provided 'as-is', without any express or implied
+warranty.  In no event will the authors be held liable for any damages
+arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not
+claim that you wrote the original software. If you use this software
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <rbf/SDRNetwork.h>
+
+#include <random>
+
+// Items are input pixels per step
+
+static void BM_SDRNetwork_getOutput(benchmark::State &state) {
+	const int inputSize = state.range(0);
+	const int numOutputs = 10;
+
+	std::mt19937 generator(1234);
+
+	std::vector<sdr::SDRNetwork::LayerDesc> layerDescs(2);
+
+	layerDescs[0]._width = inputSize;
+	layerDescs[0]._height = inputSize;
+
+	layerDescs[1]._width = inputSize / 2;
+	layerDescs[1]._height = inputSize / 2;
+
+	sdr::SDRNetwork sdrnet;
+
+	sdrnet.createRandom(inputSize, inputSize, layerDescs, numOutputs, -0.01f, 0.01f, 0.0f, 0.05f, -0.01f, 0.01f, generator);
+
+	std::uniform_real_distribution<float> inputDist(0.0f, 1.0f);
+
+	std::vector<float> input(inputSize * inputSize);
+	std::vector<float> output(numOutputs);
+
+	for (int i = 0; i < input.size(); i++)
+		input[i] = inputDist(generator);
+
+	for (auto _ : state) {
+		sdrnet.getOutput(input, output, generator);
+
+		benchmark::DoNotOptimize(output.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * inputSize * inputSize);
+}
+
+BENCHMARK(BM_SDRNetwork_getOutput)->Arg(16)->Arg(32)->Arg(64);